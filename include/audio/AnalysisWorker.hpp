@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include "audio/LatencyMonitor.hpp"
+#include "audio/MirroredRingBuffer.hpp"
+#include "utils/Semaphore.hpp"
+
+namespace ptm {
+
+struct AnalysisConfig {
+    size_t windowSize = 1024;  // Samples handed to each analysis step
+    size_t hopSize = 256;      // Samples between consecutive steps
+};
+
+struct AnalysisFrame {
+    const float* samples;  // windowSize samples, oldest first; valid during the callback only
+    size_t windowSize;
+    uint64_t hopIndex;     // Hops since start(), including missed ones
+    bool discontinuity;    // Samples were lost since the previous frame
+    LatencyStamp latency;  // Capture and read times; invalid without a monitor
+};
+
+using AnalysisCallback = std::function<void(const AnalysisFrame&)>;
+
+/**
+ * Runs an analysis callback on its own thread, once per hop of audio.
+ *
+ * The audio thread writes to the ring buffer and then calls
+ * notifySamplesWritten(), which posts the semaphore once per completed hop.
+ * The worker sleeps on it, and for each post borrows the next window
+ * straight from the mirrored ring (no copy), runs the callback and consumes
+ * one hop. Samples the ring dropped on overflow are reported as missed hops,
+ * and the next frame is flagged as a discontinuity.
+ *
+ * With a LatencyMonitor, each frame is stamped when it is borrowed; pass
+ * frame.latency on to LatencyMonitor::recordDetection() and recordSend()
+ * (LiveNoteTracker and MidiOutput do).
+ *
+ * The worker is the ring's only consumer while it runs.
+ */
+class AnalysisWorker {
+public:
+    /**
+     * @throws std::invalid_argument if the sizes do not fit the buffer
+     */
+    AnalysisWorker(MirroredRingBuffer<float>& buffer, const AnalysisConfig& config,
+                   AnalysisCallback callback, LatencyMonitor* latencyMonitor = nullptr);
+    ~AnalysisWorker();
+
+    AnalysisWorker(const AnalysisWorker&) = delete;
+    AnalysisWorker& operator=(const AnalysisWorker&) = delete;
+
+    void start();
+
+    // Wakes and joins the worker; hops still queued are not analysed
+    void stop();
+
+    bool isRunning() const { return thread_.joinable(); }
+
+    // Audio thread only, after writing count samples to the buffer
+    void notifySamplesWritten(size_t count) {
+        pendingSamples_ += count;
+        if (pendingSamples_ >= config_.hopSize) {
+            size_t hops = pendingSamples_ / config_.hopSize;
+            pendingSamples_ -= hops * config_.hopSize;
+            hopsReady_.post(static_cast<int32_t>(hops));
+        }
+    }
+
+    const AnalysisConfig& config() const { return config_; }
+    uint64_t processedHops() const { return processedHops_.load(std::memory_order_relaxed); }
+    uint64_t missedHops() const { return missedHops_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void processHop();
+    void accountForDroppedSamples();
+
+    MirroredRingBuffer<float>& buffer_;
+    const AnalysisConfig config_;
+    AnalysisCallback callback_;
+    LatencyMonitor* latencyMonitor_;
+
+    Semaphore hopsReady_;
+    std::thread thread_;
+    std::atomic<bool> stopRequested_{false};
+
+    size_t pendingSamples_ = 0;        // Audio thread
+    uint64_t seenOverflowCount_ = 0;   // Worker thread
+    uint64_t hopIndex_ = 0;
+    bool discontinuity_ = false;
+
+    std::atomic<uint64_t> processedHops_{0};
+    std::atomic<uint64_t> missedHops_{0};
+};
+
+} // namespace ptm
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <portaudio.h>
+#include <array>
+#include <condition_variable>
 #include <string>
 #include <vector>
 #include <functional>
@@ -9,52 +11,45 @@
 #include <set>
 #include <atomic>
 #include <chrono>
-#include "audio/RingBuffer.hpp"
+#include <mutex>
+#include "audio/AnalysisWorker.hpp"
+#include "audio/AudioSource.hpp"
+#include "audio/CaptureDiagnostics.hpp"
+#include "audio/DeviceRegistry.hpp"
+#include "audio/LatencyMonitor.hpp"
+#include "audio/MirroredRingBuffer.hpp"
+#include "audio/StreamStats.hpp"
+#include "utils/FunctionRef.hpp"
+#include "utils/Semaphore.hpp"
 
 namespace ptm {
 
-class AudioCaptureException : public std::runtime_error {
-public:
-    explicit AudioCaptureException(const std::string& message) 
-        : std::runtime_error(message) {}
-};
-
-struct AudioDevice {
-    PaDeviceIndex index;
-    std::string name;
-    std::string hostApi;           // Added: Host API name
-    double defaultSampleRate;
-    std::set<double> sampleRates;  // Added: Supported sample rates
-    int maxInputChannels;
-    double defaultLatency;
-    double minLatency;
-    bool isDefaultInput;           // Added: Is this the default input device?
-
-    // Added: Helper method to check sample rate support
-    bool supportsSampleRate(double rate) const {
-        // If no specific rates are listed, assume default rate only
-        if (sampleRates.empty()) {
-            return rate == defaultSampleRate;
-        }
-        return sampleRates.find(rate) != sampleRates.end();
-    }
+// Measured by AudioCapture::switchSource()
+struct DeviceSwitchStats {
+    uint64_t switches = 0;
+    double lastSwitchMs = 0.0;       // From the request to the new source's first block in the ring
+    uint64_t lastLostFrames = 0;     // Gap between the old source's last block and the new one's first
+    uint64_t lastOverlapFrames = 0;  // New-source frames discarded while the old one still fed the ring
+    uint64_t totalLostFrames = 0;
 };
 
-// Added: Callback type for device list changes
-using DeviceListCallback = std::function<void(const std::vector<AudioDevice>&)>;
-
-// Forward declare StreamStats (defined in cpp file)
-struct StreamStats;
+// Called on the audio thread with each block's channel 0. Non-owning: the
+// callable must outlive the stream, and must not allocate, lock or block.
+using CaptureCallback = FunctionRef<void(const float*, unsigned long)>;
 
 class AudioCapture {
 public:
     static constexpr size_t kDefaultBufferSize = 8192; // Ring buffer size in samples
+    // A live tracker wants the freshest audio, so stale samples go first
+    static constexpr OverflowPolicy kDefaultOverflowPolicy = OverflowPolicy::DropOldest;
     static constexpr std::chrono::milliseconds kShutdownTimeout{1000}; // 1 second timeout
+    static constexpr std::chrono::milliseconds kSwitchTimeout{500};    // Per handover step
 
     enum class StreamState {
         Closed,
         Opening,
         Running,
+        Switching,  // Running, with a new source being brought in
         Stopping,
         Error
     };
@@ -66,7 +61,8 @@ public:
     AudioCapture(const AudioCapture&) = delete;
     AudioCapture& operator=(const AudioCapture&) = delete;
 
-    // Device management
+    // Device management. While a stream is running, setDevice() switches it
+    // to the new device (see switchSource()) instead of stopping it.
     std::vector<AudioDevice> enumerateDevices();
     void setDevice(PaDeviceIndex deviceIndex);
     
@@ -76,16 +72,58 @@ public:
     // Added: Default device handling
     PaDeviceIndex getDefaultInputDevice() const;
     
-    // Added: Device monitoring
+    // Added: Device monitoring. The callback runs on the registry's monitor
+    // thread whenever the device list changes; an empty one stops monitoring.
+    // PortAudio reads the system's devices only in Pa_Initialize(), so each
+    // scan re-initialises it while no stream is open; devices plugged in or
+    // out while streaming show up once the stream stops. Device indices can
+    // change with it: start() finds the selected device again by its id.
     void setDeviceChangeCallback(DeviceListCallback callback);
+
+    // Device list and sample-rate probes, cached across calls
+    DeviceRegistry& getDeviceRegistry() { return deviceRegistry_; }
     
     // Stream control
     void start(double sampleRate = 44100.0,
               unsigned int framesPerBuffer = 256,
-              std::function<void(const float*, unsigned long)> callback = nullptr);
+              CaptureCallback callback = nullptr);
+
+    // Run the same pipeline (ring buffer, analysis worker, user callback,
+    // diagnostics) from any source, e.g. a WavFileSource or SyntheticSource
+    // replayed faster than real time. The selected device is not used.
+    void start(std::unique_ptr<AudioSource> source,
+              CaptureCallback callback = nullptr);
     void stop();
     bool isActive() const;
     StreamState getState() const { return streamState_.load(); }
+
+    // Blocks until the stream reaches the state; false on timeout
+    bool waitForState(StreamState expectedState,
+                      std::chrono::milliseconds timeout = kShutdownTimeout) const;
+
+    // Input channels opened by start() on a device (only changeable while
+    // the stream is closed). Channel 0 feeds the ring buffer, analysis worker
+    // and user callback; the channel sink sees every channel.
+    void setChannelCount(unsigned channels);
+    unsigned getChannelCount() const { return channelCount_; }
+
+    // Receives each block with all its channels interleaved, on the audio
+    // thread, after the ring buffer write; e.g. a MultiChannelTracker. Only
+    // changeable while the stream is closed. The sink is not owned and must
+    // outlive the stream; start and stop it around the stream yourself.
+    void setChannelSink(AudioSink* sink);
+
+    // Hand the running stream over to another source without stopping it.
+    // The new source is started alongside the old one and its blocks are
+    // discarded until it delivers; the old source then writes one more
+    // block and hands over at that boundary, so the ring buffer, analysis
+    // worker and statistics carry on with at most a block or so missing.
+    // If the old source has stopped delivering (e.g. it was unplugged) it is
+    // stopped and the new one takes over directly. The sample rate and
+    // channel count must match. Call from the thread that starts and stops
+    // the stream.
+    void switchSource(std::unique_ptr<AudioSource> source);
+    DeviceSwitchStats getSwitchStats() const;
     
     // Stream health monitoring
     bool isStreamHealthy() const;
@@ -95,41 +133,131 @@ public:
     bool isValidSampleRate(double sampleRate) const;
     std::vector<double> getSupportedSampleRates() const;
 
-    // Add new method to get stream statistics
-    StreamStats getStreamStats() const;
+    // Callback timing, latency and xrun counts; safe from any thread
+    StreamStatsSnapshot getStreamStats() const;
+
+    // Callback events lost because the diagnostics queue was full
+    uint64_t getDroppedDiagnosticEvents() const { return diagnostics_.droppedEvents(); }
 
     // Audio data access
     size_t getAudioData(float* buffer, size_t count);
     size_t getAvailableSamples() const;
     void clearAudioBuffer();
 
+    // Zero-copy access for a single consumer thread. peekAudioData() returns
+    // the next count unread samples as one contiguous block (nullptr if not
+    // yet available) without consuming them; consumeAudioData() advances past
+    // them and returns false if an overflow invalidated the borrowed view.
+    const float* peekAudioData(size_t count);
+    bool consumeAudioData(size_t count);
+
+    // Dedicated analysis thread: callback runs once per hop with a window
+    // borrowed from the capture buffer. Only changeable while the stream is
+    // closed; the worker starts and stops with the stream. While it is set
+    // the worker is the buffer's only reader, so do not also call
+    // getAudioData() or peekAudioData().
+    void setAnalysisCallback(const AnalysisConfig& config, AnalysisCallback callback);
+    void clearAnalysisCallback();
+    uint64_t getProcessedHops() const;
+    uint64_t getMissedHops() const;
+
+    // Per-stage latency of the live path. Capture and queue times are
+    // recorded here; the analysis callback carries AnalysisFrame::latency on
+    // to recordDetection() and recordSend(). Logged when the stream stops.
+    LatencyMonitor& getLatencyMonitor() { return latencyMonitor_; }
+    const LatencyMonitor& getLatencyMonitor() const { return latencyMonitor_; }
+
+    // Ring buffer overflow handling (only changeable while the stream is closed)
+    void setOverflowPolicy(OverflowPolicy policy);
+    OverflowPolicy getOverflowPolicy() const { return audioBuffer_.overflowPolicy(); }
+    uint64_t getDroppedSampleCount() const { return audioBuffer_.overflowCount(); }
+
 private:
-    static int paCallback(const void* inputBuffer, void* outputBuffer,
-                         unsigned long framesPerBuffer,
-                         const PaStreamCallbackTimeInfo* timeInfo,
-                         PaStreamCallbackFlags statusFlags,
-                         void* userData);
-
-    // Added: Device monitoring implementation
-    void checkDeviceChanges();
-    std::vector<AudioDevice> lastKnownDevices_;
+    // One per source slot, so blocks say which source they came from; two
+    // sources only run at once during a switch
+    class SourceSink : public AudioSink {
+    public:
+        SourceSink(AudioCapture& capture, unsigned slot) : capture_(capture), slot_(slot) {}
+        SinkStatus processBlock(const float* input, size_t frames,
+                                const AudioBlockInfo& info) override {
+            return capture_.processBlock(slot_, input, frames, info);
+        }
+        bool hasRoomFor(size_t frames) const override {
+            return capture_.hasRoomFor(slot_, frames);
+        }
+
+    private:
+        AudioCapture& capture_;
+        const unsigned slot_;
+    };
+
+    // Handover between the slots: Waiting for the new source's first block,
+    // Ready for the old source to hand over, HandedOver until the new
+    // source writes its first block, then Complete
+    enum class SwitchPhase { Idle, Waiting, Ready, HandedOver, Complete };
+    static constexpr unsigned kNoSlot = 2;
+
+    // Called on the source's thread
+    SinkStatus processBlock(unsigned slot, const float* input, size_t framesPerBuffer,
+                            const AudioBlockInfo& info);
+    bool hasRoomFor(unsigned slot, size_t frames) const;
+    bool waitForSwitchPhase(SwitchPhase phase, std::chrono::milliseconds timeout);
+
+    // Added: Device monitoring implementation, on the monitor thread
+    void onDeviceListChanged(const std::vector<AudioDevice>& devices);
+    std::vector<AudioDevice> scanDevices();  // The registry's scanner
+    void setStreamOpen(bool open);
+    DeviceRegistry deviceRegistry_;
     DeviceListCallback deviceChangeCallback_;
+    mutable std::mutex currentDeviceMutex_;  // Guards currentDeviceId_ against the monitor
+    std::string currentDeviceId_;
+    std::atomic<bool> currentDeviceLost_{false};
     
-    PaStream* stream_;
+    std::unique_ptr<AudioSource> source_;  // Set while a stream is open
+    std::unique_ptr<AudioSource> incomingSource_;  // During a switch
+    std::array<SourceSink, 2> sinks_{{SourceSink(*this, 0), SourceSink(*this, 1)}};
+    std::atomic<unsigned> activeSlot_{0};         // The slot allowed to write the ring
+    std::atomic<unsigned> incomingSlot_{kNoSlot};
+    std::atomic<SwitchPhase> switchPhase_{SwitchPhase::Idle};
+    std::atomic<uint64_t> switchOverlapFrames_{0};
+    std::atomic<int64_t> lastBlockEndNs_{0};      // ADC time just past the last block written
+    std::atomic<int64_t> switchGapNs_{0};         // From there to the new source's first block
+    Semaphore switchSignal_;                      // Posted by the audio threads on handover steps
+    DeviceSwitchStats switchStats_;               // Guarded by stateMutex_
+    double streamSampleRate_ = 0.0;
+    unsigned streamChannels_ = 1;
+    unsigned channelCount_ = 1;                   // For devices started or switched to
+    AudioSink* channelSink_ = nullptr;
+    std::vector<float> firstChannel_;             // Channel 0 of a multi-channel block
+    unsigned int framesPerBuffer_ = 256;          // For devices switched to
     PaDeviceIndex currentDevice_;
-    std::function<void(const float*, unsigned long)> userCallback_;
-    bool isInitialized_;
+    CaptureCallback userCallback_;
+
+    // Serialises re-initialising PortAudio against streams being opened
+    // and other PortAudio calls made outside the registry
+    mutable std::mutex portAudioMutex_;
+    bool isInitialized_;           // Guarded by portAudioMutex_ once monitoring
+    bool streamOpen_ = false;      // From start() until the source is gone
+    bool portAudioFresh_ = false;  // Initialised since the last scan
     AudioDevice currentDeviceInfo_;  // Added: Cache current device info
-    std::unique_ptr<StreamStats> streamStats_;  // Add stream statistics member
-    RingBuffer<float> audioBuffer_;
+    StreamStats streamStats_;  // Written by the audio thread, snapshots from anywhere
+    MirroredRingBuffer<float> audioBuffer_;
+    CaptureDiagnostics diagnostics_;  // Callback events, logged off the audio thread
+    LatencyMonitor latencyMonitor_;   // Stamped by the callback and the analysis worker
+    std::unique_ptr<AnalysisWorker> analysisWorker_;  // Reads audioBuffer_, declared after it
 
     // Enhanced stream management
-    bool waitForState(StreamState expectedState, 
-                     std::chrono::milliseconds timeout = kShutdownTimeout) const;
     void setState(StreamState newState);
+    void setError(const std::string& message, StreamState newState = StreamState::Error);
     bool shutdownStream();  // Returns true if shutdown was successful
+    void stopWorkers();     // Analysis and diagnostics threads, once the stream is closed
+    void logLatencyReport() const;
     
     std::atomic<StreamState> streamState_{StreamState::Closed};
-    std::string lastError_;
+    mutable std::mutex stateMutex_;  // Taken by setState() so waiters cannot miss a change
+    mutable std::condition_variable stateChanged_;
+    std::string lastError_;  // Guarded by stateMutex_
     std::atomic<bool> shutdownRequested_{false};
-}; 
\ No newline at end of file
+};
+
+} // namespace ptm
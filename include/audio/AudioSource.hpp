@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace ptm {
+
+class AudioCaptureException : public std::runtime_error {
+public:
+    explicit AudioCaptureException(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+// Timing of one block on the source's clock, in seconds, as PortAudio
+// reports it: when the first frame was digitised and when it was delivered
+struct AudioBlockInfo {
+    double adcTime = 0.0;       // 0 if the source cannot tell
+    int64_t adcNs = 0;          // adcTime on LatencyMonitor's steady clock; 0 if unknown
+    double currentTime = 0.0;
+    unsigned long statusFlags = 0;  // PaStreamCallbackFlags bits; replay sources leave them clear
+    unsigned channels = 1;      // Samples per frame, interleaved
+};
+
+// What the sink wants the source to do after a block
+enum class SinkStatus {
+    Continue,
+    Complete,  // Stop after this block
+    Abort      // Stop now; something went wrong
+};
+
+/**
+ * Receives blocks from an AudioSource, on the source's own thread. For a
+ * device that is the driver's real-time callback, so processBlock() must
+ * not block, allocate or log.
+ */
+class AudioSink {
+public:
+    virtual ~AudioSink() = default;
+
+    // frames * info.channels interleaved samples; null if the device
+    // delivered no input
+    virtual SinkStatus processBlock(const float* samples, size_t frames,
+                                    const AudioBlockInfo& info) = 0;
+
+    // Unpaced sources wait until this is true before the next block, so a
+    // slow consumer throttles them instead of losing audio
+    virtual bool hasRoomFor(size_t frames) const { (void)frames; return true; }
+};
+
+/**
+ * A float stream that pushes fixed-size blocks into an AudioSink: an input
+ * device, or a file or generator replayed on a simulated clock. Mono unless
+ * channels() says otherwise, in which case frames are interleaved.
+ */
+class AudioSource {
+public:
+    virtual ~AudioSource() = default;
+
+    virtual double sampleRate() const = 0;
+    virtual unsigned channels() const { return 1; }
+
+    // Begins delivering blocks to sink, which must outlive the stream
+    // @throws AudioCaptureException if the stream cannot start
+    virtual void start(AudioSink& sink) = 0;
+
+    // Stops delivering and waits for the last block to finish
+    // @throws AudioCaptureException if the stream does not stop cleanly
+    virtual void stop() = 0;
+
+    // Stops without waiting for pending blocks; never throws
+    virtual void abort() { try { stop(); } catch (...) {} }
+
+    // False once stopped, or when a finite source has run out
+    virtual bool isActive() const = 0;
+
+    // One line for the log, e.g. rate and block size
+    virtual std::string describe() const = 0;
+};
+
+} // namespace ptm
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "audio/RingBuffer.hpp"
+
+namespace ptm {
+
+// Conditions the audio callback reports instead of logging them itself
+enum class CaptureEventKind : uint8_t {
+    HighLatency,     // value: capture latency in seconds
+    InputUnderflow,  // counter: underruns so far
+    InputOverflow,   // counter: overruns so far
+    RingOverflow,    // counter: overruns so far, value: samples dropped
+    SlowCallback,    // value: callback duration in seconds
+    StatusFlags,     // value: other PaStreamCallbackFlags bits
+    NullInput,
+    Count
+};
+
+const char* toString(CaptureEventKind kind);
+
+// Fixed-size record passed from the audio thread to the logging thread
+struct CaptureEvent {
+    CaptureEventKind kind;
+    uint32_t counter;    // Running count for counted kinds, 0 otherwise
+    double value;        // Kind-specific payload, see CaptureEventKind
+    double adcTime;      // inputBufferAdcTime of the block that raised it
+    double currentTime;  // Stream time when the callback ran
+};
+
+// Called on the draining thread with every event taken from the queue
+using CaptureEventHandler = std::function<void(const CaptureEvent&)>;
+
+/**
+ * Real-time-safe diagnostics channel out of the audio callback.
+ *
+ * post() only copies a CaptureEvent into a preallocated lock-free queue,
+ * so it never blocks, locks or allocates. A background thread drains the
+ * queue into spdlog, limits each event kind to a number of lines per
+ * second and reports how many events were suppressed or lost because the
+ * queue was full. An event handler sees every event, rate-limited or not,
+ * so the owner can act on one (e.g. fail the stream) off the audio thread.
+ */
+class CaptureDiagnostics {
+public:
+    static constexpr size_t kDefaultQueueSize = 256;
+    static constexpr uint32_t kDefaultEventsPerSecond = 10;
+    static constexpr std::chrono::milliseconds kDefaultDrainInterval{50};
+
+    explicit CaptureDiagnostics(size_t queueSize = kDefaultQueueSize,
+                                uint32_t maxEventsPerSecond = kDefaultEventsPerSecond);
+    ~CaptureDiagnostics();
+
+    CaptureDiagnostics(const CaptureDiagnostics&) = delete;
+    CaptureDiagnostics& operator=(const CaptureDiagnostics&) = delete;
+
+    // Audio thread. Returns false if the queue was full and the event dropped.
+    bool post(const CaptureEvent& event) noexcept {
+        return events_.write(&event, 1) == 1;
+    }
+
+    // While stopped
+    void setEventHandler(CaptureEventHandler handler);
+
+    // Start/stop the drain thread; stop() logs whatever is still queued
+    void start(std::chrono::milliseconds drainInterval = kDefaultDrainInterval);
+    void stop();
+
+    // Drain the queue on the calling thread. Returns number of events taken.
+    size_t drain();
+
+    uint64_t droppedEvents() const { return events_.overflowCount(); }
+    uint64_t suppressedEvents() const { return suppressedTotal_.load(std::memory_order_relaxed); }
+
+private:
+    void drainLoop(std::chrono::milliseconds drainInterval);
+    void log(const CaptureEvent& event);
+    void flushRateLimitWindow(std::chrono::steady_clock::time_point now);
+
+    static constexpr size_t kKindCount = static_cast<size_t>(CaptureEventKind::Count);
+
+    RingBuffer<CaptureEvent> events_;
+    const uint32_t maxEventsPerSecond_;
+    CaptureEventHandler handler_;
+
+    // Drain-side state, touched by one draining thread at a time
+    std::mutex drainMutex_;
+    std::chrono::steady_clock::time_point windowStart_;
+    std::array<uint32_t, kKindCount> loggedInWindow_{};
+    std::array<uint32_t, kKindCount> suppressedInWindow_{};
+    uint64_t reportedDrops_ = 0;
+    std::atomic<uint64_t> suppressedTotal_{0};
+
+    std::thread thread_;
+    std::mutex stopMutex_;
+    std::condition_variable stopCondition_;
+    bool stopRequested_ = false;
+};
+
+} // namespace ptm
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <portaudio.h>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ptm {
+
+struct AudioDevice {
+    PaDeviceIndex index;
+    std::string id;                // Host API, name and ordinal; survives re-enumeration
+    std::string name;
+    std::string hostApi;           // Added: Host API name
+    double defaultSampleRate;
+    std::set<double> sampleRates;  // Added: Supported sample rates
+    int maxInputChannels;
+    double defaultLatency;
+    double minLatency;
+    bool isDefaultInput;           // Added: Is this the default input device?
+
+    // Added: Helper method to check sample rate support
+    bool supportsSampleRate(double rate) const {
+        // If no specific rates are listed, assume default rate only
+        if (sampleRates.empty()) {
+            return rate == defaultSampleRate;
+        }
+        return sampleRates.find(rate) != sampleRates.end();
+    }
+};
+
+// Added: Callback type for device list changes
+using DeviceListCallback = std::function<void(const std::vector<AudioDevice>&)>;
+
+/**
+ * The input devices and what they support, probed once per device.
+ *
+ * The device list is a cheap scan (names, host APIs, defaults; no
+ * sample-rate probing) and is cached until refresh(). Sample-rate support
+ * is probed only when first asked for and cached per device identity
+ * rather than per index, so it survives the device list being re-read and
+ * indices shifting. The scanner and probe default to PortAudio and can be
+ * replaced, e.g. for tests.
+ *
+ * startMonitoring() rescans on a background thread and calls back, on that
+ * thread, only when the list changed; nothing there touches the audio
+ * thread, and readers on other threads only wait for a short copy. Note
+ * that PortAudio re-reads the system's devices only in Pa_Initialize(), so
+ * the default scanner sees no hot-plug; AudioCapture supplies one that
+ * re-initialises PortAudio while no stream is open.
+ */
+class DeviceRegistry {
+public:
+    // Sample rates probed by supportedSampleRates()
+    static constexpr std::array<double, 9> kCommonSampleRates = {
+        8000.0, 11025.0, 16000.0, 22050.0, 32000.0, 44100.0, 48000.0, 88200.0, 96000.0
+    };
+    static constexpr std::chrono::milliseconds kDefaultMonitorInterval{1000};
+
+    // Lists input devices; id and sampleRates are filled in by the registry
+    using Scanner = std::function<std::vector<AudioDevice>()>;
+    using RateProbe = std::function<bool(const AudioDevice& device, double sampleRate)>;
+
+    // PortAudio, which must be initialised before the first query
+    DeviceRegistry();
+    DeviceRegistry(Scanner scanner, RateProbe probe);
+    ~DeviceRegistry();
+
+    DeviceRegistry(const DeviceRegistry&) = delete;
+    DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+    // Rescans the device list; returns true if it changed since the last scan
+    bool refresh();
+
+    // The cached list, scanned on first use. sampleRates are left empty:
+    // ask supportedSampleRates() for the devices you care about.
+    std::vector<AudioDevice> devices();
+    std::optional<AudioDevice> find(PaDeviceIndex index);
+    std::optional<AudioDevice> find(const std::string& id);
+
+    // Probed on first query, then answered from the cache
+    bool supportsSampleRate(const AudioDevice& device, double sampleRate);
+    std::set<double> supportedSampleRates(const AudioDevice& device);
+
+    // Rescans every interval on a background thread; callback runs there
+    void startMonitoring(DeviceListCallback callback,
+                         std::chrono::milliseconds interval = kDefaultMonitorInterval);
+    void stopMonitoring();
+    bool isMonitoring() const { return monitorThread_.joinable(); }
+
+    // Format support queries made so far
+    uint64_t probeCount() const;
+
+    // The PortAudio backend
+    static std::vector<AudioDevice> scanPortAudioDevices();
+    static bool probePortAudioRate(const AudioDevice& device, double sampleRate);
+
+private:
+    static void assignIds(std::vector<AudioDevice>& devices);
+    static bool sameDevices(const std::vector<AudioDevice>& a, const std::vector<AudioDevice>& b);
+    void monitorLoop(DeviceListCallback callback, std::chrono::milliseconds interval);
+
+    const Scanner scanner_;
+    const RateProbe probe_;
+
+    // Serialises calls into the backend, which need not be thread-safe
+    std::mutex backendMutex_;
+
+    // Guards the cache; never held while scanning or probing
+    mutable std::mutex mutex_;
+    std::vector<AudioDevice> devices_;
+    bool scanned_ = false;
+    std::unordered_map<std::string, std::map<double, bool>> rateCache_;  // By device id
+    uint64_t probes_ = 0;
+
+    std::thread monitorThread_;
+    std::mutex stopMutex_;
+    std::condition_variable stopCondition_;
+    bool stopRequested_ = false;
+};
+
+} // namespace ptm
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "audio/RingBuffer.hpp"
+#include "utils/LatencyHistogram.hpp"
+
+namespace ptm {
+
+// Legs of the path from the microphone to a MIDI message
+enum class LatencyStage {
+    Capture,    // ADC -> written to the capture ring (driver, buffering, callback)
+    Queue,      // Ring write -> read by the analysis thread (hop fill, wake-up)
+    Detection,  // Ring read -> pitch and note decision made
+    Output,     // Decision -> MIDI message sent
+    Total       // ADC -> MIDI message sent
+};
+
+constexpr size_t kLatencyStageCount = 5;
+
+inline const char* toString(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::Capture:   return "capture";
+        case LatencyStage::Queue:     return "queue";
+        case LatencyStage::Detection: return "detection";
+        case LatencyStage::Output:    return "output";
+        case LatencyStage::Total:     return "total";
+    }
+    return "unknown";
+}
+
+// Steady-clock times, in nanoseconds, of one analysis window on its way
+// through the pipeline. adcNs is the ADC time of the window's newest
+// sample; zero means the window could not be matched to a capture buffer.
+struct LatencyStamp {
+    int64_t adcNs = 0;
+    int64_t writeNs = 0;
+    int64_t readNs = 0;
+    int64_t detectNs = 0;
+
+    bool valid() const { return adcNs != 0; }
+};
+
+/**
+ * Per-stage latency histograms for the live path, against the 20 ms
+ * capture-to-MIDI budget.
+ *
+ * The audio callback reports each buffer with its ADC time (converted from
+ * the PortAudio stream clock to the steady clock) and the time it was
+ * written to the ring. Those stamps travel to the analysis thread through a
+ * small lock-free queue, keyed by stream position, so when the analysis
+ * thread borrows a window it can recover when its newest sample was
+ * digitised and written. Whoever detects the pitch then calls
+ * recordDetection(), and whoever sends the resulting MIDI message calls
+ * recordSend() with the same stamp.
+ *
+ * Every call records into lock-free histograms, so p50/p99/max per stage
+ * can be read at any time from any thread.
+ */
+class LatencyMonitor {
+public:
+    static constexpr int64_t kBudgetNs = 20'000'000;
+
+    // Steady-clock now, in nanoseconds
+    static int64_t now();
+
+    explicit LatencyMonitor(size_t maxPendingBuffers = 256);
+
+    LatencyMonitor(const LatencyMonitor&) = delete;
+    LatencyMonitor& operator=(const LatencyMonitor&) = delete;
+
+    // Before the stream starts: forget pending buffers from a previous run
+    void beginStream(double sampleRate);
+
+    // Audio thread, once per buffer: frames were written to the ring ending
+    // at stream position endPosition; adcNs is the ADC time of the first
+    // of them
+    void recordBuffer(uint64_t endPosition, size_t frames, int64_t adcNs, int64_t writeNs);
+
+    // Analysis thread: a window ending at stream position endPosition was
+    // just borrowed from the ring
+    LatencyStamp recordRead(uint64_t endPosition);
+
+    // Detection thread: sets stamp.detectNs to now
+    void recordDetection(LatencyStamp& stamp);
+
+    // Output thread: the message decided at stamp.detectNs went out now
+    void recordSend(const LatencyStamp& stamp);
+
+    const LatencyHistogram& histogram(LatencyStage stage) const {
+        return histograms_[static_cast<size_t>(stage)];
+    }
+    LatencyHistogram::Summary summary(LatencyStage stage) const {
+        return histogram(stage).summary();
+    }
+
+    // One line per stage that has samples, in milliseconds
+    std::string report() const;
+
+    // Only while no stream is running
+    void reset();
+
+private:
+    struct BufferStamp {
+        uint64_t endPosition;
+        uint64_t frames;
+        int64_t adcNs;
+        int64_t writeNs;
+    };
+
+    void record(LatencyStage stage, int64_t nanoseconds) {
+        histograms_[static_cast<size_t>(stage)].record(nanoseconds);
+    }
+
+    double nsPerSample_ = 0.0;
+    RingBuffer<BufferStamp> pending_;  // Audio thread -> analysis thread
+    BufferStamp current_{};            // Analysis thread
+    std::array<LatencyHistogram, kLatencyStageCount> histograms_;
+};
+
+} // namespace ptm
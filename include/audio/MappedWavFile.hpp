@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace ptm {
+
+class WavFileException : public std::runtime_error {
+public:
+    explicit WavFileException(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+enum class WavSampleFormat {
+    Int8,     // Unsigned, offset by 128
+    Int16,
+    Int24,
+    Int32,
+    Float32,
+    Float64
+};
+
+/**
+ * Read-only WAV file mapped into memory.
+ *
+ * The file is never loaded as a whole: frames are decoded straight from the
+ * mapping on demand, and release() lets a reader hand pages it has finished
+ * with back to the OS, so multi-gigabyte takes can be processed with a
+ * small, constant working set. RIFF and RF64 (for data
+ * larger than 4 GB) containers are understood, with PCM, IEEE float and
+ * WAVE_FORMAT_EXTENSIBLE payloads. A data chunk longer than the file, as
+ * left behind by an interrupted recording, is truncated to what is there.
+ */
+class MappedWavFile {
+public:
+    /**
+     * @throws WavFileException if the file cannot be opened or is not a
+     *         supported WAV file
+     */
+    explicit MappedWavFile(const std::string& path);
+    ~MappedWavFile();
+
+    MappedWavFile(const MappedWavFile&) = delete;
+    MappedWavFile& operator=(const MappedWavFile&) = delete;
+
+    double sampleRate() const { return sampleRate_; }
+    unsigned channels() const { return channels_; }
+    WavSampleFormat sampleFormat() const { return format_; }
+    uint64_t frames() const { return frames_; }
+    double durationSeconds() const { return static_cast<double>(frames_) / sampleRate_; }
+
+    /**
+     * Decode frames to mono float, averaging the channels. Safe to call
+     * from several threads at once.
+     * @return Frames written to out; fewer than count at the end of the file
+     */
+    size_t readFrames(uint64_t firstFrame, size_t count, float* out) const;
+
+    // Hint that frames in [beginFrame, endFrame) will not be read again
+    // soon; reading them later is still valid. Safe to call concurrently.
+    void release(uint64_t beginFrame, uint64_t endFrame) const;
+
+private:
+    void parse();
+    void unmap();
+
+    const unsigned char* data_ = nullptr;  // Whole-file mapping
+    uint64_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+
+    const unsigned char* samples_ = nullptr;  // Start of the data chunk
+    double sampleRate_ = 0.0;
+    unsigned channels_ = 0;
+    unsigned bytesPerSample_ = 0;
+    size_t frameBytes_ = 0;
+    WavSampleFormat format_ = WavSampleFormat::Int16;
+    uint64_t frames_ = 0;
+};
+
+} // namespace ptm
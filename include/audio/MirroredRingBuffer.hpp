@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include "audio/RingBuffer.hpp"
+
+namespace ptm {
+
+/**
+ * A block of memory mapped twice back to back, so that the byte at
+ * data()[i] is also visible at data()[i + size()].
+ *
+ * On POSIX systems the same shared-memory pages (memfd on Linux, an
+ * unlinked shm object elsewhere) are mapped into two adjacent halves of a
+ * single reservation. Where that is not possible the second half is
+ * ordinary memory that the owner has to keep in sync; isHardwareMirrored()
+ * tells the two cases apart.
+ */
+class MirroredMemory {
+public:
+    /**
+     * @param minBytes Lower bound for size(), rounded up to the page size
+     * @throws std::system_error if the memory cannot be allocated
+     */
+    explicit MirroredMemory(size_t minBytes);
+    ~MirroredMemory();
+
+    MirroredMemory(const MirroredMemory&) = delete;
+    MirroredMemory& operator=(const MirroredMemory&) = delete;
+
+    void* data() const { return base_; }
+    size_t size() const { return size_; }
+    bool isHardwareMirrored() const { return hardwareMirrored_; }
+
+    // Granularity that size() is rounded up to
+    static size_t pageSize();
+
+private:
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    bool hardwareMirrored_ = false;
+};
+
+// Ring storage backed by MirroredMemory: any run of up to capacity()
+// elements starting anywhere in the ring is contiguous in memory
+template<typename T>
+class MirroredRingStorage {
+    static_assert((sizeof(T) & (sizeof(T) - 1)) == 0,
+                  "Element size must be a power of two to tile whole pages");
+
+public:
+    static constexpr bool kContiguousViews = true;
+
+    explicit MirroredRingStorage(size_t capacity)
+        : memory_(std::max(roundUpToPowerOfTwo(capacity) * sizeof(T), MirroredMemory::pageSize()))
+        , data_(static_cast<T*>(memory_.data()))
+        , capacity_(memory_.size() / sizeof(T)) {}
+
+    size_t capacity() const { return capacity_; }
+
+    void copyIn(size_t pos, const T* data, size_t count) {
+        std::memcpy(data_ + pos, data, count * sizeof(T));
+        if (!memory_.isHardwareMirrored()) {
+            syncMirror(pos, count);
+        }
+    }
+
+    void copyOut(size_t pos, T* data, size_t count) const {
+        std::memcpy(data, data_ + pos, count * sizeof(T));
+    }
+
+    const T* view(size_t pos) const { return data_ + pos; }
+
+private:
+    // Software fallback: keep element i and i + capacity_ identical
+    void syncMirror(size_t pos, size_t count) {
+        const size_t end = pos + count;
+        if (end <= capacity_) {
+            std::memcpy(data_ + pos + capacity_, data_ + pos, count * sizeof(T));
+        } else {
+            std::memcpy(data_ + pos + capacity_, data_ + pos, (capacity_ - pos) * sizeof(T));
+            std::memcpy(data_, data_ + capacity_, (end - capacity_) * sizeof(T));
+        }
+    }
+
+    MirroredMemory memory_;
+    T* data_;
+    size_t capacity_;
+};
+
+// Same API as RingBuffer, plus peek()/consume()/latest() views that never copy
+template<typename T>
+using MirroredRingBuffer = RingBuffer<T, MirroredRingStorage<T>>;
+
+} // namespace ptm
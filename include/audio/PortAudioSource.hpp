@@ -0,0 +1,48 @@
+#pragma once
+
+#include <portaudio.h>
+#include <string>
+#include "audio/AudioSource.hpp"
+
+namespace ptm {
+
+/**
+ * Float input from a PortAudio device, mono or interleaved channels. The stream is opened by
+ * start() and closed by stop(); blocks arrive on the driver's callback
+ * thread with the driver's ADC and callback times. Pa_Initialize() must
+ * already have been called.
+ */
+class PortAudioSource : public AudioSource {
+public:
+    PortAudioSource(PaDeviceIndex device, double sampleRate, unsigned long framesPerBuffer,
+                    double suggestedLatency, unsigned channels = 1);
+    ~PortAudioSource() override;
+
+    PortAudioSource(const PortAudioSource&) = delete;
+    PortAudioSource& operator=(const PortAudioSource&) = delete;
+
+    double sampleRate() const override { return sampleRate_; }
+    unsigned channels() const override { return channels_; }
+    void start(AudioSink& sink) override;
+    void stop() override;
+    void abort() override;
+    bool isActive() const override;
+    std::string describe() const override;
+
+private:
+    static int paCallback(const void* inputBuffer, void* outputBuffer,
+                          unsigned long framesPerBuffer,
+                          const PaStreamCallbackTimeInfo* timeInfo,
+                          PaStreamCallbackFlags statusFlags,
+                          void* userData);
+
+    PaDeviceIndex device_;
+    double sampleRate_;
+    unsigned long framesPerBuffer_;
+    double suggestedLatency_;
+    unsigned channels_;
+    PaStream* stream_ = nullptr;
+    AudioSink* sink_ = nullptr;
+};
+
+} // namespace ptm
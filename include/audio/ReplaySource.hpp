@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "audio/AudioSource.hpp"
+#include "audio/MappedWavFile.hpp"
+
+namespace ptm {
+
+struct ReplayConfig {
+    size_t framesPerBuffer = 256;
+
+    // Playback speed relative to real time. 0 runs as fast as the sink
+    // accepts blocks: the source waits whenever hasRoomFor() is false, so
+    // nothing is dropped however far ahead of real time it gets.
+    double speed = 1.0;
+
+    bool loop = false;  // Start over at the end instead of finishing
+
+    unsigned channels = 1;  // Interleaved samples per frame
+};
+
+/**
+ * Base for sources that play a signal from memory on their own thread, with
+ * no audio hardware.
+ *
+ * Blocks are stamped from a simulated clock that starts at zero and
+ * advances by framesPerBuffer / sampleRate per block: a block's ADC time is
+ * the time of its first frame and it is delivered at the time of its last,
+ * as a device would. At speed 1 the thread sleeps until that time on the
+ * steady clock; at speed 10 it runs ten times faster; at speed 0 it only
+ * waits for the sink. Latency stamps downstream stay consistent either way.
+ *
+ * Derived classes must call stop() in their destructor, before the signal
+ * render() reads from goes away.
+ */
+class ReplaySource : public AudioSource {
+public:
+    ~ReplaySource() override;
+
+    ReplaySource(const ReplaySource&) = delete;
+    ReplaySource& operator=(const ReplaySource&) = delete;
+
+    double sampleRate() const override { return sampleRate_; }
+    unsigned channels() const override { return config_.channels; }
+    void start(AudioSink& sink) override;
+    void stop() override;
+    bool isActive() const override { return running_.load(std::memory_order_acquire); }
+    std::string describe() const override;
+
+    const ReplayConfig& config() const { return config_; }
+
+    // Frames delivered since start(), across loops
+    uint64_t framesDelivered() const { return framesDelivered_.load(std::memory_order_relaxed); }
+
+protected:
+    /**
+     * @throws std::invalid_argument for a zero block size or channel
+     *         count, a negative speed or a non-positive sample rate
+     */
+    ReplaySource(double sampleRate, const ReplayConfig& config);
+
+    // Write up to frames frames of the signal from frame position on,
+    // interleaved; return how many were written, fewer only at the end of
+    // the signal
+    virtual size_t render(uint64_t position, float* out, size_t frames) = 0;
+
+    // For describe(), e.g. the file name
+    virtual std::string name() const = 0;
+
+private:
+    void run(AudioSink& sink);
+
+    const double sampleRate_;
+    const ReplayConfig config_;
+
+    std::thread thread_;
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> framesDelivered_{0};
+};
+
+// Replays a WAV file, averaged to mono
+class WavFileSource final : public ReplaySource {
+public:
+    /**
+     * @throws WavFileException if the file cannot be read, and
+     *         std::invalid_argument unless config.channels is 1
+     */
+    explicit WavFileSource(const std::string& path, const ReplayConfig& config = ReplayConfig{});
+    ~WavFileSource() override;
+
+    const MappedWavFile& file() const { return *file_; }
+
+protected:
+    size_t render(uint64_t position, float* out, size_t frames) override;
+    std::string name() const override { return path_; }
+
+private:
+    WavFileSource(std::unique_ptr<MappedWavFile> file, const std::string& path,
+                  const ReplayConfig& config);
+
+    std::string path_;
+    std::unique_ptr<MappedWavFile> file_;
+};
+
+// Fills frames frames (interleaved, if the source has more than one channel)
+// of an endless signal, starting position frames in
+using SignalGenerator = std::function<void(uint64_t position, float* out, size_t frames)>;
+
+// Replays samples from memory (see dsp/SyntheticSignal.hpp), interleaved if
+// there is more than one channel, or a generator
+class SyntheticSource final : public ReplaySource {
+public:
+    SyntheticSource(double sampleRate, std::vector<float> samples,
+                    const ReplayConfig& config = ReplayConfig{});
+
+    // Never finishes on its own
+    SyntheticSource(double sampleRate, SignalGenerator generator,
+                    const ReplayConfig& config = ReplayConfig{});
+    ~SyntheticSource() override;
+
+protected:
+    size_t render(uint64_t position, float* out, size_t frames) override;
+    std::string name() const override;
+
+private:
+    std::vector<float> samples_;
+    SignalGenerator generator_;
+};
+
+} // namespace ptm
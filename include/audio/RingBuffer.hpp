@@ -1,70 +1,202 @@
 #pragma once
 
-#include <vector>
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <type_traits>
+#include <vector>
 
 namespace ptm {
 
+// Keeps producer-owned and consumer-owned state on separate cache lines
+constexpr size_t kCacheLineSize = 64;
+
+// What the producer does when a block does not fit into the free space
+enum class OverflowPolicy {
+    DropNewest,  // Keep unread data, truncate the incoming block
+    DropOldest,  // Advance the reader just far enough to fit the incoming block
+    Overwrite    // Never wait for the reader; it detects being lapped and skips ahead
+};
+
+inline const char* toString(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::DropNewest: return "drop-newest";
+        case OverflowPolicy::DropOldest: return "drop-oldest";
+        case OverflowPolicy::Overwrite:  return "overwrite";
+    }
+    return "unknown";
+}
+
+inline size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Plain heap storage: blocks that cross the end of the buffer are split
 template<typename T>
+class HeapRingStorage {
+public:
+    static constexpr bool kContiguousViews = false;
+
+    explicit HeapRingStorage(size_t capacity) : buffer_(roundUpToPowerOfTwo(capacity)) {}
+
+    size_t capacity() const { return buffer_.size(); }
+
+    void copyIn(size_t pos, const T* data, size_t count) {
+        const size_t firstPart = std::min(count, buffer_.size() - pos);
+
+        // Write first part
+        std::memcpy(&buffer_[pos], data, firstPart * sizeof(T));
+
+        // Write second part if wrapping around
+        if (firstPart < count) {
+            std::memcpy(&buffer_[0], data + firstPart, (count - firstPart) * sizeof(T));
+        }
+    }
+
+    void copyOut(size_t pos, T* data, size_t count) const {
+        const size_t firstPart = std::min(count, buffer_.size() - pos);
+
+        // Read first part
+        std::memcpy(data, &buffer_[pos], firstPart * sizeof(T));
+
+        // Read second part if wrapping around
+        if (firstPart < count) {
+            std::memcpy(data + firstPart, &buffer_[0], (count - firstPart) * sizeof(T));
+        }
+    }
+
+private:
+    std::vector<T> buffer_;
+};
+
+// Single-producer single-consumer ring buffer.
+//
+// Indices increase monotonically and are masked into the storage, so the
+// capacity is always rounded up to a power of two. Each side keeps a cached
+// copy of the other side's index and only reloads it when the cached value
+// says the buffer is full (producer) or empty (consumer).
+//
+// write() must only be called from one thread and read() from one other
+// thread. clear(), available() and free() are safe from any thread.
+//
+// Storage decides how elements are laid out; see MirroredRingBuffer.hpp for
+// a storage that also hands out contiguous views without copying.
+template<typename T, typename Storage = HeapRingStorage<T>>
 class RingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "RingBuffer copies elements with memcpy");
+
 public:
-    explicit RingBuffer(size_t capacity) 
-        : buffer_(capacity)
-        , capacity_(capacity)
-        , writeIndex_(0)
-        , readIndex_(0) {}
+    explicit RingBuffer(size_t capacity,
+                        OverflowPolicy policy = OverflowPolicy::DropNewest)
+        : storage_(std::max<size_t>(capacity, 1))
+        , capacity_(storage_.capacity())
+        , mask_(capacity_ - 1)
+        , policy_(policy) {}
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
 
     // Write data to the ring buffer
-    // Returns number of elements actually written
+    // Returns number of elements actually stored; anything else was dropped
+    // according to the overflow policy and is added to overflowCount()
     size_t write(const T* data, size_t count) {
-        size_t available = capacity_ - (writeIndex_ - readIndex_.load(std::memory_order_acquire));
-        size_t toWrite = std::min(count, available);
-        
-        if (toWrite == 0) return 0;
+        if (count == 0) return 0;
 
-        size_t writePos = writeIndex_ % capacity_;
-        size_t firstPart = std::min(toWrite, capacity_ - writePos);
-        
-        // Write first part
-        std::memcpy(&buffer_[writePos], data, firstPart * sizeof(T));
-        
-        // Write second part if wrapping around
-        if (firstPart < toWrite) {
-            std::memcpy(&buffer_[0], data + firstPart, (toWrite - firstPart) * sizeof(T));
+        const OverflowPolicy policy = policy_.load(std::memory_order_relaxed);
+        const size_t writeIndex = writeIndex_.load(std::memory_order_relaxed);
+        size_t dropped = 0;
+
+        // Only the newest capacity_ elements of an oversized block can survive
+        if (count > capacity_ && policy != OverflowPolicy::DropNewest) {
+            dropped += count - capacity_;
+            data += count - capacity_;
+            count = capacity_;
         }
-        
-        writeIndex_ += toWrite;
+
+        size_t toWrite = count;
+        if (policy == OverflowPolicy::DropNewest) {
+            size_t freeSpace = capacity_ - (writeIndex - cachedReadIndex_);
+            if (freeSpace < count) {
+                cachedReadIndex_ = readIndex_.load(std::memory_order_acquire);
+                freeSpace = capacity_ - (writeIndex - cachedReadIndex_);
+            }
+            toWrite = std::min(count, freeSpace);
+            dropped += count - toWrite;
+        } else if (policy == OverflowPolicy::DropOldest) {
+            if (capacity_ - (writeIndex - cachedReadIndex_) < count) {
+                dropped += discardOldest(writeIndex, count);
+            }
+        } else {
+            // Publish the slots about to be overwritten before touching them
+            // so a reader that copied them can tell its copy is torn
+            writeClaim_.store(writeIndex + count, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        if (dropped > 0) {
+            overflowCount_.fetch_add(dropped, std::memory_order_relaxed);
+        }
+        if (toWrite == 0) return 0;
+
+        storage_.copyIn(writeIndex & mask_, data, toWrite);
+        writeIndex_.store(writeIndex + toWrite, std::memory_order_release);
         return toWrite;
     }
 
     // Read data from the ring buffer
     // Returns number of elements actually read
     size_t read(T* data, size_t count) {
-        size_t available = writeIndex_.load(std::memory_order_acquire) - readIndex_;
-        size_t toRead = std::min(count, available);
-        
-        if (toRead == 0) return 0;
-
-        size_t readPos = readIndex_ % capacity_;
-        size_t firstPart = std::min(toRead, capacity_ - readPos);
-        
-        // Read first part
-        std::memcpy(data, &buffer_[readPos], firstPart * sizeof(T));
-        
-        // Read second part if wrapping around
-        if (firstPart < toRead) {
-            std::memcpy(data + firstPart, &buffer_[0], (toRead - firstPart) * sizeof(T));
+        if (count == 0) return 0;
+
+        for (;;) {
+            size_t readIndex = readIndex_.load(std::memory_order_acquire);
+            size_t readable = cachedWriteIndex_ - readIndex;
+
+            // A stale cache can trail a clear(), so it is refreshed whenever it
+            // does not cover the request
+            if (readable < count || readable > capacity_) {
+                cachedWriteIndex_ = writeIndex_.load(std::memory_order_acquire);
+                readable = cachedWriteIndex_ - readIndex;
+            }
+
+            if (readable > capacity_) {
+                // Lapped by an overwriting producer: skip to the oldest intact data
+                skipLapped(readIndex, cachedWriteIndex_ - capacity_);
+                continue;
+            }
+
+            const size_t toRead = std::min(count, readable);
+            if (toRead == 0) return 0;
+
+            storage_.copyOut(readIndex & mask_, data, toRead);
+
+            if (wasLappedDuringCopy(readIndex)) {
+                continue;
+            }
+
+            // The commit fails if clear() or a drop-oldest producer moved the
+            // read index underneath us; the copy is then discarded and redone
+            if (readIndex_.compare_exchange_strong(readIndex, readIndex + toRead,
+                                                   std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+                return toRead;
+            }
         }
-        
-        readIndex_ += toRead;
-        return toRead;
     }
 
     // Get number of elements available for reading
     size_t available() const {
-        return writeIndex_.load(std::memory_order_acquire) - 
-               readIndex_.load(std::memory_order_acquire);
+        // Load the reader first: the writer never trails a read index it has seen
+        const size_t readIndex = readIndex_.load(std::memory_order_acquire);
+        const size_t writeIndex = writeIndex_.load(std::memory_order_acquire);
+        return std::min(writeIndex - readIndex, capacity_);
     }
 
     // Get free space available for writing
@@ -72,16 +204,154 @@ public:
         return capacity_ - available();
     }
 
-    // Clear the buffer
+    // Discard everything written so far. Safe to call from any thread while
+    // the producer and consumer are running.
     void clear() {
-        readIndex_.store(0, std::memory_order_release);
-        writeIndex_.store(0, std::memory_order_release);
+        size_t readIndex = readIndex_.load(std::memory_order_acquire);
+        for (;;) {
+            const size_t writeIndex = writeIndex_.load(std::memory_order_acquire);
+            if (readIndex_.compare_exchange_weak(readIndex, writeIndex,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+                return;
+            }
+        }
+    }
+
+    // Zero-copy access, only for storages that keep the data contiguous.
+    //
+    // peek() borrows the next count unread elements without consuming them
+    // and returns nullptr if fewer are available. consume() then releases
+    // them; it returns false if clear() or an overflowing producer moved the
+    // reader in the meantime, in which case the borrowed view may be torn.
+    // Consumer thread only.
+    template<typename S = Storage, typename = std::enable_if_t<S::kContiguousViews>>
+    const T* peek(size_t count) {
+        if (count == 0 || count > capacity_) return nullptr;
+
+        const size_t readIndex = readIndex_.load(std::memory_order_acquire);
+        size_t readable = cachedWriteIndex_ - readIndex;
+        if (readable < count || readable > capacity_) {
+            cachedWriteIndex_ = writeIndex_.load(std::memory_order_acquire);
+            readable = cachedWriteIndex_ - readIndex;
+        }
+
+        if (readable > capacity_) {
+            // Lapped by an overwriting producer: skip ahead and let the caller retry
+            skipLapped(readIndex, cachedWriteIndex_ - capacity_);
+            return nullptr;
+        }
+        if (readable < count) return nullptr;
+
+        peekIndex_ = readIndex;
+        return storage_.view(readIndex & mask_);
+    }
+
+    template<typename S = Storage, typename = std::enable_if_t<S::kContiguousViews>>
+    bool consume(size_t count) {
+        size_t readIndex = peekIndex_;
+        if (wasLappedDuringCopy(readIndex)) {
+            return false;
+        }
+        if (readIndex_.compare_exchange_strong(readIndex, readIndex + count,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+            peekIndex_ += count;
+            return true;
+        }
+        return false;
+    }
+
+    // The most recently written count elements, oldest first. The view stays
+    // intact as long as the producer writes fewer than capacity() - count
+    // further elements while it is in use.
+    template<typename S = Storage, typename = std::enable_if_t<S::kContiguousViews>>
+    const T* latest(size_t count) const {
+        if (count == 0 || count > capacity_) return nullptr;
+        const size_t writeIndex = writeIndex_.load(std::memory_order_acquire);
+        if (writeIndex < count) return nullptr;
+        return storage_.view((writeIndex - count) & mask_);
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // Stream positions (elements written since construction): the end of
+    // the data written so far, for the producer, and the start of the last
+    // peek() view, for the consumer
+    size_t writePosition() const { return writeIndex_.load(std::memory_order_relaxed); }
+    size_t peekPosition() const { return peekIndex_; }
+
+    // Total number of elements lost to overflow since construction
+    uint64_t overflowCount() const {
+        return overflowCount_.load(std::memory_order_relaxed);
+    }
+
+    OverflowPolicy overflowPolicy() const {
+        return policy_.load(std::memory_order_relaxed);
+    }
+
+    // Only change the policy while no write() is in flight
+    void setOverflowPolicy(OverflowPolicy policy) {
+        policy_.store(policy, std::memory_order_relaxed);
     }
 
 private:
-    std::vector<T> buffer_;
+    // Drop-oldest: move the read index so that count more elements fit
+    size_t discardOldest(size_t writeIndex, size_t count) {
+        size_t readIndex = readIndex_.load(std::memory_order_acquire);
+        while (writeIndex + count - readIndex > capacity_) {
+            const size_t target = writeIndex + count - capacity_;
+            if (readIndex_.compare_exchange_weak(readIndex, target,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+                cachedReadIndex_ = target;
+                return target - readIndex;
+            }
+        }
+        cachedReadIndex_ = readIndex;
+        return 0;
+    }
+
+    // Overwrite: true if the producer reached the slots being read while they
+    // were copied; the reader has then been moved past the torn data
+    bool wasLappedDuringCopy(size_t readIndex) {
+        if (policy_.load(std::memory_order_relaxed) != OverflowPolicy::Overwrite) {
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const size_t claim = writeClaim_.load(std::memory_order_relaxed);
+        if (claim - readIndex > capacity_) {
+            skipLapped(readIndex, claim - capacity_);
+            return true;
+        }
+        return false;
+    }
+
+    // Overwrite: reader-side recovery after the producer lapped it
+    void skipLapped(size_t readIndex, size_t target) {
+        if (readIndex_.compare_exchange_strong(readIndex, target,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+            overflowCount_.fetch_add(target - readIndex, std::memory_order_relaxed);
+        }
+    }
+
+    Storage storage_;
     const size_t capacity_;
-    std::atomic<size_t> writeIndex_;
-    std::atomic<size_t> readIndex_;
+    const size_t mask_;
+    std::atomic<OverflowPolicy> policy_;
+
+    // Producer side
+    alignas(kCacheLineSize) std::atomic<size_t> writeIndex_{0};
+    std::atomic<size_t> writeClaim_{0};
+    size_t cachedReadIndex_ = 0;
+
+    // Consumer side
+    alignas(kCacheLineSize) std::atomic<size_t> readIndex_{0};
+    size_t cachedWriteIndex_ = 0;
+    size_t peekIndex_ = 0;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> overflowCount_{0};
 };
-} 
\ No newline at end of file
+
+} // namespace ptm
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "utils/LatencyHistogram.hpp"
+#include "utils/SeqLock.hpp"
+
+namespace ptm {
+
+// Stream health counters over some span of callbacks
+struct StreamStatsWindow {
+    double seconds = 0.0;          // Audio covered: frames / sample rate
+    uint64_t callbacks = 0;
+    uint64_t frames = 0;
+    uint64_t underruns = 0;        // Driver input underflows
+    uint64_t overruns = 0;         // Driver input overflows
+    uint64_t ringOverflows = 0;    // Callbacks whose block did not fit the ring
+    uint64_t droppedSamples = 0;   // Samples lost to those
+    double maxLatency = 0.0;       // Seconds from ADC to callback
+    double maxLoad = 0.0;          // Longest callback as a fraction of its buffer period
+};
+
+// A consistent view of StreamStats, cheap to copy
+struct StreamStatsSnapshot {
+    double currentLatency = 0.0;   // Seconds, most recent callback
+    int64_t lastCallbackNs = 0;    // Steady clock; 0 before the first callback
+    StreamStatsWindow total;       // Since the stream started
+    StreamStatsWindow recent;      // The last complete window
+
+    // Nanoseconds since the stream started. Read separately from the
+    // counters above, so they may include a callback or two more.
+    LatencyHistogram::Summary callbackDuration;
+    LatencyHistogram::Summary latency;
+};
+
+/**
+ * Health statistics of the capture stream, written by the audio thread.
+ *
+ * The callback counts events as they happen and calls endCallback() once at
+ * the end; that records the duration and latency histograms (wait-free)
+ * and publishes the counters through a SeqLock, so snapshot() from any
+ * other thread never sees a half-updated set. Counters are also kept per
+ * window of callbacks (one second by default), and the last complete
+ * window is what health checks should look at: a burst of xruns an hour
+ * ago does not make the stream unhealthy now.
+ */
+class StreamStats {
+public:
+    static constexpr std::chrono::milliseconds kDefaultWindow{1000};
+
+    explicit StreamStats(std::chrono::nanoseconds window = kDefaultWindow);
+
+    StreamStats(const StreamStats&) = delete;
+    StreamStats& operator=(const StreamStats&) = delete;
+
+    // Before the stream starts: clears everything
+    void begin(double sampleRate);
+
+    // Audio thread, during a callback; each returns the lifetime count
+    // including this one
+    uint64_t addUnderrun();
+    uint64_t addOverrun();
+    uint64_t addRingOverflow(uint64_t droppedSamples);
+
+    // Audio thread, once per callback, with steady-clock start and end
+    void endCallback(int64_t startNs, int64_t endNs, double latencySeconds, size_t frames);
+
+    // Any thread
+    StreamStatsSnapshot snapshot() const;
+
+private:
+    struct Published {
+        double currentLatency;
+        int64_t lastCallbackNs;
+        StreamStatsWindow total;
+        StreamStatsWindow recent;
+    };
+
+    static void accumulate(StreamStatsWindow& window, const StreamStatsWindow& callback);
+
+    const int64_t windowNs_;
+    double sampleRate_ = 0.0;
+
+    // Audio thread
+    StreamStatsWindow pending_;    // Events of the callback in progress
+    StreamStatsWindow total_;
+    StreamStatsWindow current_;
+    StreamStatsWindow recent_;
+    int64_t windowStartNs_ = 0;
+
+    SeqLock<Published> published_;
+    LatencyHistogram callbackDuration_;
+    LatencyHistogram latency_;
+};
+
+} // namespace ptm
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "dsp/Fft.hpp"
+
+namespace ptm {
+
+/**
+ * YIN difference function of a sliding window,
+ *     d(tau) = sum_j (x[j] - x[j + tau])^2,  j, tau < windowSize / 2
+ *
+ * Exact mode (hopSize 0) computes every window from scratch: two energy
+ * terms from running sums of squares minus twice a cross-correlation done
+ * with real FFTs, O(N log N).
+ *
+ * Incremental mode assumes consecutive compute() calls see windows exactly
+ * hopSize samples apart. It keeps d(tau) in double precision and, per hop,
+ * adds the terms of the hopSize samples entering the integration window and
+ * subtracts those leaving it: O(hopSize * windowSize), which is a fraction
+ * of the exact cost for small hops. An exact recomputation every
+ * resyncInterval hops bounds the accumulated rounding error. Call reset()
+ * after any discontinuity in the input (dropped samples, device change).
+ *
+ * All buffers are allocated in the constructor. The transform is either
+ * its own or borrowed, e.g. from an FftPlanCache; a borrowed one is only
+ * used as scratch inside compute(), so instances on one thread may share
+ * it. Not thread-safe.
+ */
+class DifferenceFunction {
+public:
+    static constexpr size_t kDefaultResyncInterval = 64;
+
+    /**
+     * @param windowSize Samples per window, at least 4
+     * @param hopSize Samples between consecutive windows; 0 for exact mode.
+     *        Hops of windowSize / 2 or more gain nothing and run exact.
+     * @param resyncInterval Incremental hops between exact recomputations
+     * @throws std::invalid_argument if windowSize is too small
+     */
+    explicit DifferenceFunction(size_t windowSize, size_t hopSize = 0,
+                                size_t resyncInterval = kDefaultResyncInterval);
+
+    /**
+     * As above, with a borrowed transform that must outlive this object
+     * @throws std::invalid_argument if fft.size() is not fftSizeFor(windowSize)
+     */
+    DifferenceFunction(size_t windowSize, RealFft& fft, size_t hopSize = 0,
+                       size_t resyncInterval = kDefaultResyncInterval);
+
+    /**
+     * Transform length used for a window size
+     * @throws std::invalid_argument if windowSize is too small
+     */
+    static size_t fftSizeFor(size_t windowSize);
+
+    /**
+     * Update for the next window
+     * @param window windowSize samples, oldest first
+     */
+    void compute(const float* window);
+
+    // Forget the previous window; the next compute() is exact
+    void reset();
+
+    size_t windowSize() const { return windowSize_; }
+    size_t hopSize() const { return hopSize_; }
+    bool isIncremental() const { return hopSize_ != 0; }
+
+    // d(tau) for tau < windowSize / 2, clamped at zero
+    const std::vector<float>& values() const { return values_; }
+
+    // sum x[j]^2 over the integration window (the first windowSize / 2 samples)
+    double energy() const { return energy_; }
+
+    // Number of from-scratch computations so far, for tests and benchmarks
+    uint64_t exactComputations() const { return exactComputations_; }
+
+private:
+    DifferenceFunction(size_t windowSize, std::unique_ptr<RealFft> ownedFft, RealFft* fft,
+                       size_t hopSize, size_t resyncInterval);
+
+    void computeExact(const float* window);
+    void computeIncremental(const float* window);
+
+    size_t windowSize_;
+    size_t integrationSize_;
+    size_t hopSize_;
+    size_t resyncInterval_;
+
+    std::unique_ptr<RealFft> ownedFft_;
+    RealFft* fft_;
+    std::vector<RealFft::Complex> windowSpectrum_;
+    std::vector<double> prefixEnergy_;   // Prefix sums of x^2, windowSize + 1 entries
+
+    std::vector<double> running_;        // Incremental d(tau)
+    std::vector<float> entering_;
+    std::vector<float> leaving_;
+    std::vector<float> previous_;        // Last window, for the leaving terms
+
+    std::vector<float> values_;
+    double energy_ = 0.0;
+    bool hasPrevious_ = false;
+    size_t hopsSinceResync_ = 0;
+    uint64_t exactComputations_ = 0;
+};
+
+} // namespace ptm
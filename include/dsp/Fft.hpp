@@ -0,0 +1,65 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace ptm {
+
+/**
+ * Real-to-complex FFT of a fixed power-of-two size.
+ *
+ * Backed by FFTW when built with USE_FFTW, otherwise by a built-in scalar
+ * radix-2 implementation with the same conventions. The transform works on
+ * its own (suitably aligned) buffers: fill real(), call forward(), read
+ * spectrum(), or the other way round for inverse().
+ *
+ * All memory is allocated in the constructor; forward() and inverse() never
+ * allocate. With FFTW the constructor also measures plans, which takes tens
+ * of milliseconds per size unless wisdom for that size has been imported:
+ * build transforms ahead of time (see FftPlanCache), not on a processing
+ * thread. Constructors may run concurrently; each instance is used by one
+ * thread at a time.
+ */
+class RealFft {
+public:
+    using Complex = std::complex<double>;
+
+    /**
+     * @param size Transform length, a power of two of at least 4
+     * @throws std::invalid_argument if size is not supported
+     */
+    explicit RealFft(size_t size);
+    ~RealFft();
+
+    RealFft(const RealFft&) = delete;
+    RealFft& operator=(const RealFft&) = delete;
+
+    size_t size() const { return size_; }
+    size_t bins() const { return size_ / 2 + 1; }
+
+    double* real();          // size() samples
+    Complex* spectrum();     // bins() values, DC to Nyquist
+
+    // real() -> spectrum()
+    void forward();
+
+    // spectrum() -> real(), scaled by size() (unnormalised, as in FFTW).
+    // The contents of spectrum() are undefined afterwards.
+    void inverse();
+
+    // FFTW wisdom: plans measured in earlier runs, which make later
+    // constructors of those sizes near-instant. Both return false on I/O
+    // failure, and always without FFTW, where there is nothing to plan.
+    static bool importWisdom(const std::string& path);
+    static bool exportWisdom(const std::string& path);
+
+private:
+    struct Impl;
+
+    size_t size_;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ptm
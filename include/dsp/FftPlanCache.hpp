@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "dsp/Fft.hpp"
+
+namespace ptm {
+
+/**
+ * Transforms of every size a stream may need, planned ahead of time on a
+ * background thread.
+ *
+ * start() returns at once; the thread first imports the wisdom file, if
+ * one is given, then builds one RealFft per size in the order given (put
+ * the size in use first) and finally exports wisdom back to the file, so
+ * that the next run finds every plan without measuring. Each transform's
+ * buffers are allocated once, as it is built.
+ *
+ * find() is a lookup plus an atomic load: it never plans, allocates or
+ * blocks, and returns nullptr for a size that is not ready yet. The
+ * transforms it hands out are shared, so they belong to the one analysis
+ * thread that runs them; building several caches is how several threads
+ * get their own.
+ */
+class FftPlanCache {
+public:
+    /**
+     * @param sizes Transform lengths, each a power of two of at least 4
+     * @param wisdomPath FFTW wisdom file, read if present and written once
+     *        every size is built; empty for none
+     * @throws std::invalid_argument if a size is not supported
+     */
+    explicit FftPlanCache(std::vector<size_t> sizes, std::string wisdomPath = {});
+
+    // Waits for the build to finish; FFTW cannot stop a plan half-way
+    ~FftPlanCache();
+
+    FftPlanCache(const FftPlanCache&) = delete;
+    FftPlanCache& operator=(const FftPlanCache&) = delete;
+
+    // Builds on a background thread; does nothing after the first call
+    void start();
+
+    // Builds on the calling thread, for tools and tests with nothing to overlap
+    void build();
+
+    void waitUntilReady();
+    bool isReady() const { return ready_.load(std::memory_order_acquire); }
+
+    // Any thread
+    RealFft* find(size_t size) const;
+
+    const std::vector<size_t>& sizes() const { return sizes_; }
+    const std::string& wisdomPath() const { return wisdomPath_; }
+
+    // Valid once ready
+    bool wisdomImported() const { return wisdomImported_; }
+    double buildSeconds() const { return buildSeconds_; }
+
+    // Why a size is missing, if building it threw; empty otherwise
+    std::string error() const;
+
+private:
+    struct Entry {
+        size_t size;
+        std::unique_ptr<RealFft> fft;
+        std::atomic<bool> built{false};
+    };
+
+    void run();
+
+    const std::vector<size_t> sizes_;
+    const std::string wisdomPath_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+
+    std::thread thread_;
+    std::atomic<bool> started_{false};
+    std::atomic<bool> ready_{false};
+    bool wisdomImported_ = false;
+    double buildSeconds_ = 0.0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable readyCondition_;
+    std::string error_;
+};
+
+} // namespace ptm
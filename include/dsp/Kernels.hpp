@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ptm {
+
+enum class InstructionSet {
+    Scalar,   // Portable C++
+    SSE2,
+    AVX2,     // AVX2 + FMA
+    AVX512    // AVX-512F
+};
+
+const char* toString(InstructionSet isa);
+
+/**
+ * The DSP primitives shared by the analysis stages, one implementation per
+ * instruction set. Pointers may be unaligned; n may be zero. Vector variants
+ * sum in a different order from the scalar one, so float results agree only
+ * to rounding.
+ */
+struct KernelTable {
+    InstructionSet isa;
+
+    // sum x[i]^2
+    float (*sumOfSquares)(const float* x, size_t n);
+
+    // max |x[i]|, 0 for n == 0
+    float (*peak)(const float* x, size_t n);
+
+    // sum a[i] * b[i]
+    float (*dot)(const float* a, const float* b, size_t n);
+
+    // sum (a[i] - b[i])^2
+    float (*squaredDifference)(const float* a, const float* b, size_t n);
+
+    // acc[i] += (value - x[i])^2
+    void (*accumulateSquaredDifference)(float value, const float* x, float* acc, size_t n);
+
+    // YIN cumulative mean normalisation: out[0] = 1,
+    // out[t] = d[t] * t / sum_{k=1..t} d[k], or 1 while that sum is 0.
+    // out may alias d.
+    void (*cumulativeMeanNormalize)(const float* d, float* out, size_t n);
+};
+
+// Best instruction set the CPU and operating system support, via CPUID
+InstructionSet detectInstructionSet();
+
+// Kernels for the detected instruction set; selected once, on first use
+const KernelTable& kernels();
+
+// Kernels for a specific instruction set, or nullptr if this build or this
+// CPU lacks it. For tests and benchmarks.
+const KernelTable* kernelsFor(InstructionSet isa);
+
+inline float sumOfSquares(const float* x, size_t n) {
+    return kernels().sumOfSquares(x, n);
+}
+
+inline float peak(const float* x, size_t n) {
+    return kernels().peak(x, n);
+}
+
+inline float dot(const float* a, const float* b, size_t n) {
+    return kernels().dot(a, b, n);
+}
+
+inline float squaredDifference(const float* a, const float* b, size_t n) {
+    return kernels().squaredDifference(a, b, n);
+}
+
+inline void accumulateSquaredDifference(float value, const float* x, float* acc, size_t n) {
+    kernels().accumulateSquaredDifference(value, x, acc, n);
+}
+
+inline void cumulativeMeanNormalize(const float* d, float* out, size_t n) {
+    kernels().cumulativeMeanNormalize(d, out, n);
+}
+
+} // namespace ptm
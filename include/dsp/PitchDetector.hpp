@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "dsp/DifferenceFunction.hpp"
+
+namespace ptm {
+
+class PitchDetectorException : public std::runtime_error {
+public:
+    explicit PitchDetectorException(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+struct PitchDetectorConfig {
+    double sampleRate = 44100.0;
+    size_t windowSize = 1024;       // Samples per analysis window (256-4096 in the GUI)
+    float threshold = 0.15f;        // YIN absolute threshold on the normalised difference
+    float minFrequency = 32.70f;    // C1; also limited by windowSize / 2
+    float maxFrequency = 4186.01f;  // C8
+
+    // Samples between consecutive process() calls. Non-zero updates the
+    // difference function incrementally (see DifferenceFunction); 0 computes
+    // every window from scratch.
+    size_t hopSize = 0;
+    size_t resyncInterval = DifferenceFunction::kDefaultResyncInterval;
+};
+
+struct PitchEstimate {
+    float frequency = 0.0f;   // Hz; best candidate even when unvoiced, 0 for silence
+    float confidence = 0.0f;  // 1 - normalised difference at the chosen lag, 0..1
+    bool voiced = false;      // A dip below the threshold was found
+};
+
+/**
+ * YIN fundamental frequency estimator (de Cheveigne & Kawahara, 2002).
+ *
+ * The difference function comes from DifferenceFunction: FFT-based,
+ * O(N log N) per window, or updated incrementally per hop when hopSize is
+ * set. The best lag is refined by parabolic interpolation.
+ *
+ * All buffers are allocated in the constructor; process() does not allocate
+ * and can run on a real-time analysis thread. The transform may be borrowed
+ * (see DifferenceFunction) so that detectors built ahead of time share
+ * planned ones. Not thread-safe.
+ */
+class PitchDetector {
+public:
+    /**
+     * @throws PitchDetectorException if the configuration is invalid
+     */
+    explicit PitchDetector(const PitchDetectorConfig& config);
+
+    /**
+     * With a borrowed transform of DifferenceFunction::fftSizeFor(windowSize),
+     * which must outlive the detector
+     * @throws PitchDetectorException if the configuration or transform is invalid
+     */
+    PitchDetector(const PitchDetectorConfig& config, RealFft& fft);
+
+    /**
+     * Analyse one window
+     * @param window config().windowSize samples, oldest first
+     */
+    PitchEstimate process(const float* window);
+
+    // Call after a gap in the input when hopSize is set
+    void reset() { difference_.reset(); }
+
+    const PitchDetectorConfig& config() const { return config_; }
+
+    // Lags examined, in samples: [minLag(), maxLag()]
+    size_t minLag() const { return minLag_; }
+    size_t maxLag() const { return maxLag_; }
+
+    // From the last process() call, indexed by lag (windowSize / 2 entries)
+    const std::vector<float>& difference() const { return difference_.values(); }
+    const std::vector<float>& normalizedDifference() const { return normalized_; }
+
+private:
+    PitchDetector(const PitchDetectorConfig& config, RealFft* fft);
+
+    PitchEstimate pickPitch() const;
+    float interpolatedLag(size_t lag) const;
+
+    PitchDetectorConfig config_;
+    size_t integrationSize_;
+    size_t minLag_;
+    size_t maxLag_;
+
+    DifferenceFunction difference_;
+    std::vector<float> normalized_;
+};
+
+} // namespace ptm
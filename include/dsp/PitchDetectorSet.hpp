@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "dsp/FftPlanCache.hpp"
+#include "dsp/PitchDetector.hpp"
+
+namespace ptm {
+
+/**
+ * One PitchDetector per selectable window size, so that changing the
+ * window size while running is a lookup rather than a reconstruction.
+ *
+ * Every detector is built in the constructor, borrowing its transform from
+ * an FftPlanCache (detectors whose windows round up to the same FFT length
+ * share one). The constructor therefore waits for the cache: build the set
+ * off the analysis thread, e.g. while the stream starts. With wisdom on
+ * disk that wait is short. After that, select() neither plans nor
+ * allocates. The set and the cache it borrows from belong to one analysis
+ * thread.
+ */
+class PitchDetectorSet {
+public:
+    // The window sizes windowSizeSlider offers: 256 to 4096 in steps of 256
+    static std::vector<size_t> defaultWindowSizes();
+
+    // Distinct transform lengths the given window sizes need, largest first
+    static std::vector<size_t> fftSizesFor(const std::vector<size_t>& windowSizes);
+
+    /**
+     * @param config Shared by every detector apart from windowSize
+     * @param cache Started, holding fftSizesFor(windowSizes); must outlive the set
+     * @throws PitchDetectorException if a configuration is invalid or the
+     *         cache is missing a transform
+     */
+    PitchDetectorSet(const PitchDetectorConfig& config, const std::vector<size_t>& windowSizes,
+                     FftPlanCache& cache);
+
+    /**
+     * Make windowSize current. A detector that was not current is reset, as
+     * the windows it last saw are stale.
+     * @return The detector, or nullptr (keeping the current one) if the
+     *         window size is not in the set
+     */
+    PitchDetector* select(size_t windowSize);
+
+    PitchDetector& current() { return *current_; }
+    const std::vector<size_t>& windowSizes() const { return windowSizes_; }
+
+private:
+    std::vector<size_t> windowSizes_;
+    std::vector<std::unique_ptr<PitchDetector>> detectors_;  // Parallel to windowSizes_
+    PitchDetector* current_ = nullptr;
+};
+
+} // namespace ptm
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dsp/PitchDetector.hpp"
+#include "dsp/SpectralFrame.hpp"
+#include "utils/LatencyHistogram.hpp"
+
+namespace ptm {
+
+struct PolyphonicDetectorConfig {
+    double sampleRate = 44100.0;
+    size_t windowSize = 4096;       // Low notes need long windows to resolve
+    size_t zeroPadding = 2;         // FFT length over window length, rounded up to a power of two
+
+    size_t maxVoices = 4;           // Fundamentals per hop, at most kMaxVoices
+    size_t maxHarmonics = 10;       // Partials summed per candidate
+    float maxPartialFrequency = 6000.0f;  // No partial is searched above this
+    float minFrequency = 65.41f;    // C2
+    float maxFrequency = 2093.0f;   // C7
+
+    // A further voice needs this fraction of the first voice's salience
+    float relativeThreshold = 0.2f;
+
+    // RMS of a voice's partials below which it is not reported
+    float minLevel = 0.01f;
+};
+
+struct PolyphonicVoice {
+    int note = -1;            // Candidate MIDI note
+    float frequency = 0.0f;   // Hz, refined from the partials
+    float salience = 0.0f;    // Weighted harmonic sum
+    float level = 0.0f;       // RMS of the partials attributed to this voice
+};
+
+struct PolyphonicEstimate {
+    static constexpr size_t kMaxVoices = 16;
+
+    std::array<PolyphonicVoice, kMaxVoices> voices;  // Strongest first
+    size_t count = 0;
+};
+
+/**
+ * Estimates several simultaneous fundamentals per hop by harmonic
+ * summation on a magnitude spectrum (after Klapuri, 2006).
+ *
+ * Every MIDI note in the frequency range is a candidate. Its salience is
+ * the weighted sum, over its first maxHarmonics partials, of the largest
+ * magnitude within a quarter tone of each partial; the weight
+ * (f0 + 27 Hz) / (h f0 + 320 Hz) favours low partials, so a note scores
+ * above its own sub-octaves. The most salient candidate becomes a voice,
+ * its partials are cancelled from a residual spectrum (by no more than a
+ * smoothed envelope of neighbouring partials, so a partial shared with
+ * another note keeps the other note's share) and the search repeats on the
+ * residual until maxVoices voices are found or the next one is too weak.
+ *
+ * The bins each candidate reads are tabulated in the constructor, so the
+ * work per hop is one FFT plus at most maxVoices passes over that table;
+ * binVisitsPerHop() gives the bound and processTime() the measured cost.
+ * process() does not allocate. Not thread-safe.
+ */
+class PolyphonicDetector {
+public:
+    /**
+     * @throws PitchDetectorException if the configuration is invalid
+     */
+    explicit PolyphonicDetector(const PolyphonicDetectorConfig& config);
+
+    /**
+     * Analyse one window
+     * @param window config().windowSize samples, oldest first
+     */
+    PolyphonicEstimate process(const float* window);
+
+    /**
+     * Change the fundamentals reported per hop without rebuilding the tables
+     * @throws PitchDetectorException unless 1..PolyphonicEstimate::kMaxVoices
+     */
+    void setMaxVoices(size_t maxVoices);
+
+    const PolyphonicDetectorConfig& config() const { return config_; }
+    const SpectralFrame& spectrum() const { return frame_; }
+
+    size_t candidateCount() const { return candidates_.size(); }
+
+    // Upper bound on spectrum bins read by one process() call
+    size_t binVisitsPerHop() const { return binVisitsPerPass_ * config_.maxVoices; }
+
+    // Wall time of each process() call
+    const LatencyHistogram& processTime() const { return processTime_; }
+
+private:
+    struct Partial {
+        uint32_t firstBin;
+        uint32_t lastBin;   // Inclusive
+        float weight;
+    };
+
+    struct Candidate {
+        int note;
+        float frequency;
+        uint32_t firstPartial;  // Index into partials_
+        uint32_t partialCount;
+    };
+
+    float salience(const Candidate& candidate) const;
+    PolyphonicVoice extract(const Candidate& candidate);
+
+    PolyphonicDetectorConfig config_;
+    SpectralFrame frame_;
+    std::vector<Candidate> candidates_;
+    std::vector<Partial> partials_;
+    size_t binVisitsPerPass_ = 0;
+    size_t lobeHalfWidth_;
+
+    // Per process() call
+    std::vector<float> residual_;
+    std::vector<uint8_t> taken_;
+    std::vector<float> amplitudes_;  // One candidate's partials
+    std::vector<uint32_t> peaks_;
+
+    LatencyHistogram processTime_;
+};
+
+} // namespace ptm
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "dsp/Fft.hpp"
+
+namespace ptm {
+
+/**
+ * Hann-windowed magnitude spectrum of one analysis window.
+ *
+ * The window is zero-padded to a power-of-two FFT of at least
+ * zeroPadding * windowSize samples, which narrows the bin spacing so that
+ * partials of neighbouring low notes fall in different bins. Any window
+ * size is accepted, not just powers of two.
+ *
+ * All buffers are allocated in the constructor; compute() does not
+ * allocate. Not thread-safe.
+ */
+class SpectralFrame {
+public:
+    /**
+     * @throws std::invalid_argument if a size is zero or the rate is not positive
+     */
+    SpectralFrame(double sampleRate, size_t windowSize, size_t zeroPadding = 2);
+
+    /**
+     * Transform one window
+     * @param window windowSize() samples, oldest first
+     */
+    void compute(const float* window);
+
+    // |X[k]| for k = 0..bins() - 1, DC to Nyquist
+    const std::vector<float>& magnitudes() const { return magnitudes_; }
+
+    size_t windowSize() const { return window_.size(); }
+    size_t fftSize() const { return fft_.size(); }
+    size_t bins() const { return fft_.bins(); }
+    double sampleRate() const { return sampleRate_; }
+    double binFrequency() const { return sampleRate_ / static_cast<double>(fft_.size()); }
+
+    // Peak amplitude of a sinusoid whose magnitude peak is 1
+    float amplitudeScale() const { return amplitudeScale_; }
+
+private:
+    double sampleRate_;
+    std::vector<float> window_;
+    RealFft fft_;
+    std::vector<float> magnitudes_;
+    float amplitudeScale_;
+};
+
+} // namespace ptm
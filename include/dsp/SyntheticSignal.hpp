@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace ptm {
+
+/**
+ * Deterministic test signals for benchmarks and tests that have no audio
+ * device: pure and harmonic tones, sweeps, vibrato and noise. Amplitudes
+ * are peak values of the fundamental; harmonic h has amplitude / h.
+ */
+namespace synthetic {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Harmonic tone at a constant frequency
+inline std::vector<float> tone(double frequency, double sampleRate, size_t count,
+                               float amplitude = 0.5f, int harmonics = 1) {
+    std::vector<float> samples(count, 0.0f);
+    const double step = 2.0 * kPi * frequency / sampleRate;
+    for (size_t i = 0; i < count; ++i) {
+        double phase = step * static_cast<double>(i);
+        double value = 0.0;
+        for (int h = 1; h <= harmonics; ++h) {
+            value += std::sin(h * phase) / h;
+        }
+        samples[i] = static_cast<float>(amplitude * value);
+    }
+    return samples;
+}
+
+// Exponential sweep from startFrequency to endFrequency over count samples
+inline std::vector<float> chirp(double startFrequency, double endFrequency, double sampleRate,
+                                size_t count, float amplitude = 0.5f) {
+    std::vector<float> samples(count);
+    const double ratio = std::pow(endFrequency / startFrequency, 1.0 / static_cast<double>(count));
+    double frequency = startFrequency;
+    double phase = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] = static_cast<float>(amplitude * std::sin(phase));
+        phase += 2.0 * kPi * frequency / sampleRate;
+        frequency *= ratio;
+    }
+    return samples;
+}
+
+// Harmonic tone whose pitch swings depthCents either side of frequency
+inline std::vector<float> vibrato(double frequency, double depthCents, double rateHz,
+                                  double sampleRate, size_t count, float amplitude = 0.5f,
+                                  int harmonics = 3) {
+    std::vector<float> samples(count);
+    double phase = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double value = 0.0;
+        for (int h = 1; h <= harmonics; ++h) {
+            value += std::sin(h * phase) / h;
+        }
+        samples[i] = static_cast<float>(amplitude * value);
+
+        double t = static_cast<double>(i) / sampleRate;
+        double cents = depthCents * std::sin(2.0 * kPi * rateHz * t);
+        phase += 2.0 * kPi * frequency * std::pow(2.0, cents / 1200.0) / sampleRate;
+    }
+    return samples;
+}
+
+// Gaussian white noise with the given RMS
+inline std::vector<float> noise(size_t count, float rms = 0.1f, uint32_t seed = 1) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> distribution(0.0f, rms);
+    std::vector<float> samples(count);
+    for (float& sample : samples) {
+        sample = distribution(rng);
+    }
+    return samples;
+}
+
+} // namespace synthetic
+} // namespace ptm
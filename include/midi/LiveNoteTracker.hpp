@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "audio/AnalysisWorker.hpp"
+#include "dsp/PitchDetectorSet.hpp"
+#include "dsp/PolyphonicDetector.hpp"
+#include "midi/NoteTelemetry.hpp"
+#include "midi/NoteTracker.hpp"
+#include "midi/ParameterStore.hpp"
+#include "midi/PolyphonicNoteTracker.hpp"
+
+namespace ptm {
+
+// Events from one LiveNoteTracker call, valid until the next
+struct LiveNoteUpdate {
+    const NoteEvent* events = nullptr;
+    size_t count = 0;
+    LatencyStamp latency;
+};
+
+/**
+ * Pitch to notes on an AnalysisWorker's thread, following the GUI controls
+ * as they move.
+ *
+ * The worker runs at the largest window and smallest hop the controls
+ * allow (analysisConfig()), so changing either never resizes anything:
+ * every hopSize / kMinHopSize frames, the newest windowSize samples of the
+ * frame are analysed by that window size's detector from a
+ * PitchDetectorSet. At each of those hops it first picks up the latest
+ * ParameterStore snapshot; the threshold and debounce time go to the
+ * NoteTracker in place. process() therefore never plans, allocates or
+ * locks, whatever the controls do.
+ *
+ * With the polyphonic control set, each analysed hop instead goes to a
+ * PolyphonicDetector over the whole kMaxWindowSize frame (low notes need
+ * the long window, so the window size control is ignored) and a
+ * PolyphonicNoteTracker, limited to the maxVoices control; both are built
+ * for kMaxVoices up front. Switching mode releases the notes the other
+ * path was holding, in the same update. Telemetry then describes the
+ * strongest voice.
+ *
+ * The first notes wait for a full kMaxWindowSize window. The MIDI channel
+ * and mode are left to whoever sends the events, via parameters(). With a
+ * telemetry channel, every analysed hop is also stored there for display.
+ *
+ * Each update carries the frame's latency stamp. With a LatencyMonitor
+ * (the capture's, which stamped the frame), the detection time of every
+ * analysed hop is recorded; pass update.latency to MidiOutput::post() so
+ * the send is recorded against the same stamp.
+ */
+class LiveNoteTracker {
+public:
+    // What the AnalysisWorker feeding process() must use
+    static AnalysisConfig analysisConfig();
+
+    /**
+     * Builds a detector per window size, waiting for the cache if needed
+     * @param cache Holding PitchDetectorSet::fftSizesFor(defaultWindowSizes());
+     *        must outlive the tracker
+     * @throws PitchDetectorException or std::invalid_argument if the
+     *         configuration is invalid
+     */
+    LiveNoteTracker(double sampleRate, ParameterStore& parameters, FftPlanCache& cache,
+                    const PitchDetectorConfig& pitch = {}, const NoteTrackerConfig& notes = {});
+
+    // Before the worker starts; nullptr for none. Must outlive the tracker.
+    void setTelemetry(NoteTelemetryChannel* telemetry) { telemetry_ = telemetry; }
+
+    // Before the worker starts; nullptr for none. Must outlive the tracker.
+    void setLatencyMonitor(LatencyMonitor* latencyMonitor) { latencyMonitor_ = latencyMonitor; }
+
+    // Analysis thread: one AnalysisWorker frame
+    LiveNoteUpdate process(const AnalysisFrame& frame);
+
+    // Analysis thread: end of input
+    LiveNoteUpdate flush(uint64_t samplePosition);
+
+    // Analysis thread: the snapshot in use
+    const ProcessingParameters& parameters() const { return parameters_.current(); }
+
+    // From the last analysed hop; monophonic and polyphonic respectively
+    const PitchEstimate& lastEstimate() const { return estimate_; }
+    const PolyphonicEstimate& lastPolyphonicEstimate() const { return polyphonicEstimate_; }
+    uint64_t analysedHops() const { return analysedHops_; }
+
+private:
+    void apply(const ProcessingParameters& parameters, uint64_t samplePosition);
+    // Whether a hop was analysed
+    bool processMonophonic(const AnalysisFrame& frame);
+    bool processPolyphonic(const AnalysisFrame& frame);
+    void append(const NoteEvent* events, size_t count);
+    void publishTelemetry(float rms);
+
+    ParameterStore& parameters_;
+    PitchDetectorSet detectors_;
+    NoteTracker tracker_;
+    PolyphonicDetector polyphonicDetector_;
+    PolyphonicNoteTracker polyphonicTracker_;
+    bool polyphonic_ = false;
+    size_t hopStride_ = 1;  // Frames per analysed hop
+    PitchEstimate estimate_;
+    PolyphonicEstimate polyphonicEstimate_;
+    uint64_t analysedHops_ = 0;
+    std::vector<NoteEvent> events_;  // Of the current call, reserved up front
+
+    NoteTelemetryChannel* telemetry_ = nullptr;
+    LatencyMonitor* latencyMonitor_ = nullptr;
+    std::array<uint8_t, 128> velocities_{};  // Of each sounding note
+};
+
+} // namespace ptm
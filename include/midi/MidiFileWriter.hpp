@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "midi/NoteTracker.hpp"
+
+namespace ptm {
+
+class MidiFileException : public std::runtime_error {
+public:
+    explicit MidiFileException(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+/**
+ * Builds a single-track (format 0) Standard MIDI File.
+ *
+ * Events are added with times in seconds and converted to ticks at a fixed
+ * tempo; they may be added in any order, and keep their insertion order
+ * when they fall on the same tick.
+ */
+class MidiFileWriter {
+public:
+    /**
+     * @param ticksPerQuarter Time resolution of the file
+     * @param beatsPerMinute Tempo written to the file, used for tick conversion
+     * @throws MidiFileException if either is out of range
+     */
+    explicit MidiFileWriter(uint16_t ticksPerQuarter = 480, double beatsPerMinute = 120.0);
+
+    // channel is 1-16
+    void addNoteOn(double seconds, int channel, int note, int velocity);
+    void addNoteOff(double seconds, int channel, int note);
+
+    // NoteTracker events, positioned by sample rate
+    void addEvents(const std::vector<NoteEvent>& events, double sampleRate, int channel);
+
+    size_t eventCount() const { return events_.size(); }
+
+    std::vector<uint8_t> toBytes() const;
+
+    /**
+     * @throws MidiFileException if the file cannot be written
+     */
+    void write(const std::string& path) const;
+
+private:
+    struct Event {
+        uint64_t tick;
+        uint64_t order;
+        uint8_t status;
+        uint8_t data1;
+        uint8_t data2;
+    };
+
+    void addEvent(double seconds, uint8_t status, int data1, int data2);
+
+    uint16_t ticksPerQuarter_;
+    uint32_t microsecondsPerQuarter_;
+    double ticksPerSecond_;
+    std::vector<Event> events_;
+};
+
+} // namespace ptm
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "audio/LatencyMonitor.hpp"
+#include "audio/RingBuffer.hpp"
+#include "midi/NoteTracker.hpp"
+#include "utils/LatencyHistogram.hpp"
+#include "utils/Semaphore.hpp"
+
+namespace ptm {
+
+class MidiOutputException : public std::runtime_error {
+public:
+    explicit MidiOutputException(const std::string& message) : std::runtime_error(message) {}
+};
+
+// A channel voice message of at most three bytes. Channels are 0-15, as
+// on the wire.
+struct MidiMessage {
+    std::array<uint8_t, 3> bytes{};
+    uint8_t size = 0;
+
+    static MidiMessage noteOn(uint8_t channel, uint8_t note, uint8_t velocity);
+    static MidiMessage noteOff(uint8_t channel, uint8_t note);
+
+    // value is 14-bit, 8192 for no bend
+    static MidiMessage pitchBend(uint8_t channel, uint16_t value);
+
+    // Bend by cents for a receiver set to +/- rangeSemitones; clamped
+    static MidiMessage pitchBendCents(uint8_t channel, double cents, double rangeSemitones = 2.0);
+
+    static MidiMessage fromNoteEvent(uint8_t channel, const NoteEvent& event);
+};
+
+/**
+ * Where MidiOutput's sender thread delivers messages: a driver port, a
+ * virtual port, or a recorder in tests.
+ */
+class MidiPort {
+public:
+    virtual ~MidiPort() = default;
+
+    // Sender thread only; may block in the driver
+    virtual void send(const uint8_t* bytes, size_t size) = 0;
+
+    // Byte-stream ports (a serial DIN link) that let MidiOutput leave out
+    // a status byte equal to the previous one, and that pass the bytes on
+    // unchanged and in order
+    virtual bool acceptsRunningStatus() const { return false; }
+
+    virtual std::string describe() const = 0;
+};
+
+// Reduction of continuous-mode pitch bends by MidiOutput's sender thread
+struct BendThinningConfig {
+    double deadbandCents = 0.0;       // Drop bends this close to the last one sent; 0 sends all
+    double bendRangeSemitones = 2.0;  // The receiver's bend range, +/-
+    bool coalesce = false;            // Send only the newest bend waiting per channel
+};
+
+/**
+ * MIDI output stage between note detection and a MidiPort.
+ *
+ * post() copies a fixed-size message into a preallocated single-producer
+ * queue and wakes the sender thread, so the detection thread never
+ * allocates, locks or waits on the driver. The sender thread hands each
+ * message to the port in order, then records the stamp's output and total
+ * latency with the LatencyMonitor, if any.
+ *
+ * A full queue drops the new message and counts it. The queue depth (now
+ * and at its highest) and the time each message waited between post() and
+ * the start of its send are reported for tuning the queue size.
+ *
+ * Continuous mode sends a pitch bend every hop, which can fill a DIN link
+ * and hold note messages up behind bends. With either kind of bend
+ * thinning, bends are held while the sender thread drains the queue and go
+ * out after the note messages taken from the queue with them. With a
+ * deadband, a bend within the deadband of the last bend sent on its
+ * channel is then dropped (one back to the centre always goes out). With
+ * coalescing, each newer bend for a channel replaces the one held. Without
+ * thinning, messages go out in the order posted. On ports that accept running
+ * status, repeated status bytes are left out and note-offs are sent as
+ * note-ons with velocity 0, so that notes and bends on one channel share
+ * a status.
+ */
+class MidiOutput {
+public:
+    static constexpr size_t kDefaultQueueSize = 256;
+
+    /**
+     * @param port Must outlive the output
+     * @param latencyMonitor Optional; must outlive the output
+     */
+    explicit MidiOutput(MidiPort& port, size_t queueSize = kDefaultQueueSize,
+                        LatencyMonitor* latencyMonitor = nullptr);
+    ~MidiOutput();
+
+    MidiOutput(const MidiOutput&) = delete;
+    MidiOutput& operator=(const MidiOutput&) = delete;
+
+    /**
+     * While stopped; the default sends every bend
+     * @throws MidiOutputException while sending
+     * @throws std::invalid_argument if the configuration is invalid
+     */
+    void setBendThinning(const BendThinningConfig& config);
+    const BendThinningConfig& bendThinning() const { return thinning_; }
+
+    // Start/stop the sender thread; stop() sends whatever is still queued
+    void start();
+    void stop();
+    bool isRunning() const { return thread_.joinable(); }
+
+    /**
+     * One producer thread at a time; never blocks, locks or allocates.
+     * Messages posted before start() wait for it.
+     * @return false if the queue was full and the message dropped
+     */
+    bool post(const MidiMessage& message, const LatencyStamp& stamp = {}) noexcept;
+
+    size_t capacity() const { return queue_.capacity(); }
+    size_t queueDepth() const { return queue_.available(); }
+    size_t maxQueueDepth() const { return maxQueueDepth_.load(std::memory_order_relaxed); }
+    uint64_t sentMessages() const { return sent_.load(std::memory_order_relaxed); }
+    uint64_t droppedMessages() const { return queue_.overflowCount(); }
+
+    // Bends not sent: inside the deadband, or replaced by a newer one
+    uint64_t filteredBends() const { return filteredBends_.load(std::memory_order_relaxed); }
+    uint64_t coalescedBends() const { return coalescedBends_.load(std::memory_order_relaxed); }
+
+    // Bytes handed to the port, after running status
+    uint64_t bytesSent() const { return bytesSent_.load(std::memory_order_relaxed); }
+
+    // post() to when the sender thread takes the message from the queue
+    const LatencyHistogram& queueWait() const { return queueWait_; }
+
+private:
+    struct Pending {
+        MidiMessage message;
+        int64_t postNs;
+        LatencyStamp stamp;
+    };
+
+    static constexpr size_t kChannels = 16;
+
+    void run();
+    size_t sendPending();
+    size_t flushHeldBends();
+    size_t deliver(const Pending& pending);
+
+    MidiPort& port_;
+    LatencyMonitor* latencyMonitor_;
+    RingBuffer<Pending> queue_;
+    Semaphore ready_;
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<size_t> maxQueueDepth_{0};
+    std::atomic<uint64_t> sent_{0};
+
+    // Sender thread state for bend thinning and running status
+    BendThinningConfig thinning_;
+    double deadbandSteps_ = 0.0;  // deadbandCents in 14-bit bend steps
+    std::array<Pending, kChannels> heldBends_{};
+    uint16_t heldChannels_ = 0;   // Bit per channel with a held bend
+    std::vector<Pending> waitingBends_;  // Held in order when not coalescing
+    std::array<int32_t, kChannels> lastBend_{};  // -1 before the first
+    uint8_t runningStatus_ = 0;   // 0 when the next message needs its status
+    std::atomic<uint64_t> filteredBends_{0};
+    std::atomic<uint64_t> coalescedBends_{0};
+    std::atomic<uint64_t> bytesSent_{0};
+    LatencyHistogram queueWait_;
+    std::thread thread_;
+};
+
+} // namespace ptm
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "audio/AudioSource.hpp"
+#include "audio/LatencyMonitor.hpp"
+#include "audio/MirroredRingBuffer.hpp"
+#include "dsp/PitchDetector.hpp"
+#include "midi/NoteTracker.hpp"
+#include "utils/LatencyHistogram.hpp"
+#include "utils/SeqLock.hpp"
+#include "utils/ThreadPool.hpp"
+
+namespace ptm {
+
+struct MultiChannelConfig {
+    double sampleRate = 44100.0;
+    unsigned channels = 1;        // Interleaved inputs, one instrument each
+
+    // Window, hop and YIN settings, and note settings; the sample rate is
+    // taken from above. A zero pitch.hopSize means the default 256.
+    PitchDetectorConfig pitch;
+    NoteTrackerConfig notes;
+
+    // Input channel c sends on MIDI channel (firstMidiChannel + c) % 16
+    uint8_t firstMidiChannel = 0;
+
+    unsigned threads = 0;         // Worker pool size; 0 uses every core
+    size_t bufferSize = 8192;     // Per-channel ring, in samples
+};
+
+// Called on a pool thread; calls for different channels may overlap.
+// latency is the stamp of the hop that produced the event (invalid for the
+// note-offs from stop()); pass it to MidiOutput::post().
+using ChannelNoteCallback = std::function<void(unsigned channel, uint8_t midiChannel,
+                                               const NoteEvent& event,
+                                               const LatencyStamp& latency)>;
+
+/**
+ * Independent monophonic pitch trackers for each channel of a
+ * multi-channel input, as an AudioSink.
+ *
+ * The audio thread deinterleaves each block into per-channel mirrored
+ * rings and, whenever a hop completes, schedules every channel on a fixed
+ * ThreadPool; nothing there blocks or allocates. A channel's task runs all
+ * its pending hops with its own PitchDetector and NoteTracker, so channels
+ * are spread across the workers and throughput grows with the core count.
+ * Hops lost to a ring overflow are counted as missed, as AnalysisWorker
+ * does, and the channel's detector restarts from an exact window.
+ *
+ * Hop latency is measured from the write of the block that completed the
+ * oldest pending hop to the end of the task that analysed it.
+ *
+ * Events are stamped like LiveNoteTracker's: the ADC time of the hop's
+ * newest sample, from AudioBlockInfo::adcNs of the latest block (or its
+ * arrival time when the source cannot tell), and when the task started
+ * and finished detecting it.
+ */
+class MultiChannelTracker : public AudioSink {
+public:
+    /**
+     * @throws std::invalid_argument or PitchDetectorException for a bad
+     *         configuration
+     */
+    MultiChannelTracker(const MultiChannelConfig& config, ChannelNoteCallback callback);
+    ~MultiChannelTracker() override;
+
+    MultiChannelTracker(const MultiChannelTracker&) = delete;
+    MultiChannelTracker& operator=(const MultiChannelTracker&) = delete;
+
+    // Before the first block: clears the rings and trackers, starts the pool
+    void start();
+
+    // After the last block: stops the pool and releases sounding notes
+    // through the callback, on the calling thread
+    void stop();
+
+    // Audio thread. Channels beyond config().channels are ignored.
+    SinkStatus processBlock(const float* samples, size_t frames,
+                            const AudioBlockInfo& info) override;
+
+    // Room in every channel's ring, so unpaced sources lose nothing
+    bool hasRoomFor(size_t frames) const override;
+
+    const MultiChannelConfig& config() const { return config_; }
+    unsigned threadCount() const { return pool_.threadCount(); }
+
+    // Totals over every channel
+    uint64_t processedHops() const;
+    uint64_t missedHops() const;
+    uint64_t processedHops(unsigned channel) const;
+    uint64_t missedHops(unsigned channel) const;
+
+    const LatencyHistogram& hopLatency() const { return hopLatency_; }
+
+private:
+    struct Channel {
+        Channel(const MultiChannelConfig& config, unsigned index);
+
+        unsigned index;
+        uint8_t midiChannel;
+        MirroredRingBuffer<float> ring;
+        PitchDetector detector;
+        NoteTracker tracker;
+
+        // Written by the audio thread, taken by the task
+        std::atomic<uint64_t> pendingHops{0};
+        std::atomic<int64_t> oldestPendingNs{0};
+
+        // Task only
+        uint64_t seenOverflowCount = 0;
+        uint64_t lastPosition = 0;
+
+        std::atomic<uint64_t> processedHops{0};
+        std::atomic<uint64_t> missedHops{0};
+    };
+
+    void runChannel(Channel& channel);
+    void processHop(Channel& channel);
+    void emit(const Channel& channel, const NoteUpdate& update);
+
+    // Latest block written, for stamping hops; audio thread to tasks
+    struct BlockClock {
+        uint64_t endPosition = 0;  // Ring write position after the block
+        int64_t endAdcNs = 0;      // ADC time of endPosition
+        int64_t writeNs = 0;
+    };
+
+    const MultiChannelConfig config_;
+    ChannelNoteCallback callback_;
+    std::vector<std::unique_ptr<Channel>> channels_;
+    std::vector<float> deinterleaved_;  // One channel of a block
+    ThreadPool pool_;
+    LatencyHistogram hopLatency_;
+    SeqLock<BlockClock> blockClock_;
+    const double nsPerSample_;
+
+    size_t pendingSamples_ = 0;  // Audio thread
+};
+
+} // namespace ptm
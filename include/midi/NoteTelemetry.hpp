@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include "utils/SeqLock.hpp"
+
+namespace ptm {
+
+/**
+ * What the status display shows, as of one analysed hop.
+ */
+struct NoteTelemetry {
+    uint64_t hop = 0;          // Analysed hops so far; 0 before the first
+    int note = -1;             // Sounding MIDI note, or -1
+    uint8_t velocity = 0;      // Of the sounding note's note-on
+    float frequency = 0.0f;    // Hz, 0 for silence
+    float cents = 0.0f;        // Deviation of frequency from the sounding (or nearest) note
+    float confidence = 0.0f;   // 0..1
+    float level = 0.0f;        // Window RMS
+};
+
+/**
+ * Latest-value channel from the analysis thread to the GUI.
+ *
+ * The analysis thread store()s every hop, which is wait-free however
+ * rarely the GUI looks; the GUI load()s on its own timer and compares hop
+ * with what it last drew to skip unchanged frames. Intermediate values are
+ * simply overwritten, so a slow or stalled display costs the analysis
+ * thread nothing, and display cost does not grow as the hop shrinks.
+ */
+using NoteTelemetryChannel = SeqLock<NoteTelemetry>;
+
+} // namespace ptm
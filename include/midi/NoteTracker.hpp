@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "audio/LatencyMonitor.hpp"
+#include "dsp/PitchDetector.hpp"
+
+namespace ptm {
+
+enum class VelocityCurve {
+    Linear,       // Velocity proportional to RMS
+    Logarithmic   // Velocity proportional to level in dB
+};
+
+struct NoteTrackerConfig {
+    double sampleRate = 44100.0;
+    float amplitudeThreshold = 0.1f;  // Window RMS that starts a note, 0..1
+    double debounceMs = 20.0;         // A note change must persist this long
+    VelocityCurve velocityCurve = VelocityCurve::Logarithmic;
+    int lowestNote = 24;              // C1
+    int highestNote = 108;            // C8
+};
+
+struct NoteEvent {
+    enum class Type : uint8_t { NoteOn, NoteOff };
+
+    Type type;
+    uint8_t note;
+    uint8_t velocity;         // 0 for NoteOff
+    uint64_t samplePosition;  // Where the change was first observed
+};
+
+// Events produced by one update(): at most a note-off and a note-on
+struct NoteUpdate {
+    std::array<NoteEvent, 2> events;
+    size_t count = 0;
+    LatencyStamp latency;  // Of the hop behind the events; set by the live trackers
+};
+
+/**
+ * Turns per-hop pitch and level estimates into note-on/note-off events.
+ *
+ * A frame sounds a note when it is voiced and its RMS is at or above the
+ * amplitude threshold; the note is the nearest MIDI note to the estimated
+ * frequency. A change, including to silence, is only acted on once it has
+ * persisted for debounceMs, and the resulting events are stamped with the
+ * position where the change was first seen rather than where it was
+ * confirmed. The velocity of a note-on comes from the loudest frame during
+ * that confirmation period.
+ *
+ * Shared by the offline path (Transcriber) and the live trackers
+ * (LiveNoteTracker, MultiChannelTracker) to turn pitch into notes.
+ * update() does not allocate.
+ */
+class NoteTracker {
+public:
+    /**
+     * @throws std::invalid_argument if the configuration is invalid
+     */
+    explicit NoteTracker(const NoteTrackerConfig& config);
+
+    /**
+     * Feed the analysis of one window
+     * @param samplePosition Position the window represents; non-decreasing
+     */
+    NoteUpdate update(const PitchEstimate& estimate, float rms, uint64_t samplePosition);
+
+    // End of input: release the sounding note, if any
+    NoteUpdate flush(uint64_t samplePosition);
+
+    void reset();
+
+    /**
+     * Change the amplitude threshold and debounce time in place, e.g. when
+     * a control moves; the sounding note and any pending change carry on.
+     * Does not allocate.
+     * @throws std::invalid_argument if either is negative
+     */
+    void setThresholds(float amplitudeThreshold, double debounceMs);
+
+    // Sounding note, or -1
+    int currentNote() const { return current_; }
+
+    const NoteTrackerConfig& config() const { return config_; }
+
+    // Nearest MIDI note to a frequency, and the offset from it in cents
+    static int frequencyToNote(float frequency);
+    static float centsFromNote(float frequency, int note);
+
+    uint8_t velocityFor(float rms) const;
+
+private:
+    int candidateNote(const PitchEstimate& estimate, float rms) const;
+
+    NoteTrackerConfig config_;
+    uint64_t debounceSamples_;
+
+    int current_ = -1;
+    int pending_ = -1;
+    bool hasPending_ = false;
+    uint64_t pendingSince_ = 0;
+    float pendingPeakRms_ = 0.0f;
+};
+
+} // namespace ptm
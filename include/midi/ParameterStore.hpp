@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "utils/TripleBuffer.hpp"
+
+namespace ptm {
+
+/**
+ * Everything the user can change while the stream runs. Fixed-size, so
+ * snapshots copy without allocating.
+ */
+struct ProcessingParameters {
+    // The limits of the GUI controls; constrained() holds values to them
+    static constexpr size_t kMinWindowSize = 256;
+    static constexpr size_t kMaxWindowSize = 4096;
+    static constexpr size_t kWindowSizeStep = 256;
+    static constexpr size_t kMinHopSize = 64;
+    static constexpr size_t kMaxHopSize = 1024;
+    static constexpr size_t kHopSizeStep = 64;
+    static constexpr double kMaxDebounceMs = 100.0;
+    static constexpr size_t kMaxVoices = 8;
+
+    float amplitudeThreshold = 0.1f;  // Window RMS that starts a note, 0..1
+    size_t windowSize = 1024;
+    size_t hopSize = 256;             // At most windowSize
+    double debounceMs = 20.0;
+    uint8_t midiChannel = 1;          // 1-16
+    bool discreteMode = true;         // Whole notes only, no pitch bend
+    bool polyphonic = false;
+    size_t maxVoices = 4;
+
+    // Snapped to the nearest value the controls allow
+    ProcessingParameters constrained() const;
+};
+
+/**
+ * Hands parameter snapshots from the GUI to the analysis thread.
+ *
+ * The GUI thread publish()es a complete snapshot whenever a control moves;
+ * the analysis thread calls update() once per hop and, when it returns
+ * true, applies current() before analysing that hop. A snapshot is never
+ * seen half-written, intermediate ones are skipped when the controls move
+ * faster than the hops, and neither side waits for or allocates on behalf
+ * of the other (see TripleBuffer).
+ */
+class ParameterStore {
+public:
+    explicit ParameterStore(const ProcessingParameters& initial = {});
+
+    ParameterStore(const ParameterStore&) = delete;
+    ParameterStore& operator=(const ParameterStore&) = delete;
+
+    // GUI thread only. Out-of-range values are constrained, not rejected,
+    // since a control cannot usefully handle an error.
+    void publish(const ProcessingParameters& parameters);
+
+    // GUI thread only: the last snapshot published
+    const ProcessingParameters& published() const { return published_; }
+
+    // Analysis thread only: true if a newer snapshot is now current()
+    bool update();
+
+    // Analysis thread only
+    const ProcessingParameters& current() const { return buffer_.front().parameters; }
+    uint64_t currentVersion() const { return buffer_.front().version; }
+
+private:
+    struct Snapshot {
+        ProcessingParameters parameters;
+        uint64_t version = 0;  // Publications so far, including this one
+    };
+
+    TripleBuffer<Snapshot> buffer_;
+    ProcessingParameters published_;
+    uint64_t version_ = 0;
+};
+
+} // namespace ptm
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dsp/PolyphonicDetector.hpp"
+#include "midi/NoteTracker.hpp"
+
+namespace ptm {
+
+/**
+ * Turns per-hop polyphonic estimates into one MIDI voice per note.
+ *
+ * Each note in the configured range has its own NoteTracker lane, fed the
+ * voice's level when the estimate contains that note and silence when it
+ * does not, so every note gets the same debounce, amplitude threshold and
+ * velocity curve as the monophonic path. At most maxVoices notes sound at
+ * once: a note that would exceed that waits until another is released.
+ * Note-offs are emitted before note-ons.
+ *
+ * update() does not allocate; the returned events are valid until the
+ * next call. Not thread-safe.
+ */
+class PolyphonicNoteTracker {
+public:
+    /**
+     * @throws std::invalid_argument if the configuration is invalid
+     */
+    PolyphonicNoteTracker(const NoteTrackerConfig& config, size_t maxVoices);
+
+    /**
+     * Feed the analysis of one window
+     * @param samplePosition Position the window represents; non-decreasing
+     */
+    const std::vector<NoteEvent>& update(const PolyphonicEstimate& estimate, uint64_t samplePosition);
+
+    // End of input: release every sounding note
+    const std::vector<NoteEvent>& flush(uint64_t samplePosition);
+
+    void reset();
+
+    /**
+     * Change the voice limit in place. Notes already sounding above a
+     * lowered limit keep sounding until released.
+     * @throws std::invalid_argument if maxVoices is 0
+     */
+    void setMaxVoices(size_t maxVoices);
+
+    /**
+     * Change every lane's threshold and debounce time in place
+     * @throws std::invalid_argument as NoteTracker::setThresholds()
+     */
+    void setThresholds(float amplitudeThreshold, double debounceMs);
+
+    // Whether note's lane is sounding
+    bool isSounding(int note) const;
+
+    size_t soundingCount() const { return sounding_; }
+    size_t maxVoices() const { return maxVoices_; }
+    const NoteTrackerConfig& config() const { return config_; }
+
+private:
+    void updateLane(size_t lane, uint64_t samplePosition);
+
+    NoteTrackerConfig config_;
+    size_t maxVoices_ = 1;
+    std::vector<NoteTracker> lanes_;  // lowestNote..highestNote
+    std::array<float, 128> levels_{};
+    std::vector<NoteEvent> events_;
+    size_t sounding_ = 0;
+};
+
+} // namespace ptm
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "midi/MidiOutput.hpp"
+
+class RtMidiOut;
+
+namespace ptm {
+
+/**
+ * A MidiPort on an RtMidi output: a hardware or software port by index, or
+ * a virtual port other applications connect to (not on Windows).
+ *
+ * send() uses RtMidiOut's pointer overload, which takes the bytes as they
+ * are instead of a std::vector.
+ */
+class RtMidiPort final : public MidiPort {
+public:
+    // Output ports in index order
+    static std::vector<std::string> portNames();
+
+    /**
+     * @throws MidiOutputException if the port cannot be opened
+     */
+    explicit RtMidiPort(unsigned portIndex, const std::string& clientName = "PitchToMidi");
+
+    /**
+     * Opens a virtual port called portName
+     * @throws MidiOutputException if the API has no virtual ports
+     */
+    static std::unique_ptr<RtMidiPort> openVirtual(const std::string& portName,
+                                                   const std::string& clientName = "PitchToMidi");
+
+    ~RtMidiPort() override;
+
+    RtMidiPort(const RtMidiPort&) = delete;
+    RtMidiPort& operator=(const RtMidiPort&) = delete;
+
+    // A driver error drops the message and is counted
+    void send(const uint8_t* bytes, size_t size) override;
+    std::string describe() const override { return name_; }
+
+    uint64_t failedSends() const { return failedSends_.load(std::memory_order_relaxed); }
+
+private:
+    RtMidiPort(std::unique_ptr<RtMidiOut> out, std::string name);
+
+    std::unique_ptr<RtMidiOut> out_;
+    std::string name_;
+    std::atomic<uint64_t> failedSends_{0};
+};
+
+} // namespace ptm
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "audio/MappedWavFile.hpp"
+#include "dsp/PitchDetector.hpp"
+#include "midi/NoteTracker.hpp"
+
+namespace ptm {
+
+struct TranscriberConfig {
+    // windowSize, hopSize (must be non-zero) and YIN settings; the sample
+    // rate is taken from the input
+    PitchDetectorConfig pitch;
+    NoteTrackerConfig notes;
+    size_t blockFrames = 65536;  // Frames decoded from the mapping at a time
+
+    // Analysis threads; 0 uses every core. Does not affect the output.
+    unsigned threads = 1;
+
+    // Hops per chunk of work, rounded up to a whole number of incremental
+    // resync periods; 0 picks a default. Does not affect the output either.
+    size_t chunkHops = 0;
+};
+
+struct Transcription {
+    std::vector<NoteEvent> events;
+    double sampleRate = 0.0;
+    uint64_t frames = 0;    // Input length
+    uint64_t hops = 0;      // Windows analysed
+    uint64_t chunks = 0;
+    unsigned threads = 0;   // Threads actually used
+};
+
+/**
+ * Transcribe a whole file offline with the live path's analysis: a
+ * PitchDetector stepped one hop at a time, window RMS, and a NoteTracker.
+ * Each window is reported at its centre.
+ *
+ * The hops are split into chunks whose inputs overlap by one window less
+ * a hop, and the chunks are analysed on config.threads threads. Every
+ * chunk starts on a hop where a single continuous detector would
+ * recompute the difference function exactly anyway, so per-hop results do
+ * not depend on the split. A single NoteTracker then runs over all hops in
+ * order, which stitches notes held across chunk boundaries: the events are
+ * identical for any thread count.
+ *
+ * The input is decoded in blocks and pages already analysed are released;
+ * only the per-hop pitch and level (12 bytes a hop) are kept for the
+ * whole file.
+ *
+ * @throws std::invalid_argument or PitchDetectorException for a bad
+ *         configuration
+ */
+Transcription transcribe(const MappedWavFile& file, const TranscriberConfig& config);
+
+} // namespace ptm
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace PitchToMidi {
+
+// What a logging thread does when the async queue is full
+enum class LogOverflowPolicy {
+    Block,       // Wait for the logger thread to make room
+    DropNewest,  // Discard the message being logged
+    DropOldest   // Discard the oldest queued message to make room
+};
+
+namespace detail {
+
+constexpr size_t kLogPayloadSize = 192;
+constexpr size_t kMaxInlineStringArg = 64;
+
+// String argument copied by value, truncated to N bytes
+template<size_t N>
+struct InlineString {
+    uint16_t size;
+    char data[N];
+
+    void assign(std::string_view text) {
+        size = static_cast<uint16_t>(std::min(text.size(), N));
+        std::memcpy(data, text.data(), size);
+    }
+
+    std::string_view view() const { return std::string_view(data, size); }
+};
+
+// How an argument is stored in a record: strings by value; numbers, enums
+// and raw pointers (printed, never followed) as they are. Anything else is
+// formatted on the calling thread, since trivially copyable views such as
+// fmt::join or std::span point into the caller's frame.
+template<typename T, typename = void>
+struct LogArg {
+    using type = std::decay_t<T>;
+    static constexpr bool kDeferrable = std::is_arithmetic<type>::value ||
+                                        std::is_enum<type>::value ||
+                                        std::is_pointer<type>::value;
+    static type capture(const T& value) { return value; }
+};
+
+template<typename T>
+struct LogArg<T, std::enable_if_t<std::is_convertible<const T&, std::string_view>::value>> {
+    using type = InlineString<kMaxInlineStringArg>;
+    static constexpr bool kDeferrable = true;
+    static type capture(const T& value) {
+        type stored;
+        stored.assign(toView(value));
+        return stored;
+    }
+
+private:
+    static std::string_view toView(const char* text) { return text ? text : "(null)"; }
+    static std::string_view toView(std::string_view text) { return text; }
+};
+
+// One preallocated queue slot: level, timestamp, thread and either the
+// captured arguments or, when they cannot be captured, pre-formatted text
+struct LogRecord {
+    using FormatFn = void (*)(const LogRecord&, fmt::memory_buffer&);
+
+    spdlog::level::level_enum level;
+    spdlog::log_clock::time_point time;
+    size_t threadId;
+    fmt::string_view formatString;
+    FormatFn format;
+    alignas(std::max_align_t) unsigned char payload[kLogPayloadSize];
+};
+
+template<typename Tuple>
+void formatCaptured(const LogRecord& record, fmt::memory_buffer& out) {
+    const auto& args = *std::launder(reinterpret_cast<const Tuple*>(record.payload));
+    std::apply([&](const auto&... values) {
+        fmt::vformat_to(std::back_inserter(out), record.formatString,
+                        fmt::make_format_args(values...));
+    }, args);
+}
+
+inline void formatText(const LogRecord& record, fmt::memory_buffer& out) {
+    const auto& text = *std::launder(
+        reinterpret_cast<const InlineString<kLogPayloadSize - sizeof(uint16_t)>*>(record.payload));
+    out.append(text.data, text.data + text.size);
+}
+
+// Fill a record for fmtString/args: arguments are copied in binary form when
+// they fit, otherwise the message is formatted here and stored as text
+template<typename... Args>
+void captureRecord(LogRecord& record, fmt::format_string<Args...> fmtString, Args&&... args) {
+    using Tuple = std::tuple<typename LogArg<std::decay_t<Args>>::type...>;
+    constexpr bool kDeferrable = (LogArg<std::decay_t<Args>>::kDeferrable && ...) &&
+                                 sizeof(Tuple) <= kLogPayloadSize &&
+                                 alignof(Tuple) <= alignof(std::max_align_t);
+
+    if constexpr (kDeferrable) {
+        new (record.payload) Tuple(LogArg<std::decay_t<Args>>::capture(args)...);
+        record.formatString = fmtString;
+        record.format = &formatCaptured<Tuple>;
+    } else {
+        using Text = InlineString<kLogPayloadSize - sizeof(uint16_t)>;
+        auto* text = new (record.payload) Text;
+        auto result = fmt::format_to_n(text->data, sizeof(text->data), fmtString,
+                                        std::forward<Args>(args)...);
+        text->size = static_cast<uint16_t>(std::min(result.size, sizeof(text->data)));
+        record.format = &formatText;
+    }
+}
+
+} // namespace detail
+
+/**
+ * Bounded multi-producer multi-consumer queue of preallocated log records
+ * (sequence-numbered slots, after Dmitry Vyukov's bounded MPMC queue).
+ * Producers never allocate; the logger thread is the usual consumer, but a
+ * producer may also pop to implement LogOverflowPolicy::DropOldest.
+ */
+class AsyncLogQueue {
+public:
+    explicit AsyncLogQueue(size_t capacity)
+        : capacity_(roundUp(capacity))
+        , cells_(new Cell[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    AsyncLogQueue(const AsyncLogQueue&) = delete;
+    AsyncLogQueue& operator=(const AsyncLogQueue&) = delete;
+
+    // fill(LogRecord&) is called on a free slot; returns false if full
+    template<typename Fill>
+    bool tryPush(Fill&& fill) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & (capacity_ - 1)];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(cell.record);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // consume(const LogRecord&) is called on the oldest record; false if empty
+    template<typename Consume>
+    bool tryPop(Consume&& consume) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & (capacity_ - 1)];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    consume(static_cast<const detail::LogRecord&>(cell.record));
+                    cell.sequence.store(pos + capacity_, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        detail::LogRecord record;
+    };
+
+    static size_t roundUp(size_t value) {
+        size_t result = 2;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    const size_t capacity_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) std::atomic<size_t> dequeuePos_{0};
+};
+
+} // namespace PitchToMidi
+
+namespace fmt {
+
+template<size_t N>
+struct formatter<PitchToMidi::detail::InlineString<N>> : formatter<string_view> {
+    template<typename FormatContext>
+    auto format(const PitchToMidi::detail::InlineString<N>& text, FormatContext& ctx) const
+        -> decltype(ctx.out()) {
+        return formatter<string_view>::format(string_view(text.data, text.size), ctx);
+    }
+};
+
+} // namespace fmt
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ptm {
+
+template<typename Signature>
+class FunctionRef;
+
+/**
+ * Non-owning reference to a callable: an object pointer and a function
+ * pointer, so it never allocates and calling it is one indirect call.
+ *
+ * Unlike std::function it does not copy the callable, which must outlive
+ * every call through the reference. It therefore binds only to lvalues
+ * (and plain function pointers): binding a temporary lambda would leave it
+ * dangling as soon as the full expression ends, so that does not compile.
+ */
+template<typename R, typename... Args>
+class FunctionRef<R(Args...)> {
+public:
+    FunctionRef() noexcept = default;
+    FunctionRef(std::nullptr_t) noexcept {}
+
+    template<typename Callable,
+             typename = std::enable_if_t<!std::is_same<std::remove_cv_t<Callable>, FunctionRef>::value &&
+                                         !std::is_function<Callable>::value &&
+                                         std::is_invocable_r<R, Callable&, Args...>::value>>
+    FunctionRef(Callable& callable) noexcept
+        : object_(const_cast<void*>(static_cast<const void*>(std::addressof(callable))))
+        , invoke_(&invokeObject<Callable>) {}
+
+    // A temporary would be gone before the first call
+    template<typename Callable,
+             typename = std::enable_if_t<!std::is_lvalue_reference<Callable>::value &&
+                                         !std::is_same<std::decay_t<Callable>, FunctionRef>::value>>
+    FunctionRef(Callable&&) = delete;
+
+    FunctionRef(R (*function)(Args...)) noexcept
+        : function_(function)
+        , invoke_(function ? &invokeFunction : nullptr) {}
+
+    R operator()(Args... args) const {
+        return invoke_(*this, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+private:
+    template<typename Callable>
+    static R invokeObject(const FunctionRef& self, Args... args) {
+        return (*static_cast<Callable*>(self.object_))(std::forward<Args>(args)...);
+    }
+
+    static R invokeFunction(const FunctionRef& self, Args... args) {
+        return self.function_(std::forward<Args>(args)...);
+    }
+
+    union {
+        void* object_ = nullptr;
+        R (*function_)(Args...);
+    };
+    R (*invoke_)(const FunctionRef&, Args...) = nullptr;
+};
+
+} // namespace ptm
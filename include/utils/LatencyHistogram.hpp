@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace ptm {
+
+/**
+ * Lock-free histogram of durations in nanoseconds.
+ *
+ * Buckets are log-linear: exact below 32 ns, then 16 buckets per power of
+ * two, so a reported percentile is at most 6.25% above the true value.
+ * record() is a few relaxed atomic adds and never blocks or allocates, so
+ * any number of threads (the audio callback included) may record while
+ * another thread reads percentiles. Readers see each counter as of some
+ * recent point; a summary taken mid-update can be off by the samples in
+ * flight, never torn.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+
+    // Longer durations (above about 137 s) all land in the last bucket;
+    // max() still reports them exactly
+    static constexpr int kMaxExponent = 36;
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+    struct Summary {
+        uint64_t count = 0;
+        double meanNs = 0.0;
+        int64_t p50Ns = 0;
+        int64_t p90Ns = 0;
+        int64_t p99Ns = 0;
+        int64_t maxNs = 0;
+    };
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // Negative durations (clock skew between stamps) count as zero
+    void record(int64_t nanoseconds) {
+        const uint64_t value = nanoseconds > 0 ? static_cast<uint64_t>(nanoseconds) : 0;
+        buckets_[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t previous = max_.load(std::memory_order_relaxed);
+        while (value > previous &&
+               !max_.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t count() const {
+        uint64_t count = 0;
+        for (const auto& bucket : buckets_) {
+            count += bucket.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    int64_t max() const { return static_cast<int64_t>(max_.load(std::memory_order_relaxed)); }
+
+    // Smallest bucket bound that at least fraction (0-1) of the samples are
+    // at or below; 0 while empty
+    int64_t percentile(double fraction) const {
+        std::array<uint64_t, kBucketCount> counts;
+        uint64_t count = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            count += counts[i];
+        }
+        return percentileOf(counts, count, fraction);
+    }
+
+    Summary summary() const {
+        std::array<uint64_t, kBucketCount> counts;
+        Summary summary;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            summary.count += counts[i];
+        }
+        if (summary.count == 0) return summary;
+
+        summary.meanNs = static_cast<double>(total_.load(std::memory_order_relaxed)) /
+                         static_cast<double>(summary.count);
+        summary.p50Ns = percentileOf(counts, summary.count, 0.50);
+        summary.p90Ns = percentileOf(counts, summary.count, 0.90);
+        summary.p99Ns = percentileOf(counts, summary.count, 0.99);
+        summary.maxNs = max();
+        return summary;
+    }
+
+    // Not atomic as a whole: only reset while nothing is recording
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        total_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    static size_t bucketFor(uint64_t value) {
+        if (value < 2 * kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        int exponent = 63;
+        while (!(value >> exponent)) --exponent;
+        if (exponent > kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        const int shift = exponent - kSubBucketBits;
+        return (static_cast<size_t>(shift) << kSubBucketBits) + static_cast<size_t>(value >> shift);
+    }
+
+    // Largest value that falls into bucket index
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < 2 * kSubBuckets) {
+            return index;
+        }
+        const int shift = static_cast<int>(index >> kSubBucketBits) - 1;
+        const uint64_t subBucket = (index & (kSubBuckets - 1)) + kSubBuckets;
+        return ((subBucket + 1) << shift) - 1;
+    }
+
+private:
+    int64_t percentileOf(const std::array<uint64_t, kBucketCount>& counts, uint64_t count,
+                         double fraction) const {
+        if (count == 0) return 0;
+
+        const double clamped = std::clamp(fraction, 0.0, 1.0);
+        const uint64_t rank = std::max<uint64_t>(
+            1, static_cast<uint64_t>(std::ceil(clamped * static_cast<double>(count))));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(static_cast<int64_t>(bucketUpperBound(i)), max());
+            }
+        }
+        return max();
+    }
+
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> total_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace ptm
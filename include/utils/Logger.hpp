@@ -3,11 +3,46 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/rotating_file_sink.h>
+#include <spdlog/details/os.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+#include "utils/AsyncLogQueue.hpp"
+
+// Log statements below this level compile to nothing. Defaults to info in
+// release builds and trace otherwise; uses spdlog's SPDLOG_LEVEL_* values.
+#ifndef PTM_LOG_ACTIVE_LEVEL
+    #ifdef NDEBUG
+        #define PTM_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
+    #else
+        #define PTM_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+    #endif
+#endif
 
 namespace PitchToMidi {
 
+enum class LogMode {
+    Sync,   // Format and write on the calling thread
+    Async   // Capture arguments, format and write on the logger thread.
+            // String arguments are copied and truncated to 64 bytes;
+            // arguments other than numbers, enums, pointers and strings
+            // are formatted on the calling thread.
+};
+
+struct LoggerOptions {
+    LogMode mode = LogMode::Sync;
+    size_t queueSize = 8192;  // Async only: preallocated message slots
+    LogOverflowPolicy overflowPolicy = LogOverflowPolicy::DropNewest;
+    bool consoleOutput = true;
+};
+
 class Logger {
 public:
     static Logger& getInstance() {
@@ -15,27 +50,39 @@ public:
         return instance;
     }
 
+    ~Logger() {
+        shutdown();
+    }
+
     // Delete copy constructor and assignment operator
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    // Initialize the logger with console and file sinks
+    // Initialize the logger with console and file sinks.
+    // Not thread-safe: call before other threads start logging.
     void init(const std::string& loggerName = "PitchToMidi",
               const std::string& logFile = "logs/pitchtomidi.log",
               size_t maxFileSize = 1048576 * 5,  // 5MB
-              size_t maxFiles = 3) {
+              size_t maxFiles = 3,
+              const LoggerOptions& options = LoggerOptions{}) {
         try {
-            // Create the logs directory if it doesn't exist
-            std::filesystem::create_directories("logs");
+            shutdown();
+
+            // Create the log directory if it doesn't exist
+            std::filesystem::path logDir = std::filesystem::path(logFile).parent_path();
+            std::filesystem::create_directories(logDir.empty() ? "logs" : logDir);
 
             // Create sinks
-            auto consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-            auto fileSink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
-                logFile, maxFileSize, maxFiles);
+            std::vector<spdlog::sink_ptr> sinks;
+            if (options.consoleOutput) {
+                sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+            }
+            sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+                logFile, maxFileSize, maxFiles));
 
             // Create logger with multiple sinks
-            logger_ = std::make_shared<spdlog::logger>(loggerName, 
-                spdlog::sinks_init_list{consoleSink, fileSink});
+            spdlog::drop(loggerName);
+            logger_ = std::make_shared<spdlog::logger>(loggerName, sinks.begin(), sinks.end());
 
             // Set log pattern
             logger_->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] [%t] %v");
@@ -51,7 +98,15 @@ public:
             spdlog::register_logger(logger_);
             spdlog::set_default_logger(logger_);
 
-            logger_->info("Logger initialized successfully");
+            if (options.mode == LogMode::Async) {
+                overflowPolicy_ = options.overflowPolicy;
+                queue_ = std::make_unique<AsyncLogQueue>(options.queueSize);
+                stopRequested_ = false;
+                worker_ = std::thread(&Logger::run, this);
+            }
+
+            logger_->info("Logger initialized successfully ({} mode)",
+                          options.mode == LogMode::Async ? "async" : "sync");
         }
         catch (const spdlog::spdlog_ex& ex) {
             std::cerr << "Logger initialization failed: " << ex.what() << std::endl;
@@ -59,48 +114,185 @@ public:
         }
     }
 
+    // Stop the async logger thread after writing everything still queued.
+    // Not thread-safe: no other thread may be logging.
+    void shutdown() {
+        if (worker_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex_);
+                stopRequested_ = true;
+            }
+            wakeCondition_.notify_one();
+            worker_.join();
+        }
+        queue_.reset();
+        if (logger_) {
+            logger_->flush();
+        }
+    }
+
+    bool isAsync() const { return queue_ != nullptr; }
+
+    // Async messages discarded because the queue was full
+    uint64_t droppedMessages() const { return dropped_.load(std::memory_order_relaxed); }
+
     // Logging methods
+    template<typename... Args>
+    void log(spdlog::level::level_enum level, fmt::format_string<Args...> fmt, Args&&... args) {
+        if (!logger_ || !logger_->should_log(level)) return;
+
+        if (queue_) {
+            enqueue(level, fmt, std::forward<Args>(args)...);
+        } else {
+            logger_->log(level, fmt, std::forward<Args>(args)...);
+        }
+    }
+
     template<typename... Args>
     void trace(fmt::format_string<Args...> fmt, Args&&... args) {
-        logger_->trace(fmt, std::forward<Args>(args)...);
+        log(spdlog::level::trace, fmt, std::forward<Args>(args)...);
     }
 
     template<typename... Args>
     void debug(fmt::format_string<Args...> fmt, Args&&... args) {
-        logger_->debug(fmt, std::forward<Args>(args)...);
+        log(spdlog::level::debug, fmt, std::forward<Args>(args)...);
     }
 
     template<typename... Args>
     void info(fmt::format_string<Args...> fmt, Args&&... args) {
-        logger_->info(fmt, std::forward<Args>(args)...);
+        log(spdlog::level::info, fmt, std::forward<Args>(args)...);
     }
 
     template<typename... Args>
     void warn(fmt::format_string<Args...> fmt, Args&&... args) {
-        logger_->warn(fmt, std::forward<Args>(args)...);
+        log(spdlog::level::warn, fmt, std::forward<Args>(args)...);
     }
 
     template<typename... Args>
     void error(fmt::format_string<Args...> fmt, Args&&... args) {
-        logger_->error(fmt, std::forward<Args>(args)...);
+        log(spdlog::level::err, fmt, std::forward<Args>(args)...);
     }
 
     template<typename... Args>
     void critical(fmt::format_string<Args...> fmt, Args&&... args) {
-        logger_->critical(fmt, std::forward<Args>(args)...);
+        log(spdlog::level::critical, fmt, std::forward<Args>(args)...);
     }
 
 private:
     Logger() = default;
+
+    static constexpr std::chrono::milliseconds kIdleWait{5};
+
+    // Format strings are stored by reference: pass string literals, as the
+    // LOG_* macros do
+    template<typename... Args>
+    void enqueue(spdlog::level::level_enum level, fmt::format_string<Args...> fmt, Args&&... args) {
+        auto fill = [&](detail::LogRecord& record) {
+            record.level = level;
+            record.time = spdlog::log_clock::now();
+            record.threadId = spdlog::details::os::thread_id();
+            detail::captureRecord(record, fmt, std::forward<Args>(args)...);
+        };
+
+        while (!queue_->tryPush(fill)) {
+            switch (overflowPolicy_) {
+                case LogOverflowPolicy::DropNewest:
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case LogOverflowPolicy::DropOldest:
+                    if (queue_->tryPop([](const detail::LogRecord&) {})) {
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                case LogOverflowPolicy::Block:
+                    std::this_thread::yield();
+                    break;
+            }
+        }
+    }
+
+    // Logger thread: formats queued records and hands them to the sinks
+    void run() {
+        fmt::memory_buffer text;
+        auto write = [this, &text](const detail::LogRecord& record) {
+            text.clear();
+            try {
+                record.format(record, text);
+            } catch (const fmt::format_error& ex) {
+                text.clear();
+                fmt::format_to(std::back_inserter(text), "[log format error: {}]", ex.what());
+            }
+
+            spdlog::details::log_msg msg(record.time, spdlog::source_loc{}, logger_->name(),
+                                         record.level,
+                                         spdlog::string_view_t(text.data(), text.size()));
+            msg.thread_id = record.threadId;
+            for (auto& sink : logger_->sinks()) {
+                if (sink->should_log(msg.level)) {
+                    sink->log(msg);
+                }
+            }
+            if (record.level >= logger_->flush_level()) {
+                logger_->flush();
+            }
+        };
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        for (;;) {
+            lock.unlock();
+            bool wroteAny = false;
+            while (queue_->tryPop(write)) {
+                wroteAny = true;
+            }
+            lock.lock();
+
+            if (stopRequested_ && !wroteAny) break;
+            if (!wroteAny) {
+                // Producers never notify, so an idle logger polls
+                wakeCondition_.wait_for(lock, kIdleWait, [this] { return stopRequested_; });
+            }
+        }
+    }
+
     std::shared_ptr<spdlog::logger> logger_;
+
+    // Async mode
+    std::unique_ptr<AsyncLogQueue> queue_;
+    LogOverflowPolicy overflowPolicy_ = LogOverflowPolicy::DropNewest;
+    std::atomic<uint64_t> dropped_{0};
+    std::thread worker_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+    bool stopRequested_ = false;
 };
 
-// Convenience macros for logging
-#define LOG_TRACE(...) PitchToMidi::Logger::getInstance().trace(__VA_ARGS__)
-#define LOG_DEBUG(...) PitchToMidi::Logger::getInstance().debug(__VA_ARGS__)
-#define LOG_INFO(...) PitchToMidi::Logger::getInstance().info(__VA_ARGS__)
-#define LOG_WARN(...) PitchToMidi::Logger::getInstance().warn(__VA_ARGS__)
+// Convenience macros for logging. Levels below PTM_LOG_ACTIVE_LEVEL expand to
+// nothing, so their arguments are not even evaluated.
+#if PTM_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+    #define LOG_TRACE(...) PitchToMidi::Logger::getInstance().trace(__VA_ARGS__)
+#else
+    #define LOG_TRACE(...) (void)0
+#endif
+
+#if PTM_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+    #define LOG_DEBUG(...) PitchToMidi::Logger::getInstance().debug(__VA_ARGS__)
+#else
+    #define LOG_DEBUG(...) (void)0
+#endif
+
+#if PTM_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+    #define LOG_INFO(...) PitchToMidi::Logger::getInstance().info(__VA_ARGS__)
+#else
+    #define LOG_INFO(...) (void)0
+#endif
+
+#if PTM_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+    #define LOG_WARN(...) PitchToMidi::Logger::getInstance().warn(__VA_ARGS__)
+#else
+    #define LOG_WARN(...) (void)0
+#endif
+
 #define LOG_ERROR(...) PitchToMidi::Logger::getInstance().error(__VA_ARGS__)
 #define LOG_CRITICAL(...) PitchToMidi::Logger::getInstance().critical(__VA_ARGS__)
 
-} // namespace PitchToMidi 
\ No newline at end of file
+} // namespace PitchToMidi
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ptm {
+
+/**
+ * Catches work a real-time thread must not do, in builds configured with
+ * PTM_RT_SANITIZER (Linux only; not together with ASan or TSan, which
+ * interpose the same functions).
+ *
+ * A RealtimeScope marks the calling thread real-time until it ends; the
+ * capture callback, the analysis worker and the channel trackers open one
+ * around each block or hop. In a sanitizer build the process's malloc
+ * family, mutex, rwlock, condition-variable and semaphore waits (with
+ * their timed and clock-selecting variants), sleeps including
+ * clock_nanosleep(), thread joins and blocking read()/write() are
+ * interposed, and any call to them inside a scope is counted and reported
+ * with a stack trace (to stderr, or to a handler). A RealtimeExemption lifts the check for work
+ * that is deliberately not real-time-safe, such as test bookkeeping.
+ *
+ * In other builds every type and function here is an inline no-op, so
+ * scopes can stay in release code.
+ */
+class RealtimeSanitizer {
+public:
+#ifdef PTM_RT_SANITIZER
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+
+    // Called on the offending thread, with checks suspended so it may
+    // allocate; frames are return addresses, innermost first
+    using Handler = void (*)(const char* function, void* const* frames, int frameCount);
+
+#ifdef PTM_RT_SANITIZER
+    // nullptr restores the default: print the first few reports to stderr
+    static void setHandler(Handler handler);
+
+    // Violations so far, on every thread
+    static uint64_t violations();
+
+    static bool isRealtimeThread();
+
+    // Prefer the scope types below
+    static void enterRealtime();
+    static void leaveRealtime();
+    static void suspend();
+    static void resume();
+#else
+    static void setHandler(Handler) {}
+    static uint64_t violations() { return 0; }
+    static bool isRealtimeThread() { return false; }
+    static void enterRealtime() {}
+    static void leaveRealtime() {}
+    static void suspend() {}
+    static void resume() {}
+#endif
+};
+
+// Marks the calling thread real-time for its lifetime; scopes nest
+class RealtimeScope {
+public:
+    RealtimeScope() { RealtimeSanitizer::enterRealtime(); }
+    ~RealtimeScope() { RealtimeSanitizer::leaveRealtime(); }
+
+    RealtimeScope(const RealtimeScope&) = delete;
+    RealtimeScope& operator=(const RealtimeScope&) = delete;
+};
+
+// Suspends the checks on the calling thread for its lifetime
+class RealtimeExemption {
+public:
+    RealtimeExemption() { RealtimeSanitizer::suspend(); }
+    ~RealtimeExemption() { RealtimeSanitizer::resume(); }
+
+    RealtimeExemption(const RealtimeExemption&) = delete;
+    RealtimeExemption& operator=(const RealtimeExemption&) = delete;
+};
+
+} // namespace ptm
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__linux__)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <ctime>
+#elif defined(__APPLE__)
+    #include <dispatch/dispatch.h>
+#else
+    #include <condition_variable>
+    #include <mutex>
+#endif
+
+namespace ptm {
+
+/**
+ * Counting semaphore for waking a worker thread from the audio callback.
+ *
+ * post() never blocks or allocates: on Linux it is an atomic add plus, only
+ * when a thread is actually asleep, one futex wake; on macOS it is a
+ * dispatch semaphore. Other platforms fall back to a mutex and condition
+ * variable, which is not strictly real-time safe.
+ */
+class Semaphore {
+public:
+    explicit Semaphore(int32_t initial = 0) {
+#if defined(__linux__)
+        count_.store(initial, std::memory_order_relaxed);
+#elif defined(__APPLE__)
+        semaphore_ = dispatch_semaphore_create(initial);
+#else
+        count_ = initial;
+#endif
+    }
+
+    ~Semaphore() {
+#if defined(__APPLE__)
+        dispatch_release(semaphore_);
+#endif
+    }
+
+    Semaphore(const Semaphore&) = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+    // Add count permits and wake a waiter
+    void post(int32_t count = 1) {
+#if defined(__linux__)
+        count_.fetch_add(count, std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_seq_cst) > 0) {
+            futex(FUTEX_WAKE_PRIVATE, count, nullptr);
+        }
+#elif defined(__APPLE__)
+        for (int32_t i = 0; i < count; ++i) {
+            dispatch_semaphore_signal(semaphore_);
+        }
+#else
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            count_ += count;
+        }
+        condition_.notify_one();
+#endif
+    }
+
+    // Take a permit if one is available
+    bool tryWait() {
+#if defined(__linux__)
+        int32_t current = count_.load(std::memory_order_relaxed);
+        while (current > 0) {
+            if (count_.compare_exchange_weak(current, current - 1, std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+#elif defined(__APPLE__)
+        return dispatch_semaphore_wait(semaphore_, DISPATCH_TIME_NOW) == 0;
+#else
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ == 0) return false;
+        --count_;
+        return true;
+#endif
+    }
+
+    // Block until a permit is available and take it
+    void wait() {
+#if defined(__linux__)
+        while (!tryWait()) {
+            sleepWhileEmpty(nullptr);
+        }
+#elif defined(__APPLE__)
+        dispatch_semaphore_wait(semaphore_, DISPATCH_TIME_FOREVER);
+#else
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return count_ > 0; });
+        --count_;
+#endif
+    }
+
+    // As wait(), giving up after timeout; returns whether a permit was taken
+    bool waitFor(std::chrono::nanoseconds timeout) {
+#if defined(__linux__)
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!tryWait()) {
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero()) {
+                return false;
+            }
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+            timespec relative;
+            relative.tv_sec = static_cast<time_t>(seconds.count());
+            relative.tv_nsec = static_cast<long>((remaining - seconds).count());
+            sleepWhileEmpty(&relative);
+        }
+        return true;
+#elif defined(__APPLE__)
+        dispatch_time_t deadline = dispatch_time(DISPATCH_TIME_NOW,
+            static_cast<int64_t>(timeout.count()));
+        return dispatch_semaphore_wait(semaphore_, deadline) == 0;
+#else
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!condition_.wait_for(lock, timeout, [this] { return count_ > 0; })) {
+            return false;
+        }
+        --count_;
+        return true;
+#endif
+    }
+
+private:
+#if defined(__linux__)
+    // Sleeps only while the count is still zero: a post() between the
+    // caller's failed tryWait() and the syscall makes FUTEX_WAIT return
+    // at once. waiters_ tells post() whether the wake syscall is needed.
+    void sleepWhileEmpty(const timespec* timeout) {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        if (count_.load(std::memory_order_seq_cst) <= 0) {
+            futex(FUTEX_WAIT_PRIVATE, 0, timeout);
+        }
+        waiters_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    long futex(int op, int32_t value, const timespec* timeout) {
+        static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t),
+                      "futex needs a plain 32-bit word");
+        return syscall(SYS_futex, reinterpret_cast<int32_t*>(&count_), op, value, timeout,
+                       nullptr, 0);
+    }
+
+    std::atomic<int32_t> count_{0};
+    std::atomic<int32_t> waiters_{0};
+#elif defined(__APPLE__)
+    dispatch_semaphore_t semaphore_;
+#else
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    int32_t count_ = 0;
+#endif
+};
+
+} // namespace ptm
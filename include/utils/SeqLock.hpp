@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ptm {
+
+/**
+ * Single-writer sequence lock for publishing a small struct.
+ *
+ * store() is wait-free: it bumps the sequence to odd, copies the value in
+ * word by word and bumps it back to even, so it is safe on the audio
+ * thread. load() copies the words out and retries if the sequence was odd
+ * or changed meanwhile, which gives readers on any thread a consistent
+ * value without ever making the writer wait. The payload is held in
+ * relaxed atomics so concurrent copies are not data races.
+ */
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock copies T with memcpy");
+
+public:
+    SeqLock() { store(T{}); }
+    explicit SeqLock(const T& value) { store(value); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Writer thread only
+    void store(const T& value) {
+        Words words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Any thread
+    T load() const {
+        Words words;
+        for (;;) {
+            const uint32_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) break;
+        }
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    using Words = std::array<uint64_t, kWords>;
+
+    std::atomic<uint32_t> sequence_{0};
+    std::array<std::atomic<uint64_t>, kWords> words_{};
+};
+
+} // namespace ptm
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "utils/Semaphore.hpp"
+
+namespace ptm {
+
+/**
+ * A fixed set of worker threads running a fixed set of tasks on demand.
+ *
+ * Tasks are added before start() and identified by index. schedule() marks
+ * a task runnable and wakes one worker. It is an atomic exchange plus a
+ * Semaphore post, never blocks or allocates, and so is safe on the audio
+ * thread. A task never runs on two workers at once: scheduling one that is
+ * already running makes it run again once it returns, and any number of
+ * schedule() calls before it starts run it once. A task should therefore
+ * do all the work pending for it, and must not throw.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // 0 threads: one per hardware thread
+    explicit ThreadPool(unsigned threads = 0)
+        : threadCount_(threads ? threads : std::max(std::thread::hardware_concurrency(), 1u)) {}
+
+    ~ThreadPool() { stop(); }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Returns the task's index; only while stopped
+    size_t addTask(Task task) {
+        if (isRunning()) {
+            throw std::logic_error("Tasks cannot be added to a running pool");
+        }
+        slots_.push_back(std::make_unique<Slot>(std::move(task)));
+        return slots_.size() - 1;
+    }
+
+    void start() {
+        if (isRunning()) return;
+
+        // Nothing can be scheduled while stopped: drop leftovers
+        while (ready_.tryWait()) {}
+        for (auto& slot : slots_) {
+            slot->state.store(kIdle, std::memory_order_relaxed);
+        }
+        stopRequested_.store(false, std::memory_order_relaxed);
+
+        workers_.reserve(threadCount_);
+        for (unsigned t = 0; t < threadCount_; ++t) {
+            workers_.emplace_back(&ThreadPool::run, this);
+        }
+    }
+
+    // Waits for running tasks to return; scheduled ones that have not
+    // started yet are dropped
+    void stop() {
+        if (!isRunning()) return;
+
+        stopRequested_.store(true, std::memory_order_release);
+        ready_.post(static_cast<int32_t>(workers_.size()));
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+        workers_.clear();
+    }
+
+    // Any thread, once started
+    void schedule(size_t task) {
+        std::atomic<uint32_t>& state = slots_[task]->state;
+        uint32_t current = state.load(std::memory_order_acquire);
+        for (;;) {
+            if (current == kIdle) {
+                if (state.compare_exchange_weak(current, kScheduled, std::memory_order_acq_rel)) {
+                    ready_.post();
+                    return;
+                }
+            } else if (current == kRunning) {
+                if (state.compare_exchange_weak(current, kRescheduled, std::memory_order_acq_rel)) {
+                    return;
+                }
+            } else {
+                return;  // Will run anyway
+            }
+        }
+    }
+
+    bool isRunning() const { return !workers_.empty(); }
+    unsigned threadCount() const { return threadCount_; }
+    size_t taskCount() const { return slots_.size(); }
+
+private:
+    enum : uint32_t { kIdle, kScheduled, kRunning, kRescheduled };
+
+    struct Slot {
+        explicit Slot(Task t) : task(std::move(t)) {}
+        Task task;
+        std::atomic<uint32_t> state{kIdle};
+    };
+
+    void run() {
+        for (;;) {
+            ready_.wait();
+            if (stopRequested_.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            // Each permit stands for one scheduled task nobody has claimed
+            // yet, so the search always ends; start at a different slot
+            // each time so no task is favoured
+            const size_t first = cursor_.fetch_add(1, std::memory_order_relaxed);
+            for (size_t i = 0;; ++i) {
+                Slot& slot = *slots_[(first + i) % slots_.size()];
+                uint32_t expected = kScheduled;
+                if (slot.state.compare_exchange_strong(expected, kRunning,
+                                                       std::memory_order_acq_rel)) {
+                    runSlot(slot);
+                    break;
+                }
+            }
+        }
+    }
+
+    void runSlot(Slot& slot) {
+        for (;;) {
+            slot.task();
+            uint32_t expected = kRunning;
+            if (slot.state.compare_exchange_strong(expected, kIdle, std::memory_order_acq_rel)) {
+                return;
+            }
+            // Scheduled again while it ran
+            slot.state.store(kRunning, std::memory_order_relaxed);
+        }
+    }
+
+    const unsigned threadCount_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::vector<std::thread> workers_;
+    Semaphore ready_;
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<size_t> cursor_{0};
+};
+
+} // namespace ptm
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ptm {
+
+/**
+ * Single-writer, single-reader handoff of the latest value of a struct.
+ *
+ * There are three slots: the writer fills its back slot and publish()
+ * swaps it with the middle one; the reader's update() swaps the middle
+ * slot with its front slot if something new was published since. Each
+ * side only ever touches its own slot and the one atomic byte, so neither
+ * waits for the other, and a reader that falls behind simply skips to the
+ * newest value. All three slots are allocated up front: as long as
+ * assigning a T does not allocate, neither side ever does.
+ *
+ * Unlike SeqLock, the reader holds a stable reference to its snapshot
+ * between updates, and T need not be trivially copyable.
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(const T& initial) {
+        for (Slot& slot : slots_) slot.value = initial;
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer thread only: the slot to fill before publish()
+    T& back() { return slots_[back_].value; }
+
+    // Writer thread only: hand back() to the reader
+    void publish() {
+        back_ = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel) &
+                kIndexMask;
+    }
+
+    void publish(const T& value) {
+        back() = value;
+        publish();
+    }
+
+    // Reader thread only: true if a newer value is now in front()
+    bool update() {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    // Reader thread only; unchanged until the next update()
+    const T& front() const { return slots_[front_].value; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    // Each slot on its own cache line, so the two sides never share one
+    struct alignas(64) Slot {
+        T value{};
+    };
+
+    std::array<Slot, 3> slots_;
+    uint8_t back_ = 0;                 // Writer
+    alignas(64) std::atomic<uint8_t> middle_{1};
+    alignas(64) uint8_t front_ = 2;    // Reader
+};
+
+} // namespace ptm
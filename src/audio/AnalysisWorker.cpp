@@ -0,0 +1,102 @@
+#include "audio/AnalysisWorker.hpp"
+#include "utils/RealtimeSanitizer.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace ptm {
+
+AnalysisWorker::AnalysisWorker(MirroredRingBuffer<float>& buffer, const AnalysisConfig& config,
+                               AnalysisCallback callback, LatencyMonitor* latencyMonitor)
+    : buffer_(buffer)
+    , config_(config)
+    , callback_(std::move(callback))
+    , latencyMonitor_(latencyMonitor) {
+    if (config_.hopSize == 0 || config_.hopSize > config_.windowSize) {
+        throw std::invalid_argument("Hop size must be between 1 and the window size");
+    }
+    if (config_.windowSize + config_.hopSize > buffer_.capacity()) {
+        throw std::invalid_argument("Window size " + std::to_string(config_.windowSize) +
+                                    " plus a hop does not fit the " +
+                                    std::to_string(buffer_.capacity()) + "-sample buffer");
+    }
+    if (!callback_) {
+        throw std::invalid_argument("Analysis callback must not be empty");
+    }
+}
+
+AnalysisWorker::~AnalysisWorker() {
+    stop();
+}
+
+void AnalysisWorker::start() {
+    if (thread_.joinable()) return;
+
+    // Nothing is writing yet: drop stale wake-ups and counts
+    while (hopsReady_.tryWait()) {}
+    pendingSamples_ = 0;
+    seenOverflowCount_ = buffer_.overflowCount();
+    hopIndex_ = 0;
+    discontinuity_ = false;
+    stopRequested_.store(false, std::memory_order_relaxed);
+
+    thread_ = std::thread(&AnalysisWorker::run, this);
+}
+
+void AnalysisWorker::stop() {
+    if (!thread_.joinable()) return;
+
+    stopRequested_.store(true, std::memory_order_release);
+    hopsReady_.post();
+    thread_.join();
+}
+
+void AnalysisWorker::run() {
+    for (;;) {
+        hopsReady_.wait();
+        if (stopRequested_.load(std::memory_order_acquire)) {
+            break;
+        }
+        processHop();
+    }
+}
+
+void AnalysisWorker::processHop() {
+    // The callback's analysis too: it has a hop's time at most
+    RealtimeScope realtime;
+    accountForDroppedSamples();
+
+    // Fewer than windowSize samples while the first window fills, or after
+    // the ring dropped data: wait for the next hop
+    const float* window = buffer_.peek(config_.windowSize);
+    if (!window) return;
+
+    LatencyStamp latency;
+    if (latencyMonitor_) {
+        latency = latencyMonitor_->recordRead(buffer_.peekPosition() + config_.windowSize);
+    }
+
+    callback_(AnalysisFrame{window, config_.windowSize, hopIndex_, discontinuity_, latency});
+    discontinuity_ = false;
+    ++hopIndex_;
+    processedHops_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!buffer_.consume(config_.hopSize)) {
+        // The producer moved the reader while the callback ran; the window
+        // it saw may have been partly overwritten
+        discontinuity_ = true;
+    }
+}
+
+void AnalysisWorker::accountForDroppedSamples() {
+    const uint64_t overflowCount = buffer_.overflowCount();
+    if (overflowCount == seenOverflowCount_) return;
+
+    const uint64_t dropped = overflowCount - seenOverflowCount_;
+    const uint64_t missed = (dropped + config_.hopSize - 1) / config_.hopSize;
+    seenOverflowCount_ = overflowCount;
+    hopIndex_ += missed;
+    missedHops_.fetch_add(missed, std::memory_order_relaxed);
+    discontinuity_ = true;
+}
+
+} // namespace ptm
@@ -1,77 +1,57 @@
 #include "audio/AudioCapture.hpp"
+#include "audio/PortAudioSource.hpp"
+#include "utils/RealtimeSanitizer.hpp"
 #include <spdlog/spdlog.h>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <thread>
 
 namespace ptm {
 
 namespace {
-    // Common sample rates to test for support
-    const std::vector<double> kCommonSampleRates = {
-        8000.0, 11025.0, 16000.0, 22050.0, 32000.0, 44100.0, 48000.0, 88200.0, 96000.0
-    };
-
     constexpr double kMaxAllowedLatency = 0.020;  // 20ms maximum latency
     constexpr unsigned int kMinBufferSize = 64;    // Minimum safe buffer size
     constexpr unsigned int kMaxBufferSize = 2048;  // Maximum safe buffer size
-    
-    // Struct to track stream performance
-    struct StreamStats {
-        std::atomic<double> currentLatency{0.0};
-        std::atomic<uint32_t> underruns{0};
-        std::atomic<uint32_t> overruns{0};
-    };
-
-    // Helper function to test if a sample rate is supported
-    bool testSampleRate(PaStreamParameters* inputParams, double sampleRate) {
-        return Pa_IsFormatSupported(inputParams, nullptr, sampleRate) == paFormatIsSupported;
-    }
+    constexpr std::chrono::milliseconds kSlowCallbackThreshold{1};
 
-    // Helper function to get supported sample rates for a device
-    std::set<double> getSupportedRates(const PaDeviceInfo* deviceInfo, PaDeviceIndex deviceIndex) {
-        std::set<double> supported;
-        
-        PaStreamParameters inputParams;
-        inputParams.device = deviceIndex;
-        inputParams.channelCount = 1;  // Mono input
-        inputParams.sampleFormat = paFloat32;
-        inputParams.suggestedLatency = deviceInfo->defaultLowInputLatency;
-        inputParams.hostApiSpecificStreamInfo = nullptr;
-
-        for (double rate : kCommonSampleRates) {
-            if (testSampleRate(&inputParams, rate)) {
-                supported.insert(rate);
-            }
-        }
-
-        return supported;
-    }
+    // Health limits, per StreamStats window
+    constexpr uint64_t kMaxXrunsPerWindow = 2;
+    constexpr std::chrono::nanoseconds kStalledStreamTimeout = std::chrono::milliseconds(500);
 }
 
 AudioCapture::AudioCapture() 
-    : stream_(nullptr)
+    : deviceRegistry_([this] { return scanDevices(); }, &DeviceRegistry::probePortAudioRate)
     , currentDevice_(paNoDevice)
     , isInitialized_(false)
-    , audioBuffer_(kDefaultBufferSize) {
+    , audioBuffer_(kDefaultBufferSize, kDefaultOverflowPolicy) {
     
     PaError err = Pa_Initialize();
     if (err != paNoError) {
-        setState(StreamState::Error);
-        lastError_ = Pa_GetErrorText(err);
-        throw AudioCaptureException(std::string("Failed to initialize PortAudio: ") + lastError_);
+        setError(Pa_GetErrorText(err));
+        throw AudioCaptureException(std::string("Failed to initialize PortAudio: ") +
+                                    Pa_GetErrorText(err));
     }
     isInitialized_ = true;
+    portAudioFresh_ = true;
     setState(StreamState::Closed);
     spdlog::info("PortAudio initialized successfully");
 
-    // Cache initial device list
-    lastKnownDevices_ = enumerateDevices();
+    // Cache initial device list; sample rates are probed when first asked for
+    deviceRegistry_.refresh();
+
+    // Callback failures become the stream's error off the audio thread
+    diagnostics_.setEventHandler([this](const CaptureEvent& event) {
+        if (event.kind == CaptureEventKind::NullInput) {
+            setError("Null input buffer in audio callback");
+        }
+    });
 }
 
 AudioCapture::~AudioCapture() {
+    deviceRegistry_.stopMonitoring();
     if (isInitialized_) {
-        if (stream_) {
+        if (source_) {
             shutdownStream();
         }
         Pa_Terminate();
@@ -80,91 +60,85 @@ AudioCapture::~AudioCapture() {
 }
 
 std::vector<AudioDevice> AudioCapture::enumerateDevices() {
-    std::vector<AudioDevice> devices;
-    int numDevices = Pa_GetDeviceCount();
-    
-    if (numDevices < 0) {
-        throw AudioCaptureException(std::string("Error getting device count: ") + 
-                                  Pa_GetErrorText(numDevices));
-    }
-
-    PaDeviceIndex defaultInput = Pa_GetDefaultInputDevice();
-
-    for (int i = 0; i < numDevices; i++) {
-        const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(i);
-        if (deviceInfo && deviceInfo->maxInputChannels > 0) {
-            AudioDevice device;
-            device.index = i;
-            device.name = deviceInfo->name;
-            device.hostApi = Pa_GetHostApiInfo(deviceInfo->hostApi)->name;
-            device.defaultSampleRate = deviceInfo->defaultSampleRate;
-            device.sampleRates = getSupportedRates(deviceInfo, i);
-            device.maxInputChannels = deviceInfo->maxInputChannels;
-            device.defaultLatency = deviceInfo->defaultLowInputLatency;
-            device.minLatency = deviceInfo->defaultLowInputLatency;
-            device.isDefaultInput = (i == defaultInput);
-            
-            devices.push_back(device);
-            
-            spdlog::debug("Found input device: {} ({})", device.name, device.hostApi);
-            for (double rate : device.sampleRates) {
-                spdlog::debug("  Supported rate: {} Hz", rate);
-            }
+    deviceRegistry_.refresh();
+    std::vector<AudioDevice> devices = deviceRegistry_.devices();
+
+    for (auto& device : devices) {
+        device.sampleRates = deviceRegistry_.supportedSampleRates(device);
+
+        spdlog::debug("Found input device: {} ({})", device.name, device.hostApi);
+        for (double rate : device.sampleRates) {
+            spdlog::debug("  Supported rate: {} Hz", rate);
         }
     }
 
     return devices;
 }
 
-void AudioCapture::checkDeviceChanges() {
-    auto currentDevices = enumerateDevices();
-    
-    // Check if the device list has changed
-    bool hasChanged = currentDevices.size() != lastKnownDevices_.size();
-    if (!hasChanged) {
-        for (size_t i = 0; i < currentDevices.size(); ++i) {
-            if (currentDevices[i].index != lastKnownDevices_[i].index ||
-                currentDevices[i].name != lastKnownDevices_[i].name) {
-                hasChanged = true;
-                break;
-            }
-        }
-    }
+void AudioCapture::onDeviceListChanged(const std::vector<AudioDevice>& devices) {
+    // Check if current device is still available. The stream is left to the
+    // thread that owns it; isStreamHealthy() reports the loss.
+    {
+        std::lock_guard<std::mutex> lock(currentDeviceMutex_);
+        if (!currentDeviceId_.empty()) {
+            bool deviceStillExists = std::any_of(devices.begin(), devices.end(),
+                [this](const AudioDevice& device) { return device.id == currentDeviceId_; });
 
-    if (hasChanged) {
-        spdlog::info("Audio device list has changed");
-        lastKnownDevices_ = currentDevices;
-        
-        // Check if current device is still available
-        if (currentDevice_ != paNoDevice) {
-            bool deviceStillExists = false;
-            for (const auto& device : currentDevices) {
-                if (device.index == currentDevice_) {
-                    deviceStillExists = true;
-                    break;
-                }
-            }
-            
-            if (!deviceStillExists && stream_) {
+            if (!deviceStillExists && !currentDeviceLost_.exchange(true)) {
                 spdlog::warn("Current audio device has been disconnected");
-                stop();  // Stop the stream as the device is no longer available
-                currentDevice_ = paNoDevice;
             }
         }
+    }
+
+    // Notify callback if registered
+    if (deviceChangeCallback_) {
+        deviceChangeCallback_(devices);
+    }
+}
 
-        // Notify callback if registered
-        if (deviceChangeCallback_) {
-            deviceChangeCallback_(currentDevices);
+// Called by the registry, which serialises it with its rate probes.
+// PortAudio only learns of devices added or removed in Pa_Initialize(), so
+// re-initialise it unless a stream is open or it has just been initialised.
+std::vector<AudioDevice> AudioCapture::scanDevices() {
+    std::lock_guard<std::mutex> lock(portAudioMutex_);
+    if (!streamOpen_ && !portAudioFresh_) {
+        if (isInitialized_) {
+            Pa_Terminate();
+            isInitialized_ = false;
+        }
+        PaError err = Pa_Initialize();
+        if (err != paNoError) {
+            throw AudioCaptureException(std::string("Failed to re-initialize PortAudio: ") +
+                                        Pa_GetErrorText(err));
         }
+        isInitialized_ = true;
     }
+    portAudioFresh_ = false;
+    return DeviceRegistry::scanPortAudioDevices();
+}
+
+void AudioCapture::setStreamOpen(bool open) {
+    std::lock_guard<std::mutex> lock(portAudioMutex_);
+    streamOpen_ = open;
 }
 
 void AudioCapture::setDeviceChangeCallback(DeviceListCallback callback) {
+    // The monitor thread reads the callback, so swap it while stopped
+    deviceRegistry_.stopMonitoring();
     deviceChangeCallback_ = std::move(callback);
+    if (deviceChangeCallback_) {
+        deviceRegistry_.startMonitoring([this](const std::vector<AudioDevice>& devices) {
+            onDeviceListChanged(devices);
+        });
+    }
 }
 
 PaDeviceIndex AudioCapture::getDefaultInputDevice() const {
-    PaDeviceIndex defaultDevice = Pa_GetDefaultInputDevice();
+    PaDeviceIndex defaultDevice;
+    {
+        std::lock_guard<std::mutex> lock(portAudioMutex_);
+        defaultDevice = Pa_GetDefaultInputDevice();
+    }
     if (defaultDevice == paNoDevice) {
         throw AudioCaptureException("No default input device available");
     }
@@ -194,25 +168,38 @@ std::vector<double> AudioCapture::getSupportedSampleRates() const {
 }
 
 void AudioCapture::setDevice(PaDeviceIndex deviceIndex) {
-    if (stream_) {
-        throw AudioCaptureException("Cannot change device while stream is active");
+    std::optional<AudioDevice> device = deviceRegistry_.find(deviceIndex);
+    if (!device) {
+        throw AudioCaptureException("Invalid device index");
     }
 
-    const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(deviceIndex);
-    if (!deviceInfo) {
-        throw AudioCaptureException("Invalid device index");
+    // Only this device's rates are probed
+    device->sampleRates = deviceRegistry_.supportedSampleRates(*device);
+
+    // A running stream moves to the new device at the same rate and block size
+    if (source_) {
+        if (!device->supportsSampleRate(streamSampleRate_)) {
+            throw AudioCaptureException("Device does not support the stream's sample rate: " +
+                                        std::to_string(streamSampleRate_));
+        }
+        if (device->maxInputChannels < static_cast<int>(streamChannels_)) {
+            throw AudioCaptureException("Device has fewer than the stream's " +
+                                        std::to_string(streamChannels_) + " input channels");
+        }
+        switchSource(std::make_unique<PortAudioSource>(deviceIndex, streamSampleRate_,
+                                                       framesPerBuffer_,
+                                                       std::min(device->defaultLatency,
+                                                                kMaxAllowedLatency),
+                                                       streamChannels_));
     }
 
     // Cache device information
-    currentDeviceInfo_.index = deviceIndex;
-    currentDeviceInfo_.name = deviceInfo->name;
-    currentDeviceInfo_.hostApi = Pa_GetHostApiInfo(deviceInfo->hostApi)->name;
-    currentDeviceInfo_.defaultSampleRate = deviceInfo->defaultSampleRate;
-    currentDeviceInfo_.sampleRates = getSupportedRates(deviceInfo, deviceIndex);
-    currentDeviceInfo_.maxInputChannels = deviceInfo->maxInputChannels;
-    currentDeviceInfo_.defaultLatency = deviceInfo->defaultLowInputLatency;
-    currentDeviceInfo_.minLatency = deviceInfo->defaultLowInputLatency;
-    currentDeviceInfo_.isDefaultInput = (deviceIndex == Pa_GetDefaultInputDevice());
+    currentDeviceInfo_ = *device;
+    {
+        std::lock_guard<std::mutex> lock(currentDeviceMutex_);
+        currentDeviceId_ = currentDeviceInfo_.id;
+        currentDeviceLost_ = false;
+    }
 
     currentDevice_ = deviceIndex;
     spdlog::info("Selected audio device: {} ({})", currentDeviceInfo_.name, 
@@ -220,17 +207,15 @@ void AudioCapture::setDevice(PaDeviceIndex deviceIndex) {
 }
 
 void AudioCapture::start(double sampleRate, unsigned int framesPerBuffer,
-                        std::function<void(const float*, unsigned long)> callback) {
+                        CaptureCallback callback) {
     if (currentDevice_ == paNoDevice) {
-        setState(StreamState::Error);
-        lastError_ = "No device selected";
-        throw AudioCaptureException(lastError_);
+        setError("No device selected");
+        throw AudioCaptureException("No device selected");
     }
 
-    if (stream_) {
-        setState(StreamState::Error);
-        lastError_ = "Stream already active";
-        throw AudioCaptureException(lastError_);
+    if (source_) {
+        setError("Stream already active");
+        throw AudioCaptureException("Stream already active");
     }
 
     setState(StreamState::Opening);
@@ -248,97 +233,115 @@ void AudioCapture::start(double sampleRate, unsigned int framesPerBuffer,
                                       std::to_string(kMaxBufferSize));
         }
 
+        if (static_cast<int>(channelCount_) > currentDeviceInfo_.maxInputChannels) {
+            throw AudioCaptureException("Device has " +
+                                        std::to_string(currentDeviceInfo_.maxInputChannels) +
+                                        " input channels, " + std::to_string(channelCount_) +
+                                        " requested");
+        }
+
         // Calculate expected latency
         double expectedLatency = static_cast<double>(framesPerBuffer) / sampleRate;
         if (expectedLatency > kMaxAllowedLatency) {
             spdlog::warn("Buffer size may introduce latency ({:.1f}ms) above target (20ms)", 
                         expectedLatency * 1000.0);
         }
+    } catch (...) {
+        setState(StreamState::Error);
+        throw;
+    }
 
-        userCallback_ = callback;
-        streamStats_ = std::make_unique<StreamStats>();
-
-        PaStreamParameters inputParameters;
-        inputParameters.device = currentDevice_;
-        inputParameters.channelCount = 1;  // Mono input
-        inputParameters.sampleFormat = paFloat32;
-        inputParameters.suggestedLatency = std::min(currentDeviceInfo_.defaultLatency, 
-                                                  kMaxAllowedLatency);
-        inputParameters.hostApiSpecificStreamInfo = nullptr;
-
-        PaError err = Pa_OpenStream(&stream_,
-                                   &inputParameters,
-                                   nullptr,  // No output
-                                   sampleRate,
-                                   framesPerBuffer,
-                                   paClipOff | paDitherOff,
-                                   AudioCapture::paCallback,
-                                   this);
-
-        if (err != paNoError) {
-            stream_ = nullptr;
-            streamStats_.reset();
-            setState(StreamState::Error);
-            lastError_ = Pa_GetErrorText(err);
-            throw AudioCaptureException(std::string("Failed to open stream: ") + lastError_);
-        }
-
-        err = Pa_StartStream(stream_);
-        if (err != paNoError) {
-            Pa_CloseStream(stream_);
-            stream_ = nullptr;
-            streamStats_.reset();
-            setState(StreamState::Error);
-            lastError_ = Pa_GetErrorText(err);
-            throw AudioCaptureException(std::string("Failed to start stream: ") + lastError_);
-        }
-
-        setState(StreamState::Running);
-        // Log stream info
-        const PaStreamInfo* streamInfo = Pa_GetStreamInfo(stream_);
-        if (streamInfo) {
-            spdlog::info("Audio stream started: {:.1f} Hz, {} frames/buffer, {:.1f}ms latency", 
-                         streamInfo->sampleRate, framesPerBuffer, 
-                         streamInfo->inputLatency * 1000.0);
-        } else {
-            spdlog::info("Audio stream started: {:.1f} Hz, {} frames/buffer", 
-                         sampleRate, framesPerBuffer);
-        }
+    // PortAudio may have been re-initialised since setDevice(), renumbering
+    // the devices; with the stream marked open it is not again until stop()
+    setStreamOpen(true);
+    std::optional<AudioDevice> device;
+    try {
+        deviceRegistry_.refresh();
+        device = deviceRegistry_.find(currentDeviceInfo_.id);
     } catch (...) {
+        setStreamOpen(false);
         setState(StreamState::Error);
         throw;
     }
+    if (!device) {
+        setStreamOpen(false);
+        const std::string message = "Selected device is no longer available: " +
+                                    currentDeviceInfo_.name;
+        setError(message);
+        throw AudioCaptureException(message);
+    }
+    currentDevice_ = device->index;
+
+    framesPerBuffer_ = framesPerBuffer;
+    start(std::make_unique<PortAudioSource>(currentDevice_, sampleRate, framesPerBuffer,
+                                            std::min(currentDeviceInfo_.defaultLatency,
+                                                     kMaxAllowedLatency),
+                                            channelCount_),
+          callback);
 }
 
-bool AudioCapture::shutdownStream() {
-    if (!stream_) return true;
+void AudioCapture::start(std::unique_ptr<AudioSource> source,
+                        CaptureCallback callback) {
+    if (!source) {
+        throw AudioCaptureException("Audio source must not be null");
+    }
 
-    shutdownRequested_ = true;
-    setState(StreamState::Stopping);
+    if (source_) {
+        setError("Stream already active");
+        throw AudioCaptureException("Stream already active");
+    }
 
-    // Wait for any pending callbacks to complete
-    if (!waitForState(StreamState::Stopping, kShutdownTimeout)) {
-        spdlog::error("Timeout waiting for stream to stop");
-        return false;
+    setState(StreamState::Opening);
+    setStreamOpen(true);
+
+    userCallback_ = callback;
+    streamSampleRate_ = source->sampleRate();
+    streamChannels_ = std::max(source->channels(), 1u);
+    // A block never leaves more than the ring's capacity in it
+    firstChannel_.assign(streamChannels_ > 1 ? audioBuffer_.capacity() : 0, 0.0f);
+    streamStats_.begin(streamSampleRate_);
+    lastBlockEndNs_.store(0, std::memory_order_relaxed);
+
+    latencyMonitor_.beginStream(source->sampleRate());
+    diagnostics_.start();
+    if (analysisWorker_) {
+        analysisWorker_->start();
     }
 
-    PaError err = Pa_StopStream(stream_);
-    if (err != paNoError) {
-        lastError_ = Pa_GetErrorText(err);
-        spdlog::error("Error stopping stream: {}", lastError_);
-        setState(StreamState::Error);
-        return false;
+    try {
+        source->start(sinks_[activeSlot_.load()]);
+    } catch (const AudioCaptureException& e) {
+        stopWorkers();
+        setStreamOpen(false);
+        setError(e.what());
+        throw;
     }
 
-    err = Pa_CloseStream(stream_);
-    if (err != paNoError) {
-        lastError_ = Pa_GetErrorText(err);
-        spdlog::error("Error closing stream: {}", lastError_);
-        setState(StreamState::Error);
+    source_ = std::move(source);
+    setState(StreamState::Running);
+    spdlog::info("Audio stream started: {}", source_->describe());
+}
+
+bool AudioCapture::shutdownStream() {
+    if (!source_) return true;
+
+    // The callback finishes from its next block on; stop() returns once
+    // the last one has
+    shutdownRequested_ = true;
+    setState(StreamState::Stopping);
+
+    try {
+        source_->stop();
+    } catch (const AudioCaptureException& e) {
+        spdlog::error("{}", e.what());
+        setError(e.what());
         return false;
     }
 
-    stream_ = nullptr;
+    source_.reset();
+    setStreamOpen(false);
+    stopWorkers();
+    logLatencyReport();
     clearAudioBuffer();
     setState(StreamState::Closed);
     shutdownRequested_ = false;
@@ -347,14 +350,16 @@ bool AudioCapture::shutdownStream() {
 }
 
 void AudioCapture::stop() {
-    if (!stream_) return;
+    if (!source_) return;
     
     if (!shutdownStream()) {
         // If graceful shutdown fails, force cleanup
-        if (stream_) {
-            Pa_AbortStream(stream_);
-            Pa_CloseStream(stream_);
-            stream_ = nullptr;
+        if (source_) {
+            source_->abort();
+            source_.reset();
+            setStreamOpen(false);
+            stopWorkers();
+            logLatencyReport();
             clearAudioBuffer();
             setState(StreamState::Closed);
             spdlog::warn("Forced stream shutdown after graceful shutdown failed");
@@ -362,137 +367,374 @@ void AudioCapture::stop() {
     }
 }
 
+// The callback no longer runs: nothing else will post to the workers
+void AudioCapture::stopWorkers() {
+    if (analysisWorker_) {
+        analysisWorker_->stop();
+    }
+    diagnostics_.stop();
+}
+
+void AudioCapture::logLatencyReport() const {
+    const std::string report = latencyMonitor_.report();
+    if (report.empty()) return;
+
+    spdlog::info("Latency per stage since the monitor was last reset:");
+    size_t lineStart = 0;
+    while (lineStart < report.size()) {
+        size_t lineEnd = report.find('\n', lineStart);
+        spdlog::info("  {}", report.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+    }
+}
+
 bool AudioCapture::isStreamHealthy() const {
-    if (!stream_) return false;
+    if (!source_) return false;
     
     StreamState state = streamState_.load();
     if (state == StreamState::Error) return false;
     if (state != StreamState::Running) return true; // Not an error if not running
     
     // Check if stream is actually active
-    if (Pa_IsStreamActive(stream_) != 1) return false;
+    if (!source_->isActive()) return false;
+    if (currentDeviceLost_.load()) return false;
     
-    // Check performance metrics
-    if (streamStats_) {
-        if (streamStats_->currentLatency.load() > kMaxAllowedLatency) return false;
-        if (streamStats_->overruns.load() > 10) return false;  // Too many overruns
-        if (streamStats_->underruns.load() > 10) return false; // Too many underruns
+    // Check performance metrics over the last complete window, so old
+    // trouble does not count against the stream forever
+    const StreamStatsSnapshot stats = streamStats_.snapshot();
+    if (stats.lastCallbackNs != 0 &&
+        LatencyMonitor::now() - stats.lastCallbackNs > kStalledStreamTimeout.count()) {
+        return false;  // Callbacks stopped arriving
     }
+    if (stats.currentLatency > kMaxAllowedLatency) return false;
+    if (stats.recent.underruns + stats.recent.overruns > kMaxXrunsPerWindow) return false;
+    if (stats.recent.maxLoad > 1.0) return false;  // A callback overran its buffer period
     
     return true;
 }
 
 void AudioCapture::setState(StreamState newState) {
-    streamState_.store(newState);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        streamState_.store(newState);
+    }
+    stateChanged_.notify_all();
 }
 
-bool AudioCapture::waitForState(StreamState expectedState, 
-                              std::chrono::milliseconds timeout) const {
-    auto start = std::chrono::steady_clock::now();
-    while (std::chrono::steady_clock::now() - start < timeout) {
-        if (streamState_.load() == expectedState) {
-            return true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+void AudioCapture::setError(const std::string& message, StreamState newState) {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        lastError_ = message;
+        streamState_.store(newState);
     }
-    return false;
+    stateChanged_.notify_all();
+}
+
+bool AudioCapture::waitForState(StreamState expectedState,
+                                std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    return stateChanged_.wait_for(lock, timeout, [this, expectedState] {
+        return streamState_.load() == expectedState;
+    });
 }
 
 bool AudioCapture::isActive() const {
-    return stream_ != nullptr && 
-           streamState_.load() == StreamState::Running &&
-           Pa_IsStreamActive(stream_) == 1;
+    const StreamState state = streamState_.load();
+    return source_ != nullptr && 
+           (state == StreamState::Running || state == StreamState::Switching) &&
+           source_->isActive();
 }
 
-int AudioCapture::paCallback(const void* inputBuffer, void* outputBuffer,
-                           unsigned long framesPerBuffer,
-                           const PaStreamCallbackTimeInfo* timeInfo,
-                           PaStreamCallbackFlags statusFlags,
-                           void* userData) {
-    (void)outputBuffer;  // Unused
-    
-    auto* instance = static_cast<AudioCapture*>(userData);
-    
+// Runs on the source's thread: the driver callback for a device. During a
+// switch two sources call in, but only the active slot's blocks go further
+// than this.
+SinkStatus AudioCapture::processBlock(unsigned slot, const float* input, size_t framesPerBuffer,
+                                      const AudioBlockInfo& info) {
+    RealtimeScope realtime;
+
     // Check for shutdown request
-    if (instance->shutdownRequested_.load()) {
-        return paComplete;
-    }
-
-    const float* input = static_cast<const float*>(inputBuffer);
-
-    // Performance monitoring
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Update performance metrics
-    if (instance->streamStats_) {
-        // Calculate actual latency
-        if (timeInfo) {
-            double currentLatency = timeInfo->currentTime - timeInfo->inputBufferAdcTime;
-            instance->streamStats_->currentLatency.store(currentLatency);
-            
-            // Log high latency events with more detail
-            if (currentLatency > kMaxAllowedLatency) {
-                spdlog::warn("High latency detected: {:.1f}ms (ADC: {:.6f}, Current: {:.6f})", 
-                            currentLatency * 1000.0,
-                            timeInfo->inputBufferAdcTime,
-                            timeInfo->currentTime);
-            }
+    if (shutdownRequested_.load()) {
+        return SinkStatus::Complete;
+    }
+
+    if (slot != activeSlot_.load(std::memory_order_acquire)) {
+        // A source that has handed over is finished
+        if (slot != incomingSlot_.load(std::memory_order_acquire)) {
+            return SinkStatus::Complete;
         }
 
-        // Enhanced buffer under/overrun logging
-        if (statusFlags & paInputUnderflow) {
-            instance->streamStats_->underruns++;
-            spdlog::warn("Audio input underrun #{} detected", 
-                        instance->streamStats_->underruns.load());
+        // The incoming source is running; its audio is not needed until
+        // the old source hands over
+        switchOverlapFrames_.fetch_add(framesPerBuffer, std::memory_order_relaxed);
+        SwitchPhase expected = SwitchPhase::Waiting;
+        if (switchPhase_.compare_exchange_strong(expected, SwitchPhase::Ready,
+                                                 std::memory_order_acq_rel)) {
+            switchSignal_.post();
         }
-        if (statusFlags & paInputOverflow) {
-            instance->streamStats_->overruns++;
-            spdlog::warn("Audio input overflow #{} detected", 
-                        instance->streamStats_->overruns.load());
+        return SinkStatus::Continue;
+    }
+    const SwitchPhase switchPhase = switchPhase_.load(std::memory_order_acquire);
+
+    // Nothing below may log directly: problems are posted as fixed-size
+    // events and logged later from the diagnostics thread
+    CaptureDiagnostics& diagnostics = diagnostics_;
+    const double adcTime = info.adcTime;
+    const double callbackTime = info.currentTime;
+    const PaStreamCallbackFlags statusFlags = info.statusFlags;
+
+    // Steady-clock start, for the callback duration and latency stamps
+    const int64_t callbackNs = LatencyMonitor::now();
+
+    // ADC time on the same clock; some host APIs leave the stream times at zero
+    int64_t adcNs = callbackNs;
+    if (adcTime > 0.0 && callbackTime >= adcTime) {
+        adcNs -= static_cast<int64_t>((callbackTime - adcTime) * 1e9);
+    }
+
+    // The new source's first block: the gap since the old source's last
+    // one is what the switch lost
+    const int64_t blockEndNs = adcNs + static_cast<int64_t>(framesPerBuffer * 1e9 / streamSampleRate_);
+    if (switchPhase == SwitchPhase::HandedOver) {
+        switchGapNs_.store(adcNs - lastBlockEndNs_.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+        switchPhase_.store(SwitchPhase::Complete, std::memory_order_release);
+        switchSignal_.post();
+    }
+
+    // Calculate actual latency
+    double currentLatency = 0.0;
+    if (callbackTime > 0.0) {
+        currentLatency = callbackTime - adcTime;
+        if (currentLatency > kMaxAllowedLatency) {
+            diagnostics.post({CaptureEventKind::HighLatency, 0, currentLatency,
+                              adcTime, callbackTime});
         }
+    }
 
-        // Log other status flags for debugging
-        if (statusFlags & paOutputUnderflow) spdlog::debug("Output underflow");
-        if (statusFlags & paOutputOverflow) spdlog::debug("Output overflow");
-        if (statusFlags & paPrimingOutput) spdlog::debug("Priming output");
+    // Buffer under/overrun reporting
+    if (statusFlags & paInputUnderflow) {
+        uint32_t count = static_cast<uint32_t>(streamStats_.addUnderrun());
+        diagnostics.post({CaptureEventKind::InputUnderflow, count, 0.0,
+                          adcTime, callbackTime});
+    }
+    if (statusFlags & paInputOverflow) {
+        uint32_t count = static_cast<uint32_t>(streamStats_.addOverrun());
+        diagnostics.post({CaptureEventKind::InputOverflow, count, 0.0,
+                          adcTime, callbackTime});
+    }
+
+    // Other status flags for debugging
+    PaStreamCallbackFlags otherFlags =
+        statusFlags & (paOutputUnderflow | paOutputOverflow | paPrimingOutput);
+    if (otherFlags) {
+        diagnostics.post({CaptureEventKind::StatusFlags, 0, static_cast<double>(otherFlags),
+                          adcTime, callbackTime});
     }
 
     // Write audio data to ring buffer
     if (input) {
-        size_t written = instance->audioBuffer_.write(input, framesPerBuffer);
-        if (written < framesPerBuffer) {
-            spdlog::warn("Ring buffer overflow - dropped {} samples", framesPerBuffer - written);
-            instance->streamStats_->overruns++;
+        // Everything but the channel sink takes channel 0; a block longer
+        // than the ring only keeps its newest frames anyway
+        const float* samples = input;
+        size_t frames = framesPerBuffer;
+        if (streamChannels_ > 1) {
+            frames = std::min(framesPerBuffer, firstChannel_.size());
+            const float* in = input + (framesPerBuffer - frames) * streamChannels_;
+            for (size_t i = 0; i < frames; ++i) {
+                firstChannel_[i] = in[i * streamChannels_];
+            }
+            samples = firstChannel_.data();
+        }
+
+        const uint64_t droppedBefore = audioBuffer_.overflowCount();
+        const size_t written = audioBuffer_.write(samples, frames);
+        const uint64_t dropped = audioBuffer_.overflowCount() - droppedBefore;
+        if (dropped > 0) {
+            uint32_t count = static_cast<uint32_t>(streamStats_.addRingOverflow(dropped));
+            diagnostics.post({CaptureEventKind::RingOverflow, count, static_cast<double>(dropped),
+                              adcTime, callbackTime});
+        }
+
+        lastBlockEndNs_.store(blockEndNs, std::memory_order_relaxed);
+
+        if (written > 0) {
+            latencyMonitor_.recordBuffer(audioBuffer_.writePosition(), written, adcNs,
+                                         LatencyMonitor::now());
+        }
+
+        // Wake the analysis thread for each completed hop
+        if (analysisWorker_) {
+            analysisWorker_->notifySamplesWritten(written);
+        }
+        if (channelSink_) {
+            AudioBlockInfo sinkInfo = info;
+            sinkInfo.adcNs = adcNs;
+            channelSink_->processBlock(input, framesPerBuffer, sinkInfo);
         }
 
         // Call user callback if provided
-        if (instance->userCallback_) {
-            instance->userCallback_(input, framesPerBuffer);
+        if (userCallback_) {
+            userCallback_(samples, static_cast<unsigned long>(frames));
         }
         
         // Monitor callback execution time
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-        
-        // Log if processing takes too long
-        if (duration.count() > 1000) { // More than 1ms
-            spdlog::warn("Audio callback processing took {:.2f}ms", duration.count() / 1000.0);
+        const int64_t endNs = LatencyMonitor::now();
+        streamStats_.endCallback(callbackNs, endNs, currentLatency, framesPerBuffer);
+
+        // Report if processing takes too long
+        const std::chrono::nanoseconds duration{endNs - callbackNs};
+        if (duration > kSlowCallbackThreshold) {
+            diagnostics.post({CaptureEventKind::SlowCallback, 0,
+                              std::chrono::duration<double>(duration).count(),
+                              adcTime, callbackTime});
         }
     } else {
-        spdlog::error("Null input buffer in audio callback");
-        instance->setState(StreamState::Error);
-        instance->lastError_ = "Null input buffer in audio callback";
-        return paAbort;
+        // The diagnostics thread records the error and enters the Error state
+        diagnostics.post({CaptureEventKind::NullInput, 0, 0.0, adcTime, callbackTime});
+        return SinkStatus::Abort;
     }
 
-    return paContinue;
+    // Hand over at this block boundary: the new source writes the next one.
+    // The phase is published first, so the new source sees it once it
+    // finds itself active.
+    if (switchPhase == SwitchPhase::Ready) {
+        switchPhase_.store(SwitchPhase::HandedOver, std::memory_order_release);
+        activeSlot_.store(incomingSlot_.load(std::memory_order_relaxed), std::memory_order_release);
+        return SinkStatus::Complete;
+    }
+
+    return SinkStatus::Continue;
 }
 
-StreamStats AudioCapture::getStreamStats() const {
-    if (!streamStats_) {
-        return StreamStats{};
+// Unpaced replay waits for the analysis worker instead of overflowing. An
+// incoming source's blocks are discarded, so it never has to wait.
+bool AudioCapture::hasRoomFor(unsigned slot, size_t frames) const {
+    if (slot != activeSlot_.load(std::memory_order_acquire)) return true;
+    if (channelSink_ && !channelSink_->hasRoomFor(frames)) return false;
+    return !analysisWorker_ || audioBuffer_.free() >= frames;
+}
+
+void AudioCapture::switchSource(std::unique_ptr<AudioSource> source) {
+    if (!source) {
+        throw AudioCaptureException("Audio source must not be null");
+    }
+    if (!source_ || streamState_.load() != StreamState::Running) {
+        throw AudioCaptureException("No running stream to switch");
+    }
+    if (source->sampleRate() != streamSampleRate_) {
+        throw AudioCaptureException("Cannot switch a " + std::to_string(streamSampleRate_) +
+                                    " Hz stream to a " + std::to_string(source->sampleRate()) +
+                                    " Hz source");
+    }
+    if (std::max(source->channels(), 1u) != streamChannels_) {
+        throw AudioCaptureException("Cannot switch a " + std::to_string(streamChannels_) +
+                                    "-channel stream to a " + std::to_string(source->channels()) +
+                                    "-channel source");
+    }
+
+    const auto switchStart = std::chrono::steady_clock::now();
+    const unsigned incoming = 1 - activeSlot_.load();
+    while (switchSignal_.tryWait()) {}
+    switchOverlapFrames_.store(0, std::memory_order_relaxed);
+    switchPhase_.store(SwitchPhase::Waiting);
+    incomingSlot_.store(incoming, std::memory_order_release);
+    setState(StreamState::Switching);
+
+    try {
+        source->start(sinks_[incoming]);
+    } catch (const AudioCaptureException&) {
+        incomingSlot_.store(kNoSlot, std::memory_order_release);
+        switchPhase_.store(SwitchPhase::Idle);
+        setState(StreamState::Running);
+        throw;
+    }
+    incomingSource_ = std::move(source);
+
+    // Normally the old source hands over by itself; one that has already
+    // stopped only needs the new source to be delivering
+    bool switched = false;
+    if (source_->isActive()) {
+        switched = waitForSwitchPhase(SwitchPhase::Complete, kSwitchTimeout);
+    } else {
+        waitForSwitchPhase(SwitchPhase::Ready, kSwitchTimeout);
     }
-    return *streamStats_;
+    if (!switched && switchPhase_.load() != SwitchPhase::Waiting) {
+        // The new source delivers but the old one does not: retire it here
+        spdlog::warn("{} stopped delivering during a switch", source_->describe());
+        source_->abort();
+        SwitchPhase expected = SwitchPhase::Ready;
+        if (switchPhase_.compare_exchange_strong(expected, SwitchPhase::HandedOver)) {
+            activeSlot_.store(incoming, std::memory_order_release);
+        }
+        switched = waitForSwitchPhase(SwitchPhase::Complete, kSwitchTimeout);
+    }
+
+    if (!switched) {
+        const std::string description = incomingSource_->describe();
+        incomingSource_->abort();
+        incomingSource_.reset();
+        incomingSlot_.store(kNoSlot, std::memory_order_release);
+        const bool oldSourceRetired = activeSlot_.load() == incoming;
+        activeSlot_.store(1 - incoming, std::memory_order_release);
+        switchPhase_.store(SwitchPhase::Idle);
+
+        const std::string message = "No audio from " + description + " within " +
+                                    std::to_string(kSwitchTimeout.count()) + " ms";
+        setError(message, oldSourceRetired ? StreamState::Error : StreamState::Running);
+        throw AudioCaptureException(message);
+    }
+
+    // The old source returned Complete after its last block
+    std::unique_ptr<AudioSource> retired = std::move(source_);
+    source_ = std::move(incomingSource_);
+    try {
+        retired->stop();
+    } catch (const AudioCaptureException& e) {
+        spdlog::warn("Error stopping the previous source: {}", e.what());
+    }
+    retired.reset();
+    incomingSlot_.store(kNoSlot, std::memory_order_release);
+    switchPhase_.store(SwitchPhase::Idle);
+
+    // Both sources' ADC times are on the steady clock, so the gap between
+    // their blocks converts to frames; an overlap loses nothing
+    const int64_t gapNs = switchGapNs_.load(std::memory_order_relaxed);
+    const uint64_t lostFrames = gapNs > 0
+        ? static_cast<uint64_t>(std::llround(gapNs * streamSampleRate_ / 1e9)) : 0;
+    const double switchMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - switchStart).count();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        switchStats_.switches++;
+        switchStats_.lastSwitchMs = switchMs;
+        switchStats_.lastLostFrames = lostFrames;
+        switchStats_.lastOverlapFrames = switchOverlapFrames_.load(std::memory_order_relaxed);
+        switchStats_.totalLostFrames += lostFrames;
+    }
+    setState(StreamState::Running);
+    spdlog::info("Audio stream switched to {} in {:.1f} ms, {} frames lost",
+                 source_->describe(), switchMs, lostFrames);
+}
+
+bool AudioCapture::waitForSwitchPhase(SwitchPhase phase, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (switchPhase_.load(std::memory_order_acquire) != phase) {
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::steady_clock::duration::zero() ||
+            !switchSignal_.waitFor(remaining)) {
+            return switchPhase_.load(std::memory_order_acquire) == phase;
+        }
+    }
+    return true;
+}
+
+DeviceSwitchStats AudioCapture::getSwitchStats() const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    return switchStats_;
+}
+
+StreamStatsSnapshot AudioCapture::getStreamStats() const {
+    return streamStats_.snapshot();
 }
 
 // New methods for audio data access
@@ -500,6 +742,14 @@ size_t AudioCapture::getAudioData(float* buffer, size_t count) {
     return audioBuffer_.read(buffer, count);
 }
 
+const float* AudioCapture::peekAudioData(size_t count) {
+    return audioBuffer_.peek(count);
+}
+
+bool AudioCapture::consumeAudioData(size_t count) {
+    return audioBuffer_.consume(count);
+}
+
 size_t AudioCapture::getAvailableSamples() const {
     return audioBuffer_.available();
 }
@@ -508,7 +758,59 @@ void AudioCapture::clearAudioBuffer() {
     audioBuffer_.clear();
 }
 
+void AudioCapture::setOverflowPolicy(OverflowPolicy policy) {
+    if (source_) {
+        throw AudioCaptureException("Cannot change overflow policy while stream is active");
+    }
+    audioBuffer_.setOverflowPolicy(policy);
+}
+
+void AudioCapture::setChannelCount(unsigned channels) {
+    if (source_) {
+        throw AudioCaptureException("Cannot change channel count while stream is active");
+    }
+    if (channels == 0) {
+        throw AudioCaptureException("Channel count must be at least 1");
+    }
+    channelCount_ = channels;
+}
+
+void AudioCapture::setChannelSink(AudioSink* sink) {
+    if (source_) {
+        throw AudioCaptureException("Cannot change channel sink while stream is active");
+    }
+    channelSink_ = sink;
+}
+
+void AudioCapture::setAnalysisCallback(const AnalysisConfig& config, AnalysisCallback callback) {
+    if (source_) {
+        throw AudioCaptureException("Cannot change analysis callback while stream is active");
+    }
+    try {
+        analysisWorker_ = std::make_unique<AnalysisWorker>(audioBuffer_, config, std::move(callback),
+                                                          &latencyMonitor_);
+    } catch (const std::invalid_argument& e) {
+        throw AudioCaptureException(std::string("Invalid analysis configuration: ") + e.what());
+    }
+}
+
+void AudioCapture::clearAnalysisCallback() {
+    if (source_) {
+        throw AudioCaptureException("Cannot change analysis callback while stream is active");
+    }
+    analysisWorker_.reset();
+}
+
+uint64_t AudioCapture::getProcessedHops() const {
+    return analysisWorker_ ? analysisWorker_->processedHops() : 0;
+}
+
+uint64_t AudioCapture::getMissedHops() const {
+    return analysisWorker_ ? analysisWorker_->missedHops() : 0;
+}
+
 std::string AudioCapture::getLastError() const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
     return lastError_;
 }
 } 
\ No newline at end of file
@@ -1,47 +1,16 @@
 #include "audio/AudioInput.hpp"
+#include "audio/DeviceRegistry.hpp"
+#include "dsp/Kernels.hpp"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
 #include <thread>
 #include <chrono>
+#include <optional>
 
 namespace ptm {
 
 namespace {
-    // Common sample rates to test for support
-    const std::vector<double> kCommonSampleRates = {
-        8000.0, 11025.0, 16000.0, 22050.0, 32000.0, 44100.0, 48000.0, 88200.0, 96000.0
-    };
-
-    // Helper function to test if a sample rate is supported
-    bool testSampleRate(PaStreamParameters* inputParams, double sampleRate) {
-        return Pa_IsFormatSupported(inputParams, nullptr, sampleRate) == paFormatIsSupported;
-    }
-
-    // Helper function to get supported sample rates for a device
-    std::set<double> getSupportedRatesInternal(const PaDeviceInfo* deviceInfo, PaDeviceIndex deviceIndex) {
-        std::set<double> supported;
-        
-        if (!deviceInfo || deviceInfo->maxInputChannels <= 0) {
-            return supported;
-        }
-        
-        PaStreamParameters inputParams;
-        inputParams.device = deviceIndex;
-        inputParams.channelCount = 1;  // Mono input
-        inputParams.sampleFormat = paFloat32;
-        inputParams.suggestedLatency = deviceInfo->defaultLowInputLatency;
-        inputParams.hostApiSpecificStreamInfo = nullptr;
-
-        for (double rate : kCommonSampleRates) {
-            if (testSampleRate(&inputParams, rate)) {
-                supported.insert(rate);
-            }
-        }
-
-        return supported;
-    }
-
     // Initialize PortAudio if needed
     bool ensurePortAudioInitialized() {
         static bool initialized = false;
@@ -66,6 +35,20 @@ namespace {
         return initialized;
     }
 
+    // Shared by the functions below, so each device is probed only once
+    DeviceRegistry& deviceRegistry() {
+        static DeviceRegistry registry;
+        return registry;
+    }
+
+    std::optional<AudioDevice> findInputDevice(int deviceId) {
+        try {
+            return deviceRegistry().find(deviceId);
+        } catch (const std::exception& e) {
+            throw AudioInputException(e.what());
+        }
+    }
+
     // Audio processing callback for captureAudio function
     int audioProcessingCallback(const void* inputBuffer, void* outputBuffer,
                                unsigned long framesPerBuffer,
@@ -81,11 +64,7 @@ namespace {
         }
         
         // Calculate RMS level of the audio input
-        float rms = 0.0f;
-        for (unsigned long i = 0; i < framesPerBuffer; i++) {
-            rms += input[i] * input[i];
-        }
-        rms = std::sqrt(rms / framesPerBuffer);
+        float rms = std::sqrt(sumOfSquares(input, framesPerBuffer) / framesPerBuffer);
         
         // Log RMS level (less frequently to avoid flooding the logs)
         static int callCount = 0;
@@ -111,39 +90,38 @@ std::vector<AudioDeviceInfo> enumerateAudioDevices() {
         throw AudioInputException("Failed to initialize PortAudio");
     }
     
-    int numDevices = Pa_GetDeviceCount();
-    if (numDevices < 0) {
-        throw AudioInputException(std::string("Error getting device count: ") + 
-                                Pa_GetErrorText(numDevices));
+    std::vector<AudioDevice> inputDevices;
+    try {
+        deviceRegistry().refresh();
+        inputDevices = deviceRegistry().devices();
+    } catch (const std::exception& e) {
+        throw AudioInputException(e.what());
     }
 
     PaDeviceIndex defaultInput = Pa_GetDefaultInputDevice();
-    std::cout << "Found " << numDevices << " audio devices, default input device index: " 
+    std::cout << "Found " << inputDevices.size() << " audio input devices, default input device index: " 
               << defaultInput << std::endl;
 
-    for (int i = 0; i < numDevices; i++) {
-        const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(i);
-        if (deviceInfo && deviceInfo->maxInputChannels > 0) {
-            AudioDeviceInfo device;
-            device.audioDeviceId = i;
-            device.name = deviceInfo->name;
-            device.hostApi = Pa_GetHostApiInfo(deviceInfo->hostApi)->name;
-            device.sampleRate = deviceInfo->defaultSampleRate;
-            device.sampleRates = getSupportedRatesInternal(deviceInfo, i);
-            device.maxInputChannels = deviceInfo->maxInputChannels;
-            device.defaultLatency = deviceInfo->defaultLowInputLatency;
-            device.minLatency = deviceInfo->defaultLowInputLatency;
-            device.isDefaultInput = (i == defaultInput);
-            
-            devices.push_back(device);
-            
-            std::cout << "Found input device: " << device.name << " (" << device.hostApi << ")" << std::endl;
-            std::cout << "  Supported rates: ";
-            for (double rate : device.sampleRates) {
-                std::cout << rate << " Hz ";
-            }
-            std::cout << std::endl;
+    for (const auto& inputDevice : inputDevices) {
+        AudioDeviceInfo device;
+        device.audioDeviceId = inputDevice.index;
+        device.name = inputDevice.name;
+        device.hostApi = inputDevice.hostApi;
+        device.sampleRate = inputDevice.defaultSampleRate;
+        device.sampleRates = deviceRegistry().supportedSampleRates(inputDevice);
+        device.maxInputChannels = inputDevice.maxInputChannels;
+        device.defaultLatency = inputDevice.defaultLatency;
+        device.minLatency = inputDevice.minLatency;
+        device.isDefaultInput = inputDevice.isDefaultInput;
+        
+        devices.push_back(device);
+        
+        std::cout << "Found input device: " << device.name << " (" << device.hostApi << ")" << std::endl;
+        std::cout << "  Supported rates: ";
+        for (double rate : device.sampleRates) {
+            std::cout << rate << " Hz ";
         }
+        std::cout << std::endl;
     }
 
     if (devices.empty()) {
@@ -174,20 +152,13 @@ bool isSampleRateSupported(int deviceId, double sampleRate) {
         throw AudioInputException("Failed to initialize PortAudio");
     }
     
-    const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(deviceId);
-    if (!deviceInfo || deviceInfo->maxInputChannels <= 0) {
+    std::optional<AudioDevice> device = findInputDevice(deviceId);
+    if (!device) {
         std::cerr << "Invalid device ID: " << deviceId << std::endl;
         return false;
     }
     
-    PaStreamParameters inputParams;
-    inputParams.device = deviceId;
-    inputParams.channelCount = 1;  // Mono input
-    inputParams.sampleFormat = paFloat32;
-    inputParams.suggestedLatency = deviceInfo->defaultLowInputLatency;
-    inputParams.hostApiSpecificStreamInfo = nullptr;
-    
-    return testSampleRate(&inputParams, sampleRate);
+    return deviceRegistry().supportsSampleRate(*device, sampleRate);
 }
 
 std::set<double> getSupportedSampleRates(int deviceId) {
@@ -196,13 +167,13 @@ std::set<double> getSupportedSampleRates(int deviceId) {
         throw AudioInputException("Failed to initialize PortAudio");
     }
     
-    const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(deviceId);
-    if (!deviceInfo || deviceInfo->maxInputChannels <= 0) {
+    std::optional<AudioDevice> device = findInputDevice(deviceId);
+    if (!device) {
         std::cerr << "Invalid device ID: " << deviceId << std::endl;
         return {};
     }
     
-    return getSupportedRatesInternal(deviceInfo, deviceId);
+    return deviceRegistry().supportedSampleRates(*device);
 }
 
 bool captureAudio(unsigned int bufferSize) {
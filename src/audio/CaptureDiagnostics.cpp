@@ -0,0 +1,156 @@
+#include "audio/CaptureDiagnostics.hpp"
+#include <portaudio.h>
+#include <spdlog/spdlog.h>
+
+namespace ptm {
+
+namespace {
+    constexpr std::chrono::seconds kRateLimitWindow{1};
+}
+
+const char* toString(CaptureEventKind kind) {
+    switch (kind) {
+        case CaptureEventKind::HighLatency:    return "high latency";
+        case CaptureEventKind::InputUnderflow: return "input underrun";
+        case CaptureEventKind::InputOverflow:  return "input overflow";
+        case CaptureEventKind::RingOverflow:   return "ring buffer overflow";
+        case CaptureEventKind::SlowCallback:   return "slow callback";
+        case CaptureEventKind::StatusFlags:    return "stream status";
+        case CaptureEventKind::NullInput:      return "null input buffer";
+        case CaptureEventKind::Count:          break;
+    }
+    return "unknown";
+}
+
+CaptureDiagnostics::CaptureDiagnostics(size_t queueSize, uint32_t maxEventsPerSecond)
+    : events_(queueSize, OverflowPolicy::DropNewest)
+    , maxEventsPerSecond_(maxEventsPerSecond)
+    , windowStart_(std::chrono::steady_clock::now()) {}
+
+CaptureDiagnostics::~CaptureDiagnostics() {
+    stop();
+}
+
+void CaptureDiagnostics::setEventHandler(CaptureEventHandler handler) {
+    if (thread_.joinable()) return;
+    handler_ = std::move(handler);
+}
+
+void CaptureDiagnostics::start(std::chrono::milliseconds drainInterval) {
+    if (thread_.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        stopRequested_ = false;
+    }
+    thread_ = std::thread(&CaptureDiagnostics::drainLoop, this, drainInterval);
+}
+
+void CaptureDiagnostics::stop() {
+    if (!thread_.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        stopRequested_ = true;
+    }
+    stopCondition_.notify_one();
+    thread_.join();
+
+    // Anything posted by the final callbacks
+    drain();
+    flushRateLimitWindow(std::chrono::steady_clock::now() + kRateLimitWindow);
+}
+
+void CaptureDiagnostics::drainLoop(std::chrono::milliseconds drainInterval) {
+    std::unique_lock<std::mutex> lock(stopMutex_);
+    while (!stopRequested_) {
+        stopCondition_.wait_for(lock, drainInterval, [this] { return stopRequested_; });
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+}
+
+size_t CaptureDiagnostics::drain() {
+    std::lock_guard<std::mutex> lock(drainMutex_);
+
+    size_t drained = 0;
+    CaptureEvent event;
+    while (events_.read(&event, 1) == 1) {
+        if (handler_) handler_(event);
+
+        auto kind = static_cast<size_t>(event.kind);
+        if (kind < kKindCount && loggedInWindow_[kind] >= maxEventsPerSecond_) {
+            suppressedInWindow_[kind]++;
+            suppressedTotal_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            if (kind < kKindCount) loggedInWindow_[kind]++;
+            log(event);
+        }
+        drained++;
+    }
+
+    uint64_t dropped = events_.overflowCount();
+    if (dropped > reportedDrops_) {
+        spdlog::warn("Diagnostics queue full: {} audio callback events lost",
+                     dropped - reportedDrops_);
+        reportedDrops_ = dropped;
+    }
+
+    flushRateLimitWindow(std::chrono::steady_clock::now());
+    return drained;
+}
+
+void CaptureDiagnostics::flushRateLimitWindow(std::chrono::steady_clock::time_point now) {
+    if (now - windowStart_ < kRateLimitWindow) return;
+
+    for (size_t kind = 0; kind < kKindCount; ++kind) {
+        if (suppressedInWindow_[kind] > 0) {
+            spdlog::warn("Suppressed {} further {} events",
+                         suppressedInWindow_[kind],
+                         toString(static_cast<CaptureEventKind>(kind)));
+        }
+    }
+    loggedInWindow_.fill(0);
+    suppressedInWindow_.fill(0);
+    windowStart_ = now;
+}
+
+void CaptureDiagnostics::log(const CaptureEvent& event) {
+    switch (event.kind) {
+        case CaptureEventKind::HighLatency:
+            spdlog::warn("High latency detected: {:.1f}ms (ADC: {:.6f}, Current: {:.6f})",
+                         event.value * 1000.0, event.adcTime, event.currentTime);
+            break;
+        case CaptureEventKind::InputUnderflow:
+            spdlog::warn("Audio input underrun #{} detected (ADC: {:.6f})",
+                         event.counter, event.adcTime);
+            break;
+        case CaptureEventKind::InputOverflow:
+            spdlog::warn("Audio input overflow #{} detected (ADC: {:.6f})",
+                         event.counter, event.adcTime);
+            break;
+        case CaptureEventKind::RingOverflow:
+            spdlog::warn("Ring buffer overflow #{} - dropped {} samples (ADC: {:.6f})",
+                         event.counter, static_cast<uint64_t>(event.value), event.adcTime);
+            break;
+        case CaptureEventKind::SlowCallback:
+            spdlog::warn("Audio callback processing took {:.2f}ms (ADC: {:.6f})",
+                         event.value * 1000.0, event.adcTime);
+            break;
+        case CaptureEventKind::StatusFlags: {
+            auto flags = static_cast<PaStreamCallbackFlags>(event.value);
+            if (flags & paOutputUnderflow) spdlog::debug("Output underflow");
+            if (flags & paOutputOverflow) spdlog::debug("Output overflow");
+            if (flags & paPrimingOutput) spdlog::debug("Priming output");
+            break;
+        }
+        case CaptureEventKind::NullInput:
+            spdlog::error("Null input buffer in audio callback (ADC: {:.6f})", event.adcTime);
+            break;
+        case CaptureEventKind::Count:
+            break;
+    }
+}
+
+} // namespace ptm
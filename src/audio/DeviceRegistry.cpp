@@ -0,0 +1,201 @@
+#include "audio/DeviceRegistry.hpp"
+#include "audio/AudioSource.hpp"
+#include <spdlog/spdlog.h>
+
+namespace ptm {
+
+DeviceRegistry::DeviceRegistry()
+    : DeviceRegistry(&DeviceRegistry::scanPortAudioDevices, &DeviceRegistry::probePortAudioRate) {}
+
+DeviceRegistry::DeviceRegistry(Scanner scanner, RateProbe probe)
+    : scanner_(std::move(scanner))
+    , probe_(std::move(probe)) {}
+
+DeviceRegistry::~DeviceRegistry() {
+    stopMonitoring();
+}
+
+bool DeviceRegistry::refresh() {
+    std::vector<AudioDevice> scanned;
+    {
+        std::lock_guard<std::mutex> lock(backendMutex_);
+        scanned = scanner_();
+    }
+    assignIds(scanned);
+    for (auto& device : scanned) {
+        device.sampleRates.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool changed = !scanned_ || !sameDevices(devices_, scanned);
+    devices_ = std::move(scanned);
+    scanned_ = true;
+    return changed;
+}
+
+std::vector<AudioDevice> DeviceRegistry::devices() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (scanned_) return devices_;
+    }
+    refresh();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return devices_;
+}
+
+std::optional<AudioDevice> DeviceRegistry::find(PaDeviceIndex index) {
+    for (const auto& device : devices()) {
+        if (device.index == index) return device;
+    }
+    return std::nullopt;
+}
+
+std::optional<AudioDevice> DeviceRegistry::find(const std::string& id) {
+    for (const auto& device : devices()) {
+        if (device.id == id) return device;
+    }
+    return std::nullopt;
+}
+
+bool DeviceRegistry::supportsSampleRate(const AudioDevice& device, double sampleRate) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto cached = rateCache_.find(device.id);
+        if (cached != rateCache_.end()) {
+            auto rate = cached->second.find(sampleRate);
+            if (rate != cached->second.end()) return rate->second;
+        }
+    }
+
+    bool supported;
+    {
+        std::lock_guard<std::mutex> lock(backendMutex_);
+        supported = probe_(device, sampleRate);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    rateCache_[device.id][sampleRate] = supported;
+    ++probes_;
+    return supported;
+}
+
+std::set<double> DeviceRegistry::supportedSampleRates(const AudioDevice& device) {
+    std::set<double> supported;
+    for (double rate : kCommonSampleRates) {
+        if (supportsSampleRate(device, rate)) {
+            supported.insert(rate);
+        }
+    }
+    return supported;
+}
+
+uint64_t DeviceRegistry::probeCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return probes_;
+}
+
+void DeviceRegistry::startMonitoring(DeviceListCallback callback, std::chrono::milliseconds interval) {
+    if (monitorThread_.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        stopRequested_ = false;
+    }
+    monitorThread_ = std::thread(&DeviceRegistry::monitorLoop, this, std::move(callback), interval);
+}
+
+void DeviceRegistry::stopMonitoring() {
+    if (!monitorThread_.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        stopRequested_ = true;
+    }
+    stopCondition_.notify_one();
+    monitorThread_.join();
+}
+
+void DeviceRegistry::monitorLoop(DeviceListCallback callback, std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(stopMutex_);
+    while (!stopCondition_.wait_for(lock, interval, [this] { return stopRequested_; })) {
+        lock.unlock();
+        try {
+            if (refresh()) {
+                spdlog::info("Audio device list has changed");
+                if (callback) callback(devices());
+            }
+        } catch (const std::exception& e) {
+            spdlog::warn("Device scan failed: {}", e.what());
+        }
+        lock.lock();
+    }
+}
+
+// Identical devices on the same host API are told apart by their order
+void DeviceRegistry::assignIds(std::vector<AudioDevice>& devices) {
+    std::unordered_map<std::string, int> seen;
+    for (auto& device : devices) {
+        std::string id = device.hostApi + ": " + device.name;
+        const int ordinal = ++seen[id];
+        if (ordinal > 1) {
+            id += " #" + std::to_string(ordinal);
+        }
+        device.id = std::move(id);
+    }
+}
+
+bool DeviceRegistry::sameDevices(const std::vector<AudioDevice>& a, const std::vector<AudioDevice>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].id != b[i].id ||
+            a[i].index != b[i].index ||
+            a[i].maxInputChannels != b[i].maxInputChannels ||
+            a[i].isDefaultInput != b[i].isDefaultInput) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<AudioDevice> DeviceRegistry::scanPortAudioDevices() {
+    std::vector<AudioDevice> devices;
+    int numDevices = Pa_GetDeviceCount();
+
+    if (numDevices < 0) {
+        throw AudioCaptureException(std::string("Error getting device count: ") +
+                                  Pa_GetErrorText(numDevices));
+    }
+
+    PaDeviceIndex defaultInput = Pa_GetDefaultInputDevice();
+
+    for (int i = 0; i < numDevices; i++) {
+        const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(i);
+        if (deviceInfo && deviceInfo->maxInputChannels > 0) {
+            AudioDevice device;
+            device.index = i;
+            device.name = deviceInfo->name;
+            device.hostApi = Pa_GetHostApiInfo(deviceInfo->hostApi)->name;
+            device.defaultSampleRate = deviceInfo->defaultSampleRate;
+            device.maxInputChannels = deviceInfo->maxInputChannels;
+            device.defaultLatency = deviceInfo->defaultLowInputLatency;
+            device.minLatency = deviceInfo->defaultLowInputLatency;
+            device.isDefaultInput = (i == defaultInput);
+            devices.push_back(device);
+        }
+    }
+
+    return devices;
+}
+
+bool DeviceRegistry::probePortAudioRate(const AudioDevice& device, double sampleRate) {
+    PaStreamParameters inputParams;
+    inputParams.device = device.index;
+    inputParams.channelCount = 1;  // Mono input
+    inputParams.sampleFormat = paFloat32;
+    inputParams.suggestedLatency = device.defaultLatency;
+    inputParams.hostApiSpecificStreamInfo = nullptr;
+
+    return Pa_IsFormatSupported(&inputParams, nullptr, sampleRate) == paFormatIsSupported;
+}
+
+} // namespace ptm
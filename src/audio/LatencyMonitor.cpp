@@ -0,0 +1,107 @@
+#include "audio/LatencyMonitor.hpp"
+#include <spdlog/fmt/fmt.h>
+#include <chrono>
+
+namespace ptm {
+
+namespace {
+    double toMs(int64_t nanoseconds) {
+        return static_cast<double>(nanoseconds) / 1e6;
+    }
+}
+
+int64_t LatencyMonitor::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Without an analysis thread nothing reads the pending stamps: keep the newest
+LatencyMonitor::LatencyMonitor(size_t maxPendingBuffers)
+    : pending_(maxPendingBuffers, OverflowPolicy::DropOldest) {}
+
+void LatencyMonitor::beginStream(double sampleRate) {
+    nsPerSample_ = sampleRate > 0.0 ? 1e9 / sampleRate : 0.0;
+    pending_.clear();
+    current_ = BufferStamp{};
+}
+
+void LatencyMonitor::recordBuffer(uint64_t endPosition, size_t frames, int64_t adcNs,
+                                  int64_t writeNs) {
+    if (frames == 0) return;
+
+    // Measured from the newest sample, like the windows downstream
+    const int64_t newestAdcNs =
+        adcNs + static_cast<int64_t>(static_cast<double>(frames - 1) * nsPerSample_);
+    record(LatencyStage::Capture, writeNs - newestAdcNs);
+
+    const BufferStamp stamp{endPosition, frames, adcNs, writeNs};
+    pending_.write(&stamp, 1);
+}
+
+LatencyStamp LatencyMonitor::recordRead(uint64_t endPosition) {
+    LatencyStamp stamp;
+    if (endPosition == 0) return stamp;
+
+    // Skip buffers that end before the window's newest sample
+    while (current_.endPosition < endPosition) {
+        if (pending_.read(&current_, 1) == 0) {
+            return stamp;
+        }
+    }
+    const uint64_t newest = endPosition - 1;
+    const uint64_t bufferStart = current_.endPosition - current_.frames;
+    if (newest < bufferStart) {
+        // The buffer holding it was dropped from the queue
+        return stamp;
+    }
+
+    stamp.adcNs = current_.adcNs +
+                  static_cast<int64_t>(static_cast<double>(newest - bufferStart) * nsPerSample_);
+    stamp.writeNs = current_.writeNs;
+    stamp.readNs = now();
+    record(LatencyStage::Queue, stamp.readNs - stamp.writeNs);
+    return stamp;
+}
+
+void LatencyMonitor::recordDetection(LatencyStamp& stamp) {
+    if (!stamp.valid()) return;
+
+    stamp.detectNs = now();
+    record(LatencyStage::Detection, stamp.detectNs - stamp.readNs);
+}
+
+void LatencyMonitor::recordSend(const LatencyStamp& stamp) {
+    if (!stamp.valid()) return;
+
+    const int64_t sendNs = now();
+    if (stamp.detectNs != 0) {
+        record(LatencyStage::Output, sendNs - stamp.detectNs);
+    }
+    record(LatencyStage::Total, sendNs - stamp.adcNs);
+}
+
+std::string LatencyMonitor::report() const {
+    std::string report;
+    for (size_t i = 0; i < kLatencyStageCount; ++i) {
+        const LatencyStage stage = static_cast<LatencyStage>(i);
+        const LatencyHistogram::Summary s = summary(stage);
+        if (s.count == 0) continue;
+
+        report += fmt::format("{:<9} p50 {:7.3f} ms  p99 {:7.3f} ms  max {:7.3f} ms  ({} samples)",
+                              toString(stage), toMs(s.p50Ns), toMs(s.p99Ns), toMs(s.maxNs),
+                              s.count);
+        if (stage == LatencyStage::Total && s.p99Ns > kBudgetNs) {
+            report += fmt::format("  over the {:.0f} ms budget", toMs(kBudgetNs));
+        }
+        report += '\n';
+    }
+    return report;
+}
+
+void LatencyMonitor::reset() {
+    for (auto& histogram : histograms_) {
+        histogram.reset();
+    }
+}
+
+} // namespace ptm
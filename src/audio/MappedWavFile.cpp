@@ -0,0 +1,315 @@
+#include "audio/MappedWavFile.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ptm {
+
+namespace {
+    constexpr uint16_t kFormatPcm = 1;
+    constexpr uint16_t kFormatFloat = 3;
+    constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+    // RF64 puts this in the 32-bit size fields that moved to the ds64 chunk
+    constexpr uint32_t kSizeInDs64 = 0xFFFFFFFFu;
+
+    uint16_t readU16(const unsigned char* p) {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    uint32_t readU32(const unsigned char* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    uint64_t readU64(const unsigned char* p) {
+        return static_cast<uint64_t>(readU32(p)) | (static_cast<uint64_t>(readU32(p + 4)) << 32);
+    }
+
+    bool hasTag(const unsigned char* p, const char* tag) {
+        return std::memcmp(p, tag, 4) == 0;
+    }
+
+    // Decoders for one sample; the format switch stays outside the frame loop
+    struct Int8Sample {
+        static float decode(const unsigned char* p) {
+            return (static_cast<float>(p[0]) - 128.0f) * (1.0f / 128.0f);
+        }
+    };
+
+    struct Int16Sample {
+        static float decode(const unsigned char* p) {
+            return static_cast<float>(static_cast<int16_t>(readU16(p))) * (1.0f / 32768.0f);
+        }
+    };
+
+    struct Int24Sample {
+        static float decode(const unsigned char* p) {
+            int32_t value = static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 8 |
+                                                 static_cast<uint32_t>(p[1]) << 16 |
+                                                 static_cast<uint32_t>(p[2]) << 24) >> 8;
+            return static_cast<float>(value) * (1.0f / 8388608.0f);
+        }
+    };
+
+    struct Int32Sample {
+        static float decode(const unsigned char* p) {
+            return static_cast<float>(static_cast<int32_t>(readU32(p))) * (1.0f / 2147483648.0f);
+        }
+    };
+
+    struct Float32Sample {
+        static float decode(const unsigned char* p) {
+            float value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+    };
+
+    struct Float64Sample {
+        static float decode(const unsigned char* p) {
+            double value;
+            std::memcpy(&value, p, sizeof(value));
+            return static_cast<float>(value);
+        }
+    };
+
+    template<typename Sample>
+    void decodeFrames(const unsigned char* in, size_t frameBytes, unsigned channels,
+                      unsigned bytesPerSample, size_t count, float* out) {
+        if (channels == 1) {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = Sample::decode(in + i * frameBytes);
+            }
+            return;
+        }
+        const float scale = 1.0f / static_cast<float>(channels);
+        for (size_t i = 0; i < count; ++i) {
+            const unsigned char* frame = in + i * frameBytes;
+            float sum = 0.0f;
+            for (unsigned c = 0; c < channels; ++c) {
+                sum += Sample::decode(frame + c * bytesPerSample);
+            }
+            out[i] = sum * scale;
+        }
+    }
+}
+
+MappedWavFile::MappedWavFile(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw WavFileException("Cannot open " + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        throw WavFileException("Cannot map empty file " + path);
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        throw WavFileException("Cannot map " + path);
+    }
+    file_ = file;
+    mapping_ = mapping;
+    data_ = static_cast<const unsigned char*>(view);
+    size_ = static_cast<uint64_t>(size.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw WavFileException("Cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        throw WavFileException("Cannot map empty file " + path);
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    close(fd);  // The mapping keeps the file referenced
+    if (mapped == MAP_FAILED) {
+        throw WavFileException("Cannot map " + path + ": " + std::strerror(err));
+    }
+    // Read-ahead for a front-to-back scan
+    madvise(mapped, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+    data_ = static_cast<const unsigned char*>(mapped);
+    size_ = static_cast<uint64_t>(info.st_size);
+#endif
+
+    try {
+        parse();
+    } catch (const WavFileException& e) {
+        unmap();
+        throw WavFileException(path + ": " + e.what());
+    }
+}
+
+MappedWavFile::~MappedWavFile() {
+    unmap();
+}
+
+void MappedWavFile::unmap() {
+    if (!data_) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    CloseHandle(static_cast<HANDLE>(file_));
+#else
+    munmap(const_cast<unsigned char*>(data_), static_cast<size_t>(size_));
+#endif
+    data_ = nullptr;
+}
+
+void MappedWavFile::parse() {
+    if (size_ < 12 || !hasTag(data_ + 8, "WAVE")) {
+        throw WavFileException("Not a WAV file");
+    }
+    const bool rf64 = hasTag(data_, "RF64");
+    if (!rf64 && !hasTag(data_, "RIFF")) {
+        throw WavFileException("Not a RIFF or RF64 file");
+    }
+
+    uint64_t ds64DataSize = 0;
+    bool haveFormat = false;
+    uint16_t formatTag = 0;
+    unsigned bitsPerSample = 0;
+
+    uint64_t pos = 12;
+    while (pos + 8 <= size_) {
+        const unsigned char* chunk = data_ + pos;
+        uint64_t chunkSize = readU32(chunk + 4);
+        const uint64_t bodyAvailable = size_ - (pos + 8);
+
+        if (hasTag(chunk, "ds64")) {
+            if (chunkSize < 24 || bodyAvailable < 24) {
+                throw WavFileException("Truncated ds64 chunk");
+            }
+            ds64DataSize = readU64(chunk + 16);
+        } else if (hasTag(chunk, "fmt ")) {
+            if (chunkSize < 16 || bodyAvailable < 16) {
+                throw WavFileException("Truncated fmt chunk");
+            }
+            formatTag = readU16(chunk + 8);
+            channels_ = readU16(chunk + 10);
+            sampleRate_ = readU32(chunk + 12);
+            frameBytes_ = readU16(chunk + 20);
+            bitsPerSample = readU16(chunk + 22);
+            if (formatTag == kFormatExtensible) {
+                if (chunkSize < 40 || bodyAvailable < 40) {
+                    throw WavFileException("Truncated extensible fmt chunk");
+                }
+                // The sub-format GUID starts with the plain format tag
+                formatTag = readU16(chunk + 32);
+            }
+            haveFormat = true;
+        } else if (hasTag(chunk, "data")) {
+            if (!haveFormat) {
+                throw WavFileException("data chunk before fmt chunk");
+            }
+            if (rf64 && chunkSize == kSizeInDs64) {
+                chunkSize = ds64DataSize;
+            }
+            samples_ = chunk + 8;
+            uint64_t bytes = std::min(chunkSize, bodyAvailable);
+            frames_ = frameBytes_ ? bytes / frameBytes_ : 0;
+            break;
+        }
+
+        // Chunks are padded to an even length
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    if (!haveFormat) throw WavFileException("Missing fmt chunk");
+    if (!samples_) throw WavFileException("Missing data chunk");
+    if (channels_ == 0 || sampleRate_ <= 0.0) {
+        throw WavFileException("Invalid channel count or sample rate");
+    }
+
+    if (formatTag == kFormatPcm && bitsPerSample == 8) {
+        format_ = WavSampleFormat::Int8;
+    } else if (formatTag == kFormatPcm && bitsPerSample == 16) {
+        format_ = WavSampleFormat::Int16;
+    } else if (formatTag == kFormatPcm && bitsPerSample == 24) {
+        format_ = WavSampleFormat::Int24;
+    } else if (formatTag == kFormatPcm && bitsPerSample == 32) {
+        format_ = WavSampleFormat::Int32;
+    } else if (formatTag == kFormatFloat && bitsPerSample == 32) {
+        format_ = WavSampleFormat::Float32;
+    } else if (formatTag == kFormatFloat && bitsPerSample == 64) {
+        format_ = WavSampleFormat::Float64;
+    } else {
+        throw WavFileException("Unsupported sample format " + std::to_string(formatTag) + " with " +
+                               std::to_string(bitsPerSample) + " bits");
+    }
+    bytesPerSample_ = bitsPerSample / 8;
+    if (frameBytes_ != static_cast<size_t>(bytesPerSample_) * channels_) {
+        throw WavFileException("Block alignment does not match the sample format");
+    }
+}
+
+size_t MappedWavFile::readFrames(uint64_t firstFrame, size_t count, float* out) const {
+    if (firstFrame >= frames_) return 0;
+    count = static_cast<size_t>(std::min<uint64_t>(count, frames_ - firstFrame));
+    const unsigned char* in = samples_ + firstFrame * frameBytes_;
+
+    switch (format_) {
+        case WavSampleFormat::Int8:
+            decodeFrames<Int8Sample>(in, frameBytes_, channels_, bytesPerSample_, count, out);
+            break;
+        case WavSampleFormat::Int16:
+            decodeFrames<Int16Sample>(in, frameBytes_, channels_, bytesPerSample_, count, out);
+            break;
+        case WavSampleFormat::Int24:
+            decodeFrames<Int24Sample>(in, frameBytes_, channels_, bytesPerSample_, count, out);
+            break;
+        case WavSampleFormat::Int32:
+            decodeFrames<Int32Sample>(in, frameBytes_, channels_, bytesPerSample_, count, out);
+            break;
+        case WavSampleFormat::Float32:
+            decodeFrames<Float32Sample>(in, frameBytes_, channels_, bytesPerSample_, count, out);
+            break;
+        case WavSampleFormat::Float64:
+            decodeFrames<Float64Sample>(in, frameBytes_, channels_, bytesPerSample_, count, out);
+            break;
+    }
+    return count;
+}
+
+void MappedWavFile::release(uint64_t beginFrame, uint64_t endFrame) const {
+#ifndef _WIN32
+    // Pages wholly inside the range; neighbouring frames may still be in use
+    static const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    endFrame = std::min(endFrame, frames_);
+    if (beginFrame >= endFrame) return;
+    const uint64_t dataOffset = static_cast<uint64_t>(samples_ - data_);
+    uint64_t beginByte = dataOffset + beginFrame * frameBytes_;
+    uint64_t endByte = dataOffset + endFrame * frameBytes_;
+    beginByte = (beginByte + page - 1) / page * page;
+    endByte -= endByte % page;
+    if (endByte > beginByte) {
+        madvise(const_cast<unsigned char*>(data_ + beginByte),
+                static_cast<size_t>(endByte - beginByte), MADV_DONTNEED);
+    }
+#else
+    (void)beginFrame;  // The working set manager trims unused views on its own
+    (void)endFrame;
+#endif
+}
+
+} // namespace ptm
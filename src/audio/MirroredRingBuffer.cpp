@@ -0,0 +1,108 @@
+#include "audio/MirroredRingBuffer.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <atomic>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define PTM_HAVE_MIRRORED_MAPPING 1
+#endif
+
+namespace ptm {
+
+namespace {
+#ifdef PTM_HAVE_MIRRORED_MAPPING
+    [[noreturn]] void throwErrno(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    // Anonymous shared-memory file of the given size; the caller closes it
+    int createSharedMemory(size_t bytes) {
+#if defined(__linux__)
+        int fd = memfd_create("ptm-ring", MFD_CLOEXEC);
+        if (fd < 0) throwErrno("memfd_create");
+#else
+        // No memfd: create a uniquely named shm object and unlink it right away
+        static std::atomic<unsigned> counter{0};
+        std::string name = "/ptm-ring-" + std::to_string(getpid()) + "-" +
+                           std::to_string(counter.fetch_add(1));
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) throwErrno("shm_open");
+        shm_unlink(name.c_str());
+#endif
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            int err = errno;
+            close(fd);
+            errno = err;
+            throwErrno("ftruncate");
+        }
+        return fd;
+    }
+
+    // Reserve 2 * bytes of address space, then map the file into both halves
+    void* mapTwice(int fd, size_t bytes) {
+        void* reservation = mmap(nullptr, 2 * bytes, PROT_NONE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (reservation == MAP_FAILED) return nullptr;
+
+        auto* base = static_cast<char*>(reservation);
+        for (char* half : {base, base + bytes}) {
+            void* mapped = mmap(half, bytes, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_FIXED, fd, 0);
+            if (mapped != half) {
+                munmap(reservation, 2 * bytes);
+                return nullptr;
+            }
+        }
+        return reservation;
+    }
+#endif
+}
+
+size_t MirroredMemory::pageSize() {
+#ifdef PTM_HAVE_MIRRORED_MAPPING
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+MirroredMemory::MirroredMemory(size_t minBytes) {
+    const size_t page = pageSize();
+    size_ = ((std::max<size_t>(minBytes, 1) + page - 1) / page) * page;
+
+#ifdef PTM_HAVE_MIRRORED_MAPPING
+    int fd = createSharedMemory(size_);
+    base_ = mapTwice(fd, size_);
+    close(fd);
+    if (base_) {
+        hardwareMirrored_ = true;
+        return;
+    }
+#endif
+
+    // Fallback: two plain copies that the ring storage keeps in sync
+    base_ = std::calloc(2, size_);
+    if (!base_) {
+        throw std::system_error(std::make_error_code(std::errc::not_enough_memory),
+                                "MirroredMemory");
+    }
+}
+
+MirroredMemory::~MirroredMemory() {
+    if (!base_) return;
+#ifdef PTM_HAVE_MIRRORED_MAPPING
+    if (hardwareMirrored_) {
+        munmap(base_, 2 * size_);
+        return;
+    }
+#endif
+    std::free(base_);
+}
+
+} // namespace ptm
@@ -0,0 +1,117 @@
+#include "audio/PortAudioSource.hpp"
+#include <spdlog/fmt/fmt.h>
+
+namespace ptm {
+
+PortAudioSource::PortAudioSource(PaDeviceIndex device, double sampleRate,
+                                 unsigned long framesPerBuffer, double suggestedLatency,
+                                 unsigned channels)
+    : device_(device)
+    , sampleRate_(sampleRate)
+    , framesPerBuffer_(framesPerBuffer)
+    , suggestedLatency_(suggestedLatency)
+    , channels_(channels) {}
+
+PortAudioSource::~PortAudioSource() {
+    abort();
+}
+
+void PortAudioSource::start(AudioSink& sink) {
+    if (stream_) {
+        throw AudioCaptureException("Stream already active");
+    }
+    sink_ = &sink;
+
+    PaStreamParameters inputParameters;
+    inputParameters.device = device_;
+    inputParameters.channelCount = static_cast<int>(channels_);  // Interleaved
+    inputParameters.sampleFormat = paFloat32;
+    inputParameters.suggestedLatency = suggestedLatency_;
+    inputParameters.hostApiSpecificStreamInfo = nullptr;
+
+    PaError err = Pa_OpenStream(&stream_,
+                                &inputParameters,
+                                nullptr,  // No output
+                                sampleRate_,
+                                framesPerBuffer_,
+                                paClipOff | paDitherOff,
+                                PortAudioSource::paCallback,
+                                this);
+    if (err != paNoError) {
+        stream_ = nullptr;
+        throw AudioCaptureException(std::string("Failed to open stream: ") + Pa_GetErrorText(err));
+    }
+
+    err = Pa_StartStream(stream_);
+    if (err != paNoError) {
+        Pa_CloseStream(stream_);
+        stream_ = nullptr;
+        throw AudioCaptureException(std::string("Failed to start stream: ") + Pa_GetErrorText(err));
+    }
+}
+
+void PortAudioSource::stop() {
+    if (!stream_) return;
+
+    PaError err = Pa_StopStream(stream_);
+    if (err != paNoError) {
+        throw AudioCaptureException(std::string("Error stopping stream: ") + Pa_GetErrorText(err));
+    }
+
+    err = Pa_CloseStream(stream_);
+    if (err != paNoError) {
+        throw AudioCaptureException(std::string("Error closing stream: ") + Pa_GetErrorText(err));
+    }
+    stream_ = nullptr;
+}
+
+void PortAudioSource::abort() {
+    if (!stream_) return;
+
+    Pa_AbortStream(stream_);
+    Pa_CloseStream(stream_);
+    stream_ = nullptr;
+}
+
+bool PortAudioSource::isActive() const {
+    return stream_ != nullptr && Pa_IsStreamActive(stream_) == 1;
+}
+
+std::string PortAudioSource::describe() const {
+    const PaStreamInfo* streamInfo = stream_ ? Pa_GetStreamInfo(stream_) : nullptr;
+    const std::string channels = channels_ > 1 ? fmt::format(", {} channels", channels_) : "";
+    if (streamInfo) {
+        return fmt::format("{:.1f} Hz, {} frames/buffer, {:.1f}ms latency{}",
+                           streamInfo->sampleRate, framesPerBuffer_,
+                           streamInfo->inputLatency * 1000.0, channels);
+    }
+    return fmt::format("{:.1f} Hz, {} frames/buffer{}", sampleRate_, framesPerBuffer_, channels);
+}
+
+int PortAudioSource::paCallback(const void* inputBuffer, void* outputBuffer,
+                                unsigned long framesPerBuffer,
+                                const PaStreamCallbackTimeInfo* timeInfo,
+                                PaStreamCallbackFlags statusFlags,
+                                void* userData) {
+    (void)outputBuffer;  // Unused
+
+    auto* source = static_cast<PortAudioSource*>(userData);
+
+    AudioBlockInfo info;
+    if (timeInfo) {
+        info.adcTime = timeInfo->inputBufferAdcTime;
+        info.currentTime = timeInfo->currentTime;
+    }
+    info.statusFlags = statusFlags;
+    info.channels = source->channels_;
+
+    switch (source->sink_->processBlock(static_cast<const float*>(inputBuffer),
+                                        framesPerBuffer, info)) {
+        case SinkStatus::Continue: return paContinue;
+        case SinkStatus::Complete: return paComplete;
+        case SinkStatus::Abort:    return paAbort;
+    }
+    return paAbort;
+}
+
+} // namespace ptm
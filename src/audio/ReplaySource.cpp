@@ -0,0 +1,166 @@
+#include "audio/ReplaySource.hpp"
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace ptm {
+
+namespace {
+    // How often an unpaced source checks whether the sink has drained
+    constexpr std::chrono::microseconds kBackpressurePoll{100};
+}
+
+ReplaySource::ReplaySource(double sampleRate, const ReplayConfig& config)
+    : sampleRate_(sampleRate)
+    , config_(config) {
+    if (!(sampleRate_ > 0.0)) {
+        throw std::invalid_argument("Sample rate must be positive");
+    }
+    if (config_.framesPerBuffer == 0) {
+        throw std::invalid_argument("Frames per buffer must be non-zero");
+    }
+    if (config_.channels == 0) {
+        throw std::invalid_argument("Channel count must be non-zero");
+    }
+    if (!(config_.speed >= 0.0)) {
+        throw std::invalid_argument("Replay speed must not be negative");
+    }
+}
+
+ReplaySource::~ReplaySource() {
+    stop();
+}
+
+void ReplaySource::start(AudioSink& sink) {
+    if (thread_.joinable()) {
+        throw AudioCaptureException("Stream already active");
+    }
+
+    stopRequested_.store(false, std::memory_order_relaxed);
+    framesDelivered_.store(0, std::memory_order_relaxed);
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&ReplaySource::run, this, std::ref(sink));
+}
+
+void ReplaySource::stop() {
+    if (!thread_.joinable()) return;
+
+    stopRequested_.store(true, std::memory_order_release);
+    thread_.join();
+}
+
+std::string ReplaySource::describe() const {
+    const std::string pace = config_.speed > 0.0 ? fmt::format("{:g}x real time", config_.speed)
+                                                 : std::string("unpaced");
+    const std::string channels = config_.channels > 1
+        ? fmt::format(", {} channels", config_.channels) : std::string();
+    return fmt::format("{}: {:.1f} Hz, {} frames/buffer{}, {}{}", name(), sampleRate_,
+                       config_.framesPerBuffer, channels, pace, config_.loop ? ", looped" : "");
+}
+
+void ReplaySource::run(AudioSink& sink) {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<float> block(config_.framesPerBuffer * config_.channels);
+    const Clock::time_point wallStart = Clock::now();
+    uint64_t streamPosition = 0;  // Drives the simulated clock
+    uint64_t signalPosition = 0;  // Restarts on each loop
+
+    while (!stopRequested_.load(std::memory_order_acquire)) {
+        size_t frames = render(signalPosition, block.data(), config_.framesPerBuffer);
+        if (frames == 0) {
+            // A signal that is empty from the start would spin forever
+            if (!config_.loop || signalPosition == 0) break;
+            signalPosition = 0;
+            continue;
+        }
+
+        AudioBlockInfo info;
+        info.adcTime = static_cast<double>(streamPosition) / sampleRate_;
+        info.currentTime = static_cast<double>(streamPosition + frames) / sampleRate_;
+        info.channels = config_.channels;
+
+        if (config_.speed > 0.0) {
+            std::this_thread::sleep_until(
+                wallStart + std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::duration<double>(info.currentTime / config_.speed)));
+        } else {
+            while (!sink.hasRoomFor(frames)) {
+                if (stopRequested_.load(std::memory_order_acquire)) {
+                    running_.store(false, std::memory_order_release);
+                    return;
+                }
+                std::this_thread::sleep_for(kBackpressurePoll);
+            }
+        }
+
+        const SinkStatus status = sink.processBlock(block.data(), frames, info);
+        streamPosition += frames;
+        signalPosition += frames;
+        framesDelivered_.store(streamPosition, std::memory_order_relaxed);
+        if (status != SinkStatus::Continue) break;
+    }
+    running_.store(false, std::memory_order_release);
+}
+
+WavFileSource::WavFileSource(const std::string& path, const ReplayConfig& config)
+    : WavFileSource(std::make_unique<MappedWavFile>(path), path, config) {}
+
+WavFileSource::WavFileSource(std::unique_ptr<MappedWavFile> file, const std::string& path,
+                             const ReplayConfig& config)
+    : ReplaySource(file->sampleRate(), config)
+    , path_(path)
+    , file_(std::move(file)) {
+    if (config.channels != 1) {
+        throw std::invalid_argument("WAV files are replayed in mono");
+    }
+}
+
+WavFileSource::~WavFileSource() {
+    stop();
+}
+
+size_t WavFileSource::render(uint64_t position, float* out, size_t frames) {
+    return file_->readFrames(position, frames, out);
+}
+
+SyntheticSource::SyntheticSource(double sampleRate, std::vector<float> samples,
+                                 const ReplayConfig& config)
+    : ReplaySource(sampleRate, config)
+    , samples_(std::move(samples)) {}
+
+SyntheticSource::SyntheticSource(double sampleRate, SignalGenerator generator,
+                                 const ReplayConfig& config)
+    : ReplaySource(sampleRate, config)
+    , generator_(std::move(generator)) {
+    if (!generator_) {
+        throw std::invalid_argument("Signal generator must not be empty");
+    }
+}
+
+SyntheticSource::~SyntheticSource() {
+    stop();
+}
+
+size_t SyntheticSource::render(uint64_t position, float* out, size_t frames) {
+    if (generator_) {
+        generator_(position, out, frames);
+        return frames;
+    }
+    const size_t channels = this->channels();
+    const size_t totalFrames = samples_.size() / channels;
+    if (position >= totalFrames) return 0;
+
+    const size_t count = std::min(frames, totalFrames - static_cast<size_t>(position));
+    std::copy_n(samples_.begin() + static_cast<std::ptrdiff_t>(position * channels),
+                count * channels, out);
+    return count;
+}
+
+std::string SyntheticSource::name() const {
+    return generator_ ? std::string("generator")
+                      : fmt::format("{} synthetic samples", samples_.size());
+}
+
+} // namespace ptm
@@ -0,0 +1,92 @@
+#include "audio/StreamStats.hpp"
+#include <algorithm>
+
+namespace ptm {
+
+StreamStats::StreamStats(std::chrono::nanoseconds window)
+    : windowNs_(std::max<int64_t>(window.count(), 1)) {}
+
+void StreamStats::begin(double sampleRate) {
+    sampleRate_ = sampleRate;
+    pending_ = StreamStatsWindow{};
+    total_ = StreamStatsWindow{};
+    current_ = StreamStatsWindow{};
+    recent_ = StreamStatsWindow{};
+    windowStartNs_ = 0;
+    published_.store(Published{});
+    callbackDuration_.reset();
+    latency_.reset();
+}
+
+uint64_t StreamStats::addUnderrun() {
+    ++pending_.underruns;
+    return total_.underruns + pending_.underruns;
+}
+
+uint64_t StreamStats::addOverrun() {
+    ++pending_.overruns;
+    return total_.overruns + pending_.overruns;
+}
+
+uint64_t StreamStats::addRingOverflow(uint64_t droppedSamples) {
+    ++pending_.ringOverflows;
+    pending_.droppedSamples += droppedSamples;
+    return total_.ringOverflows + pending_.ringOverflows;
+}
+
+void StreamStats::endCallback(int64_t startNs, int64_t endNs, double latencySeconds, size_t frames) {
+    const int64_t durationNs = endNs - startNs;
+    const double period = sampleRate_ > 0.0 ? static_cast<double>(frames) / sampleRate_ : 0.0;
+
+    callbackDuration_.record(durationNs);
+    if (latencySeconds > 0.0) {
+        latency_.record(static_cast<int64_t>(latencySeconds * 1e9));
+    }
+
+    pending_.callbacks = 1;
+    pending_.frames = frames;
+    pending_.seconds = period;
+    pending_.maxLatency = latencySeconds;
+    pending_.maxLoad = period > 0.0 ? static_cast<double>(durationNs) / 1e9 / period : 0.0;
+
+    // A callback that starts a new window closes the previous one
+    if (windowStartNs_ == 0) {
+        windowStartNs_ = startNs;
+    } else if (startNs - windowStartNs_ >= windowNs_) {
+        recent_ = current_;
+        current_ = StreamStatsWindow{};
+        windowStartNs_ = startNs;
+    }
+    accumulate(total_, pending_);
+    accumulate(current_, pending_);
+    pending_ = StreamStatsWindow{};
+
+    published_.store(Published{latencySeconds, endNs, total_, recent_});
+}
+
+StreamStatsSnapshot StreamStats::snapshot() const {
+    const Published published = published_.load();
+
+    StreamStatsSnapshot snapshot;
+    snapshot.currentLatency = published.currentLatency;
+    snapshot.lastCallbackNs = published.lastCallbackNs;
+    snapshot.total = published.total;
+    snapshot.recent = published.recent;
+    snapshot.callbackDuration = callbackDuration_.summary();
+    snapshot.latency = latency_.summary();
+    return snapshot;
+}
+
+void StreamStats::accumulate(StreamStatsWindow& window, const StreamStatsWindow& callback) {
+    window.seconds += callback.seconds;
+    window.callbacks += callback.callbacks;
+    window.frames += callback.frames;
+    window.underruns += callback.underruns;
+    window.overruns += callback.overruns;
+    window.ringOverflows += callback.ringOverflows;
+    window.droppedSamples += callback.droppedSamples;
+    window.maxLatency = std::max(window.maxLatency, callback.maxLatency);
+    window.maxLoad = std::max(window.maxLoad, callback.maxLoad);
+}
+
+} // namespace ptm
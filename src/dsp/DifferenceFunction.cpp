@@ -0,0 +1,142 @@
+#include "dsp/DifferenceFunction.hpp"
+#include "dsp/Kernels.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace ptm {
+
+// The correlation needs no zero padding beyond the window: with the
+// first half as one operand, j + tau never wraps for tau < windowSize / 2
+size_t DifferenceFunction::fftSizeFor(size_t windowSize) {
+    if (windowSize < 4) {
+        throw std::invalid_argument("Window size must be at least 4 samples, got " +
+                                    std::to_string(windowSize));
+    }
+    size_t result = 4;
+    while (result < windowSize) result <<= 1;
+    return result;
+}
+
+DifferenceFunction::DifferenceFunction(size_t windowSize, size_t hopSize, size_t resyncInterval)
+    : DifferenceFunction(windowSize, std::make_unique<RealFft>(fftSizeFor(windowSize)), nullptr,
+                         hopSize, resyncInterval) {}
+
+DifferenceFunction::DifferenceFunction(size_t windowSize, RealFft& fft, size_t hopSize,
+                                       size_t resyncInterval)
+    : DifferenceFunction(windowSize, nullptr, &fft, hopSize, resyncInterval) {}
+
+DifferenceFunction::DifferenceFunction(size_t windowSize, std::unique_ptr<RealFft> ownedFft,
+                                       RealFft* fft, size_t hopSize, size_t resyncInterval)
+    : windowSize_(windowSize)
+    , integrationSize_(windowSize / 2)
+    , hopSize_(hopSize < windowSize / 2 ? hopSize : 0)
+    , resyncInterval_(std::max<size_t>(resyncInterval, 1))
+    , ownedFft_(std::move(ownedFft))
+    , fft_(fft ? fft : ownedFft_.get())
+    , windowSpectrum_(fft_->bins())
+    , prefixEnergy_(windowSize + 1, 0.0)
+    , values_(integrationSize_, 0.0f) {
+    if (fft_->size() != fftSizeFor(windowSize_)) {
+        throw std::invalid_argument("Window size " + std::to_string(windowSize_) +
+                                    " needs a transform of " +
+                                    std::to_string(fftSizeFor(windowSize_)) + ", got " +
+                                    std::to_string(fft_->size()));
+    }
+    if (isIncremental()) {
+        running_.assign(integrationSize_, 0.0);
+        entering_.assign(integrationSize_, 0.0f);
+        leaving_.assign(integrationSize_, 0.0f);
+        previous_.assign(hopSize_ + integrationSize_, 0.0f);
+    }
+}
+
+void DifferenceFunction::compute(const float* window) {
+    if (!isIncremental() || !hasPrevious_ || hopsSinceResync_ >= resyncInterval_) {
+        computeExact(window);
+    } else {
+        computeIncremental(window);
+    }
+
+    if (isIncremental()) {
+        // The next hop's leaving terms pair each of this window's first
+        // hopSize samples with the integrationSize that follow it
+        std::copy(window, window + previous_.size(), previous_.begin());
+        hasPrevious_ = true;
+    }
+}
+
+void DifferenceFunction::reset() {
+    hasPrevious_ = false;
+    hopsSinceResync_ = 0;
+}
+
+void DifferenceFunction::computeExact(const float* window) {
+    const size_t fftSize = fft_->size();
+    const size_t bins = fft_->bins();
+    double* real = fft_->real();
+    RealFft::Complex* spectrum = fft_->spectrum();
+
+    // Spectrum of the whole window, plus running energy
+    for (size_t j = 0; j < windowSize_; ++j) {
+        double sample = window[j];
+        real[j] = sample;
+        prefixEnergy_[j + 1] = prefixEnergy_[j] + sample * sample;
+    }
+    std::fill(real + windowSize_, real + fftSize, 0.0);
+    fft_->forward();
+    std::copy(spectrum, spectrum + bins, windowSpectrum_.begin());
+
+    // Spectrum of the integration window (first half)
+    std::fill(real + integrationSize_, real + fftSize, 0.0);
+    fft_->forward();
+
+    // r(tau) = sum_j x[j] x[j + tau] = IFFT(conj(A) * B)
+    // (written out: std::complex operator* takes a slow NaN-safe path)
+    for (size_t k = 0; k < bins; ++k) {
+        const RealFft::Complex a = spectrum[k];
+        const RealFft::Complex b = windowSpectrum_[k];
+        spectrum[k] = {a.real() * b.real() + a.imag() * b.imag(),
+                       a.real() * b.imag() - a.imag() * b.real()};
+    }
+    fft_->inverse();
+
+    // d(tau) = sum x[j]^2 + sum x[j + tau]^2 - 2 r(tau)
+    const double scale = 2.0 / static_cast<double>(fftSize);
+    energy_ = prefixEnergy_[integrationSize_];
+    for (size_t tau = 0; tau < integrationSize_; ++tau) {
+        double laggedEnergy = prefixEnergy_[tau + integrationSize_] - prefixEnergy_[tau];
+        double value = std::max(energy_ + laggedEnergy - scale * real[tau], 0.0);
+        values_[tau] = static_cast<float>(value);
+        if (isIncremental()) running_[tau] = value;
+    }
+
+    hopsSinceResync_ = 0;
+    ++exactComputations_;
+}
+
+void DifferenceFunction::computeIncremental(const float* window) {
+    // Relative to the new window, j in [integrationSize - hop, integrationSize)
+    // entered the integration window; relative to the previous one,
+    // j in [0, hop) left it. Each j contributes (x[j] - x[j + tau])^2 to
+    // every lag, a contiguous run of x.
+    std::fill(entering_.begin(), entering_.end(), 0.0f);
+    std::fill(leaving_.begin(), leaving_.end(), 0.0f);
+    for (size_t j = integrationSize_ - hopSize_; j < integrationSize_; ++j) {
+        accumulateSquaredDifference(window[j], window + j, entering_.data(), integrationSize_);
+    }
+    for (size_t j = 0; j < hopSize_; ++j) {
+        accumulateSquaredDifference(previous_[j], previous_.data() + j, leaving_.data(),
+                                    integrationSize_);
+    }
+
+    for (size_t tau = 0; tau < integrationSize_; ++tau) {
+        running_[tau] += static_cast<double>(entering_[tau]) - static_cast<double>(leaving_[tau]);
+        values_[tau] = static_cast<float>(std::max(running_[tau], 0.0));
+    }
+    energy_ = sumOfSquares(window, integrationSize_);
+    ++hopsSinceResync_;
+}
+
+} // namespace ptm
@@ -0,0 +1,248 @@
+#include "dsp/Fft.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef USE_FFTW
+#include <fftw3.h>
+#endif
+
+namespace ptm {
+
+namespace {
+    bool isPowerOfTwo(size_t value) {
+        return value != 0 && (value & (value - 1)) == 0;
+    }
+
+#ifdef USE_FFTW
+    // The FFTW planner, including wisdom and plan destruction, is not
+    // thread-safe; only fftw_execute() is
+    std::mutex& plannerMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+#else
+    // Plain complex product; operator* goes through the NaN/Inf-correct
+    // library routine unless built with -ffast-math, which is several times
+    // slower in the butterflies
+    inline std::complex<double> multiply(std::complex<double> a, std::complex<double> b) {
+        return {a.real() * b.real() - a.imag() * b.imag(),
+                a.real() * b.imag() + a.imag() * b.real()};
+    }
+#endif
+}
+
+#ifdef USE_FFTW
+
+struct RealFft::Impl {
+    double* real = nullptr;
+    fftw_complex* spectrum = nullptr;
+    fftw_plan forwardPlan = nullptr;
+    fftw_plan inversePlan = nullptr;
+
+    explicit Impl(size_t size) {
+        real = fftw_alloc_real(size);
+        spectrum = fftw_alloc_complex(size / 2 + 1);
+        if (!real || !spectrum) {
+            release();
+            throw std::bad_alloc();
+        }
+
+        // Planning is slow but happens once, here, never on the processing path
+        std::lock_guard<std::mutex> lock(plannerMutex());
+        forwardPlan = fftw_plan_dft_r2c_1d(static_cast<int>(size), real, spectrum, FFTW_MEASURE);
+        inversePlan = fftw_plan_dft_c2r_1d(static_cast<int>(size), spectrum, real, FFTW_MEASURE);
+        if (!forwardPlan || !inversePlan) {
+            destroyPlans();
+            release();
+            throw std::runtime_error("Failed to create FFTW plans");
+        }
+    }
+
+    ~Impl() {
+        {
+            std::lock_guard<std::mutex> lock(plannerMutex());
+            destroyPlans();
+        }
+        release();
+    }
+
+    // Planner lock held
+    void destroyPlans() {
+        if (forwardPlan) fftw_destroy_plan(forwardPlan);
+        if (inversePlan) fftw_destroy_plan(inversePlan);
+        forwardPlan = inversePlan = nullptr;
+    }
+
+    void release() {
+        fftw_free(real);
+        fftw_free(spectrum);
+        real = nullptr;
+        spectrum = nullptr;
+    }
+
+    void forward() { fftw_execute(forwardPlan); }
+    void inverse() { fftw_execute(inversePlan); }
+};
+
+#else
+
+// A real transform of size N runs as a complex transform of size N/2 on the
+// even/odd sample pairs, followed by a split step that separates the two
+struct RealFft::Impl {
+    size_t size;
+    size_t half;
+    std::vector<double> real;
+    std::vector<Complex> spectrum;
+    std::vector<Complex> work;
+    std::vector<Complex> twiddles;       // exp(-2 pi i k / half), k < half / 2
+    std::vector<Complex> splitTwiddles;  // exp(-2 pi i k / size), k <= half
+    std::vector<uint32_t> bitReverse;
+
+    explicit Impl(size_t n)
+        : size(n)
+        , half(n / 2)
+        , real(n, 0.0)
+        , spectrum(half + 1)
+        , work(half)
+        , twiddles(std::max<size_t>(half / 2, 1))
+        , splitTwiddles(half + 1)
+        , bitReverse(half) {
+        const double pi = std::acos(-1.0);
+        for (size_t k = 0; k < twiddles.size(); ++k) {
+            twiddles[k] = std::polar(1.0, -2.0 * pi * static_cast<double>(k) / static_cast<double>(half));
+        }
+        for (size_t k = 0; k <= half; ++k) {
+            splitTwiddles[k] = std::polar(1.0, -2.0 * pi * static_cast<double>(k) / static_cast<double>(size));
+        }
+
+        size_t bits = 0;
+        while ((size_t{1} << bits) < half) ++bits;
+        for (size_t i = 0; i < half; ++i) {
+            size_t reversed = 0;
+            for (size_t b = 0; b < bits; ++b) {
+                if (i & (size_t{1} << b)) reversed |= size_t{1} << (bits - 1 - b);
+            }
+            bitReverse[i] = static_cast<uint32_t>(reversed);
+        }
+    }
+
+    void transform(bool inverse) {
+        for (size_t i = 0; i < half; ++i) {
+            size_t j = bitReverse[i];
+            if (i < j) std::swap(work[i], work[j]);
+        }
+
+        for (size_t length = 2; length <= half; length <<= 1) {
+            const size_t span = length / 2;
+            const size_t stride = half / length;
+            for (size_t start = 0; start < half; start += length) {
+                for (size_t k = 0; k < span; ++k) {
+                    Complex w = twiddles[k * stride];
+                    if (inverse) w = std::conj(w);
+                    Complex even = work[start + k];
+                    Complex odd = multiply(work[start + k + span], w);
+                    work[start + k] = even + odd;
+                    work[start + k + span] = even - odd;
+                }
+            }
+        }
+    }
+
+    void forward() {
+        for (size_t n = 0; n < half; ++n) {
+            work[n] = Complex(real[2 * n], real[2 * n + 1]);
+        }
+        transform(false);
+
+        const Complex minusHalfI(0.0, -0.5);
+        for (size_t k = 0; k <= half; ++k) {
+            Complex z = work[k % half];
+            Complex zMirror = std::conj(work[(half - k) % half]);
+            Complex even = (z + zMirror) * 0.5;
+            Complex odd = multiply(z - zMirror, minusHalfI);
+            spectrum[k] = even + multiply(splitTwiddles[k], odd);
+        }
+    }
+
+    void inverse() {
+        const Complex i(0.0, 1.0);
+        for (size_t k = 0; k < half; ++k) {
+            Complex x = spectrum[k];
+            Complex xMirror = std::conj(spectrum[half - k]);
+            Complex even = x + xMirror;
+            Complex odd = multiply(x - xMirror, std::conj(splitTwiddles[k]));
+            work[k] = even + multiply(i, odd);
+        }
+        transform(true);
+
+        for (size_t n = 0; n < half; ++n) {
+            real[2 * n] = work[n].real();
+            real[2 * n + 1] = work[n].imag();
+        }
+    }
+};
+
+#endif
+
+RealFft::RealFft(size_t size)
+    : size_(size) {
+    if (size < 4 || !isPowerOfTwo(size)) {
+        throw std::invalid_argument("FFT size must be a power of two >= 4, got " +
+                                    std::to_string(size));
+    }
+    impl_ = std::make_unique<Impl>(size);
+}
+
+RealFft::~RealFft() = default;
+
+double* RealFft::real() {
+#ifdef USE_FFTW
+    return impl_->real;
+#else
+    return impl_->real.data();
+#endif
+}
+
+RealFft::Complex* RealFft::spectrum() {
+#ifdef USE_FFTW
+    // fftw_complex is layout-compatible with std::complex<double>
+    return reinterpret_cast<Complex*>(impl_->spectrum);
+#else
+    return impl_->spectrum.data();
+#endif
+}
+
+void RealFft::forward() {
+    impl_->forward();
+}
+
+void RealFft::inverse() {
+    impl_->inverse();
+}
+
+bool RealFft::importWisdom(const std::string& path) {
+#ifdef USE_FFTW
+    std::lock_guard<std::mutex> lock(plannerMutex());
+    return fftw_import_wisdom_from_filename(path.c_str()) != 0;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool RealFft::exportWisdom(const std::string& path) {
+#ifdef USE_FFTW
+    std::lock_guard<std::mutex> lock(plannerMutex());
+    return fftw_export_wisdom_to_filename(path.c_str()) != 0;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+} // namespace ptm
@@ -0,0 +1,107 @@
+#include "dsp/FftPlanCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace ptm {
+
+namespace {
+    // Checked here so that the background thread only fails on resources
+    std::vector<size_t> validatedSizes(std::vector<size_t> sizes) {
+        std::vector<size_t> result;
+        for (size_t size : sizes) {
+            if (size < 4 || (size & (size - 1)) != 0) {
+                throw std::invalid_argument("FFT size must be a power of two >= 4, got " +
+                                            std::to_string(size));
+            }
+            if (std::find(result.begin(), result.end(), size) == result.end()) {
+                result.push_back(size);
+            }
+        }
+        return result;
+    }
+}
+
+FftPlanCache::FftPlanCache(std::vector<size_t> sizes, std::string wisdomPath)
+    : sizes_(validatedSizes(std::move(sizes)))
+    , wisdomPath_(std::move(wisdomPath)) {
+    entries_.reserve(sizes_.size());
+    for (size_t size : sizes_) {
+        auto entry = std::make_unique<Entry>();
+        entry->size = size;
+        entries_.push_back(std::move(entry));
+    }
+}
+
+FftPlanCache::~FftPlanCache() {
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void FftPlanCache::start() {
+    if (started_.exchange(true)) return;
+    thread_ = std::thread(&FftPlanCache::run, this);
+}
+
+void FftPlanCache::build() {
+    if (started_.exchange(true)) {
+        waitUntilReady();
+        return;
+    }
+    run();
+}
+
+void FftPlanCache::waitUntilReady() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    readyCondition_.wait(lock, [this] { return isReady(); });
+}
+
+RealFft* FftPlanCache::find(size_t size) const {
+    for (const auto& entry : entries_) {
+        if (entry->size == size) {
+            return entry->built.load(std::memory_order_acquire) ? entry->fft.get() : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+std::string FftPlanCache::error() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+void FftPlanCache::run() {
+    const auto begin = std::chrono::steady_clock::now();
+    if (!wisdomPath_.empty()) {
+        wisdomImported_ = RealFft::importWisdom(wisdomPath_);
+    }
+
+    for (auto& entry : entries_) {
+        try {
+            entry->fft = std::make_unique<RealFft>(entry->size);
+            entry->built.store(true, std::memory_order_release);
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error_.empty()) {
+                error_ = "FFT of size " + std::to_string(entry->size) + ": " + e.what();
+            }
+        }
+    }
+
+    // Wisdom accumulates: a failed write only costs the next run its head start
+    if (!wisdomPath_.empty()) {
+        RealFft::exportWisdom(wisdomPath_);
+    }
+    buildSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.store(true, std::memory_order_release);
+    }
+    readyCondition_.notify_all();
+}
+
+} // namespace ptm
@@ -0,0 +1,184 @@
+#include "dsp/Kernels.hpp"
+#include <cmath>
+
+#if defined(PTM_X86_KERNELS)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #include <immintrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+namespace ptm {
+
+namespace detail {
+#if defined(PTM_X86_KERNELS)
+    // Defined in KernelsSse2.cpp, KernelsAvx2.cpp and KernelsAvx512.cpp, each
+    // compiled for its own instruction set
+    const KernelTable& sse2KernelTable();
+    const KernelTable& avx2KernelTable();
+    const KernelTable& avx512KernelTable();
+#endif
+}
+
+namespace {
+    float scalarSumOfSquares(const float* x, size_t n) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            sum += x[i] * x[i];
+        }
+        return sum;
+    }
+
+    float scalarPeak(const float* x, size_t n) {
+        float result = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            float magnitude = std::fabs(x[i]);
+            if (magnitude > result) result = magnitude;
+        }
+        return result;
+    }
+
+    float scalarDot(const float* a, const float* b, size_t n) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    float scalarSquaredDifference(const float* a, const float* b, size_t n) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            float delta = a[i] - b[i];
+            sum += delta * delta;
+        }
+        return sum;
+    }
+
+    void scalarAccumulateSquaredDifference(float value, const float* x, float* acc, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            float delta = value - x[i];
+            acc[i] += delta * delta;
+        }
+    }
+
+    void scalarCumulativeMeanNormalize(const float* d, float* out, size_t n) {
+        if (n == 0) return;
+        out[0] = 1.0f;
+        float runningSum = 0.0f;
+        for (size_t t = 1; t < n; ++t) {
+            float value = d[t];
+            runningSum += value;
+            out[t] = runningSum > 0.0f ? value * static_cast<float>(t) / runningSum : 1.0f;
+        }
+    }
+
+    const KernelTable kScalarKernels = {
+        InstructionSet::Scalar,
+        scalarSumOfSquares,
+        scalarPeak,
+        scalarDot,
+        scalarSquaredDifference,
+        scalarAccumulateSquaredDifference,
+        scalarCumulativeMeanNormalize
+    };
+
+#if defined(PTM_X86_KERNELS)
+    struct CpuidRegisters {
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    };
+
+    CpuidRegisters cpuid(unsigned int leaf, unsigned int subleaf) {
+        CpuidRegisters regs;
+    #if defined(_MSC_VER)
+        int values[4];
+        __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+        regs.eax = values[0];
+        regs.ebx = values[1];
+        regs.ecx = values[2];
+        regs.edx = values[3];
+    #else
+        __cpuid_count(leaf, subleaf, regs.eax, regs.ebx, regs.ecx, regs.edx);
+    #endif
+        return regs;
+    }
+
+    // Register state the operating system saves on context switch (XCR0)
+    unsigned long long enabledStateComponents() {
+    #if defined(_MSC_VER)
+        return _xgetbv(0);
+    #else
+        unsigned int eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<unsigned long long>(edx) << 32) | eax;
+    #endif
+    }
+#endif
+}
+
+const char* toString(InstructionSet isa) {
+    switch (isa) {
+        case InstructionSet::Scalar: return "scalar";
+        case InstructionSet::SSE2: return "sse2";
+        case InstructionSet::AVX2: return "avx2";
+        case InstructionSet::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+InstructionSet detectInstructionSet() {
+#if defined(PTM_X86_KERNELS)
+    const unsigned int maxLeaf = cpuid(0, 0).eax;
+    const CpuidRegisters features = cpuid(1, 0);
+    if (!(features.edx & (1u << 26))) {
+        return InstructionSet::Scalar;
+    }
+
+    // AVX state needs OS support as well as CPU support
+    const bool osxsave = features.ecx & (1u << 27);
+    const unsigned long long xcr0 = osxsave ? enabledStateComponents() : 0;
+    const bool avxState = (xcr0 & 0x6) == 0x6;             // XMM, YMM
+    const bool avx512State = (xcr0 & 0xe6) == 0xe6;        // + opmask, ZMM
+
+    if (maxLeaf >= 7 && avxState) {
+        const CpuidRegisters extended = cpuid(7, 0);
+        const bool avx = features.ecx & (1u << 28);
+        const bool fma = features.ecx & (1u << 12);
+        const bool avx2 = extended.ebx & (1u << 5);
+        const bool avx512f = extended.ebx & (1u << 16);
+
+        if (avx512f && avx512State) return InstructionSet::AVX512;
+        if (avx && avx2 && fma) return InstructionSet::AVX2;
+    }
+    return InstructionSet::SSE2;
+#else
+    return InstructionSet::Scalar;
+#endif
+}
+
+const KernelTable* kernelsFor(InstructionSet isa) {
+    if (isa == InstructionSet::Scalar) {
+        return &kScalarKernels;
+    }
+#if defined(PTM_X86_KERNELS)
+    if (static_cast<int>(isa) > static_cast<int>(detectInstructionSet())) {
+        return nullptr;
+    }
+    switch (isa) {
+        case InstructionSet::SSE2: return &detail::sse2KernelTable();
+        case InstructionSet::AVX2: return &detail::avx2KernelTable();
+        case InstructionSet::AVX512: return &detail::avx512KernelTable();
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+const KernelTable& kernels() {
+    static const KernelTable& selected = *kernelsFor(detectInstructionSet());
+    return selected;
+}
+
+} // namespace ptm
@@ -0,0 +1,181 @@
+// Compiled with AVX2 and FMA enabled; only reached after the CPUID check in
+// Kernels.cpp. Keep standard library headers out of this file (see
+// KernelsSse2.cpp).
+#include "dsp/Kernels.hpp"
+#include <immintrin.h>
+
+namespace ptm {
+
+namespace {
+    inline float horizontalSum(__m256 v) {
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+    }
+
+    inline float horizontalMax(__m256 v) {
+        __m128 result = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        result = _mm_max_ps(result, _mm_movehl_ps(result, result));
+        result = _mm_max_ss(result, _mm_shuffle_ps(result, result, 1));
+        return _mm_cvtss_f32(result);
+    }
+
+    inline __m256 absolute(__m256 v) {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+    }
+
+    float sumOfSquares(const float* x, size_t n) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m256 a = _mm256_loadu_ps(x + i);
+            __m256 b = _mm256_loadu_ps(x + i + 8);
+            acc0 = _mm256_fmadd_ps(a, a, acc0);
+            acc1 = _mm256_fmadd_ps(b, b, acc1);
+        }
+        if (i + 8 <= n) {
+            __m256 a = _mm256_loadu_ps(x + i);
+            acc0 = _mm256_fmadd_ps(a, a, acc0);
+            i += 8;
+        }
+        float sum = horizontalSum(_mm256_add_ps(acc0, acc1));
+        for (; i < n; ++i) sum += x[i] * x[i];
+        return sum;
+    }
+
+    float peak(const float* x, size_t n) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            acc0 = _mm256_max_ps(acc0, absolute(_mm256_loadu_ps(x + i)));
+            acc1 = _mm256_max_ps(acc1, absolute(_mm256_loadu_ps(x + i + 8)));
+        }
+        if (i + 8 <= n) {
+            acc0 = _mm256_max_ps(acc0, absolute(_mm256_loadu_ps(x + i)));
+            i += 8;
+        }
+        float result = horizontalMax(_mm256_max_ps(acc0, acc1));
+        for (; i < n; ++i) {
+            float magnitude = x[i] < 0.0f ? -x[i] : x[i];
+            if (magnitude > result) result = magnitude;
+        }
+        return result;
+    }
+
+    float dot(const float* a, const float* b, size_t n) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+        }
+        if (i + 8 <= n) {
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+            i += 8;
+        }
+        float sum = horizontalSum(_mm256_add_ps(acc0, acc1));
+        for (; i < n; ++i) sum += a[i] * b[i];
+        return sum;
+    }
+
+    float squaredDifference(const float* a, const float* b, size_t n) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+            __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+            acc0 = _mm256_fmadd_ps(d0, d0, acc0);
+            acc1 = _mm256_fmadd_ps(d1, d1, acc1);
+        }
+        if (i + 8 <= n) {
+            __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+            acc0 = _mm256_fmadd_ps(d0, d0, acc0);
+            i += 8;
+        }
+        float sum = horizontalSum(_mm256_add_ps(acc0, acc1));
+        for (; i < n; ++i) {
+            float delta = a[i] - b[i];
+            sum += delta * delta;
+        }
+        return sum;
+    }
+
+    void accumulateSquaredDifference(float value, const float* x, float* acc, size_t n) {
+        const __m256 broadcast = _mm256_set1_ps(value);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 delta = _mm256_sub_ps(broadcast, _mm256_loadu_ps(x + i));
+            _mm256_storeu_ps(acc + i, _mm256_fmadd_ps(delta, delta, _mm256_loadu_ps(acc + i)));
+        }
+        for (; i < n; ++i) {
+            float delta = value - x[i];
+            acc[i] += delta * delta;
+        }
+    }
+
+    // Inclusive prefix sum of the eight lanes: scan each 128-bit half, then
+    // add the low half's total to the high half
+    inline __m256 prefixSum(__m256 v) {
+        v = _mm256_add_ps(v, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(v), 4)));
+        v = _mm256_add_ps(v, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(v), 8)));
+        __m256 lowTotal = _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3));
+        return _mm256_add_ps(v, _mm256_permute2f128_ps(lowTotal, lowTotal, 0x08));
+    }
+
+    inline __m256 broadcastLast(__m256 v) {
+        __m256 high = _mm256_permute2f128_ps(v, v, 0x11);
+        return _mm256_permute_ps(high, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    void cumulativeMeanNormalize(const float* d, float* out, size_t n) {
+        if (n == 0) return;
+        out[0] = 1.0f;
+
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 step = _mm256_set1_ps(8.0f);
+        __m256 lag = _mm256_setr_ps(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f);
+        __m256 carry = zero;
+
+        size_t t = 1;
+        for (; t + 8 <= n; t += 8) {
+            __m256 value = _mm256_loadu_ps(d + t);
+            __m256 running = _mm256_add_ps(prefixSum(value), carry);
+            __m256 normalized = _mm256_div_ps(_mm256_mul_ps(value, lag), running);
+            __m256 positive = _mm256_cmp_ps(running, zero, _CMP_GT_OQ);
+            _mm256_storeu_ps(out + t, _mm256_blendv_ps(one, normalized, positive));
+            carry = broadcastLast(running);
+            lag = _mm256_add_ps(lag, step);
+        }
+
+        float runningSum = _mm256_cvtss_f32(carry);
+        for (; t < n; ++t) {
+            float value = d[t];
+            runningSum += value;
+            out[t] = runningSum > 0.0f ? value * static_cast<float>(t) / runningSum : 1.0f;
+        }
+    }
+
+    const KernelTable kAvx2Kernels = {
+        InstructionSet::AVX2,
+        sumOfSquares,
+        peak,
+        dot,
+        squaredDifference,
+        accumulateSquaredDifference,
+        cumulativeMeanNormalize
+    };
+}
+
+namespace detail {
+    const KernelTable& avx2KernelTable() {
+        return kAvx2Kernels;
+    }
+}
+
+} // namespace ptm
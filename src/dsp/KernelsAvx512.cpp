@@ -0,0 +1,151 @@
+// Compiled with AVX-512F enabled; only reached after the CPUID check in
+// Kernels.cpp. Keep standard library headers out of this file (see
+// KernelsSse2.cpp).
+#include "dsp/Kernels.hpp"
+#include <immintrin.h>
+
+namespace ptm {
+
+namespace {
+    // Lanes [0, count) for a tail of count < 16 elements
+    inline __mmask16 tailMask(size_t count) {
+        return static_cast<__mmask16>((1u << count) - 1u);
+    }
+
+    inline __m512 absolute(__m512 v) {
+        return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(v),
+                                                    _mm512_set1_epi32(0x7fffffff)));
+    }
+
+    float sumOfSquares(const float* x, size_t n) {
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m512 a = _mm512_loadu_ps(x + i);
+            __m512 b = _mm512_loadu_ps(x + i + 16);
+            acc0 = _mm512_fmadd_ps(a, a, acc0);
+            acc1 = _mm512_fmadd_ps(b, b, acc1);
+        }
+        for (; i < n; i += 16) {
+            __mmask16 mask = n - i >= 16 ? static_cast<__mmask16>(0xffff) : tailMask(n - i);
+            __m512 a = _mm512_maskz_loadu_ps(mask, x + i);
+            acc0 = _mm512_fmadd_ps(a, a, acc0);
+        }
+        return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    }
+
+    float peak(const float* x, size_t n) {
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            acc0 = _mm512_max_ps(acc0, absolute(_mm512_loadu_ps(x + i)));
+            acc1 = _mm512_max_ps(acc1, absolute(_mm512_loadu_ps(x + i + 16)));
+        }
+        for (; i < n; i += 16) {
+            __mmask16 mask = n - i >= 16 ? static_cast<__mmask16>(0xffff) : tailMask(n - i);
+            acc0 = _mm512_max_ps(acc0, absolute(_mm512_maskz_loadu_ps(mask, x + i)));
+        }
+        return _mm512_reduce_max_ps(_mm512_max_ps(acc0, acc1));
+    }
+
+    float dot(const float* a, const float* b, size_t n) {
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+            acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+        }
+        for (; i < n; i += 16) {
+            __mmask16 mask = n - i >= 16 ? static_cast<__mmask16>(0xffff) : tailMask(n - i);
+            acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i),
+                                   _mm512_maskz_loadu_ps(mask, b + i), acc0);
+        }
+        return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    }
+
+    float squaredDifference(const float* a, const float* b, size_t n) {
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m512 d0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+            __m512 d1 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16));
+            acc0 = _mm512_fmadd_ps(d0, d0, acc0);
+            acc1 = _mm512_fmadd_ps(d1, d1, acc1);
+        }
+        for (; i < n; i += 16) {
+            __mmask16 mask = n - i >= 16 ? static_cast<__mmask16>(0xffff) : tailMask(n - i);
+            __m512 d0 = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i),
+                                      _mm512_maskz_loadu_ps(mask, b + i));
+            acc0 = _mm512_fmadd_ps(d0, d0, acc0);
+        }
+        return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    }
+
+    void accumulateSquaredDifference(float value, const float* x, float* acc, size_t n) {
+        const __m512 broadcast = _mm512_set1_ps(value);
+        for (size_t i = 0; i < n; i += 16) {
+            __mmask16 mask = n - i >= 16 ? static_cast<__mmask16>(0xffff) : tailMask(n - i);
+            __m512 delta = _mm512_sub_ps(broadcast, _mm512_maskz_loadu_ps(mask, x + i));
+            __m512 sum = _mm512_fmadd_ps(delta, delta, _mm512_maskz_loadu_ps(mask, acc + i));
+            _mm512_mask_storeu_ps(acc + i, mask, sum);
+        }
+    }
+
+    // Inclusive prefix sum of the sixteen lanes (Hillis-Steele scan)
+    inline __m512 prefixSum(__m512 v) {
+        const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                                8, 9, 10, 11, 12, 13, 14, 15);
+        for (int shift = 1; shift < 16; shift <<= 1) {
+            __m512i source = _mm512_sub_epi32(lanes, _mm512_set1_epi32(shift));
+            __mmask16 mask = static_cast<__mmask16>(0xffffu << shift);
+            v = _mm512_add_ps(v, _mm512_maskz_permutexvar_ps(mask, source, v));
+        }
+        return v;
+    }
+
+    void cumulativeMeanNormalize(const float* d, float* out, size_t n) {
+        if (n == 0) return;
+        out[0] = 1.0f;
+
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512 one = _mm512_set1_ps(1.0f);
+        const __m512 step = _mm512_set1_ps(16.0f);
+        const __m512i last = _mm512_set1_epi32(15);
+        __m512 lag = _mm512_setr_ps(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f,
+                                    9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f);
+        __m512 carry = zero;
+
+        for (size_t t = 1; t < n; t += 16) {
+            __mmask16 mask = n - t >= 16 ? static_cast<__mmask16>(0xffff) : tailMask(n - t);
+            __m512 value = _mm512_maskz_loadu_ps(mask, d + t);
+            __m512 running = _mm512_add_ps(prefixSum(value), carry);
+            __mmask16 positive = _mm512_cmp_ps_mask(running, zero, _CMP_GT_OQ);
+            __m512 normalized = _mm512_mask_div_ps(one, positive, _mm512_mul_ps(value, lag), running);
+            _mm512_mask_storeu_ps(out + t, mask, normalized);
+            carry = _mm512_permutexvar_ps(last, running);
+            lag = _mm512_add_ps(lag, step);
+        }
+    }
+
+    const KernelTable kAvx512Kernels = {
+        InstructionSet::AVX512,
+        sumOfSquares,
+        peak,
+        dot,
+        squaredDifference,
+        accumulateSquaredDifference,
+        cumulativeMeanNormalize
+    };
+}
+
+namespace detail {
+    const KernelTable& avx512KernelTable() {
+        return kAvx512Kernels;
+    }
+}
+
+} // namespace ptm
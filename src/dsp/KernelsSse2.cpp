@@ -0,0 +1,156 @@
+// Compiled with SSE2 enabled. Keep standard library headers out of this file:
+// inline functions instantiated here could be merged with the copies used by
+// code that runs before the CPUID check.
+#include "dsp/Kernels.hpp"
+#include <emmintrin.h>
+
+namespace ptm {
+
+namespace {
+    inline float horizontalSum(__m128 v) {
+        __m128 high = _mm_movehl_ps(v, v);
+        v = _mm_add_ps(v, high);
+        v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+        return _mm_cvtss_f32(v);
+    }
+
+    inline float horizontalMax(__m128 v) {
+        v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+        v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+        return _mm_cvtss_f32(v);
+    }
+
+    inline __m128 absolute(__m128 v) {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    }
+
+    float sumOfSquares(const float* x, size_t n) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m128 a = _mm_loadu_ps(x + i);
+            __m128 b = _mm_loadu_ps(x + i + 4);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+        }
+        float sum = horizontalSum(_mm_add_ps(acc0, acc1));
+        for (; i < n; ++i) sum += x[i] * x[i];
+        return sum;
+    }
+
+    float peak(const float* x, size_t n) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            acc0 = _mm_max_ps(acc0, absolute(_mm_loadu_ps(x + i)));
+            acc1 = _mm_max_ps(acc1, absolute(_mm_loadu_ps(x + i + 4)));
+        }
+        float result = horizontalMax(_mm_max_ps(acc0, acc1));
+        for (; i < n; ++i) {
+            float magnitude = x[i] < 0.0f ? -x[i] : x[i];
+            if (magnitude > result) result = magnitude;
+        }
+        return result;
+    }
+
+    float dot(const float* a, const float* b, size_t n) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+        float sum = horizontalSum(_mm_add_ps(acc0, acc1));
+        for (; i < n; ++i) sum += a[i] * b[i];
+        return sum;
+    }
+
+    float squaredDifference(const float* a, const float* b, size_t n) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m128 d0 = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+            __m128 d1 = _mm_sub_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4));
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(d0, d0));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(d1, d1));
+        }
+        float sum = horizontalSum(_mm_add_ps(acc0, acc1));
+        for (; i < n; ++i) {
+            float delta = a[i] - b[i];
+            sum += delta * delta;
+        }
+        return sum;
+    }
+
+    void accumulateSquaredDifference(float value, const float* x, float* acc, size_t n) {
+        const __m128 broadcast = _mm_set1_ps(value);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 delta = _mm_sub_ps(broadcast, _mm_loadu_ps(x + i));
+            _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(delta, delta)));
+        }
+        for (; i < n; ++i) {
+            float delta = value - x[i];
+            acc[i] += delta * delta;
+        }
+    }
+
+    // Inclusive prefix sum of the four lanes
+    inline __m128 prefixSum(__m128 v) {
+        v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)));
+        v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 8)));
+        return v;
+    }
+
+    void cumulativeMeanNormalize(const float* d, float* out, size_t n) {
+        if (n == 0) return;
+        out[0] = 1.0f;
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 step = _mm_set1_ps(4.0f);
+        __m128 lag = _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f);
+        __m128 carry = zero;
+
+        size_t t = 1;
+        for (; t + 4 <= n; t += 4) {
+            __m128 value = _mm_loadu_ps(d + t);
+            __m128 running = _mm_add_ps(prefixSum(value), carry);
+            __m128 normalized = _mm_div_ps(_mm_mul_ps(value, lag), running);
+            __m128 positive = _mm_cmpgt_ps(running, zero);
+            _mm_storeu_ps(out + t, _mm_or_ps(_mm_and_ps(positive, normalized),
+                                             _mm_andnot_ps(positive, one)));
+            carry = _mm_shuffle_ps(running, running, _MM_SHUFFLE(3, 3, 3, 3));
+            lag = _mm_add_ps(lag, step);
+        }
+
+        float runningSum = _mm_cvtss_f32(carry);
+        for (; t < n; ++t) {
+            float value = d[t];
+            runningSum += value;
+            out[t] = runningSum > 0.0f ? value * static_cast<float>(t) / runningSum : 1.0f;
+        }
+    }
+
+    const KernelTable kSse2Kernels = {
+        InstructionSet::SSE2,
+        sumOfSquares,
+        peak,
+        dot,
+        squaredDifference,
+        accumulateSquaredDifference,
+        cumulativeMeanNormalize
+    };
+}
+
+namespace detail {
+    const KernelTable& sse2KernelTable() {
+        return kSse2Kernels;
+    }
+}
+
+} // namespace ptm
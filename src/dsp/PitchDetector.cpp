@@ -0,0 +1,122 @@
+#include "dsp/PitchDetector.hpp"
+#include "dsp/Kernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ptm {
+
+namespace {
+    // Mean power below which a window is treated as silence (about -120 dBFS)
+    constexpr double kSilencePower = 1e-12;
+
+    size_t validatedWindowSize(const PitchDetectorConfig& config) {
+        if (config.windowSize < 64) {
+            throw PitchDetectorException("Window size must be at least 64 samples, got " +
+                                         std::to_string(config.windowSize));
+        }
+        return config.windowSize;
+    }
+
+    DifferenceFunction makeDifference(const PitchDetectorConfig& config, RealFft* fft) {
+        const size_t windowSize = validatedWindowSize(config);
+        if (!fft) {
+            return DifferenceFunction(windowSize, config.hopSize, config.resyncInterval);
+        }
+        if (fft->size() != DifferenceFunction::fftSizeFor(windowSize)) {
+            throw PitchDetectorException("Window size " + std::to_string(windowSize) +
+                                         " does not match a transform of " +
+                                         std::to_string(fft->size()));
+        }
+        return DifferenceFunction(windowSize, *fft, config.hopSize, config.resyncInterval);
+    }
+}
+
+PitchDetector::PitchDetector(const PitchDetectorConfig& config)
+    : PitchDetector(config, nullptr) {}
+
+PitchDetector::PitchDetector(const PitchDetectorConfig& config, RealFft& fft)
+    : PitchDetector(config, &fft) {}
+
+PitchDetector::PitchDetector(const PitchDetectorConfig& config, RealFft* fft)
+    : config_(config)
+    , integrationSize_(config.windowSize / 2)
+    , minLag_(0)
+    , maxLag_(0)
+    , difference_(makeDifference(config, fft))
+    , normalized_(integrationSize_, 1.0f) {
+    if (config_.sampleRate <= 0.0) {
+        throw PitchDetectorException("Sample rate must be positive");
+    }
+    if (config_.threshold <= 0.0f || config_.threshold >= 1.0f) {
+        throw PitchDetectorException("Threshold must be between 0 and 1");
+    }
+    if (config_.minFrequency <= 0.0f || config_.maxFrequency <= config_.minFrequency ||
+        config_.maxFrequency >= config_.sampleRate / 2.0) {
+        throw PitchDetectorException("Invalid frequency range");
+    }
+
+    // Keep one lag of margin on each side for interpolation
+    minLag_ = std::max<size_t>(2, static_cast<size_t>(config_.sampleRate / config_.maxFrequency));
+    maxLag_ = std::min(integrationSize_ - 2,
+                       static_cast<size_t>(std::ceil(config_.sampleRate / config_.minFrequency)));
+    if (minLag_ >= maxLag_) {
+        throw PitchDetectorException("Window size " + std::to_string(config_.windowSize) +
+                                     " is too small for the frequency range");
+    }
+}
+
+PitchEstimate PitchDetector::process(const float* window) {
+    difference_.compute(window);
+
+    // Cumulative mean normalised difference: d'(0) = 1,
+    // d'(tau) = d(tau) / ((1 / tau) * sum_{k=1..tau} d(k))
+    cumulativeMeanNormalize(difference_.values().data(), normalized_.data(), integrationSize_);
+    return pickPitch();
+}
+
+PitchEstimate PitchDetector::pickPitch() const {
+    PitchEstimate estimate;
+    if (difference_.energy() < kSilencePower * static_cast<double>(integrationSize_)) {
+        return estimate;
+    }
+
+    // First dip below the threshold, followed down to its minimum
+    size_t best = 0;
+    for (size_t tau = minLag_; tau <= maxLag_; ++tau) {
+        if (normalized_[tau] < config_.threshold) {
+            while (tau < maxLag_ && normalized_[tau + 1] < normalized_[tau]) {
+                ++tau;
+            }
+            best = tau;
+            estimate.voiced = true;
+            break;
+        }
+    }
+
+    // No dip: report the global minimum as an unvoiced candidate
+    if (!estimate.voiced) {
+        best = minLag_;
+        for (size_t tau = minLag_ + 1; tau <= maxLag_; ++tau) {
+            if (normalized_[tau] < normalized_[best]) best = tau;
+        }
+    }
+
+    estimate.frequency = static_cast<float>(config_.sampleRate / interpolatedLag(best));
+    estimate.confidence = std::clamp(1.0f - normalized_[best], 0.0f, 1.0f);
+    return estimate;
+}
+
+float PitchDetector::interpolatedLag(size_t lag) const {
+    float previous = normalized_[lag - 1];
+    float current = normalized_[lag];
+    float next = normalized_[lag + 1];
+
+    float curvature = previous - 2.0f * current + next;
+    if (curvature <= 0.0f) {
+        return static_cast<float>(lag);
+    }
+    float shift = 0.5f * (previous - next) / curvature;
+    return static_cast<float>(lag) + std::clamp(shift, -1.0f, 1.0f);
+}
+
+} // namespace ptm
@@ -0,0 +1,76 @@
+#include "dsp/PitchDetectorSet.hpp"
+#include <algorithm>
+#include <functional>
+#include <string>
+
+namespace ptm {
+
+std::vector<size_t> PitchDetectorSet::defaultWindowSizes() {
+    std::vector<size_t> sizes;
+    for (size_t size = 256; size <= 4096; size += 256) {
+        sizes.push_back(size);
+    }
+    return sizes;
+}
+
+// Largest first: those take longest to plan, and none is in use yet
+std::vector<size_t> PitchDetectorSet::fftSizesFor(const std::vector<size_t>& windowSizes) {
+    std::vector<size_t> sizes;
+    for (size_t windowSize : windowSizes) {
+        sizes.push_back(DifferenceFunction::fftSizeFor(windowSize));
+    }
+    std::sort(sizes.begin(), sizes.end(), std::greater<size_t>());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    return sizes;
+}
+
+PitchDetectorSet::PitchDetectorSet(const PitchDetectorConfig& config,
+                                   const std::vector<size_t>& windowSizes, FftPlanCache& cache) {
+    if (windowSizes.empty()) {
+        throw PitchDetectorException("A detector set needs at least one window size");
+    }
+    cache.waitUntilReady();
+
+    windowSizes_.reserve(windowSizes.size());
+    detectors_.reserve(windowSizes.size());
+    for (size_t windowSize : windowSizes) {
+        if (std::find(windowSizes_.begin(), windowSizes_.end(), windowSize) != windowSizes_.end()) {
+            continue;
+        }
+
+        const size_t fftSize = DifferenceFunction::fftSizeFor(std::max<size_t>(windowSize, 4));
+        RealFft* fft = cache.find(fftSize);
+        if (!fft) {
+            std::string reason = cache.error();
+            throw PitchDetectorException("No transform of size " + std::to_string(fftSize) +
+                                         " for window size " + std::to_string(windowSize) +
+                                         (reason.empty() ? "" : ": " + reason));
+        }
+
+        PitchDetectorConfig detectorConfig = config;
+        detectorConfig.windowSize = windowSize;
+        detectors_.push_back(std::make_unique<PitchDetector>(detectorConfig, *fft));
+        windowSizes_.push_back(windowSize);
+    }
+
+    current_ = select(config.windowSize);
+    if (!current_) {
+        current_ = detectors_.front().get();
+    }
+}
+
+PitchDetector* PitchDetectorSet::select(size_t windowSize) {
+    for (size_t i = 0; i < windowSizes_.size(); ++i) {
+        if (windowSizes_[i] != windowSize) continue;
+
+        PitchDetector* detector = detectors_[i].get();
+        if (detector != current_) {
+            detector->reset();
+            current_ = detector;
+        }
+        return detector;
+    }
+    return nullptr;
+}
+
+} // namespace ptm
@@ -0,0 +1,227 @@
+#include "dsp/PolyphonicDetector.hpp"
+#include "dsp/Kernels.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace ptm {
+
+namespace {
+    // Partial weights (f0 + alpha) / (h f0 + beta), from Klapuri (2006)
+    constexpr double kWeightAlpha = 27.0;
+    constexpr double kWeightBeta = 320.0;
+
+    // A partial may sit this far from h * f0: a quarter tone
+    const double kPartialTolerance = std::pow(2.0, 1.0 / 24.0);
+
+    // Partials are never searched above this fraction of the sample rate
+    constexpr double kMaxPartialFraction = 0.45;
+
+    int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double noteFrequency(int note) {
+        return 440.0 * std::pow(2.0, (note - 69) / 12.0);
+    }
+
+    const PolyphonicDetectorConfig& validated(const PolyphonicDetectorConfig& config) {
+        if (config.sampleRate <= 0.0) {
+            throw PitchDetectorException("Sample rate must be positive");
+        }
+        if (config.windowSize < 256) {
+            throw PitchDetectorException("Window size must be at least 256 samples, got " +
+                                         std::to_string(config.windowSize));
+        }
+        if (config.zeroPadding == 0) {
+            throw PitchDetectorException("Zero padding must be at least 1");
+        }
+        if (config.maxVoices == 0 || config.maxVoices > PolyphonicEstimate::kMaxVoices) {
+            throw PitchDetectorException("Voice count must be between 1 and " +
+                                         std::to_string(PolyphonicEstimate::kMaxVoices));
+        }
+        if (config.maxHarmonics == 0) {
+            throw PitchDetectorException("At least one harmonic is needed");
+        }
+        if (config.maxPartialFrequency < config.maxFrequency) {
+            throw PitchDetectorException("Partial frequency limit is below the frequency range");
+        }
+        if (config.minFrequency <= 0.0f || config.maxFrequency <= config.minFrequency ||
+            config.maxFrequency >= config.sampleRate * kMaxPartialFraction) {
+            throw PitchDetectorException("Invalid frequency range");
+        }
+        if (config.relativeThreshold < 0.0f || config.relativeThreshold > 1.0f) {
+            throw PitchDetectorException("Relative threshold must be between 0 and 1");
+        }
+        return config;
+    }
+}
+
+PolyphonicDetector::PolyphonicDetector(const PolyphonicDetectorConfig& config)
+    : config_(validated(config))
+    , frame_(config.sampleRate, config.windowSize, config.zeroPadding)
+    , lobeHalfWidth_(2 * (frame_.fftSize() / config.windowSize))  // Hann main lobe
+    , residual_(frame_.bins(), 0.0f)
+    , amplitudes_(config.maxHarmonics, 0.0f)
+    , peaks_(config.maxHarmonics, 0) {
+    const double binHz = frame_.binFrequency();
+    const double maxPartial = std::min<double>(config_.maxPartialFrequency,
+                                               config_.sampleRate * kMaxPartialFraction);
+    const auto lastBin = static_cast<double>(frame_.bins() - 2);
+
+    const int lowest = static_cast<int>(std::ceil(69.0 + 12.0 * std::log2(config_.minFrequency / 440.0)));
+    const int highest = static_cast<int>(std::floor(69.0 + 12.0 * std::log2(config_.maxFrequency / 440.0)));
+    for (int note = lowest; note <= highest; ++note) {
+        const double f0 = noteFrequency(note);
+        Candidate candidate{note, static_cast<float>(f0), static_cast<uint32_t>(partials_.size()), 0};
+        for (size_t h = 1; h <= config_.maxHarmonics; ++h) {
+            const double centre = static_cast<double>(h) * f0;
+            if (centre * kPartialTolerance > maxPartial) break;
+
+            // At least the bin nearest the partial, even where a quarter
+            // tone is narrower than a bin
+            const double centreBin = std::round(centre / binHz);
+            const double first = std::min(std::round(centre / kPartialTolerance / binHz), centreBin);
+            const double last = std::max(std::round(centre * kPartialTolerance / binHz), centreBin);
+            Partial partial;
+            partial.firstBin = static_cast<uint32_t>(std::clamp(first, 1.0, lastBin));
+            partial.lastBin = static_cast<uint32_t>(std::clamp(last, 1.0, lastBin));
+            partial.weight = static_cast<float>((f0 + kWeightAlpha) / (centre + kWeightBeta));
+            partials_.push_back(partial);
+            binVisitsPerPass_ += partial.lastBin - partial.firstBin + 1;
+            ++candidate.partialCount;
+        }
+        candidates_.push_back(candidate);
+    }
+    if (candidates_.empty()) {
+        throw PitchDetectorException("No MIDI note lies in the frequency range");
+    }
+    taken_.assign(candidates_.size(), 0);
+}
+
+void PolyphonicDetector::setMaxVoices(size_t maxVoices) {
+    PolyphonicDetectorConfig config = config_;
+    config.maxVoices = maxVoices;
+    config_.maxVoices = validated(config).maxVoices;
+}
+
+PolyphonicEstimate PolyphonicDetector::process(const float* window) {
+    const int64_t startNs = nowNs();
+    PolyphonicEstimate estimate;
+
+    frame_.compute(window);
+    const std::vector<float>& magnitudes = frame_.magnitudes();
+    std::copy(magnitudes.begin(), magnitudes.end(), residual_.begin());
+    std::fill(taken_.begin(), taken_.end(), 0);
+
+    float firstSalience = 0.0f;
+    while (estimate.count < config_.maxVoices) {
+        size_t best = candidates_.size();
+        float bestSalience = 0.0f;
+        for (size_t c = 0; c < candidates_.size(); ++c) {
+            if (taken_[c]) continue;
+            const float s = salience(candidates_[c]);
+            if (s > bestSalience) {
+                bestSalience = s;
+                best = c;
+            }
+        }
+        if (best == candidates_.size()) break;
+        if (estimate.count == 0) {
+            firstSalience = bestSalience;
+        } else if (bestSalience < config_.relativeThreshold * firstSalience) {
+            break;
+        }
+
+        taken_[best] = 1;
+        PolyphonicVoice voice = extract(candidates_[best]);
+        if (voice.level < config_.minLevel) break;
+        voice.salience = bestSalience;
+        estimate.voices[estimate.count++] = voice;
+    }
+
+    processTime_.record(nowNs() - startNs);
+    return estimate;
+}
+
+float PolyphonicDetector::salience(const Candidate& candidate) const {
+    float sum = 0.0f;
+    const Partial* partial = partials_.data() + candidate.firstPartial;
+    for (uint32_t h = 0; h < candidate.partialCount; ++h, ++partial) {
+        // Magnitudes are non-negative, so the peak kernel finds the largest
+        sum += partial->weight * peak(residual_.data() + partial->firstBin,
+                                      partial->lastBin - partial->firstBin + 1);
+    }
+    return sum;
+}
+
+// Attributes the candidate's partials to a voice and removes them from the
+// residual spectrum
+PolyphonicVoice PolyphonicDetector::extract(const Candidate& candidate) {
+    const Partial* partials = partials_.data() + candidate.firstPartial;
+    const size_t count = candidate.partialCount;
+    for (size_t h = 0; h < count; ++h) {
+        uint32_t peakBin = partials[h].firstBin;
+        for (uint32_t k = peakBin + 1; k <= partials[h].lastBin; ++k) {
+            if (residual_[k] > residual_[peakBin]) peakBin = k;
+        }
+        peaks_[h] = peakBin;
+        amplitudes_[h] = residual_[peakBin];
+    }
+
+    // Frequency from the partials, each interpolated on the full spectrum
+    // and weighted by its amplitude
+    const std::vector<float>& magnitudes = frame_.magnitudes();
+    const double binHz = frame_.binFrequency();
+    const float scale = frame_.amplitudeScale();
+    double frequencySum = 0.0;
+    double amplitudeSum = 0.0;
+    double power = 0.0;
+    for (size_t h = 0; h < count; ++h) {
+        const uint32_t k = peaks_[h];
+        const double left = magnitudes[k - 1];
+        const double centre = magnitudes[k];
+        const double right = magnitudes[k + 1];
+        const double denominator = left - 2.0 * centre + right;
+        double offset = denominator < 0.0 ? 0.5 * (left - right) / denominator : 0.0;
+        offset = std::clamp(offset, -0.5, 0.5);
+        frequencySum += amplitudes_[h] * (static_cast<double>(k) + offset) * binHz /
+                        static_cast<double>(h + 1);
+        amplitudeSum += amplitudes_[h];
+
+        const double amplitude = amplitudes_[h] * scale;
+        power += 0.5 * amplitude * amplitude;
+    }
+
+    // Cancel no more of each upper partial than the smoothed envelope of
+    // its neighbours: a louder partial is partly another note's. The lowest
+    // goes entirely, or a pure tone would leave half of itself behind.
+    for (size_t h = 0; h < count; ++h) {
+        const float a = amplitudes_[h];
+        if (a <= 0.0f) continue;
+        float removed = a;
+        if (h > 0) {
+            float sum = a + amplitudes_[h - 1];
+            int neighbours = 2;
+            if (h + 1 < count) { sum += amplitudes_[h + 1]; ++neighbours; }
+            removed = std::min(a, sum / static_cast<float>(neighbours));
+        }
+        const float keep = 1.0f - removed / a;
+
+        const size_t first = peaks_[h] > lobeHalfWidth_ ? peaks_[h] - lobeHalfWidth_ : 0;
+        const size_t last = std::min(peaks_[h] + lobeHalfWidth_, residual_.size() - 1);
+        for (size_t k = first; k <= last; ++k) {
+            residual_[k] *= keep;
+        }
+    }
+
+    PolyphonicVoice voice;
+    voice.note = candidate.note;
+    voice.frequency = amplitudeSum > 0.0 ? static_cast<float>(frequencySum / amplitudeSum)
+                                         : candidate.frequency;
+    voice.level = static_cast<float>(std::sqrt(power));
+    return voice;
+}
+
+} // namespace ptm
@@ -0,0 +1,58 @@
+#include "dsp/SpectralFrame.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ptm {
+
+namespace {
+    const double kPi = std::acos(-1.0);
+
+    size_t fftSizeFor(size_t windowSize, size_t zeroPadding) {
+        if (windowSize == 0 || zeroPadding == 0) {
+            throw std::invalid_argument("Window size and zero padding must be positive");
+        }
+        size_t size = 4;
+        while (size < windowSize * zeroPadding) {
+            size *= 2;
+        }
+        return size;
+    }
+}
+
+SpectralFrame::SpectralFrame(double sampleRate, size_t windowSize, size_t zeroPadding)
+    : sampleRate_(sampleRate)
+    , window_(windowSize)
+    , fft_(fftSizeFor(windowSize, zeroPadding))
+    , magnitudes_(fft_.bins(), 0.0f) {
+    if (sampleRate_ <= 0.0) {
+        throw std::invalid_argument("Sample rate must be positive");
+    }
+
+    // Periodic Hann; a sinusoid of amplitude A peaks at A * sum(w) / 2
+    double sum = 0.0;
+    for (size_t i = 0; i < windowSize; ++i) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * static_cast<double>(i) /
+                                                             static_cast<double>(windowSize)));
+        sum += window_[i];
+    }
+    amplitudeScale_ = sum > 0.0 ? static_cast<float>(2.0 / sum) : 0.0f;
+
+    std::fill(fft_.real(), fft_.real() + fft_.size(), 0.0);
+}
+
+void SpectralFrame::compute(const float* window) {
+    // The padding behind the window stays zero: forward() leaves real() alone
+    double* real = fft_.real();
+    for (size_t i = 0; i < window_.size(); ++i) {
+        real[i] = static_cast<double>(window[i]) * window_[i];
+    }
+    fft_.forward();
+
+    const RealFft::Complex* spectrum = fft_.spectrum();
+    for (size_t k = 0; k < magnitudes_.size(); ++k) {
+        magnitudes_[k] = static_cast<float>(std::abs(spectrum[k]));
+    }
+}
+
+} // namespace ptm
@@ -1,4 +1,6 @@
 #include "MainComponent.h"
+#include "dsp/PitchDetectorSet.hpp"
+#include "midi/RtMidiPort.hpp"
 
 MainComponent::MainComponent()
 {
@@ -23,7 +25,19 @@ MainComponent::MainComponent()
     addAndMakeVisible(midiOutputLabel);
     midiOutputLabel.setText("MIDI Output:", juce::dontSendNotification);
     addAndMakeVisible(midiOutputSelector);
-    // TODO: Populate MIDI outputs
+    // Item IDs are RtMidi port indices + 1
+    try
+    {
+        const auto ports = ptm::RtMidiPort::portNames();
+        for (size_t i = 0; i < ports.size(); ++i)
+            midiOutputSelector.addItem(ports[i], static_cast<int>(i) + 1);
+        if (!ports.empty())
+            midiOutputSelector.setSelectedId(1, juce::dontSendNotification);
+    }
+    catch (const ptm::MidiOutputException&)
+    {
+    }
+    midiOutputSelector.setTextWhenNoChoicesAvailable("No MIDI outputs");
 
     // Initialize status display
     addAndMakeVisible(currentNoteLabel);
@@ -47,6 +61,15 @@ MainComponent::MainComponent()
     addAndMakeVisible(windowSizeSlider);
     windowSizeSlider.setRange(256, 4096, 256);
     windowSizeSlider.setValue(1024);
+
+    // Wisdom from earlier runs makes planning near-instant
+    auto settingsDirectory = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                                 .getChildFile("PitchToMidi");
+    settingsDirectory.createDirectory();
+    fftPlans = std::make_unique<ptm::FftPlanCache>(
+        ptm::PitchDetectorSet::fftSizesFor(ptm::PitchDetectorSet::defaultWindowSizes()),
+        settingsDirectory.getChildFile("fftw-wisdom").getFullPathName().toStdString());
+    fftPlans->start();
     
     addAndMakeVisible(hopSizeLabel);
     hopSizeLabel.setText("Hop Size:", juce::dontSendNotification);
@@ -70,15 +93,74 @@ MainComponent::MainComponent()
     addAndMakeVisible(discreteModeButton);
     discreteModeButton.setButtonText("Discrete Mode");
     discreteModeButton.setToggleState(true, juce::dontSendNotification);
+
+    addAndMakeVisible(polyphonicModeButton);
+    polyphonicModeButton.setButtonText("Polyphonic Mode");
+    polyphonicModeButton.setToggleState(false, juce::dontSendNotification);
+    polyphonicModeButton.onClick = [this]
+    {
+        maxVoicesSlider.setEnabled(polyphonicModeButton.getToggleState());
+        publishParameters();
+    };
+
+    addAndMakeVisible(maxVoicesLabel);
+    maxVoicesLabel.setText("Max Voices:", juce::dontSendNotification);
+    addAndMakeVisible(maxVoicesSlider);
+    maxVoicesSlider.setRange(1, 8, 1);
+    maxVoicesSlider.setValue(4);
+    maxVoicesSlider.setEnabled(false);
     
     addAndMakeVisible(startStopButton);
     startStopButton.setButtonText("Start");
+
+    // Every control publishes a complete snapshot; the analysis thread
+    // picks up the latest one at its next hop
+    for (auto* slider : { &amplitudeThresholdSlider, &windowSizeSlider, &hopSizeSlider,
+                          &debounceThresholdSlider, &maxVoicesSlider })
+        slider->onValueChange = [this] { publishParameters(); };
+    midiChannelSelector.onChange = [this] { publishParameters(); };
+    discreteModeButton.onClick = [this] { publishParameters(); };
+    publishParameters();
     
     setSize(800, 600);
+
+    // A fixed display rate, however often the analysis thread publishes
+    startTimerHz(30);
+}
+
+void MainComponent::publishParameters()
+{
+    ptm::ProcessingParameters parameters;
+    parameters.amplitudeThreshold = static_cast<float>(amplitudeThresholdSlider.getValue());
+    parameters.windowSize = static_cast<size_t>(windowSizeSlider.getValue());
+    parameters.hopSize = static_cast<size_t>(hopSizeSlider.getValue());
+    parameters.debounceMs = debounceThresholdSlider.getValue();
+    parameters.midiChannel = static_cast<uint8_t>(midiChannelSelector.getSelectedId());
+    parameters.discreteMode = discreteModeButton.getToggleState();
+    parameters.polyphonic = polyphonicModeButton.getToggleState();
+    parameters.maxVoices = static_cast<size_t>(maxVoicesSlider.getValue());
+    parameterStore.publish(parameters);
 }
 
 MainComponent::~MainComponent()
 {
+    stopTimer();
+}
+
+void MainComponent::timerCallback()
+{
+    const ptm::NoteTelemetry latest = telemetry.load();
+    if (latest.hop == displayedHop)
+        return;
+    displayedHop = latest.hop;
+
+    currentNoteLabel.setText("Current Note: " + (latest.note >= 0
+                                 ? juce::MidiMessage::getMidiNoteName(latest.note, true, true, 4)
+                                 : juce::String("--")),
+                             juce::dontSendNotification);
+    velocityLabel.setText("Velocity: " + juce::String(latest.velocity), juce::dontSendNotification);
+    pitchDeviationLabel.setText("Pitch Deviation: " + juce::String(juce::roundToInt(latest.cents)) + " cents",
+                                juce::dontSendNotification);
 }
 
 void MainComponent::paint(juce::Graphics& g)
@@ -131,6 +213,8 @@ void MainComponent::resized()
     
     rightColumn.removeFromTop(10);
     discreteModeButton.setBounds(rightColumn.removeFromTop(30));
+    polyphonicModeButton.setBounds(rightColumn.removeFromTop(30));
+    setupSliderRow(maxVoicesLabel, maxVoicesSlider, rightColumn);
     
     rightColumn.removeFromTop(20);
     startStopButton.setBounds(rightColumn.removeFromTop(30));
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "dsp/FftPlanCache.hpp"
+#include "midi/NoteTelemetry.hpp"
+#include "midi/ParameterStore.hpp"
 
-class MainComponent : public juce::Component
+class MainComponent : public juce::Component,
+                      private juce::Timer
 {
 public:
     MainComponent();
@@ -12,6 +16,12 @@ public:
     void resized() override;
 
 private:
+    // Snapshot of every control, for the analysis thread
+    void publishParameters();
+
+    // Redraws the status display from the latest telemetry
+    void timerCallback() override;
+
     // Audio device manager
     std::unique_ptr<juce::AudioDeviceManager> deviceManager;
     
@@ -44,7 +54,29 @@ private:
     juce::Label midiChannelLabel;
     
     juce::ToggleButton discreteModeButton;
+
+    // Several notes per hop, one MIDI voice each
+    juce::ToggleButton polyphonicModeButton;
+    juce::Slider maxVoicesSlider;
+    juce::Label maxVoicesLabel;
+
     juce::TextButton startStopButton;
 
+    // Transforms for every window size windowSizeSlider offers, planned in
+    // the background from launch so that neither Start nor a window size
+    // change waits for FFTW
+    std::unique_ptr<ptm::FftPlanCache> fftPlans;
+
+    // Control values for the analysis thread (LiveNoteTracker). Only this
+    // end exists so far: nothing reads the snapshots until Start creates a
+    // capture -> LiveNoteTracker path.
+    ptm::ParameterStore parameterStore;
+
+    // Latest analysed hop from the analysis thread, read by the timer. Only
+    // this end exists so far: nothing writes it until Start creates a
+    // LiveNoteTracker, so the status display stays empty.
+    ptm::NoteTelemetryChannel telemetry;
+    uint64_t displayedHop = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 }; 
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "midi/LiveNoteTracker.hpp"
+#include "dsp/Kernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ptm {
+
+namespace {
+    PitchDetectorConfig exactPitchConfig(PitchDetectorConfig config, double sampleRate) {
+        // The hop varies, so every window is computed from scratch
+        config.sampleRate = sampleRate;
+        config.hopSize = 0;
+        return config;
+    }
+
+    NoteTrackerConfig noteConfig(NoteTrackerConfig config, double sampleRate) {
+        config.sampleRate = sampleRate;
+        return config;
+    }
+
+    PolyphonicDetectorConfig polyphonicConfig(double sampleRate) {
+        PolyphonicDetectorConfig config;
+        config.sampleRate = sampleRate;
+        config.windowSize = ProcessingParameters::kMaxWindowSize;
+        config.maxVoices = ProcessingParameters::kMaxVoices;
+        return config;
+    }
+
+    size_t laneCount(const NoteTrackerConfig& config) {
+        return static_cast<size_t>(std::max(config.highestNote - config.lowestNote + 1, 0));
+    }
+}
+
+AnalysisConfig LiveNoteTracker::analysisConfig() {
+    AnalysisConfig config;
+    config.windowSize = ProcessingParameters::kMaxWindowSize;
+    config.hopSize = ProcessingParameters::kMinHopSize;
+    return config;
+}
+
+LiveNoteTracker::LiveNoteTracker(double sampleRate, ParameterStore& parameters, FftPlanCache& cache,
+                                 const PitchDetectorConfig& pitch, const NoteTrackerConfig& notes)
+    : parameters_(parameters)
+    , detectors_(exactPitchConfig(pitch, sampleRate), PitchDetectorSet::defaultWindowSizes(), cache)
+    , tracker_(noteConfig(notes, sampleRate))
+    , polyphonicDetector_(polyphonicConfig(sampleRate))
+    , polyphonicTracker_(noteConfig(notes, sampleRate), ProcessingParameters::kMaxVoices) {
+    // A mode switch's releases plus a polyphonic update, at most
+    events_.reserve(2 * laneCount(polyphonicTracker_.config()) + 2);
+    parameters_.update();
+    apply(parameters_.current(), 0);
+}
+
+void LiveNoteTracker::apply(const ProcessingParameters& parameters, uint64_t samplePosition) {
+    if (parameters.polyphonic != polyphonic_) {
+        if (polyphonic_) {
+            const std::vector<NoteEvent>& released = polyphonicTracker_.flush(samplePosition);
+            append(released.data(), released.size());
+        } else {
+            const NoteUpdate released = tracker_.flush(samplePosition);
+            append(released.events.data(), released.count);
+        }
+        polyphonic_ = parameters.polyphonic;
+    }
+    detectors_.select(parameters.windowSize);
+    tracker_.setThresholds(parameters.amplitudeThreshold, parameters.debounceMs);
+    polyphonicDetector_.setMaxVoices(parameters.maxVoices);
+    polyphonicTracker_.setMaxVoices(parameters.maxVoices);
+    polyphonicTracker_.setThresholds(parameters.amplitudeThreshold, parameters.debounceMs);
+    hopStride_ = std::max<size_t>(parameters.hopSize / ProcessingParameters::kMinHopSize, 1);
+}
+
+LiveNoteUpdate LiveNoteTracker::process(const AnalysisFrame& frame) {
+    events_.clear();
+    if (frame.hopIndex % hopStride_ != 0) {
+        return {};
+    }
+    if (parameters_.update()) {
+        const uint64_t framePosition = frame.hopIndex * ProcessingParameters::kMinHopSize;
+        apply(parameters_.current(), framePosition + frame.windowSize / 2);
+    }
+
+    LiveNoteUpdate update;
+    update.latency = frame.latency;
+    const bool analysed = polyphonic_ ? processPolyphonic(frame) : processMonophonic(frame);
+    if (analysed && latencyMonitor_) {
+        latencyMonitor_->recordDetection(update.latency);
+    }
+    update.events = events_.data();
+    update.count = events_.size();
+    return update;
+}
+
+LiveNoteUpdate LiveNoteTracker::flush(uint64_t samplePosition) {
+    events_.clear();
+    if (polyphonic_) {
+        const std::vector<NoteEvent>& released = polyphonicTracker_.flush(samplePosition);
+        append(released.data(), released.size());
+    } else {
+        const NoteUpdate released = tracker_.flush(samplePosition);
+        append(released.events.data(), released.count);
+    }
+    LiveNoteUpdate update;
+    update.events = events_.data();
+    update.count = events_.size();
+    return update;
+}
+
+bool LiveNoteTracker::processMonophonic(const AnalysisFrame& frame) {
+    PitchDetector& detector = detectors_.current();
+    const size_t windowSize = detector.config().windowSize;
+    if (frame.windowSize < windowSize) {
+        return false;  // Fed by a worker not set up with analysisConfig()
+    }
+
+    const float* window = frame.samples + (frame.windowSize - windowSize);
+    estimate_ = detector.process(window);
+    const float rms = std::sqrt(sumOfSquares(window, windowSize) / static_cast<float>(windowSize));
+    ++analysedHops_;
+
+    // Centre of the analysed samples, as elsewhere
+    const uint64_t position = frame.hopIndex * ProcessingParameters::kMinHopSize +
+                              (frame.windowSize - windowSize) + windowSize / 2;
+    const NoteUpdate update = tracker_.update(estimate_, rms, position);
+    append(update.events.data(), update.count);
+
+    if (telemetry_) {
+        publishTelemetry(rms);
+    }
+    return true;
+}
+
+bool LiveNoteTracker::processPolyphonic(const AnalysisFrame& frame) {
+    const size_t windowSize = polyphonicDetector_.config().windowSize;
+    if (frame.windowSize < windowSize) {
+        return false;
+    }
+
+    const float* window = frame.samples + (frame.windowSize - windowSize);
+    polyphonicEstimate_ = polyphonicDetector_.process(window);
+    const float rms = std::sqrt(sumOfSquares(window, windowSize) / static_cast<float>(windowSize));
+    ++analysedHops_;
+
+    const uint64_t position = frame.hopIndex * ProcessingParameters::kMinHopSize +
+                              (frame.windowSize - windowSize) + windowSize / 2;
+    const std::vector<NoteEvent>& events = polyphonicTracker_.update(polyphonicEstimate_, position);
+    append(events.data(), events.size());
+
+    if (telemetry_) {
+        publishTelemetry(rms);
+    }
+    return true;
+}
+
+void LiveNoteTracker::append(const NoteEvent* events, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const NoteEvent& event = events[i];
+        velocities_[event.note & 0x7F] = event.type == NoteEvent::Type::NoteOn ? event.velocity : 0;
+        events_.push_back(event);
+    }
+}
+
+void LiveNoteTracker::publishTelemetry(float rms) {
+    NoteTelemetry telemetry;
+    telemetry.hop = analysedHops_;
+    telemetry.level = rms;
+    if (polyphonic_) {
+        // The strongest voice
+        if (polyphonicEstimate_.count > 0) {
+            const PolyphonicVoice& voice = polyphonicEstimate_.voices[0];
+            telemetry.note = polyphonicTracker_.isSounding(voice.note) ? voice.note : -1;
+            telemetry.frequency = voice.frequency;
+            telemetry.confidence = 1.0f;
+        }
+    } else {
+        telemetry.note = tracker_.currentNote();
+        telemetry.frequency = estimate_.frequency;
+        telemetry.confidence = estimate_.confidence;
+    }
+    if (telemetry.note >= 0) {
+        telemetry.velocity = velocities_[static_cast<size_t>(telemetry.note)];
+    }
+    if (telemetry.frequency > 0.0f) {
+        const int note = telemetry.note >= 0 ? telemetry.note
+                                             : NoteTracker::frequencyToNote(telemetry.frequency);
+        telemetry.cents = NoteTracker::centsFromNote(telemetry.frequency, note);
+    }
+    telemetry_->store(telemetry);
+}
+
+} // namespace ptm
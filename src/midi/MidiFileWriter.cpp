@@ -0,0 +1,151 @@
+#include "midi/MidiFileWriter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace ptm {
+
+namespace {
+    constexpr uint8_t kNoteOff = 0x80;
+    constexpr uint8_t kNoteOn = 0x90;
+
+    void appendU16(std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    }
+
+    // Variable-length quantity: 7 bits per byte, most significant first
+    void appendVarLen(std::vector<uint8_t>& out, uint32_t value) {
+        uint8_t bytes[5];
+        int count = 0;
+        do {
+            bytes[count++] = static_cast<uint8_t>(value & 0x7F);
+            value >>= 7;
+        } while (value != 0);
+        while (count > 1) {
+            out.push_back(static_cast<uint8_t>(bytes[--count] | 0x80));
+        }
+        out.push_back(bytes[0]);
+    }
+
+    uint8_t channelBits(int channel) {
+        if (channel < 1 || channel > 16) {
+            throw MidiFileException("MIDI channel must be 1-16, got " + std::to_string(channel));
+        }
+        return static_cast<uint8_t>(channel - 1);
+    }
+}
+
+MidiFileWriter::MidiFileWriter(uint16_t ticksPerQuarter, double beatsPerMinute)
+    : ticksPerQuarter_(ticksPerQuarter)
+    , microsecondsPerQuarter_(0)
+    , ticksPerSecond_(0.0) {
+    // Bit 15 of the division selects SMPTE timing, which is not supported
+    if (ticksPerQuarter_ == 0 || ticksPerQuarter_ > 0x7FFF) {
+        throw MidiFileException("Ticks per quarter note must be 1-32767");
+    }
+    // Tempo is a 24-bit count of microseconds per quarter note
+    if (!(beatsPerMinute >= 60e6 / 0xFFFFFF && beatsPerMinute <= 60e6)) {
+        throw MidiFileException("Tempo out of range");
+    }
+    microsecondsPerQuarter_ = static_cast<uint32_t>(std::lround(60e6 / beatsPerMinute));
+    ticksPerSecond_ = ticksPerQuarter_ * 1e6 / microsecondsPerQuarter_;
+}
+
+void MidiFileWriter::addNoteOn(double seconds, int channel, int note, int velocity) {
+    addEvent(seconds, static_cast<uint8_t>(kNoteOn | channelBits(channel)), note, velocity);
+}
+
+void MidiFileWriter::addNoteOff(double seconds, int channel, int note) {
+    addEvent(seconds, static_cast<uint8_t>(kNoteOff | channelBits(channel)), note, 64);
+}
+
+void MidiFileWriter::addEvents(const std::vector<NoteEvent>& events, double sampleRate, int channel) {
+    for (const NoteEvent& event : events) {
+        double seconds = static_cast<double>(event.samplePosition) / sampleRate;
+        if (event.type == NoteEvent::Type::NoteOn) {
+            addNoteOn(seconds, channel, event.note, event.velocity);
+        } else {
+            addNoteOff(seconds, channel, event.note);
+        }
+    }
+}
+
+void MidiFileWriter::addEvent(double seconds, uint8_t status, int data1, int data2) {
+    if (data1 < 0 || data1 > 127 || data2 < 0 || data2 > 127) {
+        throw MidiFileException("MIDI data byte out of range");
+    }
+    uint64_t tick = static_cast<uint64_t>(std::llround(std::max(seconds, 0.0) * ticksPerSecond_));
+    events_.push_back(Event{tick, events_.size(), status,
+                            static_cast<uint8_t>(data1), static_cast<uint8_t>(data2)});
+}
+
+std::vector<uint8_t> MidiFileWriter::toBytes() const {
+    std::vector<Event> sorted = events_;
+    std::sort(sorted.begin(), sorted.end(), [](const Event& a, const Event& b) {
+        return a.tick != b.tick ? a.tick < b.tick : a.order < b.order;
+    });
+
+    std::vector<uint8_t> track;
+    track.reserve(16 + sorted.size() * 4);
+
+    // Tempo meta event at tick 0
+    appendVarLen(track, 0);
+    track.insert(track.end(), {0xFF, 0x51, 0x03});
+    track.push_back(static_cast<uint8_t>(microsecondsPerQuarter_ >> 16));
+    track.push_back(static_cast<uint8_t>(microsecondsPerQuarter_ >> 8));
+    track.push_back(static_cast<uint8_t>(microsecondsPerQuarter_));
+
+    uint64_t previousTick = 0;
+    uint8_t runningStatus = 0;
+    for (const Event& event : sorted) {
+        uint64_t delta = event.tick - previousTick;
+        if (delta > 0x0FFFFFFF) {
+            throw MidiFileException("Gap between events too long for a MIDI file");
+        }
+        appendVarLen(track, static_cast<uint32_t>(delta));
+        if (event.status != runningStatus) {
+            track.push_back(event.status);
+            runningStatus = event.status;
+        }
+        track.push_back(event.data1);
+        track.push_back(event.data2);
+        previousTick = event.tick;
+    }
+
+    // End of track
+    appendVarLen(track, 0);
+    track.insert(track.end(), {0xFF, 0x2F, 0x00});
+
+    std::vector<uint8_t> bytes;
+    bytes.reserve(22 + track.size());
+    bytes.insert(bytes.end(), {'M', 'T', 'h', 'd'});
+    appendU32(bytes, 6);
+    appendU16(bytes, 0);  // Format 0
+    appendU16(bytes, 1);  // One track
+    appendU16(bytes, ticksPerQuarter_);
+    bytes.insert(bytes.end(), {'M', 'T', 'r', 'k'});
+    appendU32(bytes, static_cast<uint32_t>(track.size()));
+    bytes.insert(bytes.end(), track.begin(), track.end());
+    return bytes;
+}
+
+void MidiFileWriter::write(const std::string& path) const {
+    std::vector<uint8_t> bytes = toBytes();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw MidiFileException("Cannot create " + path);
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        throw MidiFileException("Failed writing " + path);
+    }
+}
+
+} // namespace ptm
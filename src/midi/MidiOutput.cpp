@@ -0,0 +1,217 @@
+#include "midi/MidiOutput.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace ptm {
+
+namespace {
+    constexpr uint8_t kNoteOff = 0x80;
+    constexpr uint8_t kNoteOn = 0x90;
+    constexpr uint8_t kPitchBend = 0xE0;
+    constexpr int32_t kBendCentre = 8192;
+
+    MidiMessage message(uint8_t status, uint8_t channel, uint8_t first, uint8_t second) {
+        MidiMessage result;
+        result.bytes = {static_cast<uint8_t>(status | (channel & 0x0F)),
+                        static_cast<uint8_t>(first & 0x7F), static_cast<uint8_t>(second & 0x7F)};
+        result.size = 3;
+        return result;
+    }
+
+    bool isPitchBend(const MidiMessage& message) {
+        return (message.bytes[0] & 0xF0) == kPitchBend;
+    }
+
+    int32_t bendValue(const MidiMessage& message) {
+        return message.bytes[1] | (message.bytes[2] << 7);
+    }
+
+    uint8_t channelOf(const MidiMessage& message) {
+        return message.bytes[0] & 0x0F;
+    }
+
+    // 14-bit steps per cent for a receiver bending +/- rangeSemitones
+    double stepsPerCent(double rangeSemitones) {
+        return kBendCentre / (rangeSemitones * 100.0);
+    }
+}
+
+MidiMessage MidiMessage::noteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
+    return message(kNoteOn, channel, note, velocity);
+}
+
+MidiMessage MidiMessage::noteOff(uint8_t channel, uint8_t note) {
+    return message(kNoteOff, channel, note, 0);
+}
+
+MidiMessage MidiMessage::pitchBend(uint8_t channel, uint16_t value) {
+    value = std::min<uint16_t>(value, 0x3FFF);
+    return message(kPitchBend, channel, static_cast<uint8_t>(value & 0x7F),
+                   static_cast<uint8_t>(value >> 7));
+}
+
+MidiMessage MidiMessage::pitchBendCents(uint8_t channel, double cents, double rangeSemitones) {
+    const double value = std::round(kBendCentre + cents * stepsPerCent(rangeSemitones));
+    return pitchBend(channel, static_cast<uint16_t>(std::clamp(value, 0.0, 16383.0)));
+}
+
+MidiMessage MidiMessage::fromNoteEvent(uint8_t channel, const NoteEvent& event) {
+    return event.type == NoteEvent::Type::NoteOn ? noteOn(channel, event.note, event.velocity)
+                                                 : noteOff(channel, event.note);
+}
+
+MidiOutput::MidiOutput(MidiPort& port, size_t queueSize, LatencyMonitor* latencyMonitor)
+    : port_(port)
+    , latencyMonitor_(latencyMonitor)
+    , queue_(queueSize, OverflowPolicy::DropNewest) {
+    lastBend_.fill(-1);
+    waitingBends_.reserve(queue_.capacity());
+}
+
+MidiOutput::~MidiOutput() {
+    stop();
+}
+
+void MidiOutput::setBendThinning(const BendThinningConfig& config) {
+    if (thread_.joinable()) {
+        throw MidiOutputException("Cannot change bend thinning while sending");
+    }
+    if (config.deadbandCents < 0.0) {
+        throw std::invalid_argument("Bend deadband must not be negative");
+    }
+    if (config.bendRangeSemitones <= 0.0) {
+        throw std::invalid_argument("Bend range must be positive");
+    }
+    thinning_ = config;
+    deadbandSteps_ = config.deadbandCents * stepsPerCent(config.bendRangeSemitones);
+}
+
+void MidiOutput::start() {
+    if (thread_.joinable()) return;
+
+    // The port may have been used by others since; restate the status
+    runningStatus_ = 0;
+
+    stopRequested_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread(&MidiOutput::run, this);
+}
+
+void MidiOutput::stop() {
+    if (!thread_.joinable()) return;
+
+    stopRequested_.store(true, std::memory_order_release);
+    ready_.post();
+    thread_.join();
+}
+
+bool MidiOutput::post(const MidiMessage& message, const LatencyStamp& stamp) noexcept {
+    const Pending pending{message, LatencyMonitor::now(), stamp};
+    if (queue_.write(&pending, 1) != 1) return false;
+
+    // Only this thread raises the maximum
+    const size_t depth = queue_.available();
+    if (depth > maxQueueDepth_.load(std::memory_order_relaxed)) {
+        maxQueueDepth_.store(depth, std::memory_order_relaxed);
+    }
+    ready_.post();
+    return true;
+}
+
+void MidiOutput::run() {
+    for (;;) {
+        ready_.wait();
+        // Posts while sending leave the count above zero, so a message
+        // never waits for the next post
+        sendPending();
+        if (stopRequested_.load(std::memory_order_acquire)) break;
+    }
+    // Anything posted by the final hops
+    sendPending();
+}
+
+size_t MidiOutput::sendPending() {
+    size_t count = 0;
+    size_t taken = 0;
+    Pending pending{};
+    while (queue_.read(&pending, 1) == 1) {
+        queueWait_.record(LatencyMonitor::now() - pending.postNs);
+
+        if (thinning_.coalesce && isPitchBend(pending.message)) {
+            const uint8_t channel = channelOf(pending.message);
+            const uint16_t bit = static_cast<uint16_t>(1u << channel);
+            if (heldChannels_ & bit) {
+                coalescedBends_.fetch_add(1, std::memory_order_relaxed);
+            }
+            heldBends_[channel] = pending;
+            heldChannels_ |= bit;
+        } else if (deadbandSteps_ > 0.0 && isPitchBend(pending.message)) {
+            waitingBends_.push_back(pending);  // Within capacity: flushed at least that often
+        } else {
+            count += deliver(pending);
+        }
+
+        // A producer that keeps the queue from emptying still gets its
+        // bends out once per queue's worth of messages
+        if (++taken == queue_.capacity()) {
+            count += flushHeldBends();
+            taken = 0;
+        }
+    }
+    return count + flushHeldBends();
+}
+
+size_t MidiOutput::flushHeldBends() {
+    size_t count = 0;
+    for (const Pending& pending : waitingBends_) {
+        count += deliver(pending);
+    }
+    waitingBends_.clear();
+    for (size_t channel = 0; heldChannels_ != 0; ++channel) {
+        const uint16_t bit = static_cast<uint16_t>(1u << channel);
+        if (heldChannels_ & bit) {
+            count += deliver(heldBends_[channel]);
+            heldChannels_ &= static_cast<uint16_t>(~bit);
+        }
+    }
+    return count;
+}
+
+size_t MidiOutput::deliver(const Pending& pending) {
+    MidiMessage message = pending.message;
+    if (isPitchBend(message)) {
+        const int32_t value = bendValue(message);
+        int32_t& last = lastBend_[channelOf(message)];
+        if (deadbandSteps_ > 0.0 && last >= 0 && value != kBendCentre &&
+            std::abs(value - last) < deadbandSteps_) {
+            filteredBends_.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+        last = value;
+    }
+
+    const uint8_t* bytes = message.bytes.data();
+    size_t size = message.size;
+    if (port_.acceptsRunningStatus()) {
+        if ((message.bytes[0] & 0xF0) == kNoteOff) {
+            message.bytes[0] = static_cast<uint8_t>(kNoteOn | channelOf(message));
+            message.bytes[2] = 0;
+        }
+        if (message.bytes[0] == runningStatus_) {
+            ++bytes;
+            --size;
+        } else {
+            runningStatus_ = message.bytes[0];
+        }
+    }
+
+    port_.send(bytes, size);
+    if (latencyMonitor_) {
+        latencyMonitor_->recordSend(pending.stamp);
+    }
+    bytesSent_.fetch_add(size, std::memory_order_relaxed);
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    return 1;
+}
+
+} // namespace ptm
@@ -0,0 +1,247 @@
+#include "midi/MultiChannelTracker.hpp"
+#include "dsp/Kernels.hpp"
+#include "utils/RealtimeSanitizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace ptm {
+
+namespace {
+    constexpr size_t kDefaultHopSize = 256;
+    constexpr uint8_t kMidiChannels = 16;
+
+    // Frames deinterleaved at a time; larger blocks are split
+    constexpr size_t kDeinterleaveFrames = 1024;
+
+    PitchDetectorConfig pitchConfigFor(const MultiChannelConfig& config) {
+        PitchDetectorConfig pitch = config.pitch;
+        pitch.sampleRate = config.sampleRate;
+        if (pitch.hopSize == 0) {
+            pitch.hopSize = kDefaultHopSize;
+        }
+        return pitch;
+    }
+
+    NoteTrackerConfig noteConfigFor(const MultiChannelConfig& config) {
+        NoteTrackerConfig notes = config.notes;
+        notes.sampleRate = config.sampleRate;
+        return notes;
+    }
+
+    MultiChannelConfig validated(MultiChannelConfig config) {
+        if (config.channels == 0) {
+            throw std::invalid_argument("Channel count must be at least 1");
+        }
+        if (config.firstMidiChannel >= kMidiChannels) {
+            throw std::invalid_argument("First MIDI channel must be between 0 and 15");
+        }
+        config.pitch = pitchConfigFor(config);
+        if (config.pitch.hopSize > config.pitch.windowSize) {
+            throw std::invalid_argument("Hop size must be between 1 and the window size");
+        }
+        if (config.pitch.windowSize + config.pitch.hopSize > config.bufferSize) {
+            throw std::invalid_argument("Window size " + std::to_string(config.pitch.windowSize) +
+                                        " plus a hop does not fit the " +
+                                        std::to_string(config.bufferSize) + "-sample buffer");
+        }
+        return config;
+    }
+}
+
+MultiChannelTracker::Channel::Channel(const MultiChannelConfig& config, unsigned channelIndex)
+    : index(channelIndex)
+    , midiChannel(static_cast<uint8_t>((config.firstMidiChannel + channelIndex) % kMidiChannels))
+    , ring(config.bufferSize, OverflowPolicy::DropOldest)
+    , detector(config.pitch)
+    , tracker(noteConfigFor(config)) {}
+
+MultiChannelTracker::MultiChannelTracker(const MultiChannelConfig& config, ChannelNoteCallback callback)
+    : config_(validated(config))
+    , callback_(std::move(callback))
+    , deinterleaved_(kDeinterleaveFrames)
+    , pool_(config.threads)
+    , nsPerSample_(1e9 / config_.sampleRate) {
+    if (!callback_) {
+        throw std::invalid_argument("Note callback must not be empty");
+    }
+
+    channels_.reserve(config_.channels);
+    for (unsigned c = 0; c < config_.channels; ++c) {
+        channels_.push_back(std::make_unique<Channel>(config_, c));
+        Channel* channel = channels_.back().get();
+        pool_.addTask([this, channel] { runChannel(*channel); });
+    }
+}
+
+MultiChannelTracker::~MultiChannelTracker() {
+    pool_.stop();
+}
+
+void MultiChannelTracker::start() {
+    if (pool_.isRunning()) return;
+
+    // Nothing is writing yet
+    for (auto& channel : channels_) {
+        channel->ring.clear();
+        channel->detector.reset();
+        channel->tracker.reset();
+        channel->pendingHops.store(0, std::memory_order_relaxed);
+        channel->seenOverflowCount = channel->ring.overflowCount();
+        channel->lastPosition = channel->ring.writePosition();
+    }
+    pendingSamples_ = 0;
+    blockClock_.store({});
+    pool_.start();
+}
+
+void MultiChannelTracker::stop() {
+    if (!pool_.isRunning()) return;
+
+    pool_.stop();
+    for (auto& channel : channels_) {
+        emit(*channel, channel->tracker.flush(channel->lastPosition));
+    }
+}
+
+SinkStatus MultiChannelTracker::processBlock(const float* samples, size_t frames,
+                                             const AudioBlockInfo& info) {
+    const size_t stride = std::max(info.channels, 1u);
+    const size_t used = std::min<size_t>(stride, config_.channels);
+
+    for (size_t offset = 0; offset < frames; offset += deinterleaved_.size()) {
+        const size_t count = std::min(deinterleaved_.size(), frames - offset);
+        for (size_t c = 0; c < channels_.size(); ++c) {
+            if (c < used) {
+                const float* in = samples + offset * stride + c;
+                for (size_t i = 0; i < count; ++i) {
+                    deinterleaved_[i] = in[i * stride];
+                }
+            } else {
+                // The source has fewer channels than configured: silence
+                std::fill(deinterleaved_.begin(), deinterleaved_.begin() + count, 0.0f);
+            }
+            channels_[c]->ring.write(deinterleaved_.data(), count);
+        }
+    }
+
+    // Every channel received the same frames, so one count and one clock
+    // cover them all
+    const int64_t now = LatencyMonitor::now();
+    BlockClock clock;
+    clock.endPosition = channels_.front()->ring.writePosition();
+    clock.endAdcNs = info.adcNs != 0 ? info.adcNs + static_cast<int64_t>(frames * nsPerSample_) : now;
+    clock.writeNs = now;
+    blockClock_.store(clock);
+
+    pendingSamples_ += frames;
+    const size_t hopSize = config_.pitch.hopSize;
+    if (pendingSamples_ >= hopSize) {
+        const size_t hops = pendingSamples_ / hopSize;
+        pendingSamples_ -= hops * hopSize;
+
+        for (size_t c = 0; c < channels_.size(); ++c) {
+            Channel& channel = *channels_[c];
+            if (channel.pendingHops.load(std::memory_order_acquire) == 0) {
+                channel.oldestPendingNs.store(now, std::memory_order_relaxed);
+            }
+            channel.pendingHops.fetch_add(hops, std::memory_order_release);
+            pool_.schedule(c);
+        }
+    }
+    return SinkStatus::Continue;
+}
+
+bool MultiChannelTracker::hasRoomFor(size_t frames) const {
+    for (const auto& channel : channels_) {
+        if (channel->ring.free() < frames) return false;
+    }
+    return true;
+}
+
+void MultiChannelTracker::runChannel(Channel& channel) {
+    const uint64_t hops = channel.pendingHops.exchange(0, std::memory_order_acquire);
+    if (hops == 0) return;
+    RealtimeScope realtime;
+    const int64_t firstReadyNs = channel.oldestPendingNs.load(std::memory_order_relaxed);
+
+    for (uint64_t hop = 0; hop < hops; ++hop) {
+        processHop(channel);
+    }
+    hopLatency_.record(LatencyMonitor::now() - firstReadyNs);
+}
+
+void MultiChannelTracker::processHop(Channel& channel) {
+    const size_t windowSize = config_.pitch.windowSize;
+    const size_t hopSize = config_.pitch.hopSize;
+
+    const uint64_t overflowCount = channel.ring.overflowCount();
+    if (overflowCount != channel.seenOverflowCount) {
+        const uint64_t dropped = overflowCount - channel.seenOverflowCount;
+        channel.seenOverflowCount = overflowCount;
+        channel.missedHops.fetch_add((dropped + hopSize - 1) / hopSize, std::memory_order_relaxed);
+        channel.detector.reset();
+    }
+
+    // Fewer than windowSize samples while the first window fills
+    const float* window = channel.ring.peek(windowSize);
+    if (!window) return;
+
+    // The newest sample's ADC time, back from the latest block's
+    LatencyStamp stamp;
+    stamp.readNs = LatencyMonitor::now();
+    const BlockClock clock = blockClock_.load();
+    const uint64_t endPosition = channel.ring.peekPosition() + windowSize;
+    if (clock.endPosition >= endPosition) {
+        const auto behind = static_cast<double>(clock.endPosition - endPosition + 1);
+        stamp.adcNs = clock.endAdcNs - static_cast<int64_t>(behind * nsPerSample_);
+        stamp.writeNs = stamp.adcNs + (clock.writeNs - clock.endAdcNs);
+    }
+
+    const PitchEstimate estimate = channel.detector.process(window);
+    const float rms = std::sqrt(sumOfSquares(window, windowSize) / static_cast<float>(windowSize));
+    channel.lastPosition = channel.ring.peekPosition() + windowSize / 2;
+    NoteUpdate update = channel.tracker.update(estimate, rms, channel.lastPosition);
+    stamp.detectNs = LatencyMonitor::now();
+    update.latency = stamp;
+    emit(channel, update);
+    channel.processedHops.fetch_add(1, std::memory_order_relaxed);
+
+    if (!channel.ring.consume(hopSize)) {
+        // Overwritten while it was analysed: the next window starts afresh
+        channel.detector.reset();
+    }
+}
+
+void MultiChannelTracker::emit(const Channel& channel, const NoteUpdate& update) {
+    for (size_t i = 0; i < update.count; ++i) {
+        callback_(channel.index, channel.midiChannel, update.events[i], update.latency);
+    }
+}
+
+uint64_t MultiChannelTracker::processedHops() const {
+    uint64_t total = 0;
+    for (const auto& channel : channels_) {
+        total += channel->processedHops.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t MultiChannelTracker::missedHops() const {
+    uint64_t total = 0;
+    for (const auto& channel : channels_) {
+        total += channel->missedHops.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t MultiChannelTracker::processedHops(unsigned channel) const {
+    return channels_.at(channel)->processedHops.load(std::memory_order_relaxed);
+}
+
+uint64_t MultiChannelTracker::missedHops(unsigned channel) const {
+    return channels_.at(channel)->missedHops.load(std::memory_order_relaxed);
+}
+
+} // namespace ptm
@@ -0,0 +1,126 @@
+#include "midi/NoteTracker.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ptm {
+
+namespace {
+    // RMS of a full-scale sine: the top of both velocity curves
+    constexpr float kFullScaleRms = 0.70710678f;
+
+    // Level range, below full scale, spread over velocities 1..127
+    constexpr float kVelocityRangeDb = 48.0f;
+
+    NoteEvent makeEvent(NoteEvent::Type type, int note, uint8_t velocity, uint64_t position) {
+        return NoteEvent{type, static_cast<uint8_t>(note), velocity, position};
+    }
+}
+
+NoteTracker::NoteTracker(const NoteTrackerConfig& config)
+    : config_(config)
+    , debounceSamples_(0) {
+    if (config_.sampleRate <= 0.0) {
+        throw std::invalid_argument("Sample rate must be positive");
+    }
+    if (config_.lowestNote < 0 || config_.highestNote > 127 ||
+        config_.lowestNote > config_.highestNote) {
+        throw std::invalid_argument("Invalid note range");
+    }
+    setThresholds(config_.amplitudeThreshold, config_.debounceMs);
+}
+
+void NoteTracker::setThresholds(float amplitudeThreshold, double debounceMs) {
+    if (debounceMs < 0.0) {
+        throw std::invalid_argument("Debounce time must not be negative");
+    }
+    if (amplitudeThreshold < 0.0f) {
+        throw std::invalid_argument("Amplitude threshold must not be negative");
+    }
+    config_.amplitudeThreshold = amplitudeThreshold;
+    config_.debounceMs = debounceMs;
+    debounceSamples_ = static_cast<uint64_t>(std::llround(debounceMs * config_.sampleRate / 1000.0));
+}
+
+int NoteTracker::frequencyToNote(float frequency) {
+    return static_cast<int>(std::lround(69.0 + 12.0 * std::log2(frequency / 440.0)));
+}
+
+float NoteTracker::centsFromNote(float frequency, int note) {
+    return static_cast<float>(1200.0 * std::log2(frequency / 440.0) - 100.0 * (note - 69));
+}
+
+uint8_t NoteTracker::velocityFor(float rms) const {
+    float level = std::min(rms / kFullScaleRms, 1.0f);
+    float scaled;
+    if (config_.velocityCurve == VelocityCurve::Linear) {
+        scaled = level;
+    } else {
+        float db = 20.0f * std::log10(std::max(level, 1e-6f));
+        scaled = 1.0f + db / kVelocityRangeDb;
+    }
+    long velocity = std::lround(1.0f + 126.0f * std::clamp(scaled, 0.0f, 1.0f));
+    return static_cast<uint8_t>(velocity);
+}
+
+int NoteTracker::candidateNote(const PitchEstimate& estimate, float rms) const {
+    if (!estimate.voiced || estimate.frequency <= 0.0f || rms < config_.amplitudeThreshold) {
+        return -1;
+    }
+    int note = frequencyToNote(estimate.frequency);
+    if (note < config_.lowestNote || note > config_.highestNote) {
+        return -1;
+    }
+    return note;
+}
+
+NoteUpdate NoteTracker::update(const PitchEstimate& estimate, float rms, uint64_t samplePosition) {
+    NoteUpdate result;
+    const int candidate = candidateNote(estimate, rms);
+
+    if (candidate == current_) {
+        hasPending_ = false;
+        return result;
+    }
+    if (!hasPending_ || candidate != pending_) {
+        pending_ = candidate;
+        hasPending_ = true;
+        pendingSince_ = samplePosition;
+        pendingPeakRms_ = rms;
+    } else {
+        pendingPeakRms_ = std::max(pendingPeakRms_, rms);
+    }
+    if (samplePosition - pendingSince_ < debounceSamples_) {
+        return result;
+    }
+
+    // The change has held for the debounce time
+    if (current_ >= 0) {
+        result.events[result.count++] = makeEvent(NoteEvent::Type::NoteOff, current_, 0, pendingSince_);
+    }
+    if (pending_ >= 0) {
+        result.events[result.count++] = makeEvent(NoteEvent::Type::NoteOn, pending_,
+                                                  velocityFor(pendingPeakRms_), pendingSince_);
+    }
+    current_ = pending_;
+    hasPending_ = false;
+    return result;
+}
+
+NoteUpdate NoteTracker::flush(uint64_t samplePosition) {
+    NoteUpdate result;
+    if (current_ >= 0) {
+        result.events[result.count++] = makeEvent(NoteEvent::Type::NoteOff, current_, 0, samplePosition);
+    }
+    reset();
+    return result;
+}
+
+void NoteTracker::reset() {
+    current_ = -1;
+    pending_ = -1;
+    hasPending_ = false;
+    pendingSince_ = 0;
+    pendingPeakRms_ = 0.0f;
+}
+
+} // namespace ptm
@@ -0,0 +1,45 @@
+#include "midi/ParameterStore.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ptm {
+
+namespace {
+    size_t snap(size_t value, size_t low, size_t high, size_t step) {
+        value = std::clamp(value, low, high);
+        return low + (value - low + step / 2) / step * step;
+    }
+}
+
+ProcessingParameters ProcessingParameters::constrained() const {
+    ProcessingParameters result = *this;
+    if (!std::isfinite(result.amplitudeThreshold)) result.amplitudeThreshold = 0.0f;
+    if (!std::isfinite(result.debounceMs)) result.debounceMs = 0.0;
+
+    result.amplitudeThreshold = std::clamp(result.amplitudeThreshold, 0.0f, 1.0f);
+    result.windowSize = snap(windowSize, kMinWindowSize, kMaxWindowSize, kWindowSizeStep);
+    result.hopSize = std::min(snap(hopSize, kMinHopSize, kMaxHopSize, kHopSizeStep),
+                              result.windowSize);
+    result.debounceMs = std::clamp(result.debounceMs, 0.0, kMaxDebounceMs);
+    result.midiChannel = std::clamp<uint8_t>(midiChannel, 1, 16);
+    result.maxVoices = std::clamp<size_t>(maxVoices, 1, kMaxVoices);
+    return result;
+}
+
+ParameterStore::ParameterStore(const ProcessingParameters& initial)
+    : buffer_(Snapshot{initial.constrained(), 0})
+    , published_(initial.constrained()) {}
+
+void ParameterStore::publish(const ProcessingParameters& parameters) {
+    published_ = parameters.constrained();
+    Snapshot& snapshot = buffer_.back();
+    snapshot.parameters = published_;
+    snapshot.version = ++version_;
+    buffer_.publish();
+}
+
+bool ParameterStore::update() {
+    return buffer_.update();
+}
+
+} // namespace ptm
@@ -0,0 +1,108 @@
+#include "midi/PolyphonicNoteTracker.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace ptm {
+
+PolyphonicNoteTracker::PolyphonicNoteTracker(const NoteTrackerConfig& config, size_t maxVoices)
+    : config_(config) {
+    setMaxVoices(maxVoices);
+    NoteTracker{config_};  // Throws if the configuration is invalid
+
+    lanes_.reserve(static_cast<size_t>(config_.highestNote - config_.lowestNote + 1));
+    for (int note = config_.lowestNote; note <= config_.highestNote; ++note) {
+        lanes_.emplace_back(config_);
+    }
+    events_.reserve(lanes_.size());
+}
+
+const std::vector<NoteEvent>& PolyphonicNoteTracker::update(const PolyphonicEstimate& estimate,
+                                                            uint64_t samplePosition) {
+    events_.clear();
+    levels_.fill(0.0f);
+    for (size_t v = 0; v < estimate.count; ++v) {
+        const PolyphonicVoice& voice = estimate.voices[v];
+        if (voice.note >= config_.lowestNote && voice.note <= config_.highestNote) {
+            levels_[static_cast<size_t>(voice.note)] = voice.level;
+        }
+    }
+
+    // Sounding notes first, so their releases make room for new ones
+    for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+        if (lanes_[lane].currentNote() >= 0) updateLane(lane, samplePosition);
+    }
+    for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+        if (lanes_[lane].currentNote() < 0) updateLane(lane, samplePosition);
+    }
+    return events_;
+}
+
+void PolyphonicNoteTracker::updateLane(size_t lane, uint64_t samplePosition) {
+    const int note = config_.lowestNote + static_cast<int>(lane);
+    NoteTracker& tracker = lanes_[lane];
+    const bool wasSounding = tracker.currentNote() >= 0;
+
+    PitchEstimate estimate;
+    float level = levels_[static_cast<size_t>(note)];
+    if (!wasSounding && sounding_ >= maxVoices_) {
+        level = 0.0f;  // No voice free: keep it from starting
+    }
+    if (level > 0.0f) {
+        estimate.frequency = static_cast<float>(440.0 * std::pow(2.0, (note - 69) / 12.0));
+        estimate.confidence = 1.0f;
+        estimate.voiced = true;
+    }
+
+    const NoteUpdate update = tracker.update(estimate, level, samplePosition);
+    for (size_t i = 0; i < update.count; ++i) {
+        events_.push_back(update.events[i]);
+    }
+    const bool isSounding = tracker.currentNote() >= 0;
+    if (isSounding != wasSounding) {
+        sounding_ = isSounding ? sounding_ + 1 : sounding_ - 1;
+    }
+}
+
+const std::vector<NoteEvent>& PolyphonicNoteTracker::flush(uint64_t samplePosition) {
+    events_.clear();
+    for (NoteTracker& tracker : lanes_) {
+        const NoteUpdate update = tracker.flush(samplePosition);
+        for (size_t i = 0; i < update.count; ++i) {
+            events_.push_back(update.events[i]);
+        }
+    }
+    sounding_ = 0;
+    return events_;
+}
+
+void PolyphonicNoteTracker::reset() {
+    for (NoteTracker& tracker : lanes_) {
+        tracker.reset();
+    }
+    events_.clear();
+    sounding_ = 0;
+}
+
+void PolyphonicNoteTracker::setMaxVoices(size_t maxVoices) {
+    if (maxVoices == 0) {
+        throw std::invalid_argument("Voice count must be at least 1");
+    }
+    maxVoices_ = maxVoices;
+}
+
+void PolyphonicNoteTracker::setThresholds(float amplitudeThreshold, double debounceMs) {
+    for (NoteTracker& tracker : lanes_) {
+        tracker.setThresholds(amplitudeThreshold, debounceMs);
+    }
+    config_.amplitudeThreshold = amplitudeThreshold;
+    config_.debounceMs = debounceMs;
+}
+
+bool PolyphonicNoteTracker::isSounding(int note) const {
+    if (note < config_.lowestNote || note > config_.highestNote) {
+        return false;
+    }
+    return lanes_[static_cast<size_t>(note - config_.lowestNote)].currentNote() >= 0;
+}
+
+} // namespace ptm
@@ -0,0 +1,61 @@
+#include "midi/RtMidiPort.hpp"
+#include "RtMidi.h"
+
+namespace ptm {
+
+std::vector<std::string> RtMidiPort::portNames() {
+    std::vector<std::string> names;
+    try {
+        RtMidiOut out;
+        const unsigned count = out.getPortCount();
+        for (unsigned i = 0; i < count; ++i) {
+            names.push_back(out.getPortName(i));
+        }
+    } catch (const RtMidiError& e) {
+        throw MidiOutputException("Cannot list MIDI outputs: " + e.getMessage());
+    }
+    return names;
+}
+
+RtMidiPort::RtMidiPort(unsigned portIndex, const std::string& clientName) {
+    try {
+        out_ = std::make_unique<RtMidiOut>(RtMidi::UNSPECIFIED, clientName);
+        if (portIndex >= out_->getPortCount()) {
+            throw MidiOutputException("No MIDI output " + std::to_string(portIndex) + " (" +
+                                      std::to_string(out_->getPortCount()) + " available)");
+        }
+        name_ = out_->getPortName(portIndex);
+        out_->openPort(portIndex, clientName + " Output");
+    } catch (const RtMidiError& e) {
+        throw MidiOutputException("Cannot open MIDI output " + std::to_string(portIndex) + ": " +
+                                  e.getMessage());
+    }
+}
+
+RtMidiPort::RtMidiPort(std::unique_ptr<RtMidiOut> out, std::string name)
+    : out_(std::move(out))
+    , name_(std::move(name)) {}
+
+std::unique_ptr<RtMidiPort> RtMidiPort::openVirtual(const std::string& portName,
+                                                    const std::string& clientName) {
+    try {
+        auto out = std::make_unique<RtMidiOut>(RtMidi::UNSPECIFIED, clientName);
+        out->openVirtualPort(portName);
+        return std::unique_ptr<RtMidiPort>(new RtMidiPort(std::move(out), portName + " (virtual)"));
+    } catch (const RtMidiError& e) {
+        throw MidiOutputException("Cannot open virtual MIDI output " + portName + ": " +
+                                  e.getMessage());
+    }
+}
+
+RtMidiPort::~RtMidiPort() = default;
+
+void RtMidiPort::send(const uint8_t* bytes, size_t size) {
+    try {
+        out_->sendMessage(bytes, size);
+    } catch (const RtMidiError&) {
+        failedSends_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace ptm
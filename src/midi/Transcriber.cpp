@@ -0,0 +1,161 @@
+#include "midi/Transcriber.hpp"
+#include "dsp/Kernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace ptm {
+
+namespace {
+    // Keep the top of the pitch range clear of Nyquist for low-rate files
+    constexpr double kMaxFrequencyFraction = 0.45;
+
+    // Default chunk length, in incremental resync periods (about 6 s of
+    // 48 kHz audio at the default window and hop)
+    constexpr size_t kDefaultChunkPeriods = 16;
+
+    struct HopAnalysis {
+        PitchEstimate estimate;
+        float rms;
+    };
+
+    // Per-thread detector and decode buffer
+    class ChunkAnalyzer {
+    public:
+        ChunkAnalyzer(const PitchDetectorConfig& config, size_t blockFrames)
+            : detector_(config)
+            , windowSize_(config.windowSize)
+            , hopSize_(config.hopSize)
+            , staging_(config.windowSize + std::max(blockFrames, config.hopSize)) {}
+
+        // Analyse hops [firstHop, firstHop + hopCount)
+        void analyse(const MappedWavFile& file, uint64_t firstHop, size_t hopCount, HopAnalysis* out) {
+            // An exact first window, as a continuous run would compute here
+            detector_.reset();
+
+            const uint64_t chunkStart = firstHop * hopSize_;
+            uint64_t stagedStart = chunkStart;
+            size_t staged = 0;
+
+            for (size_t hop = 0; hop < hopCount; ++hop) {
+                const uint64_t position = chunkStart + hop * hopSize_;
+                size_t offset = static_cast<size_t>(position - stagedStart);
+                if (offset + windowSize_ > staged) {
+                    // Slide the unread tail to the front and refill behind it
+                    size_t keep = staged - offset;
+                    std::memmove(staging_.data(), staging_.data() + offset, keep * sizeof(float));
+                    stagedStart = position;
+                    staged = keep + file.readFrames(position + keep, staging_.size() - keep,
+                                                    staging_.data() + keep);
+                    offset = 0;
+                }
+
+                const float* window = staging_.data() + offset;
+                out[hop].estimate = detector_.process(window);
+                out[hop].rms = std::sqrt(sumOfSquares(window, windowSize_) /
+                                         static_cast<float>(windowSize_));
+            }
+        }
+
+    private:
+        PitchDetector detector_;
+        size_t windowSize_;
+        size_t hopSize_;
+        std::vector<float> staging_;
+    };
+}
+
+Transcription transcribe(const MappedWavFile& file, const TranscriberConfig& config) {
+    PitchDetectorConfig pitchConfig = config.pitch;
+    pitchConfig.sampleRate = file.sampleRate();
+    pitchConfig.maxFrequency = std::min(pitchConfig.maxFrequency,
+                                        static_cast<float>(file.sampleRate() * kMaxFrequencyFraction));
+    const size_t windowSize = pitchConfig.windowSize;
+    const size_t hopSize = pitchConfig.hopSize;
+    if (hopSize == 0 || hopSize > windowSize) {
+        throw std::invalid_argument("Hop size must be between 1 and the window size");
+    }
+
+    NoteTrackerConfig noteConfig = config.notes;
+    noteConfig.sampleRate = file.sampleRate();
+    NoteTracker tracker(noteConfig);
+
+    Transcription result;
+    result.sampleRate = file.sampleRate();
+    result.frames = file.frames();
+    result.hops = result.frames >= windowSize ? (result.frames - windowSize) / hopSize + 1 : 0;
+
+    // An incremental detector recomputes exactly once every resync period;
+    // chunks made of whole periods start on those hops
+    const bool incremental = hopSize < windowSize / 2;
+    const size_t period = incremental ? std::max<size_t>(pitchConfig.resyncInterval, 1) + 1 : 1;
+    size_t chunkHops = config.chunkHops ? config.chunkHops : kDefaultChunkPeriods * period;
+    chunkHops = (chunkHops + period - 1) / period * period;
+    result.chunks = (result.hops + chunkHops - 1) / chunkHops;
+
+    unsigned threads = config.threads ? config.threads : std::thread::hardware_concurrency();
+    threads = static_cast<unsigned>(std::clamp<uint64_t>(result.chunks, 1, std::max(threads, 1u)));
+    result.threads = threads;
+
+    // Detectors are built up front so a bad configuration throws here
+    std::vector<std::unique_ptr<ChunkAnalyzer>> analyzers;
+    for (unsigned t = 0; t < threads; ++t) {
+        analyzers.push_back(std::make_unique<ChunkAnalyzer>(pitchConfig, config.blockFrames));
+    }
+
+    std::vector<HopAnalysis> hops(static_cast<size_t>(result.hops));
+    std::atomic<uint64_t> nextChunk{0};
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    auto work = [&](ChunkAnalyzer& analyzer) {
+        try {
+            for (uint64_t chunk = nextChunk++; chunk < result.chunks; chunk = nextChunk++) {
+                const uint64_t firstHop = chunk * chunkHops;
+                const size_t count = static_cast<size_t>(
+                    std::min<uint64_t>(chunkHops, result.hops - firstHop));
+                analyzer.analyse(file, firstHop, count, hops.data() + firstHop);
+
+                // Frames no other chunk reads: up to where the next one starts
+                file.release(firstHop * hopSize, (firstHop + count) * hopSize);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure) failure = std::current_exception();
+            nextChunk = result.chunks;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back(work, std::ref(*analyzers[t]));
+    }
+    work(*analyzers[0]);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    // Stitch: one tracker over every hop in order
+    auto append = [&](const NoteUpdate& update) {
+        result.events.insert(result.events.end(), update.events.begin(),
+                             update.events.begin() + static_cast<std::ptrdiff_t>(update.count));
+    };
+    for (uint64_t hop = 0; hop < result.hops; ++hop) {
+        const HopAnalysis& analysis = hops[static_cast<size_t>(hop)];
+        append(tracker.update(analysis.estimate, analysis.rms, hop * hopSize + windowSize / 2));
+    }
+    append(tracker.flush(result.frames));
+    return result;
+}
+
+} // namespace ptm
@@ -0,0 +1,129 @@
+// ptm-convert: transcribe a WAV recording to a Standard MIDI File offline,
+// with the same pitch, velocity and note-event logic as the live path.
+
+#include "audio/MappedWavFile.hpp"
+#include "midi/MidiFileWriter.hpp"
+#include "midi/Transcriber.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] input.wav output.mid\n"
+              << "\n"
+              << "Options:\n"
+              << "  --window N        Analysis window in samples (default 1024)\n"
+              << "  --hop N           Samples between windows (default 256)\n"
+              << "  --threshold X     RMS that starts a note, 0-1 (default 0.1)\n"
+              << "  --yin-threshold X YIN voicing threshold, 0-1 (default 0.15)\n"
+              << "  --debounce MS     Time a note change must persist (default 20)\n"
+              << "  --channel N       MIDI channel, 1-16 (default 1)\n"
+              << "  --velocity CURVE  linear or log (default log)\n"
+              << "  --threads N       Analysis threads, 0 for all cores (default 0)\n";
+}
+
+bool parseOptions(int argc, char* argv[], ptm::TranscriberConfig& config, int& channel,
+                  std::string& input, std::string& output) {
+    config.pitch.hopSize = 256;
+    config.threads = 0;
+
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            return false;
+        }
+        if (arg.rfind("--", 0) == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return false;
+            }
+            const char* value = argv[++i];
+            if (arg == "--window") {
+                config.pitch.windowSize = std::strtoul(value, nullptr, 10);
+            } else if (arg == "--hop") {
+                config.pitch.hopSize = std::strtoul(value, nullptr, 10);
+            } else if (arg == "--threshold") {
+                config.notes.amplitudeThreshold = std::strtof(value, nullptr);
+            } else if (arg == "--yin-threshold") {
+                config.pitch.threshold = std::strtof(value, nullptr);
+            } else if (arg == "--debounce") {
+                config.notes.debounceMs = std::strtod(value, nullptr);
+            } else if (arg == "--threads") {
+                config.threads = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+            } else if (arg == "--channel") {
+                channel = std::atoi(value);
+            } else if (arg == "--velocity" && std::strcmp(value, "linear") == 0) {
+                config.notes.velocityCurve = ptm::VelocityCurve::Linear;
+            } else if (arg == "--velocity" && std::strcmp(value, "log") == 0) {
+                config.notes.velocityCurve = ptm::VelocityCurve::Logarithmic;
+            } else {
+                std::cerr << "Unknown option " << arg << " " << value << std::endl;
+                return false;
+            }
+        } else if (positional == 0) {
+            input = arg;
+            ++positional;
+        } else if (positional == 1) {
+            output = arg;
+            ++positional;
+        } else {
+            std::cerr << "Unexpected argument " << arg << std::endl;
+            return false;
+        }
+    }
+    return positional == 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ptm::TranscriberConfig config;
+    int channel = 1;
+    std::string input;
+    std::string output;
+    if (!parseOptions(argc, argv, config, channel, input, output)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+
+        ptm::MappedWavFile file(input);
+        ptm::Transcription transcription = ptm::transcribe(file, config);
+        auto analysed = std::chrono::steady_clock::now();
+
+        ptm::MidiFileWriter writer;
+        writer.addEvents(transcription.events, transcription.sampleRate, channel);
+        writer.write(output);
+        auto end = std::chrono::steady_clock::now();
+
+        size_t notes = 0;
+        for (const ptm::NoteEvent& event : transcription.events) {
+            if (event.type == ptm::NoteEvent::Type::NoteOn) ++notes;
+        }
+
+        const double audioSeconds = file.durationSeconds();
+        const double analysisSeconds = std::chrono::duration<double>(analysed - start).count();
+        const double totalSeconds = std::chrono::duration<double>(end - start).count();
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << input << ": " << audioSeconds << " s, " << file.sampleRate() << " Hz, "
+                  << file.channels() << " channel(s)\n"
+                  << "  " << transcription.hops << " windows in " << transcription.chunks << " chunks on "
+                  << transcription.threads << " thread(s), " << notes << " notes -> " << output << "\n"
+                  << "  analysis " << std::setprecision(3) << analysisSeconds << " s, total "
+                  << totalSeconds << " s, " << std::setprecision(1)
+                  << audioSeconds / totalSeconds << "x real time" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ptm-convert: " << e.what() << std::endl;
+        return 1;
+    }
+}
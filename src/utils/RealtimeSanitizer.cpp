@@ -0,0 +1,210 @@
+// Interposers for PTM_RT_SANITIZER builds. Linked into the executable, the
+// definitions below take the place of the C library's for the whole
+// process; each checks the calling thread and forwards to the real one.
+
+#include "utils/RealtimeSanitizer.hpp"
+
+#ifdef PTM_RT_SANITIZER
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <ctime>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+
+// glibc's own allocator entry points. dlsym() may itself allocate, so the
+// malloc family cannot be looked up the way the other functions are.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+}
+
+namespace ptm {
+
+namespace {
+    constexpr int kMaxFrames = 32;
+    constexpr uint64_t kMaxDefaultReports = 8;
+
+    // Plain ints: static TLS, readable from inside malloc without allocating
+    thread_local int realtimeDepth = 0;
+    thread_local int suspendDepth = 0;
+
+    std::atomic<RealtimeSanitizer::Handler> handler{nullptr};
+    std::atomic<uint64_t> violationCount{0};
+
+    void defaultReport(const char* function, void* const* frames, int frameCount) {
+        const uint64_t index = violationCount.load(std::memory_order_relaxed);
+        if (index > kMaxDefaultReports) return;
+
+        std::fprintf(stderr, "Real-time violation: %s called on a real-time thread\n", function);
+        // Skip report() and the interposer itself
+        const int skip = frameCount > 2 ? 2 : 0;
+        backtrace_symbols_fd(const_cast<void**>(frames) + skip, frameCount - skip, STDERR_FILENO);
+        if (index == kMaxDefaultReports) {
+            std::fprintf(stderr, "Real-time violation: further reports suppressed\n");
+        }
+    }
+
+    void report(const char* function) {
+        ++suspendDepth;  // Reporting may allocate, lock and write
+        void* frames[kMaxFrames];
+        const int frameCount = backtrace(frames, kMaxFrames);
+        violationCount.fetch_add(1, std::memory_order_relaxed);
+
+        RealtimeSanitizer::Handler current = handler.load(std::memory_order_acquire);
+        (current ? current : defaultReport)(function, frames, frameCount);
+        --suspendDepth;
+    }
+
+    inline void check(const char* function) {
+        if (realtimeDepth > 0 && suspendDepth == 0) {
+            report(function);
+        }
+    }
+
+    // The next definition of a symbol, i.e. the C library's
+    template<typename Function>
+    Function next(const char* name, std::atomic<Function>& cache) {
+        Function function = cache.load(std::memory_order_acquire);
+        if (!function) {
+            function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+            cache.store(function, std::memory_order_release);
+        }
+        return function;
+    }
+
+    // backtrace() loads the unwinder on first use; do that before any
+    // thread is real-time
+    __attribute__((constructor)) void warmUp() {
+        void* frames[1];
+        backtrace(frames, 1);
+    }
+}
+
+void RealtimeSanitizer::setHandler(Handler newHandler) {
+    handler.store(newHandler, std::memory_order_release);
+}
+
+uint64_t RealtimeSanitizer::violations() {
+    return violationCount.load(std::memory_order_relaxed);
+}
+
+bool RealtimeSanitizer::isRealtimeThread() {
+    return realtimeDepth > 0;
+}
+
+void RealtimeSanitizer::enterRealtime() {
+    ++realtimeDepth;
+}
+
+void RealtimeSanitizer::leaveRealtime() {
+    --realtimeDepth;
+}
+
+void RealtimeSanitizer::suspend() {
+    ++suspendDepth;
+}
+
+void RealtimeSanitizer::resume() {
+    --suspendDepth;
+}
+
+} // namespace ptm
+
+// Forwards to the next definition after checking the calling thread.
+// Specifier matches the C library's declaration: noexcept or nothing.
+#define PTM_RT_INTERPOSE(ReturnType, name, Parameters, Arguments, Specifier)  \
+    ReturnType name Parameters Specifier {                                    \
+        using Function = ReturnType(*) Parameters;                            \
+        static std::atomic<Function> real{nullptr};                           \
+        ptm::check(#name);                                                    \
+        return ptm::next<Function>(#name, real) Arguments;                    \
+    }
+
+extern "C" {
+
+void* malloc(size_t size) noexcept {
+    ptm::check("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    ptm::check("calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept {
+    ptm::check("realloc");
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) noexcept {
+    if (pointer) ptm::check("free");
+    __libc_free(pointer);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+    ptm::check("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    ptm::check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) noexcept {
+    ptm::check("posix_memalign");
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* pointer = __libc_memalign(alignment, size);
+    if (!pointer) return ENOMEM;
+    *result = pointer;
+    return 0;
+}
+
+PTM_RT_INTERPOSE(int, pthread_mutex_lock, (pthread_mutex_t* mutex), (mutex), noexcept)
+PTM_RT_INTERPOSE(int, pthread_mutex_timedlock,
+                 (pthread_mutex_t* mutex, const struct timespec* deadline), (mutex, deadline), noexcept)
+PTM_RT_INTERPOSE(int, pthread_mutex_clocklock,
+                 (pthread_mutex_t* mutex, clockid_t clock, const struct timespec* deadline),
+                 (mutex, clock, deadline), noexcept)
+PTM_RT_INTERPOSE(int, pthread_rwlock_rdlock, (pthread_rwlock_t* lock), (lock), noexcept)
+PTM_RT_INTERPOSE(int, pthread_rwlock_wrlock, (pthread_rwlock_t* lock), (lock), noexcept)
+PTM_RT_INTERPOSE(int, pthread_cond_wait, (pthread_cond_t* condition, pthread_mutex_t* mutex),
+                 (condition, mutex), )
+PTM_RT_INTERPOSE(int, pthread_cond_timedwait,
+                 (pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* deadline),
+                 (condition, mutex, deadline), )
+PTM_RT_INTERPOSE(int, pthread_cond_clockwait,
+                 (pthread_cond_t* condition, pthread_mutex_t* mutex, clockid_t clock,
+                  const struct timespec* deadline),
+                 (condition, mutex, clock, deadline), )
+PTM_RT_INTERPOSE(int, pthread_join, (pthread_t thread, void** result), (thread, result), )
+PTM_RT_INTERPOSE(int, sem_wait, (sem_t* semaphore), (semaphore), )
+PTM_RT_INTERPOSE(int, sem_timedwait, (sem_t* semaphore, const struct timespec* deadline),
+                 (semaphore, deadline), )
+PTM_RT_INTERPOSE(int, sem_clockwait, (sem_t* semaphore, clockid_t clock, const struct timespec* deadline),
+                 (semaphore, clock, deadline), )
+PTM_RT_INTERPOSE(int, nanosleep, (const struct timespec* duration, struct timespec* remaining),
+                 (duration, remaining), )
+PTM_RT_INTERPOSE(int, clock_nanosleep,
+                 (clockid_t clock, int flags, const struct timespec* duration, struct timespec* remaining),
+                 (clock, flags, duration, remaining), )
+PTM_RT_INTERPOSE(int, usleep, (useconds_t microseconds), (microseconds), )
+PTM_RT_INTERPOSE(unsigned int, sleep, (unsigned int seconds), (seconds), )
+PTM_RT_INTERPOSE(ssize_t, read, (int fd, void* buffer, size_t count), (fd, buffer, count), )
+PTM_RT_INTERPOSE(ssize_t, write, (int fd, const void* buffer, size_t count), (fd, buffer, count), )
+
+} // extern "C"
+
+#endif // PTM_RT_SANITIZER
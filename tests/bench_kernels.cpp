@@ -0,0 +1,80 @@
+#include "dsp/Kernels.hpp"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+constexpr size_t kLength = 4096;           // Largest GUI window size
+constexpr size_t kIterations = 20000;
+
+volatile float gSink;
+
+template<typename Fn>
+double samplesPerNanosecond(Fn&& kernel) {
+    // Warm up caches and clocks
+    for (size_t i = 0; i < kIterations / 10; ++i) kernel();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kIterations; ++i) kernel();
+    auto end = std::chrono::steady_clock::now();
+    double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+    return static_cast<double>(kLength * kIterations) / nanoseconds;
+}
+
+} // namespace
+
+int main() {
+    std::vector<float> a(kLength);
+    std::vector<float> b(kLength);
+    std::vector<float> out(kLength);
+    for (size_t i = 0; i < kLength; ++i) {
+        a[i] = static_cast<float>(std::sin(0.01 * static_cast<double>(i)));
+        b[i] = static_cast<float>(std::cos(0.013 * static_cast<double>(i))) + 1.0f;
+    }
+
+    std::cout << "Kernel throughput in Gsamples/s, " << kLength << " samples per call"
+              << " (selected: " << ptm::toString(ptm::kernels().isa) << ")" << std::endl;
+    std::cout << std::setw(8) << "isa" << std::setw(14) << "sumOfSquares" << std::setw(10)
+              << "peak" << std::setw(10) << "dot" << std::setw(12) << "sqDiff"
+              << std::setw(12) << "accSqDiff" << std::setw(10) << "cmnd" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    for (auto isa : {ptm::InstructionSet::Scalar, ptm::InstructionSet::SSE2,
+                     ptm::InstructionSet::AVX2, ptm::InstructionSet::AVX512}) {
+        const ptm::KernelTable* table = ptm::kernelsFor(isa);
+        if (!table) {
+            std::cout << std::setw(8) << ptm::toString(isa) << "  (not available)" << std::endl;
+            continue;
+        }
+
+        double sumOfSquares = samplesPerNanosecond([&] {
+            gSink = table->sumOfSquares(a.data(), kLength);
+        });
+        double peak = samplesPerNanosecond([&] {
+            gSink = table->peak(a.data(), kLength);
+        });
+        double dot = samplesPerNanosecond([&] {
+            gSink = table->dot(a.data(), b.data(), kLength);
+        });
+        double squaredDifference = samplesPerNanosecond([&] {
+            gSink = table->squaredDifference(a.data(), b.data(), kLength);
+        });
+        double accumulate = samplesPerNanosecond([&] {
+            table->accumulateSquaredDifference(0.5f, a.data(), out.data(), kLength);
+            gSink = out[kLength - 1];
+        });
+        double normalize = samplesPerNanosecond([&] {
+            table->cumulativeMeanNormalize(b.data(), out.data(), kLength);
+            gSink = out[kLength - 1];
+        });
+
+        std::cout << std::setw(8) << ptm::toString(isa) << std::setw(14) << sumOfSquares
+                  << std::setw(10) << peak << std::setw(10) << dot
+                  << std::setw(12) << squaredDifference << std::setw(12) << accumulate
+                  << std::setw(10) << normalize << std::endl;
+    }
+    return 0;
+}
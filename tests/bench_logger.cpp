@@ -0,0 +1,84 @@
+#include "utils/Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t kCalls = 100000;
+constexpr size_t kBurst = 64;  // Calls between pauses, so the async queue drains
+
+struct LatencySummary {
+    double p50;
+    double p99;
+    double max;
+};
+
+LatencySummary summarize(std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    return {samples[samples.size() / 2],
+            samples[samples.size() * 99 / 100],
+            samples.back()};
+}
+
+// Measures how long each LOG_INFO call blocks the calling thread
+LatencySummary measure(const PitchToMidi::LoggerOptions& options, const std::string& logFile) {
+    auto& logger = PitchToMidi::Logger::getInstance();
+    logger.init("bench", logFile, 1048576 * 50, 2, options);
+
+    std::vector<double> samples;
+    samples.reserve(kCalls);
+    const std::string deviceName = "Built-in Microphone";
+
+    for (size_t i = 0; i < kCalls; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        LOG_INFO("hop {} device {} pitch {:.2f} Hz note {} velocity {}",
+                 i, deviceName, 440.0 + static_cast<double>(i % 100) * 0.5,
+                 static_cast<int>(69 + i % 12), static_cast<int>(i % 128));
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+
+        if (i % kBurst == kBurst - 1) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    logger.shutdown();
+    return summarize(samples);
+}
+
+} // namespace
+
+int main() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "ptm_bench_logger";
+    std::filesystem::create_directories(dir);
+
+    PitchToMidi::LoggerOptions sync;
+    sync.consoleOutput = false;
+
+    PitchToMidi::LoggerOptions async = sync;
+    async.mode = PitchToMidi::LogMode::Async;
+    async.queueSize = 16384;
+
+    LatencySummary syncResult = measure(sync, (dir / "sync.log").string());
+    LatencySummary asyncResult = measure(async, (dir / "async.log").string());
+
+    std::cout << "Per-call LOG_INFO latency on the calling thread (" << kCalls
+              << " calls, file sink)" << std::endl;
+    std::cout << std::setw(8) << "mode" << std::setw(12) << "p50 ns"
+              << std::setw(12) << "p99 ns" << std::setw(12) << "max ns" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << std::setw(8) << "sync" << std::setw(12) << syncResult.p50
+              << std::setw(12) << syncResult.p99 << std::setw(12) << syncResult.max << std::endl;
+    std::cout << std::setw(8) << "async" << std::setw(12) << asyncResult.p50
+              << std::setw(12) << asyncResult.p99 << std::setw(12) << asyncResult.max << std::endl;
+    std::cout << "Async messages dropped: "
+              << PitchToMidi::Logger::getInstance().droppedMessages() << std::endl;
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "dsp/DifferenceFunction.hpp"
+#include "dsp/PitchDetector.hpp"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+constexpr double kSampleRate = 96000.0;
+constexpr size_t kHopSize = 64;
+constexpr double kBenchSeconds = 2.0;  // Audio analysed per configuration
+
+// Harmonic tone with vibrato, so every hop sees a slightly different window
+std::vector<float> makeSignal(size_t count) {
+    const double pi = std::acos(-1.0);
+    std::vector<float> samples(count);
+    double phase = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double t = static_cast<double>(i) / kSampleRate;
+        double frequency = 220.0 * (1.0 + 0.01 * std::sin(2.0 * pi * 5.0 * t));
+        phase += 2.0 * pi * frequency / kSampleRate;
+        samples[i] = static_cast<float>(0.5 * std::sin(phase) + 0.25 * std::sin(2.0 * phase) +
+                                        0.125 * std::sin(3.0 * phase));
+    }
+    return samples;
+}
+
+// The O(N * tau) difference function the FFT path replaces
+double directDifference(const float* window, size_t windowSize, std::vector<float>& out) {
+    const size_t half = windowSize / 2;
+    double checksum = 0.0;
+    for (size_t tau = 0; tau < half; ++tau) {
+        float sum = 0.0f;
+        for (size_t j = 0; j < half; ++j) {
+            float delta = window[j] - window[j + tau];
+            sum += delta * delta;
+        }
+        out[tau] = sum;
+        checksum += sum;
+    }
+    return checksum;
+}
+
+template<typename Fn>
+double microsecondsPerHop(const std::vector<float>& signal, size_t windowSize, size_t hopSize,
+                          Fn&& analyse) {
+    const size_t hops = (signal.size() - windowSize) / hopSize;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t hop = 0; hop < hops; ++hop) {
+        analyse(signal.data() + hop * hopSize);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / static_cast<double>(hops);
+}
+
+} // namespace
+
+int main() {
+    const double budget = 1e6 * static_cast<double>(kHopSize) / kSampleRate;
+    auto signal = makeSignal(static_cast<size_t>(kSampleRate * kBenchSeconds) + 4096);
+
+#ifdef USE_FFTW
+    const char* backend = "FFTW";
+#else
+    const char* backend = "built-in radix-2";
+#endif
+    std::cout << "PitchDetector at " << kSampleRate / 1000.0 << " kHz, hop " << kHopSize
+              << " (budget " << std::fixed << std::setprecision(1) << budget
+              << " us per hop), FFT: " << backend << std::endl;
+    std::cout << std::setw(8) << "window" << std::setw(14) << "method" << std::setw(12)
+              << "us/hop" << std::setw(14) << "x real-time" << std::endl;
+
+    double sink = 0.0;
+    for (size_t windowSize : {1024, 2048, 4096}) {
+        ptm::PitchDetectorConfig config;
+        config.sampleRate = kSampleRate;
+        config.windowSize = windowSize;
+        ptm::PitchDetector detector(config);
+        config.hopSize = kHopSize;
+        ptm::PitchDetector incrementalDetector(config);
+
+        double fftCost = microsecondsPerHop(signal, windowSize, kHopSize, [&](const float* window) {
+            sink += detector.process(window).frequency;
+        });
+
+        double incrementalCost = microsecondsPerHop(signal, windowSize, kHopSize,
+                                                    [&](const float* window) {
+            sink += incrementalDetector.process(window).frequency;
+        });
+
+        std::vector<float> difference(windowSize / 2);
+        double directCost = microsecondsPerHop(signal, windowSize, kHopSize, [&](const float* window) {
+            sink += directDifference(window, windowSize, difference);
+        });
+
+        std::cout << std::setw(8) << windowSize << std::setw(14) << "fft yin"
+                  << std::setw(12) << fftCost << std::setw(14) << budget / fftCost << std::endl;
+        std::cout << std::setw(8) << windowSize << std::setw(14) << "incr yin"
+                  << std::setw(12) << incrementalCost << std::setw(14) << budget / incrementalCost
+                  << std::endl;
+        std::cout << std::setw(8) << windowSize << std::setw(14) << "direct diff"
+                  << std::setw(12) << directCost << std::setw(14) << budget / directCost << std::endl;
+    }
+
+    // Difference function alone: from scratch versus incremental, by hop size
+    const size_t windowSize = 1024;
+    std::cout << std::endl << "DifferenceFunction, window " << windowSize << std::endl;
+    std::cout << std::setw(8) << "hop" << std::setw(12) << "exact us" << std::setw(12)
+              << "incr us" << std::setw(10) << "ratio" << std::endl;
+    for (size_t hopSize : {32, 64, 128, 256}) {
+        ptm::DifferenceFunction exact(windowSize);
+        ptm::DifferenceFunction incremental(windowSize, hopSize);
+
+        double exactCost = microsecondsPerHop(signal, windowSize, hopSize, [&](const float* window) {
+            exact.compute(window);
+            sink += exact.values()[100];
+        });
+        double incrementalCost = microsecondsPerHop(signal, windowSize, hopSize,
+                                                    [&](const float* window) {
+            incremental.compute(window);
+            sink += incremental.values()[100];
+        });
+
+        std::cout << std::setw(8) << hopSize << std::setw(12) << exactCost << std::setw(12)
+                  << incrementalCost << std::setw(10) << std::setprecision(2)
+                  << incrementalCost / exactCost << std::setprecision(1) << std::endl;
+    }
+
+    // Keep the optimiser from discarding the work
+    if (sink == 42.0) std::cout << sink << std::endl;
+    return 0;
+}
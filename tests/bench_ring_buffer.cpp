@@ -0,0 +1,181 @@
+#include "audio/MirroredRingBuffer.hpp"
+#include "audio/RingBuffer.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// The pre-rewrite buffer, kept verbatim as the comparison baseline
+template<typename T>
+class LegacyRingBuffer {
+public:
+    explicit LegacyRingBuffer(size_t capacity)
+        : buffer_(capacity)
+        , capacity_(capacity)
+        , writeIndex_(0)
+        , readIndex_(0) {}
+
+    size_t write(const T* data, size_t count) {
+        size_t available = capacity_ - (writeIndex_ - readIndex_.load(std::memory_order_acquire));
+        size_t toWrite = std::min(count, available);
+        if (toWrite == 0) return 0;
+
+        size_t writePos = writeIndex_ % capacity_;
+        size_t firstPart = std::min(toWrite, capacity_ - writePos);
+        std::memcpy(&buffer_[writePos], data, firstPart * sizeof(T));
+        if (firstPart < toWrite) {
+            std::memcpy(&buffer_[0], data + firstPart, (toWrite - firstPart) * sizeof(T));
+        }
+        writeIndex_ += toWrite;
+        return toWrite;
+    }
+
+    size_t read(T* data, size_t count) {
+        size_t available = writeIndex_.load(std::memory_order_acquire) - readIndex_;
+        size_t toRead = std::min(count, available);
+        if (toRead == 0) return 0;
+
+        size_t readPos = readIndex_ % capacity_;
+        size_t firstPart = std::min(toRead, capacity_ - readPos);
+        std::memcpy(data, &buffer_[readPos], firstPart * sizeof(T));
+        if (firstPart < toRead) {
+            std::memcpy(data + firstPart, &buffer_[0], (toRead - firstPart) * sizeof(T));
+        }
+        readIndex_ += toRead;
+        return toRead;
+    }
+
+private:
+    std::vector<T> buffer_;
+    const size_t capacity_;
+    std::atomic<size_t> writeIndex_;
+    std::atomic<size_t> readIndex_;
+};
+
+constexpr size_t kCapacity = 8192;  // Matches AudioCapture::kDefaultBufferSize
+constexpr size_t kSamplesPerRun = size_t{1} << 25;
+
+// Streams kSamplesPerRun samples through the buffer in blocks of blockSize,
+// producer and consumer on separate threads. Returns samples per second.
+template<typename Buffer>
+double measureThroughput(Buffer& buffer, size_t blockSize) {
+    std::vector<float> source(blockSize, 0.5f);
+    std::vector<float> sink(blockSize);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread producer([&] {
+        size_t sent = 0;
+        while (sent < kSamplesPerRun) {
+            size_t written = buffer.write(source.data(), blockSize);
+            if (written == 0) {
+                std::this_thread::yield();
+            }
+            sent += written;
+        }
+    });
+
+    size_t received = 0;
+    while (received < kSamplesPerRun) {
+        size_t count = buffer.read(sink.data(), blockSize);
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        received += count;
+    }
+    producer.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(kSamplesPerRun) / elapsed.count();
+}
+
+// Analysis access pattern: every hop, look at the next windowSize samples and
+// advance by hopSize. The copying variant mimics getAudioData() into scratch.
+// Returns nanoseconds per hop.
+template<typename Access>
+double measureWindowAccess(size_t windowSize, size_t hopSize, Access access) {
+    constexpr size_t kHops = 200000;
+    ptm::MirroredRingBuffer<float> buffer(kCapacity);
+    std::vector<float> hop(hopSize, 0.25f);
+    std::vector<float> warmup(windowSize - hopSize, 0.25f);
+    buffer.write(warmup.data(), warmup.size());
+
+    float checksum = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kHops; ++i) {
+        buffer.write(hop.data(), hopSize);
+        checksum += access(buffer, windowSize, hopSize);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (checksum < 0.0f) std::cout << checksum;  // Keep the work observable
+    return elapsed.count() / kHops;
+}
+
+void runWindowBenchmark() {
+    std::cout << std::endl << "Analysis window access (copy vs zero-copy view)" << std::endl;
+    std::cout << std::setw(8) << "window" << std::setw(8) << "hop"
+              << std::setw(14) << "copy ns/hop"
+              << std::setw(14) << "view ns/hop" << std::endl;
+
+    for (size_t windowSize : {1024, 4096}) {
+        for (size_t hopSize : {64, 256}) {
+            // The window overlaps the next one, so only hopSize samples are
+            // consumed; the remainder is kept in a scratch history
+            std::vector<float> scratch(windowSize);
+            double copyNs = measureWindowAccess(windowSize, hopSize,
+                [&scratch](ptm::MirroredRingBuffer<float>& buffer, size_t window, size_t hop) {
+                    std::memmove(scratch.data(), scratch.data() + hop, (window - hop) * sizeof(float));
+                    buffer.read(scratch.data() + window - hop, hop);
+                    return scratch[window / 2];
+                });
+            double viewNs = measureWindowAccess(windowSize, hopSize,
+                [](ptm::MirroredRingBuffer<float>& buffer, size_t window, size_t hop) {
+                    const float* view = buffer.peek(window);
+                    float sample = view ? view[window / 2] : 0.0f;
+                    buffer.consume(hop);
+                    return sample;
+                });
+
+            std::cout << std::setw(8) << windowSize << std::setw(8) << hopSize
+                      << std::setw(14) << std::fixed << std::setprecision(1) << copyNs
+                      << std::setw(14) << viewNs << std::endl;
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "RingBuffer throughput (" << kCapacity << " float capacity, "
+              << kSamplesPerRun << " samples per run)" << std::endl;
+    std::cout << std::setw(8) << "block"
+              << std::setw(16) << "legacy MS/s"
+              << std::setw(16) << "current MS/s"
+              << std::setw(16) << "mirrored MS/s"
+              << std::setw(10) << "speedup" << std::endl;
+
+    for (size_t blockSize = 64; blockSize <= 2048; blockSize *= 2) {
+        LegacyRingBuffer<float> legacy(kCapacity);
+        ptm::RingBuffer<float> current(kCapacity, ptm::OverflowPolicy::DropNewest);
+        ptm::MirroredRingBuffer<float> mirrored(kCapacity, ptm::OverflowPolicy::DropNewest);
+
+        double legacyRate = measureThroughput(legacy, blockSize);
+        double currentRate = measureThroughput(current, blockSize);
+        double mirroredRate = measureThroughput(mirrored, blockSize);
+
+        std::cout << std::setw(8) << blockSize
+                  << std::setw(16) << std::fixed << std::setprecision(1) << legacyRate / 1e6
+                  << std::setw(16) << currentRate / 1e6
+                  << std::setw(16) << mirroredRate / 1e6
+                  << std::setw(9) << std::setprecision(2) << currentRate / legacyRate << "x"
+                  << std::endl;
+    }
+
+    runWindowBenchmark();
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "audio/MappedWavFile.hpp"
+#include "midi/Transcriber.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kDefaultSeconds = 300.0;  // Override with the first argument
+
+// 16-bit mono take: a scale of harmonic notes with vibrato and rests,
+// written in slices so long takes do not need the whole signal in memory
+std::string writeTake(double seconds) {
+    const double pi = std::acos(-1.0);
+    const uint64_t frames = static_cast<uint64_t>(seconds * kSampleRate);
+    const uint32_t dataBytes = static_cast<uint32_t>(frames * 2);
+    std::string path = (std::filesystem::temp_directory_path() / "ptm_bench_transcriber.wav").string();
+    std::ofstream out(path, std::ios::binary);
+
+    auto put32 = [&](uint32_t value) { out.write(reinterpret_cast<const char*>(&value), 4); };
+    auto put16 = [&](uint16_t value) { out.write(reinterpret_cast<const char*>(&value), 2); };
+    out.write("RIFF", 4);
+    put32(36 + dataBytes);
+    out.write("WAVEfmt ", 8);
+    put32(16);
+    put16(1);
+    put16(1);
+    put32(static_cast<uint32_t>(kSampleRate));
+    put32(static_cast<uint32_t>(kSampleRate) * 2);
+    put16(2);
+    put16(16);
+    out.write("data", 4);
+    put32(dataBytes);
+
+    const int scale[] = {0, 2, 4, 5, 7, 9, 11, 12};
+    const uint64_t noteFrames = static_cast<uint64_t>(0.3 * kSampleRate);
+    std::vector<int16_t> slice(noteFrames);
+    double phase = 0.0;
+    for (uint64_t start = 0, note = 0; start < frames; start += noteFrames, ++note) {
+        double frequency = 220.0 * std::pow(2.0, scale[note % 8] / 12.0);
+        double amplitude = note % 7 == 6 ? 0.0 : 0.3 + 0.1 * static_cast<double>(note % 3);
+        size_t count = static_cast<size_t>(std::min(noteFrames, frames - start));
+        for (size_t i = 0; i < count; ++i) {
+            double t = static_cast<double>(i) / kSampleRate;
+            phase += 2.0 * pi * frequency * (1.0 + 0.005 * std::sin(2.0 * pi * 5.0 * t)) / kSampleRate;
+            double value = amplitude * (std::sin(phase) + 0.5 * std::sin(2.0 * phase));
+            slice[i] = static_cast<int16_t>(value * 20000.0);
+        }
+        out.write(reinterpret_cast<const char*>(slice.data()), static_cast<std::streamsize>(count * 2));
+    }
+    return path;
+}
+
+bool sameEvents(const std::vector<ptm::NoteEvent>& a, const std::vector<ptm::NoteEvent>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].type != b[i].type || a[i].note != b[i].note || a[i].velocity != b[i].velocity ||
+            a[i].samplePosition != b[i].samplePosition) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : kDefaultSeconds;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::string path = writeTake(seconds);
+    ptm::MappedWavFile file(path);
+
+    ptm::TranscriberConfig config;
+    config.pitch.windowSize = 1024;
+    config.pitch.hopSize = 256;
+
+    std::cout << "Transcriber scaling: " << seconds << " s at " << kSampleRate / 1000.0
+              << " kHz, window " << config.pitch.windowSize << ", hop " << config.pitch.hopSize
+              << ", " << cores << " core(s)" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(10) << "seconds" << std::setw(14)
+              << "x real-time" << std::setw(10) << "speedup" << std::setw(12) << "efficiency"
+              << std::setw(10) << "output" << std::endl;
+    std::cout << std::fixed;
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < cores; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(cores);
+
+    ptm::Transcription reference;
+    double baseline = 0.0;
+    bool allIdentical = true;
+    for (unsigned threads : threadCounts) {
+        config.threads = threads;
+        auto start = std::chrono::steady_clock::now();
+        auto result = ptm::transcribe(file, config);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (threads == 1) {
+            reference = result;
+            baseline = elapsed;
+        }
+        bool identical = sameEvents(result.events, reference.events);
+        allIdentical = allIdentical && identical;
+
+        std::cout << std::setw(8) << threads << std::setw(10) << std::setprecision(3) << elapsed
+                  << std::setw(14) << std::setprecision(1) << seconds / elapsed
+                  << std::setw(10) << std::setprecision(2) << baseline / elapsed
+                  << std::setw(11) << std::setprecision(0) << 100.0 * baseline / elapsed / threads
+                  << "%" << std::setw(10) << (identical ? "same" : "DIFFERS") << std::endl;
+    }
+    std::cout << reference.events.size() << " events, " << reference.chunks << " chunks" << std::endl;
+
+    std::remove(path.c_str());
+    return allIdentical ? 0 : 1;
+}
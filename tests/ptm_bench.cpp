@@ -0,0 +1,791 @@
+// ptm_bench: headless microbenchmarks of the real-time path on synthetic
+// signals. Prints a table to stderr and JSON to stdout (or --output), so
+// ns/hop and real-time factor can be tracked across commits.
+//
+//   ptm_bench [--output FILE] [--label TEXT] [--filter TEXT] [--min-time SECONDS]
+
+#include "audio/AnalysisWorker.hpp"
+#include "audio/AudioCapture.hpp"
+#include "audio/LatencyMonitor.hpp"
+#include "audio/MirroredRingBuffer.hpp"
+#include "audio/ReplaySource.hpp"
+#include "audio/RingBuffer.hpp"
+#include "audio/StreamStats.hpp"
+#include "dsp/Kernels.hpp"
+#include "dsp/PitchDetector.hpp"
+#include "dsp/PitchDetectorSet.hpp"
+#include "dsp/PolyphonicDetector.hpp"
+#include "dsp/SyntheticSignal.hpp"
+#include "midi/MidiOutput.hpp"
+#include "midi/MultiChannelTracker.hpp"
+#include "midi/NoteTracker.hpp"
+#include "midi/PolyphonicNoteTracker.hpp"
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kSignalSeconds = 2.0;
+constexpr int kRepetitions = 5;  // Median of this many timed runs
+
+volatile float gSink;
+
+struct Options {
+    std::string output;
+    std::string label;
+    std::string filter;
+    double minTime = 0.1;  // Seconds per timed run
+};
+
+struct Result {
+    std::string name;
+    std::string signal;
+    std::vector<std::pair<std::string, double>> params;
+    std::string unit;           // What one operation is: "block" or "hop"
+    double nsPerOp = 0.0;
+    double realTimeFactor = 0.0;  // Audio time per operation / processing time; 0 if n/a
+    uint64_t operations = 0;
+};
+
+struct Signal {
+    std::string name;
+    std::vector<float> samples;
+};
+
+std::vector<Signal> makeSignals() {
+    const size_t count = static_cast<size_t>(kSampleRate * kSignalSeconds);
+    return {
+        {"sine", ptm::synthetic::tone(220.0, kSampleRate, count, 0.5f, 3)},
+        {"chirp", ptm::synthetic::chirp(55.0, 1760.0, kSampleRate, count)},
+        {"vibrato", ptm::synthetic::vibrato(330.0, 40.0, 5.5, kSampleRate, count)},
+        {"noise", ptm::synthetic::noise(count, 0.2f)},
+    };
+}
+
+// Runs op (which performs opsPerCall operations) until minTime has passed,
+// kRepetitions times, and returns the median ns per operation
+double measure(const Options& options, uint64_t opsPerCall, const std::function<void()>& op,
+               uint64_t& totalOps) {
+    op();  // Warm up caches and lazily built tables
+    std::vector<double> samples;
+    totalOps = 0;
+    for (int r = 0; r < kRepetitions; ++r) {
+        uint64_t ops = 0;
+        auto start = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed{0.0};
+        do {
+            op();
+            ops += opsPerCall;
+            elapsed = std::chrono::steady_clock::now() - start;
+        } while (elapsed.count() < options.minTime);
+        samples.push_back(elapsed.count() * 1e9 / static_cast<double>(ops));
+        totalOps += ops;
+    }
+    std::nth_element(samples.begin(), samples.begin() + kRepetitions / 2, samples.end());
+    return samples[kRepetitions / 2];
+}
+
+class Bench {
+public:
+    explicit Bench(Options options) : options_(std::move(options)) {}
+
+    bool selected(const std::string& name) const {
+        return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+    }
+
+    // samplesPerOp: audio samples one operation covers, for the real-time factor
+    void run(const std::string& name, const std::string& signal,
+             std::vector<std::pair<std::string, double>> params, const std::string& unit,
+             uint64_t opsPerCall, size_t samplesPerOp, const std::function<void()>& op) {
+        std::string fullName = signal.empty() ? name : name + "/" + signal;
+        if (!selected(fullName)) return;
+
+        Result result;
+        result.name = name;
+        result.signal = signal;
+        result.params = std::move(params);
+        result.unit = unit;
+        result.nsPerOp = measure(options_, opsPerCall, op, result.operations);
+        if (samplesPerOp > 0) {
+            double audioNs = 1e9 * static_cast<double>(samplesPerOp) / kSampleRate;
+            result.realTimeFactor = audioNs / result.nsPerOp;
+        }
+        add(std::move(result));
+    }
+
+    // A result measured by the caller, e.g. in real time
+    void add(Result result) {
+        const std::string fullName = result.signal.empty() ? result.name
+                                                           : result.name + "/" + result.signal;
+        std::ostringstream paramText;
+        for (const auto& param : result.params) {
+            paramText << param.first << "=" << param.second << " ";
+        }
+        std::cerr << std::left << std::setw(34) << fullName << std::setw(24) << paramText.str()
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(12)
+                  << result.nsPerOp << " ns/" << std::left << std::setw(6) << result.unit
+                  << std::right;
+        if (result.realTimeFactor > 0.0) {
+            std::cerr << std::setw(10) << std::setprecision(0) << result.realTimeFactor << "x";
+        }
+        std::cerr << std::endl;
+        results_.push_back(std::move(result));
+    }
+
+    void writeJson(std::ostream& out) const;
+    const Options& options() const { return options_; }
+
+private:
+    Options options_;
+    std::vector<Result> results_;
+};
+
+void Bench::writeJson(std::ostream& out) const {
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+#ifdef USE_FFTW
+    const char* fft = "fftw";
+#else
+    const char* fft = "builtin";
+#endif
+#if defined(__clang__)
+    const std::string compiler = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    const std::string compiler = std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+    const std::string compiler = "msvc " + std::to_string(_MSC_VER);
+#else
+    const std::string compiler = "unknown";
+#endif
+
+    std::time_t now = std::time(nullptr);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    // Ordered, so the file reads in the order written here
+    nlohmann::ordered_json results = nlohmann::ordered_json::array();
+    for (const Result& result : results_) {
+        nlohmann::ordered_json entry = {{"name", result.name}, {"signal", result.signal}};
+        for (const auto& param : result.params) {
+            entry[param.first] = param.second;
+        }
+        entry["unit"] = result.unit;
+        entry["ns_per_op"] = result.nsPerOp;
+        entry["realtime_factor"] = result.realTimeFactor;
+        entry["operations"] = result.operations;
+        results.push_back(std::move(entry));
+    }
+
+    const nlohmann::ordered_json report = {
+        {"schema", 1},
+        {"label", options_.label},
+        {"timestamp", timestamp},
+        {"build", build},
+        {"compiler", compiler},
+        {"isa", ptm::toString(ptm::kernels().isa)},
+        {"fft", fft},
+        {"sample_rate", kSampleRate},
+        {"results", std::move(results)},
+    };
+    out << report.dump(2) << "\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        if (arg == "--output") {
+            options.output = argv[++i];
+        } else if (arg == "--label") {
+            options.label = argv[++i];
+        } else if (arg == "--filter") {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time") {
+            options.minTime = std::atof(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.minTime > 0.0;
+}
+
+// --- Benchmarks --------------------------------------------------------------
+
+void benchRingBuffers(Bench& bench, const std::vector<float>& source) {
+    for (size_t block : {64, 256, 1024}) {
+        ptm::RingBuffer<float> ring(8192);
+        std::vector<float> out(block);
+        size_t offset = 0;
+        bench.run("ring_buffer/write_read", "", {{"block", static_cast<double>(block)}}, "block",
+                  1000, block, [&] {
+            for (int i = 0; i < 1000; ++i) {
+                ring.write(source.data() + offset, block);
+                ring.read(out.data(), block);
+                offset = (offset + block) % (source.size() - block);
+            }
+            gSink = out[0];
+        });
+    }
+
+    // The analysis side's access pattern: a window view, then one hop consumed
+    const size_t window = 1024;
+    for (size_t hop : {64, 256}) {
+        ptm::MirroredRingBuffer<float> ring(8192);
+        size_t offset = 0;
+        ring.write(source.data(), window - hop);
+        bench.run("mirrored_ring/write_peek_consume", "",
+                  {{"window", static_cast<double>(window)}, {"hop", static_cast<double>(hop)}},
+                  "hop", 1000, hop, [&] {
+            float sum = 0.0f;
+            for (int i = 0; i < 1000; ++i) {
+                ring.write(source.data() + offset, hop);
+                const float* view = ring.peek(window);
+                sum += view[window - 1];
+                ring.consume(hop);
+                offset = (offset + hop) % (source.size() - hop);
+            }
+            gSink = sum;
+        });
+    }
+}
+
+// AudioCapture's block callback in the steady state, driven by an unpaced
+// SyntheticSource so every block goes through the real processBlock():
+// ring write, stream statistics and latency stamps, and hop notifications
+// to an analysis worker with nothing to do. ns/block is the callback's own
+// mean duration from the stream statistics, so the source's thread and the
+// stream's start and stop are not counted; median of kRepetitions streams.
+void benchCaptureCallback(Bench& bench, const std::vector<float>& source) {
+    const std::string name = "capture_callback";
+    if (!bench.selected(name)) return;
+
+    // AudioCapture logs every start and stop to stdout, where the JSON goes
+    const spdlog::level::level_enum level = spdlog::get_level();
+    spdlog::set_level(spdlog::level::off);
+
+    {
+        ptm::AudioCapture capture;
+        capture.setAnalysisCallback(ptm::AnalysisConfig{}, [](const ptm::AnalysisFrame&) {});
+        auto ignore = [](const float*, unsigned long) {};
+        for (size_t block : {64, 128, 256, 512}) {
+            ptm::ReplayConfig replay;
+            replay.framesPerBuffer = block;
+            replay.speed = 0.0;  // As fast as the analysis worker keeps up
+
+            std::vector<double> means;
+            Result result;
+            for (int r = 0; r <= kRepetitions; ++r) {  // The first warms up
+                capture.start(std::make_unique<ptm::SyntheticSource>(kSampleRate, source, replay),
+                              ignore);
+                while (capture.isActive()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                const ptm::StreamStatsSnapshot stats = capture.getStreamStats();
+                capture.stop();
+                if (r > 0) {
+                    means.push_back(stats.callbackDuration.meanNs);
+                    result.operations += stats.callbackDuration.count;
+                }
+            }
+            std::nth_element(means.begin(), means.begin() + kRepetitions / 2, means.end());
+
+            result.name = name;
+            result.params = {{"block", static_cast<double>(block)}};
+            result.unit = "block";
+            result.nsPerOp = means[kRepetitions / 2];
+            result.realTimeFactor = 1e9 * static_cast<double>(block) / kSampleRate / result.nsPerOp;
+            bench.add(std::move(result));
+        }
+    }
+    spdlog::set_level(level);
+}
+
+void benchAmplitude(Bench& bench, const std::vector<Signal>& signals) {
+    for (size_t window : {1024, 2048}) {
+        const size_t hop = 256;
+        const Signal& signal = signals.front();
+        const size_t hops = (signal.samples.size() - window) / hop;
+        bench.run("amplitude", "", {{"window", static_cast<double>(window)}, {"hop", static_cast<double>(hop)}},
+                  "hop", hops, hop, [&] {
+            float sum = 0.0f;
+            for (size_t h = 0; h < hops; ++h) {
+                const float* x = signal.samples.data() + h * hop;
+                sum += std::sqrt(ptm::sumOfSquares(x, window) / static_cast<float>(window));
+                sum += ptm::peak(x, window);
+            }
+            gSink = sum;
+        });
+    }
+}
+
+void benchPitch(Bench& bench, const std::vector<Signal>& signals) {
+    for (size_t window : {1024, 2048}) {
+        for (size_t hop : {64, 256}) {
+            for (bool incremental : {false, true}) {
+                ptm::PitchDetectorConfig config;
+                config.sampleRate = kSampleRate;
+                config.windowSize = window;
+                config.hopSize = incremental ? hop : 0;
+                ptm::PitchDetector detector(config);
+
+                for (const Signal& signal : signals) {
+                    const size_t hops = (signal.samples.size() - window) / hop;
+                    bench.run(incremental ? "pitch/incremental" : "pitch/exact", signal.name,
+                              {{"window", static_cast<double>(window)}, {"hop", static_cast<double>(hop)}},
+                              "hop", hops, hop, [&] {
+                        detector.reset();
+                        float sum = 0.0f;
+                        for (size_t h = 0; h < hops; ++h) {
+                            sum += detector.process(signal.samples.data() + h * hop).frequency;
+                        }
+                        gSink = sum;
+                    });
+                }
+            }
+        }
+    }
+}
+
+// Changing the window size mid-stream: a detector built ahead of time per
+// size, against constructing one (and, with FFTW, planning) on the spot
+void benchWindowSwitch(Bench& bench, const std::vector<Signal>& signals) {
+    if (!bench.selected("window_switch")) return;
+
+    const std::vector<size_t> windows = ptm::PitchDetectorSet::defaultWindowSizes();
+    ptm::FftPlanCache cache(ptm::PitchDetectorSet::fftSizesFor(windows));
+    cache.build();
+
+    Result plans;
+    plans.name = "window_switch/plan_all";
+    plans.unit = "build";
+    plans.nsPerOp = cache.buildSeconds() * 1e9;
+    plans.operations = 1;
+    bench.add(std::move(plans));
+
+    ptm::PitchDetectorConfig config;
+    config.sampleRate = kSampleRate;
+    ptm::PitchDetectorSet detectors(config, windows, cache);
+
+    // One hop per switch, cycling through every window size
+    const Signal& signal = signals.front();
+    const size_t ops = windows.size();
+    bench.run("window_switch/select", signal.name, {}, "switch", ops, 0, [&] {
+        float sum = 0.0f;
+        for (size_t window : windows) {
+            sum += detectors.select(window)->process(signal.samples.data()).frequency;
+        }
+        gSink = sum;
+    });
+    bench.run("window_switch/rebuild", signal.name, {}, "switch", ops, 0, [&] {
+        float sum = 0.0f;
+        for (size_t window : windows) {
+            config.windowSize = window;
+            ptm::PitchDetector detector(config);
+            sum += detector.process(signal.samples.data()).frequency;
+        }
+        gSink = sum;
+    });
+}
+
+// Note events alone, on estimates precomputed from each signal
+void benchNoteTracker(Bench& bench, const std::vector<Signal>& signals) {
+    const size_t window = 1024;
+    const size_t hop = 256;
+    ptm::PitchDetectorConfig pitchConfig;
+    pitchConfig.sampleRate = kSampleRate;
+    pitchConfig.windowSize = window;
+    pitchConfig.hopSize = hop;
+    ptm::PitchDetector detector(pitchConfig);
+
+    ptm::NoteTrackerConfig noteConfig;
+    noteConfig.sampleRate = kSampleRate;
+    ptm::NoteTracker tracker(noteConfig);
+
+    for (const Signal& signal : signals) {
+        std::string name = "note_tracker/" + signal.name;
+        if (!bench.selected(name)) continue;
+
+        const size_t hops = (signal.samples.size() - window) / hop;
+        std::vector<ptm::PitchEstimate> estimates(hops);
+        std::vector<float> levels(hops);
+        detector.reset();
+        for (size_t h = 0; h < hops; ++h) {
+            const float* x = signal.samples.data() + h * hop;
+            estimates[h] = detector.process(x);
+            levels[h] = std::sqrt(ptm::sumOfSquares(x, window) / static_cast<float>(window));
+        }
+
+        bench.run("note_tracker", signal.name, {{"hop", static_cast<double>(hop)}}, "hop", hops, hop, [&] {
+            tracker.reset();
+            size_t events = 0;
+            for (size_t h = 0; h < hops; ++h) {
+                events += tracker.update(estimates[h], levels[h], h * hop).count;
+            }
+            gSink = static_cast<float>(events);
+        });
+    }
+}
+
+// Amplitude, incremental pitch and note events together, as the live path runs them
+void benchPipeline(Bench& bench, const std::vector<Signal>& signals) {
+    for (size_t window : {1024, 2048}) {
+        const size_t hop = 256;
+        ptm::PitchDetectorConfig pitchConfig;
+        pitchConfig.sampleRate = kSampleRate;
+        pitchConfig.windowSize = window;
+        pitchConfig.hopSize = hop;
+        ptm::PitchDetector detector(pitchConfig);
+
+        ptm::NoteTrackerConfig noteConfig;
+        noteConfig.sampleRate = kSampleRate;
+        ptm::NoteTracker tracker(noteConfig);
+
+        for (const Signal& signal : signals) {
+            const size_t hops = (signal.samples.size() - window) / hop;
+            bench.run("pipeline", signal.name,
+                      {{"window", static_cast<double>(window)}, {"hop", static_cast<double>(hop)}},
+                      "hop", hops, hop, [&] {
+                detector.reset();
+                tracker.reset();
+                size_t events = 0;
+                for (size_t h = 0; h < hops; ++h) {
+                    const float* x = signal.samples.data() + h * hop;
+                    float rms = std::sqrt(ptm::sumOfSquares(x, window) / static_cast<float>(window));
+                    events += tracker.update(detector.process(x), rms, h * hop + window / 2).count;
+                }
+                gSink = static_cast<float>(events);
+            });
+        }
+    }
+}
+
+// Polyphonic detection and per-note voices; the chord gives every voice
+// something to find, so the cost per hop is near its bound
+void benchPolyphonic(Bench& bench, const std::vector<Signal>& signals) {
+    const size_t count = signals.front().samples.size();
+    std::vector<Signal> inputs{{"chord", std::vector<float>(count, 0.0f)}, signals.back()};
+    for (double frequency : {130.81, 261.63, 329.63, 392.0}) {
+        auto tone = ptm::synthetic::tone(frequency, kSampleRate, count, 0.2f, 6);
+        for (size_t i = 0; i < count; ++i) {
+            inputs[0].samples[i] += tone[i];
+        }
+    }
+
+    const size_t hop = 512;
+    for (size_t window : {2048, 4096}) {
+        for (size_t voices : {1, 4, 8}) {
+            ptm::PolyphonicDetectorConfig detectorConfig;
+            detectorConfig.sampleRate = kSampleRate;
+            detectorConfig.windowSize = window;
+            detectorConfig.maxVoices = voices;
+            ptm::PolyphonicDetector detector(detectorConfig);
+
+            ptm::NoteTrackerConfig noteConfig;
+            noteConfig.sampleRate = kSampleRate;
+            ptm::PolyphonicNoteTracker tracker(noteConfig, voices);
+
+            for (const Signal& signal : inputs) {
+                const size_t hops = (signal.samples.size() - window) / hop;
+                bench.run("polyphonic", signal.name,
+                          {{"window", static_cast<double>(window)}, {"hop", static_cast<double>(hop)},
+                           {"voices", static_cast<double>(voices)}},
+                          "hop", hops, hop, [&] {
+                    tracker.reset();
+                    size_t events = 0;
+                    for (size_t h = 0; h < hops; ++h) {
+                        const float* x = signal.samples.data() + h * hop;
+                        events += tracker.update(detector.process(x), h * hop + window / 2).size();
+                    }
+                    gSink = static_cast<float>(events);
+                });
+            }
+        }
+    }
+}
+
+// Independent trackers fed at real time, doubling the channel count until
+// hops are missed. Each channel's ring holds a window and a hop, so a hop
+// counts as missed once its channel falls a window behind. ns/hop is the
+// mean time from a hop's block arriving to its analysis finishing.
+void benchChannelScaling(Bench& bench, const std::vector<float>& source) {
+    if (!bench.selected("channel_scaling")) return;
+
+    constexpr size_t kHop = 128;
+    constexpr size_t kWindow = 1024;
+    constexpr unsigned kMaxChannels = 256;
+    const double seconds = std::max(bench.options().minTime * 10.0, 1.0);
+    const size_t blocks = static_cast<size_t>(seconds * kSampleRate / kHop);
+    const auto blockPeriod = std::chrono::nanoseconds(static_cast<int64_t>(1e9 * kHop / kSampleRate));
+
+    for (unsigned channels = 1; channels <= kMaxChannels; channels *= 2) {
+        ptm::MultiChannelConfig config;
+        config.sampleRate = kSampleRate;
+        config.channels = channels;
+        config.pitch.windowSize = kWindow;
+        config.pitch.hopSize = kHop;
+        config.bufferSize = kWindow + kHop;
+        ptm::MultiChannelTracker tracker(config, [](unsigned, uint8_t, const ptm::NoteEvent&, const ptm::LatencyStamp&) {});
+
+        // Each channel plays the signal from a different point
+        std::vector<float> block(kHop * channels);
+        ptm::AudioBlockInfo info;
+        info.channels = channels;
+
+        tracker.start();
+        auto deadline = std::chrono::steady_clock::now();
+        for (size_t b = 0; b < blocks; ++b) {
+            for (unsigned c = 0; c < channels; ++c) {
+                const size_t offset = (b * kHop + c * 997) % (source.size() - kHop);
+                for (size_t i = 0; i < kHop; ++i) {
+                    block[i * channels + c] = source[offset + i];
+                }
+            }
+            deadline += blockPeriod;
+            std::this_thread::sleep_until(deadline);
+            tracker.processBlock(block.data(), kHop, info);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        tracker.stop();
+
+        const auto latency = tracker.hopLatency().summary();
+        const uint64_t missed = tracker.missedHops();
+        Result result;
+        result.name = "channel_scaling";
+        result.params = {{"channels", static_cast<double>(channels)},
+                         {"threads", static_cast<double>(tracker.threadCount())},
+                         {"hop", static_cast<double>(kHop)},
+                         {"missed_hops", static_cast<double>(missed)},
+                         {"p99_us", latency.p99Ns / 1e3}};
+        result.unit = "hop";
+        result.nsPerOp = latency.meanNs;
+        result.operations = tracker.processedHops();
+        bench.add(std::move(result));
+
+        if (missed > 0) break;
+    }
+}
+
+// Blocks for as long as the bytes take on a 31.25 kbaud DIN link
+struct DinPort final : ptm::MidiPort {
+    static constexpr int64_t kWireNsPerByte = 320'000;  // 10 bits per byte
+
+    explicit DinPort(bool runningStatus = false) : runningStatus(runningStatus) {}
+
+    void send(const uint8_t*, size_t size) override {
+        const int64_t until = ptm::LatencyMonitor::now() + kWireNsPerByte * static_cast<int64_t>(size);
+        while (ptm::LatencyMonitor::now() < until) {}
+    }
+    bool acceptsRunningStatus() const override { return runningStatus; }
+    std::string describe() const override { return "simulated DIN"; }
+
+    bool runningStatus;
+};
+
+// One pitch bend per hop and a note pair every 32 hops, posted in real time
+// as the detection thread would, to a port that blocks for as long as each
+// message takes on a 31.25 kbaud DIN link. ns/message is the cost of
+// post() to the posting thread; the queue wait and depth are what the
+// sender thread absorbs instead.
+void benchMidiOutput(Bench& bench) {
+    if (!bench.selected("midi_output")) return;
+
+    constexpr size_t kHop = 128;
+    const double seconds = std::max(bench.options().minTime * 10.0, 1.0);
+    const size_t hops = static_cast<size_t>(seconds * kSampleRate / kHop);
+    const auto hopPeriod = std::chrono::nanoseconds(static_cast<int64_t>(1e9 * kHop / kSampleRate));
+
+    DinPort port;
+    ptm::MidiOutput output(port);
+    output.start();
+
+    int64_t postNs = 0;
+    uint64_t posts = 0;
+    auto post = [&](const ptm::MidiMessage& message) {
+        const int64_t start = ptm::LatencyMonitor::now();
+        output.post(message);
+        postNs += ptm::LatencyMonitor::now() - start;
+        ++posts;
+    };
+
+    auto deadline = std::chrono::steady_clock::now();
+    for (size_t h = 0; h < hops; ++h) {
+        const uint8_t note = static_cast<uint8_t>(60 + (h / 32) % 12);
+        if (h % 32 == 0) post(ptm::MidiMessage::noteOn(0, note, 100));
+        post(ptm::MidiMessage::pitchBend(0, static_cast<uint16_t>(8192 + (h % 64) * 16)));
+        if (h % 32 == 31) post(ptm::MidiMessage::noteOff(0, note));
+        deadline += hopPeriod;
+        std::this_thread::sleep_until(deadline);
+    }
+    output.stop();
+
+    const auto wait = output.queueWait().summary();
+    Result result;
+    result.name = "midi_output";
+    result.params = {{"hop", static_cast<double>(kHop)},
+                     {"p99_wait_us", wait.p99Ns / 1e3},
+                     {"max_depth", static_cast<double>(output.maxQueueDepth())},
+                     {"dropped", static_cast<double>(output.droppedMessages())}};
+    result.unit = "msg";
+    result.nsPerOp = posts > 0 ? static_cast<double>(postNs) / static_cast<double>(posts) : 0.0;
+    result.operations = posts;
+    bench.add(std::move(result));
+}
+
+// Continuous mode on four channels (one voice each) over DIN: a bend per
+// channel per hop, following the pitch detected in the vibrato signal, and
+// the note restruck every half second. Compares messages and bytes per
+// second and note latency without and with bend thinning.
+void benchMidiThinning(Bench& bench, const std::vector<float>& vibrato) {
+    constexpr size_t kHop = 128;
+    constexpr size_t kWindow = 1024;
+    constexpr uint8_t kChannels = 4;
+    const double seconds = std::max(bench.options().minTime * 10.0, 1.0);
+    const size_t hops = static_cast<size_t>(seconds * kSampleRate / kHop);
+    const size_t restrikeHops = static_cast<size_t>(0.5 * kSampleRate / kHop);
+    const auto hopPeriod = std::chrono::nanoseconds(static_cast<int64_t>(1e9 * kHop / kSampleRate));
+
+    // Cents from the nearest note, per hop of the signal
+    ptm::PitchDetectorConfig pitchConfig;
+    pitchConfig.sampleRate = kSampleRate;
+    pitchConfig.windowSize = kWindow;
+    pitchConfig.hopSize = kHop;
+    ptm::PitchDetector detector(pitchConfig);
+    std::vector<double> cents;
+    int note = 0;
+    for (size_t h = 0; h * kHop + kWindow <= vibrato.size(); ++h) {
+        const ptm::PitchEstimate estimate = detector.process(vibrato.data() + h * kHop);
+        if (!estimate.voiced) continue;
+        const double midi = 69.0 + 12.0 * std::log2(estimate.frequency / 440.0);
+        if (cents.empty()) note = static_cast<int>(std::lround(midi));
+        cents.push_back((midi - note) * 100.0);
+    }
+    if (cents.empty()) return;
+
+    struct Variant {
+        const char* name;
+        ptm::BendThinningConfig thinning;
+        bool runningStatus;
+    };
+    const Variant variants[] = {
+        {"every_bend", {}, false},
+        {"thinned", {3.0, 2.0, true}, false},
+        {"running_status", {3.0, 2.0, true}, true},
+    };
+
+    for (const Variant& variant : variants) {
+        const std::string name = std::string("midi_thinning/") + variant.name;
+        if (!bench.selected(name)) continue;
+
+        ptm::LatencyMonitor monitor;
+        DinPort port(variant.runningStatus);
+        ptm::MidiOutput output(port, ptm::MidiOutput::kDefaultQueueSize, &monitor);
+        output.setBendThinning(variant.thinning);
+        output.start();
+
+        int64_t postNs = 0;
+        uint64_t posts = 0;
+        auto post = [&](const ptm::MidiMessage& message, const ptm::LatencyStamp& stamp) {
+            const int64_t start = ptm::LatencyMonitor::now();
+            output.post(message, stamp);
+            postNs += ptm::LatencyMonitor::now() - start;
+            ++posts;
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+        auto deadline = start;
+        for (size_t h = 0; h < hops; ++h) {
+            for (uint8_t channel = 0; channel < kChannels; ++channel) {
+                // Notes are stamped so the monitor times them alone
+                ptm::LatencyStamp stamp;
+                stamp.adcNs = stamp.detectNs = ptm::LatencyMonitor::now();
+                if (h % restrikeHops == 0) {
+                    if (h > 0) post(ptm::MidiMessage::noteOff(channel, static_cast<uint8_t>(note)), stamp);
+                    post(ptm::MidiMessage::noteOn(channel, static_cast<uint8_t>(note), 100), stamp);
+                }
+                // Voices a quarter of the vibrato apart
+                const double bend = cents[(h + channel * 17) % cents.size()];
+                post(ptm::MidiMessage::pitchBendCents(channel, bend), {});
+            }
+            deadline += hopPeriod;
+            std::this_thread::sleep_until(deadline);
+        }
+        output.stop();
+        // Including the time to drain what was still queued
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const auto notes = monitor.summary(ptm::LatencyStage::Output);
+        Result result;
+        result.name = name;
+        result.signal = "vibrato";
+        result.params = {{"hop", static_cast<double>(kHop)},
+                         {"channels", static_cast<double>(kChannels)},
+                         {"posted_per_s", static_cast<double>(posts) / seconds},
+                         {"sent_per_s", static_cast<double>(output.sentMessages()) / elapsed},
+                         {"bytes_per_s", static_cast<double>(output.bytesSent()) / elapsed},
+                         {"note_p99_us", notes.p99Ns / 1e3},
+                         {"dropped", static_cast<double>(output.droppedMessages())}};
+        result.unit = "msg";
+        result.nsPerOp = posts > 0 ? static_cast<double>(postNs) / static_cast<double>(posts) : 0.0;
+        result.operations = posts;
+        bench.add(std::move(result));
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--output FILE] [--label TEXT] [--filter TEXT] [--min-time SECONDS]" << std::endl;
+        return 2;
+    }
+#ifndef NDEBUG
+    std::cerr << "Warning: assertions are enabled; build in Release for meaningful numbers" << std::endl;
+#endif
+
+    auto signals = makeSignals();
+    Bench bench(options);
+    benchRingBuffers(bench, signals.front().samples);
+    benchCaptureCallback(bench, signals.front().samples);
+    benchAmplitude(bench, signals);
+    benchPitch(bench, signals);
+    benchWindowSwitch(bench, signals);
+    benchNoteTracker(bench, signals);
+    benchPipeline(bench, signals);
+    benchPolyphonic(bench, signals);
+    benchChannelScaling(bench, signals.front().samples);
+    benchMidiOutput(bench);
+    benchMidiThinning(bench, signals[2].samples);  // vibrato
+
+    if (options.output.empty()) {
+        bench.writeJson(std::cout);
+    } else {
+        std::ofstream file(options.output);
+        if (!file) {
+            std::cerr << "Cannot write " << options.output << std::endl;
+            return 1;
+        }
+        bench.writeJson(file);
+    }
+    return 0;
+}
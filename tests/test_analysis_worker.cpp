@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "audio/AnalysisWorker.hpp"
+#include "utils/RealtimeSanitizer.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using ptm::AnalysisConfig;
+using ptm::AnalysisFrame;
+using ptm::AnalysisWorker;
+using ptm::MirroredRingBuffer;
+
+namespace {
+    // Waits up to a second for the worker to catch up
+    template<typename Predicate>
+    bool eventually(Predicate predicate) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST(AnalysisWorkerTest, DeliversEveryHopInOrder) {
+    MirroredRingBuffer<float> buffer(8192);
+    AnalysisConfig config;
+    config.windowSize = 256;
+    config.hopSize = 64;
+
+    std::mutex mutex;
+    std::vector<float> firstSamples;
+    std::vector<uint64_t> hopIndices;
+    bool windowsIntact = true;
+
+    AnalysisWorker worker(buffer, config, [&](const AnalysisFrame& frame) {
+        // The producer writes a ramp, so every window must be consecutive
+        for (size_t i = 1; i < frame.windowSize; ++i) {
+            if (frame.samples[i] != frame.samples[0] + static_cast<float>(i)) {
+                windowsIntact = false;
+            }
+        }
+        ptm::RealtimeExemption exemption;  // Test bookkeeping
+        std::lock_guard<std::mutex> lock(mutex);
+        firstSamples.push_back(frame.samples[0]);
+        hopIndices.push_back(frame.hopIndex);
+    });
+    worker.start();
+
+    // 100 callbacks of 48 frames: hops do not line up with callbacks
+    const size_t blocks = 100;
+    const size_t blockSize = 48;
+    std::vector<float> block(blockSize);
+    float next = 0.0f;
+    for (size_t b = 0; b < blocks; ++b) {
+        std::iota(block.begin(), block.end(), next);
+        next += static_cast<float>(blockSize);
+        worker.notifySamplesWritten(buffer.write(block.data(), block.size()));
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    // 4800 samples: hops complete at 64, 128, ...; the first three only
+    // partially fill a 256-sample window and are skipped
+    const uint64_t expected = (blocks * blockSize) / config.hopSize - 3;
+    ASSERT_TRUE(eventually([&] { return worker.processedHops() == expected; }));
+    worker.stop();
+
+    EXPECT_TRUE(windowsIntact);
+    EXPECT_EQ(worker.missedHops(), 0u);
+    ASSERT_EQ(firstSamples.size(), expected);
+    for (size_t i = 0; i < firstSamples.size(); ++i) {
+        EXPECT_EQ(firstSamples[i], static_cast<float>(i * config.hopSize));
+        EXPECT_EQ(hopIndices[i], i);
+    }
+}
+
+TEST(AnalysisWorkerTest, ReportsHopsDroppedByTheRing) {
+    MirroredRingBuffer<float> buffer(2048);
+    const size_t capacity = buffer.capacity();
+    AnalysisConfig config;
+    config.windowSize = 512;
+    config.hopSize = 128;
+
+    std::atomic<bool> release{false};
+    std::atomic<int> discontinuities{0};
+    AnalysisWorker worker(buffer, config, [&](const AnalysisFrame& frame) {
+        if (frame.discontinuity) discontinuities.fetch_add(1);
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    worker.start();
+
+    // Fill a window, then keep writing while the callback is stuck: with
+    // drop-newest the ring rejects whatever no longer fits
+    std::vector<float> samples(capacity + 4 * config.hopSize, 1.0f);
+    worker.notifySamplesWritten(buffer.write(samples.data(), config.windowSize));
+    ASSERT_TRUE(eventually([&] { return buffer.available() == config.windowSize; }));
+    size_t written = buffer.write(samples.data() + config.windowSize,
+                                  samples.size() - config.windowSize);
+    worker.notifySamplesWritten(written);
+    const uint64_t dropped = buffer.overflowCount();
+    ASSERT_GT(dropped, 0u);
+
+    release = true;
+    ASSERT_TRUE(eventually([&] { return worker.missedHops() > 0; }));
+    worker.stop();
+
+    EXPECT_EQ(worker.missedHops(), (dropped + config.hopSize - 1) / config.hopSize);
+    EXPECT_EQ(discontinuities.load(), 1);
+}
+
+TEST(AnalysisWorkerTest, RejectsInvalidConfiguration) {
+    MirroredRingBuffer<float> buffer(1024);
+    auto callback = [](const AnalysisFrame&) {};
+
+    AnalysisConfig zeroHop;
+    zeroHop.hopSize = 0;
+    EXPECT_THROW(AnalysisWorker(buffer, zeroHop, callback), std::invalid_argument);
+
+    AnalysisConfig tooLarge;
+    tooLarge.windowSize = buffer.capacity();
+    EXPECT_THROW(AnalysisWorker(buffer, tooLarge, callback), std::invalid_argument);
+
+    EXPECT_THROW(AnalysisWorker(buffer, AnalysisConfig{}, nullptr), std::invalid_argument);
+}
+
+TEST(AnalysisWorkerTest, StopIsIdempotentAndRestartable) {
+    MirroredRingBuffer<float> buffer(4096);
+    std::atomic<uint64_t> calls{0};
+    AnalysisWorker worker(buffer, AnalysisConfig{}, [&](const AnalysisFrame&) { ++calls; });
+
+    worker.stop();
+    worker.start();
+    EXPECT_TRUE(worker.isRunning());
+    worker.stop();
+    worker.stop();
+    EXPECT_FALSE(worker.isRunning());
+
+    std::vector<float> samples(AnalysisConfig{}.windowSize, 0.5f);
+    worker.start();
+    worker.notifySamplesWritten(buffer.write(samples.data(), samples.size()));
+    EXPECT_TRUE(eventually([&] { return calls.load() == 1; }));
+    worker.stop();
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "audio/AudioCapture.hpp"
+#include "audio/CaptureDiagnostics.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using ptm::AudioCapture;
+using ptm::CaptureDiagnostics;
+using ptm::CaptureEvent;
+using ptm::CaptureEventKind;
+
+TEST(CaptureDiagnosticsTest, CountsEventsLostToFullQueue) {
+    CaptureDiagnostics diagnostics(16);
+    CaptureEvent event{CaptureEventKind::InputOverflow, 1, 0.0, 0.0, 0.0};
+
+    size_t accepted = 0;
+    for (int i = 0; i < 40; ++i) {
+        accepted += diagnostics.post(event) ? 1 : 0;
+    }
+
+    EXPECT_EQ(accepted, 16u);
+    EXPECT_EQ(diagnostics.droppedEvents(), 24u);
+    EXPECT_EQ(diagnostics.drain(), 16u);
+    EXPECT_TRUE(diagnostics.post(event));
+}
+
+TEST(CaptureDiagnosticsTest, RateLimitsEachKindIndependently) {
+    CaptureDiagnostics diagnostics(64, 5);
+
+    for (int i = 0; i < 12; ++i) {
+        diagnostics.post({CaptureEventKind::SlowCallback, 0, 0.002, 0.0, 0.0});
+    }
+    for (int i = 0; i < 3; ++i) {
+        diagnostics.post({CaptureEventKind::HighLatency, 0, 0.030, 0.0, 0.0});
+    }
+
+    EXPECT_EQ(diagnostics.drain(), 15u);
+    EXPECT_EQ(diagnostics.suppressedEvents(), 7u);
+}
+
+TEST(CaptureDiagnosticsTest, StopDrainsPendingEvents) {
+    CaptureDiagnostics diagnostics;
+    diagnostics.start(std::chrono::milliseconds(1000));
+    diagnostics.post({CaptureEventKind::NullInput, 0, 0.0, 1.5, 1.6});
+    diagnostics.stop();
+    EXPECT_EQ(diagnostics.drain(), 0u);
+}
+
+TEST(CaptureDiagnosticsTest, HandlerSeesRateLimitedEventsToo) {
+    CaptureDiagnostics diagnostics(64, 2);
+    int nullInputs = 0;
+    diagnostics.setEventHandler([&](const CaptureEvent& event) {
+        if (event.kind == CaptureEventKind::NullInput) ++nullInputs;
+    });
+
+    for (int i = 0; i < 5; ++i) {
+        diagnostics.post({CaptureEventKind::NullInput, 0, 0.0, 0.0, 0.0});
+    }
+    EXPECT_EQ(diagnostics.drain(), 5u);
+    EXPECT_EQ(diagnostics.suppressedEvents(), 3u);
+    EXPECT_EQ(nullInputs, 5);
+}
+
+namespace {
+    // Delivers one block without input from its own thread, as a device
+    // whose driver fails would
+    class NullInputSource final : public ptm::AudioSource {
+    public:
+        ~NullInputSource() override { stop(); }
+
+        double sampleRate() const override { return 48000.0; }
+        void start(ptm::AudioSink& sink) override {
+            active_ = true;
+            thread_ = std::thread([this, &sink] {
+                sink.processBlock(nullptr, 256, ptm::AudioBlockInfo{});
+                active_ = false;
+            });
+        }
+        void stop() override {
+            if (thread_.joinable()) thread_.join();
+        }
+        bool isActive() const override { return active_; }
+        std::string describe() const override { return "null input"; }
+
+    private:
+        std::atomic<bool> active_{false};
+        std::thread thread_;
+    };
+}
+
+TEST(CaptureDiagnosticsTest, NullInputPutsTheStreamInErrorPromptly) {
+    AudioCapture capture;
+    capture.start(std::make_unique<NullInputSource>());
+
+    // The state change is notified, so this does not wait out its timeout
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(capture.waitForState(AudioCapture::StreamState::Error, std::chrono::seconds(5)));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    EXPECT_EQ(capture.getLastError(), "Null input buffer in audio callback");
+    EXPECT_FALSE(capture.isStreamHealthy());
+    capture.stop();
+}
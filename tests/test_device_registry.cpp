@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "audio/DeviceRegistry.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using ptm::AudioDevice;
+using ptm::DeviceRegistry;
+
+namespace {
+    AudioDevice makeDevice(PaDeviceIndex index, const std::string& name) {
+        AudioDevice device{};
+        device.index = index;
+        device.name = name;
+        device.hostApi = "Test";
+        device.defaultSampleRate = 48000.0;
+        device.maxInputChannels = 2;
+        device.defaultLatency = 0.005;
+        device.minLatency = 0.005;
+        device.isDefaultInput = (index == 0);
+        return device;
+    }
+
+    // A fake backend whose device list the test can change
+    struct FakeBackend {
+        std::mutex mutex;
+        std::vector<AudioDevice> devices;
+        std::atomic<int> scans{0};
+        std::atomic<int> probes{0};
+
+        DeviceRegistry::Scanner scanner() {
+            return [this] {
+                ++scans;
+                std::lock_guard<std::mutex> lock(mutex);
+                return devices;
+            };
+        }
+
+        // Every device supports 44.1 and 48 kHz only
+        DeviceRegistry::RateProbe probe() {
+            return [this](const AudioDevice&, double rate) {
+                ++probes;
+                return rate == 44100.0 || rate == 48000.0;
+            };
+        }
+
+        void set(std::vector<AudioDevice> newDevices) {
+            std::lock_guard<std::mutex> lock(mutex);
+            devices = std::move(newDevices);
+        }
+    };
+}
+
+TEST(DeviceRegistryTest, ScansOnceAndProbesLazily) {
+    FakeBackend backend;
+    backend.set({makeDevice(0, "Mic"), makeDevice(1, "Interface")});
+    DeviceRegistry registry(backend.scanner(), backend.probe());
+
+    auto devices = registry.devices();
+    ASSERT_EQ(devices.size(), 2u);
+    EXPECT_EQ(devices[0].id, "Test: Mic");
+    EXPECT_TRUE(devices[0].sampleRates.empty());
+    registry.devices();
+    EXPECT_EQ(backend.scans.load(), 1);
+    EXPECT_EQ(backend.probes.load(), 0);
+
+    // One rate of one device
+    EXPECT_TRUE(registry.supportsSampleRate(devices[1], 48000.0));
+    EXPECT_EQ(backend.probes.load(), 1);
+
+    // The rest of that device's rates, then everything from the cache
+    std::set<double> rates = registry.supportedSampleRates(devices[1]);
+    EXPECT_EQ(rates, (std::set<double>{44100.0, 48000.0}));
+    EXPECT_EQ(backend.probes.load(), static_cast<int>(DeviceRegistry::kCommonSampleRates.size()));
+    registry.supportedSampleRates(devices[1]);
+    EXPECT_FALSE(registry.supportsSampleRate(devices[1], 96000.0));
+    EXPECT_EQ(registry.probeCount(), DeviceRegistry::kCommonSampleRates.size());
+}
+
+TEST(DeviceRegistryTest, CacheFollowsIdentityNotIndex) {
+    FakeBackend backend;
+    backend.set({makeDevice(0, "Mic"), makeDevice(1, "Interface")});
+    DeviceRegistry registry(backend.scanner(), backend.probe());
+
+    registry.supportedSampleRates(*registry.find(1));
+    const int probes = backend.probes.load();
+
+    // A device appears in front and the interface moves to index 2
+    backend.set({makeDevice(0, "Mic"), makeDevice(1, "Headset"), makeDevice(2, "Interface")});
+    EXPECT_TRUE(registry.refresh());
+    EXPECT_FALSE(registry.refresh());
+
+    auto moved = registry.find(2);
+    ASSERT_TRUE(moved.has_value());
+    EXPECT_EQ(moved->name, "Interface");
+    registry.supportedSampleRates(*moved);
+    EXPECT_EQ(backend.probes.load(), probes);
+}
+
+TEST(DeviceRegistryTest, IdenticalDevicesGetDistinctIds) {
+    FakeBackend backend;
+    backend.set({makeDevice(0, "USB Mic"), makeDevice(1, "USB Mic")});
+    DeviceRegistry registry(backend.scanner(), backend.probe());
+
+    auto devices = registry.devices();
+    ASSERT_EQ(devices.size(), 2u);
+    EXPECT_EQ(devices[0].id, "Test: USB Mic");
+    EXPECT_EQ(devices[1].id, "Test: USB Mic #2");
+}
+
+TEST(DeviceRegistryTest, MonitorReportsOnlyChanges) {
+    FakeBackend backend;
+    backend.set({makeDevice(0, "Mic")});
+    DeviceRegistry registry(backend.scanner(), backend.probe());
+    registry.devices();
+
+    std::mutex mutex;
+    std::vector<std::vector<AudioDevice>> reports;
+    registry.startMonitoring([&](const std::vector<AudioDevice>& devices) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reports.push_back(devices);
+    }, std::chrono::milliseconds(5));
+    EXPECT_TRUE(registry.isMonitoring());
+
+    auto reportCount = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return reports.size();
+    };
+    auto waitForScans = [&](int count) {
+        const int target = backend.scans.load() + count;
+        while (backend.scans.load() < target) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    waitForScans(3);
+    EXPECT_EQ(reportCount(), 0u);
+
+    backend.set({makeDevice(0, "Mic"), makeDevice(1, "Interface")});
+    waitForScans(3);
+    ASSERT_EQ(reportCount(), 1u);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(reports[0].size(), 2u);
+        EXPECT_EQ(reports[0][1].name, "Interface");
+    }
+
+    // Stopping is prompt even with a long interval
+    registry.stopMonitoring();
+    EXPECT_FALSE(registry.isMonitoring());
+    registry.startMonitoring(nullptr, std::chrono::hours(1));
+    auto start = std::chrono::steady_clock::now();
+    registry.stopMonitoring();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    EXPECT_EQ(backend.probes.load(), 0);
+}
+
+TEST(DeviceRegistryTest, MonitorReportsDevicesPluggedInAndOut) {
+    FakeBackend backend;
+    backend.set({makeDevice(0, "Mic")});
+    DeviceRegistry registry(backend.scanner(), backend.probe());
+    registry.devices();
+
+    std::mutex mutex;
+    std::vector<std::vector<AudioDevice>> reports;
+    registry.startMonitoring([&](const std::vector<AudioDevice>& devices) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reports.push_back(devices);
+    }, std::chrono::milliseconds(5));
+
+    auto waitForReports = [&](size_t count) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (reports.size() >= count) return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    };
+
+    // A USB interface is plugged in, then the built-in mic goes away and
+    // the interface is renumbered
+    backend.set({makeDevice(0, "Mic"), makeDevice(1, "USB Interface")});
+    ASSERT_TRUE(waitForReports(1));
+    backend.set({makeDevice(0, "USB Interface")});
+    ASSERT_TRUE(waitForReports(2));
+    registry.stopMonitoring();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(reports.size(), 2u);
+    ASSERT_EQ(reports[0].size(), 2u);
+    EXPECT_EQ(reports[0][1].id, "Test: USB Interface");
+    ASSERT_EQ(reports[1].size(), 1u);
+    EXPECT_EQ(reports[1][0].id, "Test: USB Interface");
+    EXPECT_EQ(reports[1][0].index, 0);
+    EXPECT_EQ(registry.find("Test: Mic"), std::nullopt);
+    EXPECT_EQ(registry.find("Test: USB Interface")->index, 0);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "audio/AudioCapture.hpp"
+#include "audio/ReplaySource.hpp"
+#include "utils/RealtimeSanitizer.hpp"
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using ptm::AudioCapture;
+using ptm::AudioCaptureException;
+using ptm::DeviceSwitchStats;
+using ptm::ReplayConfig;
+using ptm::SyntheticSource;
+
+namespace {
+    constexpr double kSampleRate = 48000.0;
+    constexpr size_t kFrames = 256;
+
+    // An endless real-time source whose every sample is value
+    std::unique_ptr<SyntheticSource> constantSource(float value, double sampleRate = kSampleRate) {
+        ReplayConfig config;
+        config.framesPerBuffer = kFrames;
+        return std::make_unique<SyntheticSource>(sampleRate, [value](uint64_t, float* out, size_t frames) {
+            std::fill(out, out + frames, value);
+        }, config);
+    }
+
+    // The first sample of each block that reached the capture callback
+    struct BlockLog {
+        std::mutex mutex;
+        std::vector<float> values;
+
+        // Locks and allocates on the audio thread, which a test may
+        void operator()(const float* samples, unsigned long) {
+            ptm::RealtimeExemption exemption;
+            std::lock_guard<std::mutex> lock(mutex);
+            values.push_back(samples[0]);
+        }
+
+        size_t count(float value) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return static_cast<size_t>(std::count(values.begin(), values.end(), value));
+        }
+    };
+}
+
+TEST(DeviceSwitchTest, HandsOverAtABlockBoundaryWithoutStopping) {
+    AudioCapture capture;
+    BlockLog log;
+    capture.start(constantSource(0.25f), log);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    capture.switchSource(constantSource(0.75f));
+    EXPECT_EQ(capture.getState(), AudioCapture::StreamState::Running);
+    EXPECT_TRUE(capture.isActive());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    capture.stop();
+    EXPECT_TRUE(capture.waitForState(AudioCapture::StreamState::Closed, std::chrono::milliseconds(0)));
+
+    // Every block came from one source or the other, old before new
+    std::vector<float> values = log.values;
+    ASSERT_GT(log.count(0.25f), 0u);
+    ASSERT_GT(log.count(0.75f), 0u);
+    EXPECT_EQ(log.count(0.25f) + log.count(0.75f), values.size());
+    auto firstNew = std::find(values.begin(), values.end(), 0.75f);
+    EXPECT_EQ(std::find(firstNew, values.end(), 0.25f), values.end());
+
+    // Both sources are paced to the steady clock, so the gap is about a
+    // block at most; a loaded machine gets some slack
+    DeviceSwitchStats stats = capture.getSwitchStats();
+    EXPECT_EQ(stats.switches, 1u);
+    EXPECT_LT(stats.lastLostFrames, 4 * kFrames);
+    EXPECT_EQ(stats.totalLostFrames, stats.lastLostFrames);
+    EXPECT_GT(stats.lastOverlapFrames, 0u);
+    EXPECT_GT(stats.lastSwitchMs, 0.0);
+    EXPECT_LT(stats.lastSwitchMs, static_cast<double>(AudioCapture::kSwitchTimeout.count()));
+}
+
+TEST(DeviceSwitchTest, TakesOverFromASourceThatStoppedDelivering) {
+    AudioCapture capture;
+    BlockLog log;
+
+    // 20 ms of audio, then nothing: as if the device had been unplugged
+    ReplayConfig config;
+    config.framesPerBuffer = kFrames;
+    capture.start(std::make_unique<SyntheticSource>(kSampleRate, std::vector<float>(960, 0.25f), config),
+                  log);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_FALSE(capture.isActive());
+
+    capture.switchSource(constantSource(0.75f));
+    EXPECT_TRUE(capture.isActive());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    capture.stop();
+
+    EXPECT_GT(log.count(0.75f), 0u);
+    DeviceSwitchStats stats = capture.getSwitchStats();
+    EXPECT_EQ(stats.switches, 1u);
+    EXPECT_GT(stats.lastLostFrames, 0u);  // The time the old source was silent
+}
+
+TEST(DeviceSwitchTest, RejectsSwitchesThatCannotWork) {
+    AudioCapture capture;
+    EXPECT_THROW(capture.switchSource(constantSource(0.5f)), AudioCaptureException);
+
+    capture.start(constantSource(0.25f));
+    EXPECT_THROW(capture.switchSource(constantSource(0.5f, 44100.0)), AudioCaptureException);
+    EXPECT_THROW(capture.switchSource(nullptr), AudioCaptureException);
+
+    // The stream carries on untouched
+    EXPECT_EQ(capture.getState(), AudioCapture::StreamState::Running);
+    EXPECT_TRUE(capture.isActive());
+    EXPECT_EQ(capture.getSwitchStats().switches, 0u);
+    capture.stop();
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "dsp/DifferenceFunction.hpp"
+#include "dsp/PitchDetector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using ptm::DifferenceFunction;
+
+namespace {
+    // Harmonic tone with vibrato and a little noise
+    std::vector<float> makeSignal(size_t count, double sampleRate) {
+        const double pi = std::acos(-1.0);
+        std::mt19937 rng(21);
+        std::normal_distribution<float> noise(0.0f, 0.01f);
+        std::vector<float> samples(count);
+        double phase = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double t = static_cast<double>(i) / sampleRate;
+            phase += 2.0 * pi * 196.0 * (1.0 + 0.02 * std::sin(2.0 * pi * 6.0 * t)) / sampleRate;
+            samples[i] = static_cast<float>(0.6 * std::sin(phase) + 0.3 * std::sin(2.0 * phase)) +
+                         noise(rng);
+        }
+        return samples;
+    }
+
+    float maxAbsoluteError(const std::vector<float>& actual, const std::vector<float>& expected) {
+        float error = 0.0f;
+        for (size_t i = 0; i < actual.size(); ++i) {
+            error = std::max(error, std::fabs(actual[i] - expected[i]));
+        }
+        return error;
+    }
+}
+
+TEST(DifferenceFunctionTest, IncrementalTracksExactAcrossManyHops) {
+    const size_t windowSize = 1024;
+    const size_t hop = 64;
+    auto signal = makeSignal(windowSize + hop * 400, 44100.0);
+
+    DifferenceFunction exact(windowSize);
+    DifferenceFunction incremental(windowSize, hop, 1000);
+    ASSERT_TRUE(incremental.isIncremental());
+
+    for (size_t offset = 0; offset + windowSize <= signal.size(); offset += hop) {
+        exact.compute(signal.data() + offset);
+        incremental.compute(signal.data() + offset);
+
+        const auto& expected = exact.values();
+        float scale = *std::max_element(expected.begin(), expected.end());
+        ASSERT_LT(maxAbsoluteError(incremental.values(), expected), 1e-4f * scale)
+            << "offset " << offset;
+        ASSERT_NEAR(incremental.energy(), exact.energy(), 1e-4 * exact.energy());
+    }
+    EXPECT_EQ(incremental.exactComputations(), 1u);
+}
+
+TEST(DifferenceFunctionTest, ResyncsAtTheConfiguredInterval) {
+    const size_t windowSize = 256;
+    const size_t hop = 16;
+    auto signal = makeSignal(windowSize + hop * 20, 44100.0);
+
+    DifferenceFunction difference(windowSize, hop, 8);
+    for (size_t i = 0; i < 20; ++i) {
+        difference.compute(signal.data() + i * hop);
+    }
+    // First call, then after every 8 incremental hops: calls 1, 10 and 19
+    EXPECT_EQ(difference.exactComputations(), 3u);
+}
+
+TEST(DifferenceFunctionTest, ResetForcesExactComputation) {
+    const size_t windowSize = 256;
+    auto signal = makeSignal(windowSize * 4, 44100.0);
+
+    DifferenceFunction difference(windowSize, 32);
+    DifferenceFunction exact(windowSize);
+    difference.compute(signal.data());
+    difference.compute(signal.data() + 32);
+    EXPECT_EQ(difference.exactComputations(), 1u);
+
+    // A jump that is not one hop, announced with reset()
+    difference.reset();
+    difference.compute(signal.data() + 500);
+    exact.compute(signal.data() + 500);
+    EXPECT_EQ(difference.exactComputations(), 2u);
+    EXPECT_EQ(difference.values(), exact.values());
+}
+
+TEST(DifferenceFunctionTest, LargeHopsRunExact) {
+    DifferenceFunction difference(1024, 512);
+    EXPECT_FALSE(difference.isIncremental());
+    EXPECT_EQ(difference.hopSize(), 0u);
+    EXPECT_THROW(DifferenceFunction(2), std::invalid_argument);
+}
+
+TEST(DifferenceFunctionTest, IncrementalPitchDetectorMatchesExact) {
+    const double sampleRate = 48000.0;
+    const size_t hop = 128;
+    auto signal = makeSignal(2048 + hop * 100, sampleRate);
+
+    ptm::PitchDetectorConfig config;
+    config.sampleRate = sampleRate;
+    config.windowSize = 2048;
+    ptm::PitchDetector exact(config);
+    config.hopSize = hop;
+    ptm::PitchDetector incremental(config);
+
+    for (size_t offset = 0; offset + config.windowSize <= signal.size(); offset += hop) {
+        auto expected = exact.process(signal.data() + offset);
+        auto actual = incremental.process(signal.data() + offset);
+        ASSERT_EQ(actual.voiced, expected.voiced) << "offset " << offset;
+        ASSERT_NEAR(actual.frequency, expected.frequency, 0.01f) << "offset " << offset;
+    }
+}
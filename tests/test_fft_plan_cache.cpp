@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "dsp/FftPlanCache.hpp"
+#include "dsp/PitchDetectorSet.hpp"
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using ptm::DifferenceFunction;
+using ptm::FftPlanCache;
+using ptm::PitchDetector;
+using ptm::PitchDetectorConfig;
+using ptm::PitchDetectorException;
+using ptm::PitchDetectorSet;
+using ptm::RealFft;
+
+namespace {
+    std::vector<float> makeTone(double frequency, size_t count) {
+        const double pi = std::acos(-1.0);
+        std::vector<float> samples(count);
+        for (size_t i = 0; i < count; ++i) {
+            samples[i] = static_cast<float>(0.5 * std::sin(2.0 * pi * frequency * i / 44100.0));
+        }
+        return samples;
+    }
+}
+
+TEST(FftPlanCacheTest, BuildsEverySizeInTheBackground) {
+    FftPlanCache cache({1024, 256, 1024, 4096});
+    EXPECT_EQ(cache.sizes(), (std::vector<size_t>{1024, 256, 4096}));
+    EXPECT_EQ(cache.find(1024), nullptr);
+
+    cache.start();
+    cache.waitUntilReady();
+    ASSERT_TRUE(cache.isReady());
+    EXPECT_TRUE(cache.error().empty());
+
+    for (size_t size : cache.sizes()) {
+        RealFft* fft = cache.find(size);
+        ASSERT_NE(fft, nullptr);
+        EXPECT_EQ(fft->size(), size);
+        EXPECT_EQ(cache.find(size), fft);
+    }
+    EXPECT_EQ(cache.find(512), nullptr);
+
+    EXPECT_THROW(FftPlanCache({1000}), std::invalid_argument);
+}
+
+TEST(FftPlanCacheTest, WritesWisdomOnlyWithFftw) {
+    const std::string path = ::testing::TempDir() + "ptm_fft_wisdom";
+    std::remove(path.c_str());
+
+    FftPlanCache first({512}, path);
+    first.build();
+    FftPlanCache second({512}, path);
+    second.build();
+#ifdef USE_FFTW
+    EXPECT_TRUE(second.wisdomImported());
+#else
+    EXPECT_FALSE(second.wisdomImported());
+#endif
+    EXPECT_NE(second.find(512), nullptr);
+    std::remove(path.c_str());
+}
+
+TEST(FftPlanCacheTest, BorrowedTransformGivesTheSameDifference) {
+    FftPlanCache cache({DifferenceFunction::fftSizeFor(768)});
+    cache.build();
+    auto signal = makeTone(220.0, 768);
+
+    DifferenceFunction owned(768);
+    DifferenceFunction borrowed(768, *cache.find(1024));
+    owned.compute(signal.data());
+    borrowed.compute(signal.data());
+    EXPECT_EQ(borrowed.values(), owned.values());
+
+    EXPECT_THROW(DifferenceFunction(512, *cache.find(1024)), std::invalid_argument);
+}
+
+TEST(PitchDetectorSetTest, SwitchesWindowSizeWithoutRebuilding) {
+    const auto windows = PitchDetectorSet::defaultWindowSizes();
+    ASSERT_EQ(windows.size(), 16u);
+    EXPECT_EQ(PitchDetectorSet::fftSizesFor(windows),
+              (std::vector<size_t>{4096, 2048, 1024, 512, 256}));
+
+    FftPlanCache cache(PitchDetectorSet::fftSizesFor(windows));
+    cache.start();
+    PitchDetectorConfig config;
+    PitchDetectorSet detectors(config, windows, cache);
+    EXPECT_EQ(detectors.current().config().windowSize, 1024u);
+
+    auto signal = makeTone(440.0, 4096);
+    for (size_t window : {1536u, 4096u, 1024u}) {
+        PitchDetector* detector = detectors.select(window);
+        ASSERT_NE(detector, nullptr);
+        EXPECT_EQ(&detectors.current(), detector);
+        EXPECT_EQ(detector->config().windowSize, window);
+
+        config.windowSize = window;
+        PitchDetector standalone(config);
+        EXPECT_FLOAT_EQ(detector->process(signal.data()).frequency,
+                        standalone.process(signal.data()).frequency);
+    }
+
+    // Unknown sizes leave the current detector in place
+    EXPECT_EQ(detectors.select(1000), nullptr);
+    EXPECT_EQ(detectors.current().config().windowSize, 1024u);
+}
+
+TEST(PitchDetectorSetTest, NeedsEveryTransformInTheCache) {
+    FftPlanCache cache({1024});
+    cache.build();
+    EXPECT_THROW(PitchDetectorSet(PitchDetectorConfig{}, {1024, 2048}, cache),
+                 PitchDetectorException);
+}
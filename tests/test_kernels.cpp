@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "dsp/Kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using ptm::InstructionSet;
+using ptm::KernelTable;
+
+namespace {
+    const size_t kSizes[] = {0, 1, 3, 7, 8, 15, 16, 17, 31, 33, 64, 255, 1000, 2048, 4097};
+
+    std::vector<float> randomSignal(size_t count, unsigned seed, float low = -1.0f) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(low, 1.0f);
+        std::vector<float> values(count);
+        for (auto& value : values) value = dist(rng);
+        return values;
+    }
+
+    // Vector variants reassociate the sums; allow rounding proportional to n
+    void expectClose(float actual, float expected, size_t n, const char* what) {
+        float tolerance = 1e-6f * static_cast<float>(n + 1) * std::max(1.0f, std::fabs(expected));
+        EXPECT_NEAR(actual, expected, tolerance) << what << " n=" << n;
+    }
+
+    class KernelTest : public ::testing::TestWithParam<InstructionSet> {
+    protected:
+        void SetUp() override {
+            variant_ = ptm::kernelsFor(GetParam());
+            if (!variant_) {
+                GTEST_SKIP() << ptm::toString(GetParam()) << " not available on this machine";
+            }
+            scalar_ = ptm::kernelsFor(InstructionSet::Scalar);
+        }
+
+        const KernelTable* variant_ = nullptr;
+        const KernelTable* scalar_ = nullptr;
+    };
+}
+
+TEST(KernelDispatchTest, SelectedTableMatchesDetectedInstructionSet) {
+    EXPECT_EQ(ptm::kernels().isa, ptm::detectInstructionSet());
+    ASSERT_NE(ptm::kernelsFor(InstructionSet::Scalar), nullptr);
+    EXPECT_EQ(ptm::kernelsFor(ptm::detectInstructionSet())->isa, ptm::detectInstructionSet());
+}
+
+TEST_P(KernelTest, ReductionsMatchScalar) {
+    // Offset by one so the vector loads are unaligned
+    auto a = randomSignal(4097 + 1, 1);
+    auto b = randomSignal(4097 + 1, 2);
+    for (size_t n : kSizes) {
+        const float* x = a.data() + 1;
+        const float* y = b.data() + 1;
+        expectClose(variant_->sumOfSquares(x, n), scalar_->sumOfSquares(x, n), n, "sumOfSquares");
+        expectClose(variant_->dot(x, y, n), scalar_->dot(x, y, n), n, "dot");
+        expectClose(variant_->squaredDifference(x, y, n), scalar_->squaredDifference(x, y, n),
+                    n, "squaredDifference");
+        EXPECT_EQ(variant_->peak(x, n), scalar_->peak(x, n)) << "peak n=" << n;
+    }
+}
+
+TEST_P(KernelTest, AccumulateSquaredDifferenceMatchesScalar) {
+    auto x = randomSignal(4097 + 1, 4);
+    auto initial = randomSignal(4097, 5, 0.0f);
+    for (size_t n : kSizes) {
+        std::vector<float> expected(initial.begin(), initial.begin() + n);
+        std::vector<float> actual = expected;
+        scalar_->accumulateSquaredDifference(0.3f, x.data() + 1, expected.data(), n);
+        variant_->accumulateSquaredDifference(0.3f, x.data() + 1, actual.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_NEAR(actual[i], expected[i], 1e-6f) << "n=" << n << " i=" << i;
+        }
+    }
+}
+
+TEST_P(KernelTest, PeakFindsNegativeExtremeInTail) {
+    std::vector<float> x(37, 0.25f);
+    x[36] = -0.9f;
+    EXPECT_EQ(variant_->peak(x.data(), x.size()), 0.9f);
+    x[36] = 0.1f;
+    x[5] = -0.7f;
+    EXPECT_EQ(variant_->peak(x.data(), x.size()), 0.7f);
+}
+
+TEST_P(KernelTest, CumulativeMeanNormalizeMatchesScalar) {
+    auto d = randomSignal(4097 + 1, 3, 0.0f);
+    std::vector<float> expected(4097);
+    std::vector<float> actual(4097);
+    for (size_t n : kSizes) {
+        scalar_->cumulativeMeanNormalize(d.data() + 1, expected.data(), n);
+        variant_->cumulativeMeanNormalize(d.data() + 1, actual.data(), n);
+        for (size_t t = 0; t < n; ++t) {
+            EXPECT_NEAR(actual[t], expected[t], 1e-4f * std::max(1.0f, expected[t]))
+                << "n=" << n << " t=" << t;
+        }
+    }
+}
+
+TEST_P(KernelTest, CumulativeMeanNormalizeHandlesLeadingZerosInPlace) {
+    std::vector<float> d(40, 0.0f);
+    for (size_t t = 20; t < d.size(); ++t) d[t] = 0.5f;
+    std::vector<float> expected(d.size());
+    scalar_->cumulativeMeanNormalize(d.data(), expected.data(), d.size());
+
+    variant_->cumulativeMeanNormalize(d.data(), d.data(), d.size());
+    for (size_t t = 0; t < d.size(); ++t) {
+        EXPECT_NEAR(d[t], expected[t], 1e-5f) << "t=" << t;
+    }
+    EXPECT_EQ(d[0], 1.0f);
+    EXPECT_EQ(d[19], 1.0f);
+    EXPECT_NEAR(d[20], 20.0f, 1e-4f);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllInstructionSets, KernelTest,
+                         ::testing::Values(InstructionSet::Scalar, InstructionSet::SSE2,
+                                           InstructionSet::AVX2, InstructionSet::AVX512),
+                         [](const ::testing::TestParamInfo<InstructionSet>& info) {
+                             return std::string(ptm::toString(info.param));
+                         });
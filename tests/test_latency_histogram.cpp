@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "utils/LatencyHistogram.hpp"
+#include <thread>
+#include <vector>
+
+using ptm::LatencyHistogram;
+
+TEST(LatencyHistogramTest, BucketsCoverEveryValueWithBoundedError) {
+    EXPECT_EQ(LatencyHistogram::bucketFor(0), 0u);
+    EXPECT_EQ(LatencyHistogram::bucketFor(31), 31u);
+
+    size_t previous = 0;
+    for (uint64_t value = 1; value < (uint64_t{1} << 30); value = value * 5 / 4 + 1) {
+        const size_t bucket = LatencyHistogram::bucketFor(value);
+        EXPECT_GE(bucket, previous);
+        previous = bucket;
+
+        const uint64_t upper = LatencyHistogram::bucketUpperBound(bucket);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(static_cast<double>(upper - value), value / 16.0) << value;
+        if (bucket > 0) {
+            EXPECT_LT(LatencyHistogram::bucketUpperBound(bucket - 1), value);
+        }
+    }
+
+    EXPECT_EQ(LatencyHistogram::bucketFor(UINT64_MAX), LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, ReportsPercentilesAndMax) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), 0);
+
+    // 1..1000 microseconds
+    for (int64_t us = 1; us <= 1000; ++us) {
+        histogram.record(us * 1000);
+    }
+
+    LatencyHistogram::Summary summary = histogram.summary();
+    EXPECT_EQ(summary.count, 1000u);
+    EXPECT_NEAR(summary.meanNs, 500500.0, 1.0);
+    EXPECT_EQ(summary.maxNs, 1000000);
+    EXPECT_GE(summary.p50Ns, 500000);
+    EXPECT_LE(summary.p50Ns, 500000 * 17 / 16);
+    EXPECT_GE(summary.p99Ns, 990000);
+    EXPECT_LE(summary.p99Ns, 1000000);
+    EXPECT_EQ(histogram.percentile(1.0), 1000000);
+
+    histogram.record(-5);
+    EXPECT_EQ(histogram.percentile(0.0), 0);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.max(), 0);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordsAreAllCounted) {
+    LatencyHistogram histogram;
+    const int threads = 4;
+    const int perThread = 50000;
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&, t] {
+            for (int i = 0; i < perThread; ++i) {
+                histogram.record((t + 1) * 1000 + i % 100);
+            }
+        });
+    }
+    // Reading while recording must be safe
+    while (histogram.count() < static_cast<uint64_t>(threads) * perThread / 2) {
+        histogram.summary();
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_EQ(histogram.count(), static_cast<uint64_t>(threads) * perThread);
+    EXPECT_EQ(histogram.max(), threads * 1000 + 99);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "audio/AnalysisWorker.hpp"
+#include "audio/LatencyMonitor.hpp"
+#include "utils/RealtimeSanitizer.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using ptm::LatencyMonitor;
+using ptm::LatencyStage;
+using ptm::LatencyStamp;
+
+namespace {
+    constexpr double kSampleRate = 48000.0;
+    constexpr int64_t kNsPerSample = 20833;  // 1 / 48 kHz, rounded down
+}
+
+TEST(LatencyMonitorTest, MatchesWindowsToTheBufferOfTheirNewestSample) {
+    LatencyMonitor monitor;
+    monitor.beginStream(kSampleRate);
+
+    // Three 256-frame buffers, digitised 1 ms before they were written
+    const int64_t start = LatencyMonitor::now() - 100'000'000;
+    for (int64_t b = 0; b < 3; ++b) {
+        const int64_t adcNs = start + b * 256 * kNsPerSample;
+        monitor.recordBuffer(static_cast<uint64_t>((b + 1) * 256), 256, adcNs,
+                             adcNs + 255 * kNsPerSample + 1'000'000);
+    }
+
+    // Capture is measured from each buffer's newest sample
+    const auto capture = monitor.summary(LatencyStage::Capture);
+    EXPECT_EQ(capture.count, 3u);
+    EXPECT_NEAR(static_cast<double>(capture.maxNs), 1e6, 1e6 / 16);
+
+    // A window ending at 600 has its newest sample 87 frames into buffer 2
+    LatencyStamp stamp = monitor.recordRead(600);
+    ASSERT_TRUE(stamp.valid());
+    EXPECT_NEAR(static_cast<double>(stamp.adcNs),
+                static_cast<double>(start + (512 + 87) * kNsPerSample), 600.0);
+    EXPECT_EQ(stamp.writeNs, start + 2 * 256 * kNsPerSample + 255 * kNsPerSample + 1'000'000);
+    EXPECT_GE(stamp.readNs, stamp.writeNs);
+
+    // Later windows in the same buffer still match; past the last one, not
+    EXPECT_TRUE(monitor.recordRead(768).valid());
+    EXPECT_FALSE(monitor.recordRead(1024).valid());
+    EXPECT_EQ(monitor.summary(LatencyStage::Queue).count, 2u);
+
+    monitor.recordDetection(stamp);
+    EXPECT_GE(stamp.detectNs, stamp.readNs);
+    monitor.recordSend(stamp);
+
+    for (LatencyStage stage : {LatencyStage::Detection, LatencyStage::Output, LatencyStage::Total}) {
+        EXPECT_EQ(monitor.summary(stage).count, 1u) << ptm::toString(stage);
+    }
+    EXPECT_GE(monitor.summary(LatencyStage::Total).maxNs, 100'000'000 - 600 * kNsPerSample);
+
+    const std::string report = monitor.report();
+    EXPECT_NE(report.find("capture"), std::string::npos);
+    EXPECT_NE(report.find("over the 20 ms budget"), std::string::npos);
+
+    monitor.reset();
+    EXPECT_TRUE(monitor.report().empty());
+}
+
+TEST(LatencyMonitorTest, InvalidStampsAreNotRecorded) {
+    LatencyMonitor monitor;
+    monitor.beginStream(kSampleRate);
+
+    LatencyStamp stamp = monitor.recordRead(256);
+    EXPECT_FALSE(stamp.valid());
+    monitor.recordDetection(stamp);
+    monitor.recordSend(stamp);
+
+    for (size_t i = 0; i < ptm::kLatencyStageCount; ++i) {
+        EXPECT_EQ(monitor.histogram(static_cast<LatencyStage>(i)).count(), 0u);
+    }
+}
+
+TEST(LatencyMonitorTest, AnalysisWorkerStampsEachFrame) {
+    ptm::MirroredRingBuffer<float> buffer(8192);
+    LatencyMonitor monitor;
+    monitor.beginStream(kSampleRate);
+
+    ptm::AnalysisConfig config;
+    config.windowSize = 256;
+    config.hopSize = 128;
+
+    std::mutex mutex;
+    std::vector<LatencyStamp> stamps;
+    ptm::AnalysisWorker worker(buffer, config, [&](const ptm::AnalysisFrame& frame) {
+        LatencyStamp stamp = frame.latency;
+        monitor.recordDetection(stamp);
+        monitor.recordSend(stamp);
+        ptm::RealtimeExemption exemption;  // Test bookkeeping
+        std::lock_guard<std::mutex> lock(mutex);
+        stamps.push_back(stamp);
+    }, &monitor);
+    worker.start();
+
+    // The capture callback's order: write, stamp, then wake the worker
+    std::vector<float> block(128, 0.0f);
+    for (int b = 0; b < 20; ++b) {
+        const int64_t adcNs = LatencyMonitor::now() - 128 * kNsPerSample;
+        const size_t written = buffer.write(block.data(), block.size());
+        monitor.recordBuffer(buffer.writePosition(), written, adcNs, LatencyMonitor::now());
+        worker.notifySamplesWritten(written);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (worker.processedHops() < 19 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    worker.stop();
+
+    ASSERT_EQ(stamps.size(), 19u);
+    for (const LatencyStamp& stamp : stamps) {
+        ASSERT_TRUE(stamp.valid());
+        EXPECT_LE(stamp.adcNs, stamp.writeNs);
+        EXPECT_LE(stamp.writeNs, stamp.readNs);
+        EXPECT_LE(stamp.readNs, stamp.detectNs);
+    }
+    EXPECT_EQ(monitor.summary(LatencyStage::Total).count, 19u);
+}
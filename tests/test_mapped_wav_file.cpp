@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "audio/MappedWavFile.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using ptm::MappedWavFile;
+using ptm::WavFileException;
+using ptm::WavSampleFormat;
+
+namespace {
+    void put16(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void put32(std::vector<uint8_t>& out, uint32_t value) {
+        put16(out, value & 0xFFFF);
+        put16(out, value >> 16);
+    }
+
+    void putTag(std::vector<uint8_t>& out, const char* tag) {
+        out.insert(out.end(), tag, tag + 4);
+    }
+
+    // Canonical RIFF/WAVE with a junk chunk before fmt, and a data size
+    // that can be overstated to mimic an interrupted recording
+    std::vector<uint8_t> makeWav(uint16_t formatTag, uint16_t channels, uint32_t sampleRate,
+                                 uint16_t bits, const std::vector<uint8_t>& payload,
+                                 uint32_t claimedDataSize = 0) {
+        std::vector<uint8_t> out;
+        putTag(out, "RIFF");
+        put32(out, 0);
+        putTag(out, "WAVE");
+        putTag(out, "JUNK");
+        put32(out, 3);
+        out.insert(out.end(), {0, 0, 0, 0});  // Three bytes plus padding
+        putTag(out, "fmt ");
+        put32(out, 16);
+        put16(out, formatTag);
+        put16(out, channels);
+        put32(out, sampleRate);
+        put32(out, sampleRate * channels * bits / 8);
+        put16(out, static_cast<uint16_t>(channels * bits / 8));
+        put16(out, bits);
+        putTag(out, "data");
+        put32(out, claimedDataSize ? claimedDataSize : static_cast<uint32_t>(payload.size()));
+        out.insert(out.end(), payload.begin(), payload.end());
+        uint32_t riffSize = static_cast<uint32_t>(out.size() - 8);
+        for (int i = 0; i < 4; ++i) out[4 + i] = static_cast<uint8_t>(riffSize >> (8 * i));
+        return out;
+    }
+
+    class TempFile {
+    public:
+        explicit TempFile(const std::vector<uint8_t>& bytes, const std::string& suffix = "") {
+            const auto* info = testing::UnitTest::GetInstance()->current_test_info();
+            path_ = (std::filesystem::temp_directory_path() /
+                     (std::string("ptm_") + info->name() + suffix + ".wav")).string();
+            std::ofstream file(path_, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(bytes.data()),
+                       static_cast<std::streamsize>(bytes.size()));
+        }
+        ~TempFile() { std::remove(path_.c_str()); }
+        const std::string& path() const { return path_; }
+
+    private:
+        std::string path_;
+    };
+}
+
+TEST(MappedWavFileTest, Decodes16BitStereoAsMono) {
+    std::vector<uint8_t> payload;
+    const int16_t samples[] = {16384, 0, -32768, -32768, 32767, -32767};
+    for (int16_t s : samples) put16(payload, static_cast<uint16_t>(s));
+    TempFile file(makeWav(1, 2, 48000, 16, payload));
+
+    MappedWavFile wav(file.path());
+    EXPECT_EQ(wav.sampleRate(), 48000.0);
+    EXPECT_EQ(wav.channels(), 2u);
+    EXPECT_EQ(wav.sampleFormat(), WavSampleFormat::Int16);
+    ASSERT_EQ(wav.frames(), 3u);
+
+    float out[3];
+    ASSERT_EQ(wav.readFrames(0, 3, out), 3u);
+    EXPECT_FLOAT_EQ(out[0], 0.25f);
+    EXPECT_FLOAT_EQ(out[1], -1.0f);
+    EXPECT_NEAR(out[2], 0.0f, 1e-4f);
+}
+
+TEST(MappedWavFileTest, Decodes24BitAndFloat) {
+    std::vector<uint8_t> pcm24 = {0x00, 0x00, 0x40, 0x00, 0x00, 0xC0, 0xFF, 0xFF, 0xFF};
+    TempFile file24(makeWav(1, 1, 44100, 24, pcm24));
+    MappedWavFile wav24(file24.path());
+    float out[3];
+    ASSERT_EQ(wav24.readFrames(0, 3, out), 3u);
+    EXPECT_FLOAT_EQ(out[0], 0.5f);
+    EXPECT_FLOAT_EQ(out[1], -0.5f);
+    EXPECT_FLOAT_EQ(out[2], -1.0f / 8388608.0f);
+
+    std::vector<uint8_t> floats;
+    for (float value : {0.125f, -0.75f}) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        put32(floats, bits);
+    }
+    TempFile fileFloat(makeWav(3, 1, 96000, 32, floats), "_float");
+    MappedWavFile wavFloat(fileFloat.path());
+    EXPECT_EQ(wavFloat.sampleFormat(), WavSampleFormat::Float32);
+    ASSERT_EQ(wavFloat.readFrames(0, 3, out), 2u);
+    EXPECT_EQ(out[0], 0.125f);
+    EXPECT_EQ(out[1], -0.75f);
+}
+
+TEST(MappedWavFileTest, ReadsFromAnOffsetAndStopsAtTheEnd) {
+    std::vector<uint8_t> payload;
+    for (int i = 0; i < 100; ++i) put16(payload, static_cast<uint16_t>(i * 100));
+    TempFile file(makeWav(1, 1, 8000, 16, payload));
+    MappedWavFile wav(file.path());
+
+    std::vector<float> out(20);
+    ASSERT_EQ(wav.readFrames(90, out.size(), out.data()), 10u);
+    EXPECT_FLOAT_EQ(out[0], 9000.0f / 32768.0f);
+    EXPECT_EQ(wav.readFrames(100, out.size(), out.data()), 0u);
+
+    wav.release(0, 50);
+    ASSERT_EQ(wav.readFrames(0, 1, out.data()), 1u);
+    EXPECT_EQ(out[0], 0.0f);
+}
+
+TEST(MappedWavFileTest, TruncatesOverstatedDataChunk) {
+    std::vector<uint8_t> payload(40, 0);
+    TempFile file(makeWav(1, 1, 44100, 16, payload, 0x7FFFFFF0));
+    MappedWavFile wav(file.path());
+    EXPECT_EQ(wav.frames(), 20u);
+}
+
+TEST(MappedWavFileTest, RejectsUnsupportedInput) {
+    EXPECT_THROW(MappedWavFile("/nonexistent/ptm.wav"), WavFileException);
+
+    TempFile notWav(std::vector<uint8_t>(64, 'x'));
+    EXPECT_THROW(MappedWavFile(notWav.path()), WavFileException);
+
+    // 12-bit PCM
+    TempFile odd(makeWav(1, 1, 44100, 12, std::vector<uint8_t>(8, 0)), "_12bit");
+    EXPECT_THROW(MappedWavFile(odd.path()), WavFileException);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "midi/MidiFileWriter.hpp"
+#include <vector>
+
+using ptm::MidiFileException;
+using ptm::MidiFileWriter;
+using ptm::NoteEvent;
+
+TEST(MidiFileWriterTest, WritesHeaderTempoAndEvents) {
+    MidiFileWriter writer(480, 120.0);  // 960 ticks per second
+    writer.addNoteOn(0.0, 1, 60, 100);
+    writer.addNoteOff(0.5, 1, 60);
+
+    std::vector<uint8_t> expected = {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x01, 0xE0,
+        'M', 'T', 'r', 'k', 0, 0, 0, 20,
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,  // 500000 us per quarter
+        0x00, 0x90, 60, 100,
+        0x83, 0x60, 0x80, 60, 64,                   // Delta 480
+        0x00, 0xFF, 0x2F, 0x00
+    };
+    EXPECT_EQ(writer.toBytes(), expected);
+}
+
+TEST(MidiFileWriterTest, SortsByTimeAndUsesRunningStatus) {
+    MidiFileWriter writer(96, 60.0);  // 96 ticks per second
+    writer.addNoteOn(1.0, 2, 64, 90);
+    writer.addNoteOn(0.0, 2, 62, 80);
+    writer.addNoteOn(1.0, 2, 67, 70);  // Same tick: stays after note 64
+
+    auto bytes = writer.toBytes();
+    std::vector<uint8_t> events(bytes.begin() + 22 + 7, bytes.end() - 4);
+    std::vector<uint8_t> expected = {
+        0x00, 0x91, 62, 80,
+        0x60, 64, 90,
+        0x00, 67, 70
+    };
+    EXPECT_EQ(events, expected);
+}
+
+TEST(MidiFileWriterTest, ConvertsNoteEventsBySampleRate) {
+    MidiFileWriter writer(480, 120.0);
+    std::vector<NoteEvent> events = {
+        {NoteEvent::Type::NoteOn, 69, 127, 0},
+        {NoteEvent::Type::NoteOff, 69, 0, 44100},
+    };
+    writer.addEvents(events, 44100.0, 10);
+    ASSERT_EQ(writer.eventCount(), 2u);
+
+    auto bytes = writer.toBytes();
+    // One second is 960 ticks: VLQ 0x87 0x40
+    std::vector<uint8_t> tail(bytes.end() - 4 - 5, bytes.end() - 4);
+    EXPECT_EQ(tail, (std::vector<uint8_t>{0x87, 0x40, 0x89, 69, 64}));
+}
+
+TEST(MidiFileWriterTest, RejectsOutOfRangeValues) {
+    EXPECT_THROW(MidiFileWriter(0), MidiFileException);
+    MidiFileWriter writer;
+    EXPECT_THROW(writer.addNoteOn(0.0, 0, 60, 100), MidiFileException);
+    EXPECT_THROW(writer.addNoteOn(0.0, 17, 60, 100), MidiFileException);
+    EXPECT_THROW(writer.addNoteOn(0.0, 1, 128, 100), MidiFileException);
+}
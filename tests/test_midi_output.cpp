@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+#include "midi/MidiOutput.hpp"
+#include "utils/RealtimeSanitizer.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using ptm::LatencyMonitor;
+using ptm::LatencyStage;
+using ptm::LatencyStamp;
+using ptm::MidiMessage;
+using ptm::MidiOutput;
+using ptm::MidiPort;
+using ptm::NoteEvent;
+
+namespace {
+    // Records what was sent; optionally blocks like a slow driver
+    class RecordingPort final : public MidiPort {
+    public:
+        explicit RecordingPort(std::chrono::microseconds delay = {}, bool runningStatus = false)
+            : delay_(delay)
+            , runningStatus_(runningStatus) {}
+
+        void send(const uint8_t* bytes, size_t size) override {
+            if (delay_.count() > 0) std::this_thread::sleep_for(delay_);
+            std::lock_guard<std::mutex> lock(mutex_);
+            sent_.emplace_back(bytes, bytes + size);
+        }
+
+        bool acceptsRunningStatus() const override { return runningStatus_; }
+        std::string describe() const override { return "recording"; }
+
+        std::vector<std::vector<uint8_t>> sent() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return sent_;
+        }
+
+    private:
+        std::chrono::microseconds delay_;
+        bool runningStatus_;
+        std::mutex mutex_;
+        std::vector<std::vector<uint8_t>> sent_;
+    };
+
+    std::vector<uint8_t> bytesOf(const MidiMessage& message) {
+        return {message.bytes.begin(), message.bytes.begin() + message.size};
+    }
+
+    bool waitForSent(const MidiOutput& output, uint64_t count) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (output.sentMessages() < count) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST(MidiMessageTest, EncodesChannelVoiceMessages) {
+    const MidiMessage on = MidiMessage::noteOn(2, 69, 100);
+    EXPECT_EQ(on.size, 3u);
+    EXPECT_EQ(on.bytes[0], 0x92);
+    EXPECT_EQ(on.bytes[1], 69);
+    EXPECT_EQ(on.bytes[2], 100);
+
+    const MidiMessage off = MidiMessage::fromNoteEvent(15, {NoteEvent::Type::NoteOff, 60, 0, 0});
+    EXPECT_EQ(off.bytes[0], 0x8F);
+    EXPECT_EQ(off.bytes[1], 60);
+    EXPECT_EQ(off.bytes[2], 0);
+
+    // 14 bits, least significant 7 first
+    const MidiMessage bend = MidiMessage::pitchBend(0, 0x2345);
+    EXPECT_EQ(bend.bytes[0], 0xE0);
+    EXPECT_EQ(bend.bytes[1], 0x45);
+    EXPECT_EQ(bend.bytes[2], 0x46);
+    EXPECT_EQ(MidiMessage::pitchBend(0, 0xFFFF).bytes[2], 0x7F);
+}
+
+TEST(MidiOutputTest, SendsInOrderOnItsOwnThread) {
+    RecordingPort port;
+    MidiOutput output(port, 64);
+    output.start();
+
+    for (uint8_t note = 60; note < 72; ++note) {
+        ASSERT_TRUE(output.post(MidiMessage::noteOn(0, note, 90)));
+        ASSERT_TRUE(output.post(MidiMessage::noteOff(0, note)));
+    }
+    ASSERT_TRUE(waitForSent(output, 24));
+    output.stop();
+
+    const auto sent = port.sent();
+    ASSERT_EQ(sent.size(), 24u);
+    for (size_t i = 0; i < sent.size(); ++i) {
+        ASSERT_EQ(sent[i].size(), 3u);
+        EXPECT_EQ(sent[i][0], i % 2 == 0 ? 0x90 : 0x80);
+        EXPECT_EQ(sent[i][1], 60 + i / 2);
+    }
+    EXPECT_EQ(output.droppedMessages(), 0u);
+    EXPECT_EQ(output.queueDepth(), 0u);
+    EXPECT_EQ(output.queueWait().count(), 24u);
+}
+
+TEST(MidiOutputTest, PostNeverWaitsForASlowPort) {
+    // Each send blocks for 2 ms; a queue of 16 fills and then drops
+    RecordingPort port(std::chrono::microseconds(2000));
+    MidiOutput output(port, 16);
+    output.start();
+
+    const auto start = std::chrono::steady_clock::now();
+    size_t accepted = 0;
+    for (int i = 0; i < 64; ++i) {
+        ptm::RealtimeScope realtime;
+        if (output.post(MidiMessage::pitchBend(0, static_cast<uint16_t>(8192 + i)))) ++accepted;
+    }
+    const auto postTime = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(postTime, std::chrono::milliseconds(20));
+
+    EXPECT_EQ(output.droppedMessages(), 64u - accepted);
+    EXPECT_GT(output.droppedMessages(), 0u);
+    EXPECT_EQ(output.maxQueueDepth(), output.capacity());
+
+    // stop() still sends everything that was accepted
+    output.stop();
+    EXPECT_EQ(output.sentMessages(), accepted);
+    EXPECT_EQ(port.sent().size(), accepted);
+
+    // The later messages waited behind the earlier sends
+    EXPECT_GE(output.queueWait().summary().maxNs, 10'000'000);
+}
+
+TEST(MidiOutputTest, SendsMessagesPostedBeforeStart) {
+    RecordingPort port;
+    MidiOutput output(port);
+    ASSERT_TRUE(output.post(MidiMessage::noteOn(0, 64, 80)));
+    EXPECT_EQ(output.queueDepth(), 1u);
+
+    output.start();
+    EXPECT_TRUE(waitForSent(output, 1));
+    output.stop();
+    EXPECT_EQ(port.sent().size(), 1u);
+}
+
+TEST(MidiOutputTest, RecordsOutputLatencyWithTheStamp) {
+    LatencyMonitor monitor;
+    RecordingPort port;
+    MidiOutput output(port, MidiOutput::kDefaultQueueSize, &monitor);
+    output.start();
+
+    LatencyStamp stamp;
+    stamp.adcNs = LatencyMonitor::now() - 5'000'000;
+    stamp.detectNs = LatencyMonitor::now();
+    output.post(MidiMessage::noteOn(0, 69, 100), stamp);
+    output.post(MidiMessage::noteOff(0, 69));  // Unstamped: not recorded
+    ASSERT_TRUE(waitForSent(output, 2));
+    output.stop();
+
+    EXPECT_EQ(monitor.summary(LatencyStage::Output).count, 1u);
+    EXPECT_EQ(monitor.summary(LatencyStage::Total).count, 1u);
+    EXPECT_GE(monitor.summary(LatencyStage::Total).maxNs, 5'000'000);
+}
+
+TEST(MidiOutputTest, DropsBendsInsideTheDeadband) {
+    RecordingPort port;
+    MidiOutput output(port);
+    ptm::BendThinningConfig thinning;
+    thinning.deadbandCents = 5.0;
+    EXPECT_THROW(output.setBendThinning({-1.0, 2.0, false}), std::invalid_argument);
+    output.setBendThinning(thinning);
+
+    for (double cents : {10.0, 12.0, 16.0, 0.0, 2.0, -4.0}) {
+        output.post(MidiMessage::pitchBendCents(0, cents));
+    }
+    output.post(MidiMessage::pitchBendCents(1, 2.0));  // First on its channel
+    output.start();
+    output.stop();
+
+    // 12 is within 5 cents of 10; 0 is the centre; 2 and -4 are within 5 of 0
+    const auto sent = port.sent();
+    ASSERT_EQ(sent.size(), 4u);
+    EXPECT_EQ(sent[0], bytesOf(MidiMessage::pitchBendCents(0, 10.0)));
+    EXPECT_EQ(sent[1], bytesOf(MidiMessage::pitchBendCents(0, 16.0)));
+    EXPECT_EQ(sent[2], (std::vector<uint8_t>{0xE0, 0x00, 0x40}));
+    EXPECT_EQ(sent[3][0], 0xE1);
+    EXPECT_EQ(output.filteredBends(), 3u);
+    EXPECT_EQ(output.sentMessages(), 4u);
+}
+
+TEST(MidiOutputTest, CoalescesWaitingBendsBehindNotes) {
+    RecordingPort port;
+    MidiOutput output(port);
+    output.setBendThinning({0.0, 2.0, true});
+
+    // Queued together, as behind a slow send
+    output.post(MidiMessage::pitchBendCents(0, 10.0));
+    output.post(MidiMessage::noteOn(0, 64, 100));
+    output.post(MidiMessage::pitchBendCents(0, 20.0));
+    output.post(MidiMessage::pitchBendCents(1, -30.0));
+    output.post(MidiMessage::noteOff(0, 64));
+    output.post(MidiMessage::pitchBendCents(0, 30.0));
+    output.start();
+    output.stop();
+
+    const auto sent = port.sent();
+    ASSERT_EQ(sent.size(), 4u);
+    EXPECT_EQ(sent[0][0], 0x90);
+    EXPECT_EQ(sent[1][0], 0x80);
+    EXPECT_EQ(sent[2], bytesOf(MidiMessage::pitchBendCents(0, 30.0)));
+    EXPECT_EQ(sent[3][0], 0xE1);
+    EXPECT_EQ(output.coalescedBends(), 2u);
+}
+
+TEST(MidiOutputTest, DeadbandAloneStillSendsNotesFirst) {
+    RecordingPort port;
+    MidiOutput output(port);
+    output.setBendThinning({5.0, 2.0, false});
+
+    output.post(MidiMessage::pitchBendCents(0, 10.0));
+    output.post(MidiMessage::pitchBendCents(0, 20.0));
+    output.post(MidiMessage::noteOn(0, 64, 100));
+    output.post(MidiMessage::pitchBendCents(0, 22.0));
+    output.post(MidiMessage::pitchBendCents(0, 40.0));
+    output.post(MidiMessage::noteOff(0, 64));
+    output.start();
+    output.stop();
+
+    // Every bend waits, in order, and 22 is within 5 cents of 20
+    const auto sent = port.sent();
+    ASSERT_EQ(sent.size(), 5u);
+    EXPECT_EQ(sent[0][0], 0x90);
+    EXPECT_EQ(sent[1][0], 0x80);
+    EXPECT_EQ(sent[2], bytesOf(MidiMessage::pitchBendCents(0, 10.0)));
+    EXPECT_EQ(sent[3], bytesOf(MidiMessage::pitchBendCents(0, 20.0)));
+    EXPECT_EQ(sent[4], bytesOf(MidiMessage::pitchBendCents(0, 40.0)));
+    EXPECT_EQ(output.filteredBends(), 1u);
+    EXPECT_EQ(output.coalescedBends(), 0u);
+}
+
+TEST(MidiOutputTest, LeavesOutRepeatedStatusOnByteStreamPorts) {
+    RecordingPort port({}, true);
+    MidiOutput output(port);
+
+    output.post(MidiMessage::noteOn(0, 60, 100));
+    output.post(MidiMessage::pitchBend(0, 8192));
+    output.post(MidiMessage::pitchBend(0, 8300));
+    output.post(MidiMessage::noteOff(0, 60));
+    output.post(MidiMessage::noteOn(0, 62, 100));
+    output.post(MidiMessage::noteOn(1, 62, 100));
+    output.start();
+    output.stop();
+
+    const std::vector<std::vector<uint8_t>> expected = {
+        {0x90, 60, 100}, {0xE0, 0x00, 0x40}, {0x6C, 0x40},
+        {0x90, 60, 0},  // Note-off as a note-on with velocity 0
+        {62, 100}, {0x91, 62, 100}};
+    EXPECT_EQ(port.sent(), expected);
+    EXPECT_EQ(output.bytesSent(), 16u);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "audio/MirroredRingBuffer.hpp"
+#include <numeric>
+#include <vector>
+
+using ptm::MirroredMemory;
+using ptm::MirroredRingBuffer;
+using ptm::OverflowPolicy;
+
+namespace {
+    std::vector<float> ramp(size_t count, float start = 0.0f) {
+        std::vector<float> values(count);
+        std::iota(values.begin(), values.end(), start);
+        return values;
+    }
+}
+
+TEST(MirroredMemoryTest, SecondHalfAliasesFirst) {
+    MirroredMemory memory(100);
+    ASSERT_EQ(memory.size() % MirroredMemory::pageSize(), 0u);
+
+    auto* bytes = static_cast<unsigned char*>(memory.data());
+    bytes[3] = 0x5a;
+    if (memory.isHardwareMirrored()) {
+        EXPECT_EQ(bytes[memory.size() + 3], 0x5a);
+        bytes[memory.size() + 7] = 0xa5;
+        EXPECT_EQ(bytes[7], 0xa5);
+    }
+}
+
+TEST(MirroredRingBufferTest, CapacityCoversAtLeastOnePage) {
+    MirroredRingBuffer<float> buffer(16);
+    EXPECT_GE(buffer.capacity() * sizeof(float), MirroredMemory::pageSize());
+    EXPECT_EQ(buffer.capacity() & (buffer.capacity() - 1), 0u);
+}
+
+TEST(MirroredRingBufferTest, PeekReturnsContiguousViewAcrossWrap) {
+    MirroredRingBuffer<float> buffer(8192);
+    const size_t capacity = buffer.capacity();
+    std::vector<float> scratch(capacity);
+
+    // Move the read position close to the end of the storage
+    auto head = ramp(capacity - 10);
+    buffer.write(head.data(), head.size());
+    buffer.read(scratch.data(), head.size());
+
+    auto window = ramp(64, 1000.0f);
+    buffer.write(window.data(), window.size());
+
+    const float* view = buffer.peek(64);
+    ASSERT_NE(view, nullptr);
+    for (size_t i = 0; i < 64; ++i) {
+        EXPECT_FLOAT_EQ(view[i], 1000.0f + static_cast<float>(i));
+    }
+    EXPECT_EQ(buffer.available(), 64u);
+    EXPECT_TRUE(buffer.consume(16));
+    EXPECT_EQ(buffer.available(), 48u);
+    EXPECT_EQ(buffer.peek(64), nullptr);
+}
+
+TEST(MirroredRingBufferTest, LatestViewsMostRecentSamples) {
+    MirroredRingBuffer<float> buffer(1024);
+    auto data = ramp(buffer.capacity() + 100);
+    buffer.write(data.data(), buffer.capacity() / 2);
+    buffer.clear();
+    buffer.write(data.data() + buffer.capacity() / 2, buffer.capacity() / 2 + 100);
+
+    const float* view = buffer.latest(200);
+    ASSERT_NE(view, nullptr);
+    EXPECT_FLOAT_EQ(view[0], static_cast<float>(buffer.capacity() - 100));
+    EXPECT_FLOAT_EQ(view[199], static_cast<float>(buffer.capacity() + 99));
+}
+
+TEST(MirroredRingBufferTest, ConsumeFailsAfterDropOldestOverflow) {
+    MirroredRingBuffer<float> buffer(1024, OverflowPolicy::DropOldest);
+    auto data = ramp(buffer.capacity());
+    buffer.write(data.data(), buffer.capacity());
+
+    ASSERT_NE(buffer.peek(32), nullptr);
+    buffer.write(data.data(), 64);
+    EXPECT_FALSE(buffer.consume(32));
+    EXPECT_EQ(buffer.overflowCount(), 64u);
+}
+
+TEST(MirroredRingBufferTest, ReadMatchesHeapRingBuffer) {
+    MirroredRingBuffer<float> mirrored(1024);
+    ptm::RingBuffer<float> heap(mirrored.capacity());
+    std::vector<float> a(300), b(300);
+
+    float next = 0.0f;
+    for (int round = 0; round < 50; ++round) {
+        auto block = ramp(257, next);
+        next += 257.0f;
+        mirrored.write(block.data(), block.size());
+        heap.write(block.data(), block.size());
+
+        size_t readA = mirrored.read(a.data(), a.size());
+        size_t readB = heap.read(b.data(), b.size());
+        ASSERT_EQ(readA, readB);
+        for (size_t i = 0; i < readA; ++i) {
+            ASSERT_FLOAT_EQ(a[i], b[i]);
+        }
+    }
+}
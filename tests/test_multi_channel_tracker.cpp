@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include "midi/MultiChannelTracker.hpp"
+#include "audio/AudioCapture.hpp"
+#include "audio/ReplaySource.hpp"
+#include "utils/RealtimeSanitizer.hpp"
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using ptm::AudioBlockInfo;
+using ptm::AudioCapture;
+using ptm::AudioCaptureException;
+using ptm::LatencyStamp;
+using ptm::MultiChannelConfig;
+using ptm::MultiChannelTracker;
+using ptm::NoteEvent;
+using ptm::ReplayConfig;
+using ptm::SyntheticSource;
+
+namespace {
+    const double kPi = std::acos(-1.0);
+    constexpr double kSampleRate = 44100.0;
+
+    struct ChannelEvent {
+        unsigned channel;
+        uint8_t midiChannel;
+        NoteEvent event;
+        LatencyStamp latency;
+    };
+
+    // Interleaved harmonic tones, one frequency per channel (0 for silence)
+    std::vector<float> interleavedTones(const std::vector<double>& frequencies, size_t frames) {
+        const size_t channels = frequencies.size();
+        std::vector<float> samples(frames * channels);
+        for (size_t i = 0; i < frames; ++i) {
+            const double t = static_cast<double>(i) / kSampleRate;
+            for (size_t c = 0; c < channels; ++c) {
+                const double f = frequencies[c];
+                samples[i * channels + c] = f > 0.0
+                    ? static_cast<float>(0.4 * std::sin(2.0 * kPi * f * t) +
+                                         0.2 * std::sin(4.0 * kPi * f * t))
+                    : 0.0f;
+            }
+        }
+        return samples;
+    }
+
+    // Feeds blocks the way an unpaced source would
+    void feed(MultiChannelTracker& tracker, const std::vector<float>& samples, unsigned channels,
+              size_t framesPerBlock) {
+        AudioBlockInfo info;
+        info.channels = channels;
+        const size_t frames = samples.size() / channels;
+        for (size_t offset = 0; offset < frames; offset += framesPerBlock) {
+            const size_t count = std::min(framesPerBlock, frames - offset);
+            while (!tracker.hasRoomFor(count)) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            tracker.processBlock(samples.data() + offset * channels, count, info);
+        }
+    }
+}
+
+TEST(MultiChannelTrackerTest, TracksEachChannelOnItsOwnMidiChannel) {
+    MultiChannelConfig config;
+    config.sampleRate = kSampleRate;
+    config.channels = 4;
+    config.firstMidiChannel = 2;
+    config.threads = 2;
+    config.pitch.windowSize = 1024;
+    config.pitch.hopSize = 128;
+
+    std::mutex mutex;
+    std::vector<ChannelEvent> events;
+    MultiChannelTracker tracker(config, [&](unsigned channel, uint8_t midiChannel, const NoteEvent& event,
+                                            const LatencyStamp& latency) {
+        ptm::RealtimeExemption exemption;  // Test bookkeeping
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back({channel, midiChannel, event, latency});
+    });
+    EXPECT_EQ(tracker.threadCount(), 2u);
+
+    // A3, A4 and E5 on the first three channels; the fourth is silent
+    const size_t frames = static_cast<size_t>(kSampleRate / 2);
+    tracker.start();
+    feed(tracker, interleavedTones({220.0, 440.0, 659.26, 0.0}, frames), 4, 256);
+
+    // Every hop of every channel runs once the last block is in
+    const uint64_t expectedHops = 4 * ((frames - config.pitch.windowSize) / config.pitch.hopSize + 1);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (tracker.processedHops() < expectedHops && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    tracker.stop();
+    EXPECT_EQ(tracker.processedHops(), expectedHops);
+    EXPECT_EQ(tracker.missedHops(), 0u);
+    EXPECT_GT(tracker.hopLatency().summary().count, 0u);
+
+    const uint8_t expectedNotes[] = {57, 69, 76};
+    for (unsigned c = 0; c < 3; ++c) {
+        std::vector<NoteEvent> channelEvents;
+        for (const ChannelEvent& e : events) {
+            if (e.channel != c) continue;
+            EXPECT_EQ(e.midiChannel, 2 + c);
+            channelEvents.push_back(e.event);
+        }
+        // One note, released by stop()
+        ASSERT_EQ(channelEvents.size(), 2u) << "channel " << c;
+        EXPECT_EQ(channelEvents[0].type, NoteEvent::Type::NoteOn);
+        EXPECT_EQ(channelEvents[0].note, expectedNotes[c]);
+        EXPECT_EQ(channelEvents[1].type, NoteEvent::Type::NoteOff);
+    }
+    for (const ChannelEvent& e : events) {
+        EXPECT_NE(e.channel, 3u);
+    }
+}
+
+TEST(MultiChannelTrackerTest, MidiChannelsWrapAfterSixteen) {
+    MultiChannelConfig config;
+    config.channels = 20;
+    config.firstMidiChannel = 10;
+    config.threads = 1;
+
+    std::mutex mutex;
+    std::vector<ChannelEvent> events;
+    MultiChannelTracker tracker(config, [&](unsigned channel, uint8_t midiChannel, const NoteEvent& event,
+                                            const LatencyStamp& latency) {
+        ptm::RealtimeExemption exemption;  // Test bookkeeping
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back({channel, midiChannel, event, latency});
+    });
+
+    // A tone on channel 7 only
+    std::vector<double> frequencies(20, 0.0);
+    frequencies[7] = 440.0;
+    tracker.start();
+    feed(tracker, interleavedTones(frequencies, static_cast<size_t>(config.sampleRate / 4)), 20, 512);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    tracker.stop();
+
+    ASSERT_FALSE(events.empty());
+    for (const ChannelEvent& e : events) {
+        EXPECT_EQ(e.channel, 7u);
+        EXPECT_EQ(e.midiChannel, 1u);  // (10 + 7) % 16
+    }
+}
+
+TEST(MultiChannelTrackerTest, RunsBehindAudioCapture) {
+    MultiChannelConfig config;
+    config.sampleRate = kSampleRate;
+    config.channels = 2;
+    config.threads = 2;
+
+    std::mutex mutex;
+    std::vector<ChannelEvent> events;
+    MultiChannelTracker tracker(config, [&](unsigned channel, uint8_t midiChannel, const NoteEvent& event,
+                                            const LatencyStamp& latency) {
+        ptm::RealtimeExemption exemption;  // Test bookkeeping
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back({channel, midiChannel, event, latency});
+    });
+
+    AudioCapture capture;
+    capture.setChannelSink(&tracker);
+
+    // Unpaced, so the tracker throttles the source instead of missing hops
+    ReplayConfig replay;
+    replay.speed = 0.0;
+    replay.channels = 2;
+    const size_t frames = static_cast<size_t>(kSampleRate / 2);
+    std::vector<float> monoSamples;
+    auto collect = [&](const float* samples, unsigned long count) {
+        ptm::RealtimeExemption exemption;  // Test bookkeeping
+        monoSamples.insert(monoSamples.end(), samples, samples + count);
+    };
+    tracker.start();
+    capture.start(std::make_unique<SyntheticSource>(kSampleRate,
+                                                    interleavedTones({440.0, 220.0}, frames), replay),
+                  collect);
+    EXPECT_THROW(capture.setChannelSink(nullptr), AudioCaptureException);
+    EXPECT_THROW(capture.switchSource(std::make_unique<SyntheticSource>(
+                     kSampleRate, std::vector<float>(1024, 0.0f))), AudioCaptureException);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (capture.isActive() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    capture.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    tracker.stop();
+
+    // The capture callback only sees the first channel
+    const std::vector<float> expected = interleavedTones({440.0}, frames);
+    EXPECT_EQ(monoSamples, expected);
+
+    EXPECT_EQ(tracker.missedHops(), 0u);
+    ASSERT_EQ(events.size(), 4u);
+    for (const ChannelEvent& e : events) {
+        if (e.event.type == NoteEvent::Type::NoteOn) {
+            EXPECT_EQ(e.event.note, e.channel == 0 ? 69 : 57);
+
+            // Stamped from the capture's ADC times, ready for MidiOutput
+            ASSERT_TRUE(e.latency.valid());
+            EXPECT_LE(e.latency.adcNs, e.latency.readNs);
+            EXPECT_LE(e.latency.readNs, e.latency.detectNs);
+            EXPECT_LT(e.latency.detectNs - e.latency.adcNs, 1'000'000'000);
+        }
+    }
+}
+
+TEST(MultiChannelTrackerTest, RejectsBadConfigurations) {
+    auto ignore = [](unsigned, uint8_t, const NoteEvent&, const LatencyStamp&) {};
+
+    MultiChannelConfig config;
+    config.channels = 0;
+    EXPECT_THROW(MultiChannelTracker(config, ignore), std::invalid_argument);
+
+    config.channels = 2;
+    config.firstMidiChannel = 16;
+    EXPECT_THROW(MultiChannelTracker(config, ignore), std::invalid_argument);
+
+    config.firstMidiChannel = 0;
+    config.pitch.windowSize = 4096;
+    config.bufferSize = 4096;
+    EXPECT_THROW(MultiChannelTracker(config, ignore), std::invalid_argument);
+
+    config.bufferSize = 8192;
+    EXPECT_THROW(MultiChannelTracker(config, nullptr), std::invalid_argument);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "dsp/SyntheticSignal.hpp"
+#include "midi/LiveNoteTracker.hpp"
+#include "midi/NoteTelemetry.hpp"
+#include "midi/ParameterStore.hpp"
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using ptm::AnalysisFrame;
+using ptm::FftPlanCache;
+using ptm::LiveNoteTracker;
+using ptm::NoteEvent;
+using ptm::NoteTelemetry;
+using ptm::NoteTelemetryChannel;
+using ptm::ParameterStore;
+using ptm::PitchDetectorSet;
+using ptm::ProcessingParameters;
+
+namespace {
+    constexpr double kSampleRate = 44100.0;
+
+    // Runs the tracker over samples the way an AnalysisWorker would
+    std::vector<NoteEvent> feed(LiveNoteTracker& tracker, const std::vector<float>& samples,
+                                uint64_t& hopIndex, size_t hops) {
+        const auto config = LiveNoteTracker::analysisConfig();
+        std::vector<NoteEvent> events;
+        for (size_t h = 0; h < hops; ++h, ++hopIndex) {
+            const size_t offset = static_cast<size_t>(hopIndex * config.hopSize) %
+                                  (samples.size() - config.windowSize);
+            AnalysisFrame frame{samples.data() + offset, config.windowSize, hopIndex, false, {}};
+            auto update = tracker.process(frame);
+            events.insert(events.end(), update.events, update.events + update.count);
+        }
+        return events;
+    }
+}
+
+TEST(NoteTelemetryTest, ChannelHoldsTheLatestHop) {
+    NoteTelemetryChannel channel;
+    const NoteTelemetry initial = channel.load();
+    EXPECT_EQ(initial.hop, 0u);
+    EXPECT_EQ(initial.note, -1);
+    EXPECT_EQ(initial.velocity, 0u);
+
+    NoteTelemetry telemetry;
+    for (uint64_t hop = 1; hop <= 3; ++hop) {
+        telemetry.hop = hop;
+        telemetry.note = 60 + static_cast<int>(hop);
+        telemetry.frequency = 100.0f * static_cast<float>(hop);
+        channel.store(telemetry);
+    }
+    const NoteTelemetry latest = channel.load();
+    EXPECT_EQ(latest.hop, 3u);
+    EXPECT_EQ(latest.note, 63);
+    EXPECT_FLOAT_EQ(latest.frequency, 300.0f);
+}
+
+// The display thread polls while the analysis thread stores every hop
+TEST(NoteTelemetryTest, ReaderNeverSeesAHalfWrittenHop) {
+    NoteTelemetryChannel channel;
+    constexpr uint64_t kHops = 200000;
+    std::atomic<bool> done{false};
+
+    std::thread analysis([&] {
+        NoteTelemetry telemetry;
+        for (uint64_t hop = 1; hop <= kHops; ++hop) {
+            telemetry.hop = hop;
+            telemetry.note = static_cast<int>(hop % 128);
+            telemetry.velocity = static_cast<uint8_t>(hop % 128);
+            telemetry.frequency = static_cast<float>(hop % 1000);
+            telemetry.level = static_cast<float>(hop % 1000);
+            channel.store(telemetry);
+        }
+        done = true;
+    });
+
+    uint64_t lastHop = 0;
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+    while (!done) {
+        const NoteTelemetry telemetry = channel.load();
+        if (telemetry.hop == 0) continue;
+        if (telemetry.note != static_cast<int>(telemetry.hop % 128) ||
+            telemetry.velocity != telemetry.hop % 128 ||
+            telemetry.frequency != static_cast<float>(telemetry.hop % 1000) ||
+            telemetry.level != telemetry.frequency) {
+            ++torn;
+        }
+        if (telemetry.hop < lastHop) ++backwards;
+        lastHop = telemetry.hop;
+    }
+    analysis.join();
+
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(backwards, 0u);
+    EXPECT_EQ(channel.load().hop, kHops);
+}
+
+TEST(LiveNoteTrackerTest, PublishesTelemetryForEveryAnalysedHop) {
+    FftPlanCache cache(PitchDetectorSet::fftSizesFor(PitchDetectorSet::defaultWindowSizes()));
+    cache.start();
+
+    ProcessingParameters parameters;
+    parameters.hopSize = 128;
+    parameters.debounceMs = 0.0;
+    ParameterStore store(parameters);
+    LiveNoteTracker tracker(kSampleRate, store, cache);
+    NoteTelemetryChannel telemetry;
+    tracker.setTelemetry(&telemetry);
+
+    // A quarter tone sharp of A4
+    const double frequency = 440.0 * std::pow(2.0, 0.5 / 12.0);
+    auto samples = ptm::synthetic::tone(frequency, kSampleRate, 16384, 0.5f, 3);
+    uint64_t hopIndex = 0;
+    auto events = feed(tracker, samples, hopIndex, 20);
+    ASSERT_EQ(events.size(), 1u);
+
+    const NoteTelemetry latest = telemetry.load();
+    EXPECT_EQ(latest.hop, 10u);
+    EXPECT_EQ(latest.note, events[0].note);
+    EXPECT_EQ(latest.velocity, events[0].velocity);
+    EXPECT_GT(latest.confidence, 0.9f);
+    EXPECT_NEAR(std::fabs(latest.cents), 50.0f, 5.0f);
+}
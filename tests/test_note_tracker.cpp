@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "midi/NoteTracker.hpp"
+#include <vector>
+
+using ptm::NoteEvent;
+using ptm::NoteTracker;
+using ptm::NoteTrackerConfig;
+using ptm::PitchEstimate;
+
+namespace {
+    // 1 ms per hop at 1 kHz keeps the debounce arithmetic readable
+    NoteTrackerConfig makeConfig(double debounceMs) {
+        NoteTrackerConfig config;
+        config.sampleRate = 1000.0;
+        config.debounceMs = debounceMs;
+        config.amplitudeThreshold = 0.1f;
+        return config;
+    }
+
+    PitchEstimate voiced(float frequency) {
+        PitchEstimate estimate;
+        estimate.frequency = frequency;
+        estimate.confidence = 0.9f;
+        estimate.voiced = true;
+        return estimate;
+    }
+
+    // Feeds one estimate per millisecond and collects the events
+    std::vector<NoteEvent> feed(NoteTracker& tracker, uint64_t& position,
+                                const PitchEstimate& estimate, float rms, int hops) {
+        std::vector<NoteEvent> events;
+        for (int i = 0; i < hops; ++i, ++position) {
+            auto update = tracker.update(estimate, rms, position);
+            events.insert(events.end(), update.events.begin(), update.events.begin() + update.count);
+        }
+        return events;
+    }
+}
+
+TEST(NoteTrackerTest, MapsFrequencyToNearestNote) {
+    EXPECT_EQ(NoteTracker::frequencyToNote(440.0f), 69);
+    EXPECT_EQ(NoteTracker::frequencyToNote(261.63f), 60);
+    EXPECT_EQ(NoteTracker::frequencyToNote(452.0f), 69);   // +46 cents
+    EXPECT_EQ(NoteTracker::frequencyToNote(454.0f), 70);   // +54 cents
+    EXPECT_NEAR(NoteTracker::centsFromNote(452.0f, 69), 46.6f, 0.1f);
+}
+
+TEST(NoteTrackerTest, DebouncesOnsetAndStampsItWhereItBegan) {
+    NoteTracker tracker(makeConfig(5.0));
+    uint64_t position = 0;
+
+    auto events = feed(tracker, position, voiced(440.0f), 0.3f, 5);
+    EXPECT_TRUE(events.empty());
+
+    events = feed(tracker, position, voiced(440.0f), 0.3f, 1);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, NoteEvent::Type::NoteOn);
+    EXPECT_EQ(events[0].note, 69);
+    EXPECT_EQ(events[0].samplePosition, 0u);
+    EXPECT_EQ(tracker.currentNote(), 69);
+}
+
+TEST(NoteTrackerTest, IgnoresBriefGlitches) {
+    NoteTracker tracker(makeConfig(5.0));
+    uint64_t position = 0;
+    feed(tracker, position, voiced(440.0f), 0.3f, 10);
+
+    // An octave error and a dropout, each shorter than the debounce time
+    auto events = feed(tracker, position, voiced(880.0f), 0.3f, 3);
+    auto more = feed(tracker, position, PitchEstimate{}, 0.0f, 4);
+    events.insert(events.end(), more.begin(), more.end());
+    more = feed(tracker, position, voiced(440.0f), 0.3f, 10);
+    events.insert(events.end(), more.begin(), more.end());
+
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(tracker.currentNote(), 69);
+}
+
+TEST(NoteTrackerTest, NoteChangeEmitsOffThenOn) {
+    NoteTracker tracker(makeConfig(0.0));
+    uint64_t position = 0;
+    feed(tracker, position, voiced(440.0f), 0.3f, 1);
+
+    auto events = feed(tracker, position, voiced(493.88f), 0.3f, 1);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].type, NoteEvent::Type::NoteOff);
+    EXPECT_EQ(events[0].note, 69);
+    EXPECT_EQ(events[1].type, NoteEvent::Type::NoteOn);
+    EXPECT_EQ(events[1].note, 71);
+    EXPECT_EQ(events[0].samplePosition, events[1].samplePosition);
+}
+
+TEST(NoteTrackerTest, QuietOrUnvoicedFramesEndTheNote) {
+    NoteTracker tracker(makeConfig(0.0));
+    uint64_t position = 0;
+    feed(tracker, position, voiced(220.0f), 0.3f, 3);
+
+    auto events = feed(tracker, position, voiced(220.0f), 0.05f, 1);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, NoteEvent::Type::NoteOff);
+
+    feed(tracker, position, voiced(220.0f), 0.3f, 1);
+    PitchEstimate unvoiced = voiced(220.0f);
+    unvoiced.voiced = false;
+    events = feed(tracker, position, unvoiced, 0.3f, 1);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, NoteEvent::Type::NoteOff);
+
+    feed(tracker, position, voiced(220.0f), 0.3f, 1);
+    auto flushed = tracker.flush(position);
+    ASSERT_EQ(flushed.count, 1u);
+    EXPECT_EQ(flushed.events[0].type, NoteEvent::Type::NoteOff);
+    EXPECT_EQ(tracker.currentNote(), -1);
+}
+
+TEST(NoteTrackerTest, VelocityFollowsLevel) {
+    NoteTrackerConfig config = makeConfig(0.0);
+    NoteTracker logarithmic(config);
+    config.velocityCurve = ptm::VelocityCurve::Linear;
+    NoteTracker linear(config);
+
+    EXPECT_EQ(logarithmic.velocityFor(0.7071f), 127);
+    EXPECT_EQ(linear.velocityFor(0.7071f), 127);
+    EXPECT_EQ(logarithmic.velocityFor(0.0f), 1);
+    EXPECT_EQ(linear.velocityFor(0.0f), 1);
+
+    // -24 dB is half way on the log curve but low on the linear one
+    float minus24Db = 0.7071f * 0.0631f;
+    EXPECT_NEAR(logarithmic.velocityFor(minus24Db), 64, 1);
+    EXPECT_LT(linear.velocityFor(minus24Db), 10);
+    EXPECT_LT(linear.velocityFor(0.2f), linear.velocityFor(0.4f));
+}
+
+TEST(NoteTrackerTest, RejectsInvalidConfiguration) {
+    NoteTrackerConfig config;
+    config.debounceMs = -1.0;
+    EXPECT_THROW(NoteTracker{config}, std::invalid_argument);
+    config = NoteTrackerConfig{};
+    config.highestNote = 128;
+    EXPECT_THROW(NoteTracker{config}, std::invalid_argument);
+}
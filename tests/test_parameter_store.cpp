@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "dsp/SyntheticSignal.hpp"
+#include "midi/LiveNoteTracker.hpp"
+#include "midi/ParameterStore.hpp"
+#include <algorithm>
+#include <vector>
+
+using ptm::AnalysisFrame;
+using ptm::FftPlanCache;
+using ptm::LiveNoteTracker;
+using ptm::NoteEvent;
+using ptm::ParameterStore;
+using ptm::PitchDetectorSet;
+using ptm::ProcessingParameters;
+
+namespace {
+    constexpr double kSampleRate = 44100.0;
+
+    // Runs the tracker over samples the way an AnalysisWorker would
+    std::vector<NoteEvent> feed(LiveNoteTracker& tracker, const std::vector<float>& samples,
+                                uint64_t& hopIndex, size_t hops) {
+        const auto config = LiveNoteTracker::analysisConfig();
+        std::vector<NoteEvent> events;
+        for (size_t h = 0; h < hops; ++h, ++hopIndex) {
+            const size_t offset = static_cast<size_t>(hopIndex * config.hopSize) %
+                                  (samples.size() - config.windowSize);
+            AnalysisFrame frame{samples.data() + offset, config.windowSize, hopIndex, false, {}};
+            auto update = tracker.process(frame);
+            events.insert(events.end(), update.events, update.events + update.count);
+        }
+        return events;
+    }
+}
+
+TEST(ParameterStoreTest, ConstrainsToTheControlRanges) {
+    ProcessingParameters parameters;
+    parameters.amplitudeThreshold = 1.5f;
+    parameters.windowSize = 1000;
+    parameters.hopSize = 5000;
+    parameters.debounceMs = -3.0;
+    parameters.midiChannel = 0;
+    parameters.maxVoices = 20;
+
+    const auto constrained = parameters.constrained();
+    EXPECT_FLOAT_EQ(constrained.amplitudeThreshold, 1.0f);
+    EXPECT_EQ(constrained.windowSize, 1024u);
+    EXPECT_EQ(constrained.hopSize, 1024u);
+    EXPECT_DOUBLE_EQ(constrained.debounceMs, 0.0);
+    EXPECT_EQ(constrained.midiChannel, 1);
+    EXPECT_EQ(constrained.maxVoices, ProcessingParameters::kMaxVoices);
+
+    // The hop never exceeds the window
+    parameters.windowSize = 256;
+    parameters.hopSize = 512;
+    EXPECT_EQ(parameters.constrained().hopSize, 256u);
+}
+
+TEST(ParameterStoreTest, AnalysisThreadPicksUpTheLatestSnapshot) {
+    ParameterStore store;
+    EXPECT_FALSE(store.update());
+    EXPECT_EQ(store.currentVersion(), 0u);
+
+    ProcessingParameters parameters;
+    parameters.windowSize = 2048;
+    store.publish(parameters);
+    parameters.windowSize = 3072;
+    store.publish(parameters);
+    EXPECT_EQ(store.current().windowSize, 1024u);  // Until the next hop
+
+    EXPECT_TRUE(store.update());
+    EXPECT_EQ(store.current().windowSize, 3072u);
+    EXPECT_EQ(store.currentVersion(), 2u);
+    EXPECT_EQ(store.published().windowSize, 3072u);
+    EXPECT_FALSE(store.update());
+}
+
+TEST(LiveNoteTrackerTest, FollowsTheControlsAtHopBoundaries) {
+    FftPlanCache cache(PitchDetectorSet::fftSizesFor(PitchDetectorSet::defaultWindowSizes()));
+    cache.start();
+
+    ProcessingParameters parameters;
+    parameters.hopSize = 256;
+    parameters.debounceMs = 0.0;
+    ParameterStore store(parameters);
+    LiveNoteTracker tracker(kSampleRate, store, cache);
+
+    auto samples = ptm::synthetic::tone(440.0, kSampleRate, 16384, 0.5f, 3);
+    uint64_t hopIndex = 0;
+
+    // Every fourth 64-sample frame is a 256-sample hop
+    auto events = feed(tracker, samples, hopIndex, 16);
+    EXPECT_EQ(tracker.analysedHops(), 4u);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, NoteEvent::Type::NoteOn);
+    EXPECT_EQ(events[0].note, 69);
+    EXPECT_NEAR(tracker.lastEstimate().frequency, 440.0f, 1.0f);
+
+    // A larger window and hop from the next hop on
+    parameters.windowSize = 4096;
+    parameters.hopSize = 1024;
+    store.publish(parameters);
+    feed(tracker, samples, hopIndex, 32);
+    EXPECT_EQ(tracker.parameters().windowSize, 4096u);
+    EXPECT_EQ(tracker.analysedHops(), 6u);
+
+    // A threshold above the tone's level releases the note
+    parameters.amplitudeThreshold = 0.9f;
+    store.publish(parameters);
+    events = feed(tracker, samples, hopIndex, 16);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, NoteEvent::Type::NoteOff);
+}
+
+TEST(LiveNoteTrackerTest, PolyphonicModeSendsANoteOnPerVoice) {
+    FftPlanCache cache(PitchDetectorSet::fftSizesFor(PitchDetectorSet::defaultWindowSizes()));
+    cache.start();
+
+    ProcessingParameters parameters;
+    parameters.hopSize = 512;
+    parameters.debounceMs = 0.0;
+    parameters.amplitudeThreshold = 0.02f;
+    parameters.polyphonic = true;
+    parameters.maxVoices = 4;
+    ParameterStore store(parameters);
+    LiveNoteTracker tracker(kSampleRate, store, cache);
+
+    // C major triad: C4, E4, G4
+    std::vector<float> samples(32768, 0.0f);
+    for (double frequency : {261.63, 329.63, 392.0}) {
+        const auto note = ptm::synthetic::tone(frequency, kSampleRate, samples.size(), 0.2f, 4);
+        for (size_t i = 0; i < samples.size(); ++i) samples[i] += note[i];
+    }
+    uint64_t hopIndex = 0;
+    auto events = feed(tracker, samples, hopIndex, 64);
+    ASSERT_EQ(events.size(), 3u);
+    std::vector<int> notes;
+    for (const NoteEvent& event : events) {
+        EXPECT_EQ(event.type, NoteEvent::Type::NoteOn);
+        notes.push_back(event.note);
+    }
+    std::sort(notes.begin(), notes.end());
+    EXPECT_EQ(notes, (std::vector<int>{60, 64, 67}));
+
+    // Back to monophonic releases every voice at the next hop
+    parameters.polyphonic = false;
+    store.publish(parameters);
+    events = feed(tracker, samples, hopIndex, 8);
+    ASSERT_GE(events.size(), 3u);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(events[i].type, NoteEvent::Type::NoteOff);
+    }
+}
+
+TEST(LiveNoteTrackerTest, PolyphonicVoiceLimitFollowsTheControl) {
+    FftPlanCache cache(PitchDetectorSet::fftSizesFor(PitchDetectorSet::defaultWindowSizes()));
+    cache.start();
+
+    ProcessingParameters parameters;
+    parameters.hopSize = 512;
+    parameters.debounceMs = 0.0;
+    parameters.amplitudeThreshold = 0.02f;
+    parameters.polyphonic = true;
+    parameters.maxVoices = 2;
+    ParameterStore store(parameters);
+    LiveNoteTracker tracker(kSampleRate, store, cache);
+
+    std::vector<float> samples(32768, 0.0f);
+    for (double frequency : {261.63, 329.63, 392.0}) {
+        const auto note = ptm::synthetic::tone(frequency, kSampleRate, samples.size(), 0.2f, 4);
+        for (size_t i = 0; i < samples.size(); ++i) samples[i] += note[i];
+    }
+    uint64_t hopIndex = 0;
+    EXPECT_EQ(feed(tracker, samples, hopIndex, 64).size(), 2u);
+}
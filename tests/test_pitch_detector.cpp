@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "dsp/Fft.hpp"
+#include "dsp/PitchDetector.hpp"
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+using ptm::PitchDetector;
+using ptm::PitchDetectorConfig;
+using ptm::PitchDetectorException;
+using ptm::RealFft;
+
+namespace {
+    const double kPi = std::acos(-1.0);
+
+    std::vector<float> tone(double frequency, double sampleRate, size_t count,
+                            int harmonics = 1, float amplitude = 0.5f) {
+        std::vector<float> samples(count, 0.0f);
+        for (int h = 1; h <= harmonics; ++h) {
+            for (size_t i = 0; i < count; ++i) {
+                samples[i] += amplitude / static_cast<float>(h) *
+                    static_cast<float>(std::sin(2.0 * kPi * frequency * h * i / sampleRate));
+            }
+        }
+        return samples;
+    }
+
+    PitchDetectorConfig makeConfig(double sampleRate, size_t windowSize) {
+        PitchDetectorConfig config;
+        config.sampleRate = sampleRate;
+        config.windowSize = windowSize;
+        return config;
+    }
+}
+
+TEST(RealFftTest, ForwardMatchesDirectDft) {
+    const size_t n = 64;
+    RealFft fft(n);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> input(n);
+    for (auto& value : input) value = dist(rng);
+
+    std::copy(input.begin(), input.end(), fft.real());
+    fft.forward();
+
+    for (size_t k = 0; k < fft.bins(); ++k) {
+        std::complex<double> expected = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            expected += input[j] * std::polar(1.0, -2.0 * kPi * k * j / n);
+        }
+        EXPECT_NEAR(fft.spectrum()[k].real(), expected.real(), 1e-9) << "bin " << k;
+        EXPECT_NEAR(fft.spectrum()[k].imag(), expected.imag(), 1e-9) << "bin " << k;
+    }
+}
+
+TEST(RealFftTest, InverseIsScaledBySize) {
+    const size_t n = 256;
+    RealFft fft(n);
+    std::vector<double> input(n);
+    for (size_t i = 0; i < n; ++i) input[i] = std::sin(0.1 * i) + 0.25 * std::cos(0.7 * i);
+
+    std::copy(input.begin(), input.end(), fft.real());
+    fft.forward();
+    fft.inverse();
+
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(fft.real()[i], input[i] * n, 1e-8);
+    }
+}
+
+TEST(RealFftTest, RejectsUnsupportedSizes) {
+    EXPECT_THROW(RealFft(0), std::invalid_argument);
+    EXPECT_THROW(RealFft(2), std::invalid_argument);
+    EXPECT_THROW(RealFft(1000), std::invalid_argument);
+}
+
+TEST(PitchDetectorTest, DifferenceMatchesDirectComputation) {
+    PitchDetector detector(makeConfig(44100.0, 768));
+    auto window = tone(220.0, 44100.0, 768, 4);
+    detector.process(window.data());
+
+    const auto& difference = detector.difference();
+    ASSERT_EQ(difference.size(), 384u);
+    for (size_t tau = 0; tau < difference.size(); ++tau) {
+        double expected = 0.0;
+        for (size_t j = 0; j < 384; ++j) {
+            double delta = window[j] - window[j + tau];
+            expected += delta * delta;
+        }
+        EXPECT_NEAR(difference[tau], expected, 1e-3 + 1e-4 * expected) << "lag " << tau;
+    }
+}
+
+TEST(PitchDetectorTest, DetectsSineWithSubSampleAccuracy) {
+    const double sampleRate = 44100.0;
+    PitchDetector detector(makeConfig(sampleRate, 2048));
+    for (double frequency : {82.41, 196.0, 440.0, 1046.5, 3000.0}) {
+        auto window = tone(frequency, sampleRate, 2048);
+        auto estimate = detector.process(window.data());
+        EXPECT_TRUE(estimate.voiced) << frequency;
+        EXPECT_NEAR(estimate.frequency, frequency, frequency * 0.002) << frequency;
+        EXPECT_GT(estimate.confidence, 0.9f) << frequency;
+    }
+}
+
+TEST(PitchDetectorTest, FindsFundamentalOfHarmonicTone) {
+    const double sampleRate = 96000.0;
+    PitchDetector detector(makeConfig(sampleRate, 4096));
+    auto window = tone(110.0, sampleRate, 4096, 8);
+    auto estimate = detector.process(window.data());
+    EXPECT_TRUE(estimate.voiced);
+    EXPECT_NEAR(estimate.frequency, 110.0, 0.5);
+}
+
+TEST(PitchDetectorTest, SilenceAndNoiseAreUnvoiced) {
+    PitchDetector detector(makeConfig(44100.0, 1024));
+
+    std::vector<float> silence(1024, 0.0f);
+    auto estimate = detector.process(silence.data());
+    EXPECT_FALSE(estimate.voiced);
+    EXPECT_EQ(estimate.frequency, 0.0f);
+    EXPECT_EQ(estimate.confidence, 0.0f);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> noise(1024);
+    for (auto& sample : noise) sample = dist(rng);
+    estimate = detector.process(noise.data());
+    EXPECT_FALSE(estimate.voiced);
+    EXPECT_LT(estimate.confidence, 0.85f);
+}
+
+TEST(PitchDetectorTest, RejectsInvalidConfiguration) {
+    EXPECT_THROW(PitchDetector(makeConfig(44100.0, 32)), PitchDetectorException);
+    EXPECT_THROW(PitchDetector(makeConfig(0.0, 1024)), PitchDetectorException);
+
+    auto config = makeConfig(44100.0, 1024);
+    config.threshold = 1.5f;
+    EXPECT_THROW(PitchDetector{config}, PitchDetectorException);
+
+    config = makeConfig(44100.0, 1024);
+    config.maxFrequency = 30000.0f;
+    EXPECT_THROW(PitchDetector{config}, PitchDetectorException);
+}
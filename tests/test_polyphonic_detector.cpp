@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "dsp/PolyphonicDetector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using ptm::PitchDetectorException;
+using ptm::PolyphonicDetector;
+using ptm::PolyphonicDetectorConfig;
+using ptm::PolyphonicEstimate;
+using ptm::SpectralFrame;
+
+namespace {
+    const double kPi = std::acos(-1.0);
+    constexpr double kSampleRate = 44100.0;
+    constexpr size_t kWindow = 4096;
+
+    double noteFrequency(int note) {
+        return 440.0 * std::pow(2.0, (note - 69) / 12.0);
+    }
+
+    // Notes with six partials each, falling off as 1/h
+    std::vector<float> chord(const std::vector<int>& notes, float amplitude = 0.2f) {
+        std::vector<float> samples(kWindow, 0.0f);
+        for (int note : notes) {
+            const double f0 = noteFrequency(note);
+            for (int h = 1; h <= 6; ++h) {
+                for (size_t i = 0; i < kWindow; ++i) {
+                    samples[i] += amplitude / static_cast<float>(h) *
+                        static_cast<float>(std::sin(2.0 * kPi * f0 * h * i / kSampleRate));
+                }
+            }
+        }
+        return samples;
+    }
+
+    std::vector<int> notesOf(const PolyphonicEstimate& estimate) {
+        std::vector<int> notes;
+        for (size_t v = 0; v < estimate.count; ++v) {
+            notes.push_back(estimate.voices[v].note);
+        }
+        std::sort(notes.begin(), notes.end());
+        return notes;
+    }
+
+    PolyphonicDetectorConfig makeConfig(size_t maxVoices) {
+        PolyphonicDetectorConfig config;
+        config.sampleRate = kSampleRate;
+        config.windowSize = kWindow;
+        config.maxVoices = maxVoices;
+        return config;
+    }
+}
+
+TEST(SpectralFrameTest, PeakGivesSineAmplitude) {
+    SpectralFrame frame(kSampleRate, 3000);
+    EXPECT_EQ(frame.fftSize(), 8192u);
+
+    // A sine centred on a bin
+    const double frequency = 100.0 * frame.binFrequency();
+    std::vector<float> samples(3000);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = 0.4f * static_cast<float>(std::sin(2.0 * kPi * frequency * i / kSampleRate));
+    }
+    frame.compute(samples.data());
+
+    const auto& magnitudes = frame.magnitudes();
+    auto peak = std::max_element(magnitudes.begin(), magnitudes.end());
+    EXPECT_EQ(peak - magnitudes.begin(), 100);
+    EXPECT_NEAR(*peak * frame.amplitudeScale(), 0.4f, 0.01f);
+}
+
+TEST(PolyphonicDetectorTest, FindsEachNoteOfATriad) {
+    PolyphonicDetector detector(makeConfig(6));
+    auto estimate = detector.process(chord({60, 64, 67}).data());
+    EXPECT_EQ(notesOf(estimate), (std::vector<int>{60, 64, 67}));
+
+    for (size_t v = 0; v < estimate.count; ++v) {
+        const auto& voice = estimate.voices[v];
+        EXPECT_NEAR(voice.frequency, noteFrequency(voice.note), noteFrequency(voice.note) * 0.01);
+        EXPECT_GT(voice.level, 0.1f);
+        if (v > 0) {
+            EXPECT_LE(voice.salience, estimate.voices[v - 1].salience);
+        }
+    }
+}
+
+TEST(PolyphonicDetectorTest, KeepsOneVoiceForOneNoteAndNoneForSilence) {
+    PolyphonicDetector detector(makeConfig(6));
+    EXPECT_EQ(notesOf(detector.process(chord({57}).data())), (std::vector<int>{57}));
+
+    // A fifth apart shares every third partial
+    EXPECT_EQ(notesOf(detector.process(chord({60, 67}).data())), (std::vector<int>{60, 67}));
+
+    std::vector<float> silence(kWindow, 0.0f);
+    EXPECT_EQ(detector.process(silence.data()).count, 0u);
+}
+
+TEST(PolyphonicDetectorTest, VoiceCountAndWorkAreBounded) {
+    PolyphonicDetector two(makeConfig(2));
+    auto estimate = two.process(chord({60, 64, 67, 72}).data());
+    EXPECT_EQ(estimate.count, 2u);
+
+    // The bound grows with the voice count, not the signal
+    PolyphonicDetector four(makeConfig(4));
+    EXPECT_EQ(four.binVisitsPerHop(), 2 * two.binVisitsPerHop());
+    EXPECT_EQ(two.processTime().summary().count, 1u);
+}
+
+TEST(PolyphonicDetectorTest, RejectsInvalidConfiguration) {
+    auto config = makeConfig(0);
+    EXPECT_THROW(PolyphonicDetector{config}, PitchDetectorException);
+
+    config = makeConfig(PolyphonicEstimate::kMaxVoices + 1);
+    EXPECT_THROW(PolyphonicDetector{config}, PitchDetectorException);
+
+    config = makeConfig(4);
+    config.maxFrequency = 30000.0f;
+    EXPECT_THROW(PolyphonicDetector{config}, PitchDetectorException);
+
+    config = makeConfig(4);
+    config.windowSize = 128;
+    EXPECT_THROW(PolyphonicDetector{config}, PitchDetectorException);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "midi/PolyphonicNoteTracker.hpp"
+#include <vector>
+
+using ptm::NoteEvent;
+using ptm::NoteTrackerConfig;
+using ptm::PolyphonicEstimate;
+using ptm::PolyphonicNoteTracker;
+
+namespace {
+    // 1 ms per hop at 1 kHz, as in the monophonic tests
+    NoteTrackerConfig makeConfig(double debounceMs) {
+        NoteTrackerConfig config;
+        config.sampleRate = 1000.0;
+        config.debounceMs = debounceMs;
+        config.amplitudeThreshold = 0.1f;
+        return config;
+    }
+
+    PolyphonicEstimate voices(const std::vector<int>& notes, float level = 0.3f) {
+        PolyphonicEstimate estimate;
+        for (int note : notes) {
+            auto& voice = estimate.voices[estimate.count++];
+            voice.note = note;
+            voice.level = level;
+        }
+        return estimate;
+    }
+
+    std::vector<NoteEvent> feed(PolyphonicNoteTracker& tracker, uint64_t& position,
+                                const PolyphonicEstimate& estimate, int hops) {
+        std::vector<NoteEvent> events;
+        for (int i = 0; i < hops; ++i, ++position) {
+            const auto& update = tracker.update(estimate, position);
+            events.insert(events.end(), update.begin(), update.end());
+        }
+        return events;
+    }
+}
+
+TEST(PolyphonicNoteTrackerTest, EachNoteIsItsOwnVoice) {
+    PolyphonicNoteTracker tracker(makeConfig(5.0), 4);
+    uint64_t position = 0;
+
+    auto events = feed(tracker, position, voices({60, 64}), 10);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].type, NoteEvent::Type::NoteOn);
+    EXPECT_EQ(events[0].note, 60);
+    EXPECT_EQ(events[1].note, 64);
+    EXPECT_EQ(events[0].samplePosition, 0u);
+    EXPECT_EQ(tracker.soundingCount(), 2u);
+
+    // A third note joins without disturbing the others
+    events = feed(tracker, position, voices({60, 64, 67}), 10);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].note, 67);
+
+    // One drops out
+    events = feed(tracker, position, voices({60, 67}), 10);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, NoteEvent::Type::NoteOff);
+    EXPECT_EQ(events[0].note, 64);
+
+    EXPECT_EQ(tracker.flush(position).size(), 2u);
+    EXPECT_EQ(tracker.soundingCount(), 0u);
+}
+
+TEST(PolyphonicNoteTrackerTest, FlushReleasesEverything) {
+    PolyphonicNoteTracker tracker(makeConfig(0.0), 4);
+    uint64_t position = 0;
+    feed(tracker, position, voices({48, 55, 64}), 2);
+
+    std::vector<NoteEvent> events = tracker.flush(position);
+    ASSERT_EQ(events.size(), 3u);
+    for (const NoteEvent& event : events) {
+        EXPECT_EQ(event.type, NoteEvent::Type::NoteOff);
+        EXPECT_EQ(event.samplePosition, position);
+    }
+    EXPECT_EQ(tracker.soundingCount(), 0u);
+}
+
+TEST(PolyphonicNoteTrackerTest, NeverExceedsTheVoiceLimit) {
+    PolyphonicNoteTracker tracker(makeConfig(2.0), 2);
+    uint64_t position = 0;
+
+    auto events = feed(tracker, position, voices({60, 64, 67}), 10);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(tracker.soundingCount(), 2u);
+
+    // Releasing one lets the waiting note in, after its own debounce
+    events = feed(tracker, position, voices({64, 67}), 10);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].type, NoteEvent::Type::NoteOff);
+    EXPECT_EQ(events[0].note, 60);
+    EXPECT_EQ(events[1].type, NoteEvent::Type::NoteOn);
+    EXPECT_EQ(events[1].note, 67);
+    EXPECT_EQ(tracker.soundingCount(), 2u);
+}
+
+TEST(PolyphonicNoteTrackerTest, QuietVoicesAndOutOfRangeNotesAreIgnored) {
+    NoteTrackerConfig config = makeConfig(0.0);
+    config.lowestNote = 40;
+    config.highestNote = 80;
+    PolyphonicNoteTracker tracker(config, 4);
+    uint64_t position = 0;
+
+    EXPECT_TRUE(feed(tracker, position, voices({60}, 0.05f), 5).empty());
+    EXPECT_TRUE(feed(tracker, position, voices({30, 100}), 5).empty());
+    EXPECT_THROW(PolyphonicNoteTracker(config, 0), std::invalid_argument);
+}
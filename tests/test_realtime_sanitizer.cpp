@@ -0,0 +1,264 @@
+#include <gtest/gtest.h>
+#include "audio/AudioCapture.hpp"
+#include "audio/ReplaySource.hpp"
+#include "dsp/SyntheticSignal.hpp"
+#include "midi/LiveNoteTracker.hpp"
+#include "midi/MidiOutput.hpp"
+#include "utils/FunctionRef.hpp"
+#include "utils/RealtimeSanitizer.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef PTM_RT_SANITIZER
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#endif
+
+using ptm::AnalysisFrame;
+using ptm::AudioCapture;
+using ptm::FftPlanCache;
+using ptm::FunctionRef;
+using ptm::LiveNoteTracker;
+using ptm::NoteEvent;
+using ptm::ParameterStore;
+using ptm::PitchDetectorSet;
+using ptm::ProcessingParameters;
+using ptm::RealtimeExemption;
+using ptm::RealtimeSanitizer;
+using ptm::RealtimeScope;
+using ptm::ReplayConfig;
+using ptm::SyntheticSource;
+
+namespace {
+    constexpr double kSampleRate = 44100.0;
+
+    // Handler state: the handler runs with checks suspended, but plain
+    // atomics keep it usable from any thread
+    std::atomic<int> reported{0};
+    std::atomic<bool> reportedMalloc{false};
+    std::atomic<bool> reportedMutex{false};
+
+    void countReport(const char* function, void* const*, int frameCount) {
+        reported.fetch_add(1);
+        if (std::strcmp(function, "malloc") == 0) reportedMalloc = true;
+        if (std::strcmp(function, "pthread_mutex_lock") == 0) reportedMutex = true;
+        if (frameCount <= 0) reported.fetch_add(100);  // No stack trace
+    }
+
+    // Through a volatile pointer, so the compiler cannot drop the pair
+    void* (*volatile allocate)(size_t) = std::malloc;
+    void (*volatile release)(void*) = std::free;
+
+    int twice(int value) { return 2 * value; }
+
+    // Counts what MidiOutput's sender thread delivers
+    class CountingPort final : public ptm::MidiPort {
+    public:
+        void send(const uint8_t*, size_t) override { sent.fetch_add(1, std::memory_order_relaxed); }
+        std::string describe() const override { return "counting"; }
+
+        std::atomic<uint64_t> sent{0};
+    };
+}
+
+TEST(FunctionRefTest, CallsWithoutOwning) {
+    int calls = 0;
+    auto add = [&calls](int value) { calls += value; return calls; };
+    FunctionRef<int(int)> ref = add;
+    EXPECT_TRUE(ref);
+    EXPECT_EQ(ref(2), 2);
+    EXPECT_EQ(ref(3), 5);
+    EXPECT_EQ(calls, 5);
+
+    FunctionRef<int(int)> function = twice;
+    EXPECT_EQ(function(4), 8);
+
+    FunctionRef<int(int)> empty;
+    EXPECT_FALSE(empty);
+    EXPECT_FALSE(FunctionRef<int(int)>(nullptr));
+
+    // Temporaries would dangle, so they do not bind
+    static_assert(!std::is_constructible<FunctionRef<int(int)>, decltype(add)&&>::value,
+                  "binds an rvalue callable");
+    static_assert(std::is_constructible<FunctionRef<int(int)>, decltype(add)&>::value,
+                  "does not bind an lvalue callable");
+}
+
+TEST(RealtimeSanitizerTest, ReportsAllocationsAndLocksOnRealtimeThreads) {
+    if (!RealtimeSanitizer::kEnabled) {
+        GTEST_SKIP() << "Configure with -DPTM_RT_SANITIZER=ON";
+    }
+    RealtimeSanitizer::setHandler(countReport);
+    reported = 0;
+    std::mutex mutex;
+
+    // Anything goes outside a scope
+    release(allocate(64));
+    { std::lock_guard<std::mutex> lock(mutex); }
+    EXPECT_EQ(reported.load(), 0);
+    EXPECT_FALSE(RealtimeSanitizer::isRealtimeThread());
+
+    // No gtest assertions inside: a failing one would allocate
+    const uint64_t before = RealtimeSanitizer::violations();
+    bool inScope = false;
+    int reportedBefore = 0;
+    int reportedAfter = 0;
+    {
+        RealtimeScope realtime;
+        inScope = RealtimeSanitizer::isRealtimeThread();
+        void* block = allocate(64);
+        { std::lock_guard<std::mutex> lock(mutex); }
+
+        // ...unless exempted
+        reportedBefore = reported.load();
+        {
+            RealtimeExemption exemption;
+            release(allocate(64));
+            { std::lock_guard<std::mutex> lock(mutex); }
+        }
+        reportedAfter = reported.load();
+        release(block);
+    }
+    EXPECT_TRUE(inScope);
+    EXPECT_EQ(reportedAfter, reportedBefore);
+    EXPECT_FALSE(RealtimeSanitizer::isRealtimeThread());
+    RealtimeSanitizer::setHandler(nullptr);
+
+    EXPECT_TRUE(reportedMalloc.load());
+    EXPECT_TRUE(reportedMutex.load());
+    EXPECT_EQ(reported.load(), 3);  // malloc, the lock and free
+    EXPECT_EQ(RealtimeSanitizer::violations() - before, 3u);
+}
+
+#ifdef PTM_RT_SANITIZER
+// The clock-selecting and timed variants block just the same
+TEST(RealtimeSanitizerTest, ReportsTimedWaits) {
+    RealtimeSanitizer::setHandler(countReport);
+    reported = 0;
+
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_t held = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t condition = PTHREAD_COND_INITIALIZER;
+    sem_t semaphore;
+    sem_init(&semaphore, 0, 1);
+    pthread_mutex_lock(&held);
+    timespec past{};  // Every deadline has passed, so nothing waits
+    const timespec zero{};
+
+    int results[5] = {};
+    {
+        RealtimeScope realtime;
+        results[0] = pthread_mutex_timedlock(&mutex, &past);
+        pthread_mutex_unlock(&mutex);
+        results[1] = pthread_mutex_clocklock(&mutex, CLOCK_MONOTONIC, &past);
+        pthread_mutex_unlock(&mutex);
+        results[2] = pthread_cond_clockwait(&condition, &held, CLOCK_MONOTONIC, &past);
+        results[3] = sem_clockwait(&semaphore, CLOCK_MONOTONIC, &past);
+        results[4] = clock_nanosleep(CLOCK_MONOTONIC, 0, &zero, nullptr);
+    }
+    RealtimeSanitizer::setHandler(nullptr);
+    pthread_mutex_unlock(&held);
+    sem_destroy(&semaphore);
+
+    EXPECT_EQ(results[0], 0);
+    EXPECT_EQ(results[1], 0);
+    EXPECT_EQ(results[2], ETIMEDOUT);
+    EXPECT_EQ(results[3], 0);
+    EXPECT_EQ(results[4], 0);
+    EXPECT_EQ(reported.load(), 5);
+}
+#endif
+
+// Synthetic notes through capture, the analysis worker and a live tracker
+// whose controls move while it runs; in a sanitizer build, nothing on the
+// audio or analysis thread may allocate, lock or block
+TEST(RealtimeSanitizerTest, FullPipelineIsRealtimeSafe) {
+    FftPlanCache cache(PitchDetectorSet::fftSizesFor(PitchDetectorSet::defaultWindowSizes()));
+    cache.start();
+
+    ProcessingParameters parameters;
+    parameters.hopSize = 256;
+    parameters.debounceMs = 0.0;
+    ParameterStore store(parameters);
+    LiveNoteTracker tracker(kSampleRate, store, cache);
+    ptm::NoteTelemetryChannel telemetry;
+    tracker.setTelemetry(&telemetry);
+
+    // A4, E5 and A3, a quarter second each with gaps, four times over
+    std::vector<float> samples;
+    for (int repeat = 0; repeat < 4; ++repeat) {
+        for (double frequency : {440.0, 659.26, 220.0}) {
+            auto note = ptm::synthetic::tone(frequency, kSampleRate, 11025, 0.5f, 3);
+            samples.insert(samples.end(), note.begin(), note.end());
+            samples.insert(samples.end(), 4410, 0.0f);
+        }
+    }
+
+    std::atomic<uint64_t> noteOns{0};
+    AudioCapture capture;
+    ptm::LatencyMonitor& latency = capture.getLatencyMonitor();
+    tracker.setLatencyMonitor(&latency);
+    CountingPort port;
+    ptm::MidiOutput output(port, ptm::MidiOutput::kDefaultQueueSize, &latency);
+    output.start();
+    capture.setAnalysisCallback(LiveNoteTracker::analysisConfig(), [&](const AnalysisFrame& frame) {
+        const auto update = tracker.process(frame);
+        for (size_t i = 0; i < update.count; ++i) {
+            if (update.events[i].type == NoteEvent::Type::NoteOn) {
+                noteOns.fetch_add(1, std::memory_order_relaxed);
+            }
+            output.post(ptm::MidiMessage::fromNoteEvent(0, update.events[i]), update.latency);
+        }
+    });
+
+    std::atomic<uint64_t> capturedFrames{0};
+    auto count = [&capturedFrames](const float*, unsigned long frames) {
+        capturedFrames.fetch_add(frames, std::memory_order_relaxed);
+    };
+
+    const uint64_t before = RealtimeSanitizer::violations();
+    ReplayConfig replay;
+    replay.speed = 0.0;  // Waits for the analysis worker, so no hop is missed
+    capture.start(std::make_unique<SyntheticSource>(kSampleRate, samples, replay), count);
+
+    // Move the controls the whole time
+    const size_t windows[] = {1024, 2048, 4096, 3072};
+    const size_t hops[] = {64, 256, 512, 128};
+    size_t step = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (capture.isActive() && std::chrono::steady_clock::now() < deadline) {
+        parameters.windowSize = windows[step % 4];
+        parameters.hopSize = hops[step % 4];
+        parameters.debounceMs = static_cast<double>(step % 3);
+        parameters.polyphonic = step % 5 >= 3;
+        parameters.maxVoices = 1 + step % ProcessingParameters::kMaxVoices;
+        store.publish(parameters);
+        ++step;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    capture.stop();
+    output.stop();
+
+    EXPECT_EQ(RealtimeSanitizer::violations() - before, 0u);
+    EXPECT_EQ(capturedFrames.load(), samples.size());
+    EXPECT_EQ(capture.getMissedHops(), 0u);
+    EXPECT_GT(tracker.analysedHops(), 0u);
+    EXPECT_GT(noteOns.load(), 0u);
+    EXPECT_EQ(telemetry.load().hop, tracker.analysedHops());
+
+    // Every stage, from capture to the MIDI send, was stamped
+    EXPECT_EQ(port.sent.load(), output.sentMessages());
+    EXPECT_GT(output.sentMessages(), 0u);
+    for (auto stage : {ptm::LatencyStage::Capture, ptm::LatencyStage::Queue,
+                       ptm::LatencyStage::Detection, ptm::LatencyStage::Output,
+                       ptm::LatencyStage::Total}) {
+        EXPECT_GT(latency.summary(stage).count, 0u) << ptm::toString(stage);
+    }
+    EXPECT_EQ(latency.summary(ptm::LatencyStage::Detection).count, tracker.analysedHops());
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include "audio/ReplaySource.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ptm::AudioBlockInfo;
+using ptm::ReplayConfig;
+using ptm::SinkStatus;
+using ptm::SyntheticSource;
+using ptm::WavFileSource;
+
+namespace {
+    // Records every block; optionally stops after a number of frames
+    class RecordingSink : public ptm::AudioSink {
+    public:
+        SinkStatus processBlock(const float* samples, size_t frames,
+                                const AudioBlockInfo& info) override {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->samples.insert(this->samples.end(), samples, samples + frames);
+            blocks.push_back(info);
+            return this->samples.size() >= stopAfter ? SinkStatus::Complete : SinkStatus::Continue;
+        }
+
+        bool hasRoomFor(size_t) const override { return room.load(); }
+
+        std::mutex mutex;
+        std::vector<float> samples;
+        std::vector<AudioBlockInfo> blocks;
+        size_t stopAfter = SIZE_MAX;
+        std::atomic<bool> room{true};
+    };
+
+    template<typename Predicate>
+    bool eventually(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::seconds(2)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    std::vector<float> ramp(size_t count) {
+        std::vector<float> samples(count);
+        std::iota(samples.begin(), samples.end(), 0.0f);
+        return samples;
+    }
+}
+
+TEST(ReplaySourceTest, UnpacedReplayDeliversEverySampleOnASimulatedClock) {
+    ReplayConfig config;
+    config.framesPerBuffer = 100;
+    config.speed = 0.0;
+    SyntheticSource source(1000.0, ramp(1050), config);
+    RecordingSink sink;
+
+    source.start(sink);
+    ASSERT_TRUE(eventually([&] { return !source.isActive(); }));
+    source.stop();
+
+    EXPECT_EQ(sink.samples, ramp(1050));
+    EXPECT_EQ(source.framesDelivered(), 1050u);
+    ASSERT_EQ(sink.blocks.size(), 11u);
+    for (size_t b = 0; b < sink.blocks.size(); ++b) {
+        EXPECT_DOUBLE_EQ(sink.blocks[b].adcTime, b * 0.1);
+        EXPECT_EQ(sink.blocks[b].statusFlags, 0u);
+    }
+    // The short last block is delivered when its last frame is "digitised"
+    EXPECT_DOUBLE_EQ(sink.blocks.back().currentTime, 1.05);
+}
+
+TEST(ReplaySourceTest, PacesToTheRequestedSpeed) {
+    ReplayConfig config;
+    config.framesPerBuffer = 480;
+    config.speed = 2.0;
+    SyntheticSource source(48000.0, std::vector<float>(24000, 0.0f), config);  // 0.5 s
+    RecordingSink sink;
+
+    auto start = std::chrono::steady_clock::now();
+    source.start(sink);
+    ASSERT_TRUE(eventually([&] { return !source.isActive(); }));
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    source.stop();
+
+    EXPECT_EQ(source.framesDelivered(), 24000u);
+    EXPECT_GE(elapsed, 0.24);
+    EXPECT_LT(elapsed, 1.0);
+}
+
+TEST(ReplaySourceTest, UnpacedReplayWaitsForTheSink) {
+    ReplayConfig config;
+    config.framesPerBuffer = 64;
+    config.speed = 0.0;
+    SyntheticSource source(48000.0, ramp(640), config);
+    RecordingSink sink;
+    sink.room = false;
+
+    source.start(sink);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(source.framesDelivered(), 0u);
+    EXPECT_TRUE(source.isActive());
+
+    sink.room = true;
+    ASSERT_TRUE(eventually([&] { return !source.isActive(); }));
+    source.stop();
+    EXPECT_EQ(sink.samples, ramp(640));
+}
+
+TEST(ReplaySourceTest, LoopsAndStopsOnRequest) {
+    ReplayConfig config;
+    config.framesPerBuffer = 30;
+    config.speed = 0.0;
+    config.loop = true;
+    SyntheticSource source(8000.0, ramp(50), config);
+    RecordingSink sink;
+    sink.stopAfter = 200;
+
+    source.start(sink);
+    ASSERT_TRUE(eventually([&] { return !source.isActive(); }));
+    source.stop();
+
+    // Blocks end at the loop point rather than spanning it
+    ASSERT_GE(sink.samples.size(), 200u);
+    for (size_t i = 0; i < sink.samples.size(); ++i) {
+        EXPECT_EQ(sink.samples[i], static_cast<float>(i % 50)) << i;
+    }
+    // The clock keeps running across loops
+    EXPECT_DOUBLE_EQ(sink.blocks[2].adcTime, 50.0 / 8000.0);
+
+    // A generator never ends; stop() must still return
+    SyntheticSource endless(8000.0, [](uint64_t position, float* out, size_t frames) {
+        for (size_t i = 0; i < frames; ++i) out[i] = static_cast<float>(position + i);
+    }, config);
+    RecordingSink endlessSink;
+    endless.start(endlessSink);
+    ASSERT_TRUE(eventually([&] { return endless.framesDelivered() > 1000; }));
+    endless.stop();
+    EXPECT_FALSE(endless.isActive());
+}
+
+TEST(ReplaySourceTest, ReplaysAWavFile) {
+    std::vector<int16_t> pcm(3000);
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<int16_t>(i * 10);
+    }
+
+    auto put32 = [](std::ofstream& out, uint32_t value) {
+        out.write(reinterpret_cast<const char*>(&value), 4);
+    };
+    auto put16 = [](std::ofstream& out, uint16_t value) {
+        out.write(reinterpret_cast<const char*>(&value), 2);
+    };
+    std::string path = (std::filesystem::temp_directory_path() / "ptm_replay_source.wav").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        uint32_t dataBytes = static_cast<uint32_t>(pcm.size() * 2);
+        out.write("RIFF", 4);
+        put32(out, 36 + dataBytes);
+        out.write("WAVEfmt ", 8);
+        put32(out, 16);
+        put16(out, 1);
+        put16(out, 1);
+        put32(out, 16000);
+        put32(out, 32000);
+        put16(out, 2);
+        put16(out, 16);
+        out.write("data", 4);
+        put32(out, dataBytes);
+        out.write(reinterpret_cast<const char*>(pcm.data()), dataBytes);
+    }
+
+    ReplayConfig config;
+    config.speed = 0.0;
+    {
+        WavFileSource source(path, config);
+        EXPECT_DOUBLE_EQ(source.sampleRate(), 16000.0);
+        RecordingSink sink;
+        source.start(sink);
+        ASSERT_TRUE(eventually([&] { return !source.isActive(); }));
+        source.stop();
+
+        std::vector<float> expected(pcm.size());
+        source.file().readFrames(0, expected.size(), expected.data());
+        EXPECT_EQ(sink.samples, expected);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ReplaySourceTest, RejectsInvalidConfiguration) {
+    ReplayConfig zeroBlock;
+    zeroBlock.framesPerBuffer = 0;
+    EXPECT_THROW(SyntheticSource(48000.0, ramp(10), zeroBlock), std::invalid_argument);
+
+    ReplayConfig negative;
+    negative.speed = -1.0;
+    EXPECT_THROW(SyntheticSource(48000.0, ramp(10), negative), std::invalid_argument);
+
+    EXPECT_THROW(SyntheticSource(0.0, ramp(10)), std::invalid_argument);
+    EXPECT_THROW(SyntheticSource(48000.0, ptm::SignalGenerator{}), std::invalid_argument);
+    EXPECT_THROW(WavFileSource("/nonexistent/ptm.wav"), ptm::WavFileException);
+}
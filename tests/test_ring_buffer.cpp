@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "audio/RingBuffer.hpp"
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using ptm::OverflowPolicy;
+using ptm::RingBuffer;
+
+namespace {
+    std::vector<float> ramp(size_t count, float start = 0.0f) {
+        std::vector<float> values(count);
+        std::iota(values.begin(), values.end(), start);
+        return values;
+    }
+}
+
+TEST(RingBufferTest, RoundsCapacityUpToPowerOfTwo) {
+    RingBuffer<float> buffer(1000);
+    EXPECT_EQ(buffer.capacity(), 1024u);
+    EXPECT_EQ(buffer.available(), 0u);
+    EXPECT_EQ(buffer.free(), 1024u);
+}
+
+TEST(RingBufferTest, WrapsAroundPreservingOrder) {
+    RingBuffer<float> buffer(8);
+    std::vector<float> out(8);
+
+    auto first = ramp(6);
+    ASSERT_EQ(buffer.write(first.data(), first.size()), 6u);
+    ASSERT_EQ(buffer.read(out.data(), 4), 4u);
+
+    auto second = ramp(6, 6.0f);
+    ASSERT_EQ(buffer.write(second.data(), second.size()), 6u);
+    ASSERT_EQ(buffer.available(), 8u);
+    ASSERT_EQ(buffer.read(out.data(), 8), 8u);
+    for (size_t i = 0; i < 8; ++i) {
+        EXPECT_FLOAT_EQ(out[i], static_cast<float>(i + 4));
+    }
+}
+
+TEST(RingBufferTest, DropNewestTruncatesIncomingBlock) {
+    RingBuffer<float> buffer(8, OverflowPolicy::DropNewest);
+    auto data = ramp(12);
+    EXPECT_EQ(buffer.write(data.data(), data.size()), 8u);
+    EXPECT_EQ(buffer.overflowCount(), 4u);
+
+    std::vector<float> out(8);
+    ASSERT_EQ(buffer.read(out.data(), 8), 8u);
+    EXPECT_FLOAT_EQ(out.front(), 0.0f);
+    EXPECT_FLOAT_EQ(out.back(), 7.0f);
+}
+
+TEST(RingBufferTest, DropOldestKeepsFreshestSamples) {
+    RingBuffer<float> buffer(8, OverflowPolicy::DropOldest);
+    auto first = ramp(6);
+    auto second = ramp(6, 6.0f);
+    buffer.write(first.data(), first.size());
+    EXPECT_EQ(buffer.write(second.data(), second.size()), 6u);
+    EXPECT_EQ(buffer.overflowCount(), 4u);
+
+    std::vector<float> out(8);
+    ASSERT_EQ(buffer.read(out.data(), 8), 8u);
+    EXPECT_FLOAT_EQ(out.front(), 4.0f);
+    EXPECT_FLOAT_EQ(out.back(), 11.0f);
+}
+
+TEST(RingBufferTest, OverwriteCountsLappedSamplesOnRead) {
+    RingBuffer<float> buffer(8, OverflowPolicy::Overwrite);
+    auto data = ramp(20);
+    buffer.write(data.data(), 10);
+    buffer.write(data.data() + 10, 10);
+
+    std::vector<float> out(8);
+    ASSERT_EQ(buffer.read(out.data(), 8), 8u);
+    EXPECT_FLOAT_EQ(out.front(), 12.0f);
+    EXPECT_FLOAT_EQ(out.back(), 19.0f);
+    EXPECT_EQ(buffer.overflowCount(), 12u);
+}
+
+TEST(RingBufferTest, ClearDiscardsUnreadData) {
+    RingBuffer<float> buffer(16);
+    auto data = ramp(10);
+    buffer.write(data.data(), data.size());
+    buffer.clear();
+    EXPECT_EQ(buffer.available(), 0u);
+
+    std::vector<float> out(4);
+    EXPECT_EQ(buffer.read(out.data(), out.size()), 0u);
+
+    buffer.write(data.data(), 4);
+    ASSERT_EQ(buffer.read(out.data(), 4), 4u);
+    EXPECT_FLOAT_EQ(out[0], 0.0f);
+}
+
+TEST(RingBufferTest, ConcurrentTransferIsLossless) {
+    constexpr size_t kTotal = 1 << 18;
+    constexpr size_t kBlock = 64;
+    RingBuffer<float> buffer(1024, OverflowPolicy::DropNewest);
+
+    std::thread producer([&buffer] {
+        std::vector<float> block(kBlock);
+        size_t next = 0;
+        while (next < kTotal) {
+            for (size_t i = 0; i < kBlock; ++i) {
+                block[i] = static_cast<float>((next + i) % 4096);
+            }
+            size_t written = 0;
+            while (written < kBlock) {
+                written += buffer.write(block.data() + written, kBlock - written);
+                if (written < kBlock) std::this_thread::yield();
+            }
+            next += kBlock;
+        }
+    });
+
+    std::vector<float> block(kBlock);
+    size_t received = 0;
+    bool ordered = true;
+    while (received < kTotal) {
+        size_t count = buffer.read(block.data(), block.size());
+        for (size_t i = 0; i < count; ++i) {
+            ordered &= block[i] == static_cast<float>((received + i) % 4096);
+        }
+        received += count;
+        if (count == 0) std::this_thread::yield();
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+}
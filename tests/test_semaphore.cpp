@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "utils/Semaphore.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using ptm::Semaphore;
+
+TEST(SemaphoreTest, CountsPermits) {
+    Semaphore semaphore(2);
+    EXPECT_TRUE(semaphore.tryWait());
+    EXPECT_TRUE(semaphore.tryWait());
+    EXPECT_FALSE(semaphore.tryWait());
+
+    semaphore.post(3);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(semaphore.tryWait());
+    }
+    EXPECT_FALSE(semaphore.tryWait());
+}
+
+TEST(SemaphoreTest, WaitForTimesOutWithoutPermit) {
+    Semaphore semaphore;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(semaphore.waitFor(std::chrono::milliseconds(20)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST(SemaphoreTest, EveryPostWakesOneWait) {
+    const int posts = 20000;
+    Semaphore semaphore;
+    std::atomic<int> received{0};
+
+    std::thread consumer([&] {
+        for (int i = 0; i < posts; ++i) {
+            semaphore.wait();
+            received.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    for (int i = 0; i < posts; ++i) {
+        semaphore.post();
+        if (i % 1000 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    consumer.join();
+
+    EXPECT_EQ(received.load(), posts);
+    EXPECT_FALSE(semaphore.tryWait());
+}
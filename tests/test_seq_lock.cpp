@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "utils/SeqLock.hpp"
+#include <atomic>
+#include <thread>
+
+using ptm::SeqLock;
+
+namespace {
+    // Larger than a word, with fields that must always agree
+    struct Payload {
+        uint64_t a;
+        uint64_t b;
+        double c;
+        uint32_t d;
+    };
+}
+
+TEST(SeqLockTest, StoresAndLoadsAValue) {
+    SeqLock<Payload> lock;
+    Payload initial = lock.load();
+    EXPECT_EQ(initial.a, 0u);
+    EXPECT_EQ(initial.d, 0u);
+
+    lock.store(Payload{1, 2, 3.5, 4});
+    Payload value = lock.load();
+    EXPECT_EQ(value.a, 1u);
+    EXPECT_EQ(value.b, 2u);
+    EXPECT_DOUBLE_EQ(value.c, 3.5);
+    EXPECT_EQ(value.d, 4u);
+}
+
+TEST(SeqLockTest, ReadersNeverSeeATornValue) {
+    SeqLock<Payload> lock;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (uint64_t i = 1; i <= 500000; ++i) {
+            lock.store(Payload{i, i * 3, static_cast<double>(i) / 2.0, static_cast<uint32_t>(i)});
+        }
+        done = true;
+    });
+
+    uint64_t previous = 0;
+    while (!done.load()) {
+        const Payload value = lock.load();
+        ASSERT_EQ(value.b, value.a * 3);
+        ASSERT_DOUBLE_EQ(value.c, static_cast<double>(value.a) / 2.0);
+        ASSERT_EQ(value.d, static_cast<uint32_t>(value.a));
+        ASSERT_GE(value.a, previous);
+        previous = value.a;
+    }
+    writer.join();
+
+    EXPECT_EQ(lock.load().a, 500000u);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "audio/StreamStats.hpp"
+#include <atomic>
+#include <thread>
+
+using ptm::StreamStats;
+using ptm::StreamStatsSnapshot;
+
+namespace {
+    constexpr double kSampleRate = 48000.0;
+    constexpr size_t kFrames = 480;               // 10 ms buffers
+    constexpr int64_t kPeriodNs = 10'000'000;
+}
+
+TEST(StreamStatsTest, CountsPerWindowAndInTotal) {
+    StreamStats stats(std::chrono::milliseconds(100));
+    stats.begin(kSampleRate);
+
+    // 25 callbacks 10 ms apart, taking 1 ms each; two xruns early on
+    for (int64_t i = 0; i < 25; ++i) {
+        const int64_t start = 1'000'000'000 + i * kPeriodNs;
+        if (i == 2) {
+            EXPECT_EQ(stats.addUnderrun(), 1u);
+            EXPECT_EQ(stats.addOverrun(), 1u);
+        }
+        if (i == 3) {
+            EXPECT_EQ(stats.addRingOverflow(100), 1u);
+        }
+        stats.endCallback(start, start + 1'000'000, 0.004, kFrames);
+    }
+
+    StreamStatsSnapshot snapshot = stats.snapshot();
+    EXPECT_EQ(snapshot.total.callbacks, 25u);
+    EXPECT_EQ(snapshot.total.frames, 25u * kFrames);
+    EXPECT_NEAR(snapshot.total.seconds, 0.25, 1e-9);
+    EXPECT_EQ(snapshot.total.underruns, 1u);
+    EXPECT_EQ(snapshot.total.overruns, 1u);
+    EXPECT_EQ(snapshot.total.ringOverflows, 1u);
+    EXPECT_EQ(snapshot.total.droppedSamples, 100u);
+    EXPECT_NEAR(snapshot.total.maxLoad, 0.1, 1e-9);
+    EXPECT_DOUBLE_EQ(snapshot.currentLatency, 0.004);
+    EXPECT_EQ(snapshot.lastCallbackNs, 1'000'000'000 + 24 * kPeriodNs + 1'000'000);
+
+    // Windows of ten callbacks: the xruns fell in the first, which is no
+    // longer the most recent
+    EXPECT_EQ(snapshot.recent.callbacks, 10u);
+    EXPECT_EQ(snapshot.recent.underruns, 0u);
+    EXPECT_EQ(snapshot.recent.overruns, 0u);
+
+    EXPECT_EQ(snapshot.callbackDuration.count, 25u);
+    EXPECT_GE(snapshot.callbackDuration.p50Ns, 1'000'000);
+    EXPECT_LE(snapshot.callbackDuration.p50Ns, 1'000'000 * 17 / 16);
+    EXPECT_EQ(snapshot.latency.maxNs, 4'000'000);
+
+    // A new stream starts from zero
+    stats.begin(kSampleRate);
+    snapshot = stats.snapshot();
+    EXPECT_EQ(snapshot.total.callbacks, 0u);
+    EXPECT_EQ(snapshot.lastCallbackNs, 0);
+    EXPECT_EQ(snapshot.callbackDuration.count, 0u);
+}
+
+TEST(StreamStatsTest, RecentWindowReflectsNewTrouble) {
+    StreamStats stats(std::chrono::milliseconds(50));
+    stats.begin(kSampleRate);
+
+    int64_t start = 0;
+    auto callback = [&](int64_t durationNs) {
+        start += kPeriodNs;
+        stats.endCallback(start, start + durationNs, 0.002, kFrames);
+    };
+
+    for (int i = 0; i < 10; ++i) callback(500'000);
+    EXPECT_LT(stats.snapshot().recent.maxLoad, 0.1);
+
+    // One callback longer than its 10 ms period, then a window later it is
+    // the most recent complete window
+    callback(12'000'000);
+    for (int i = 0; i < 5; ++i) callback(500'000);
+    EXPECT_GT(stats.snapshot().recent.maxLoad, 1.0);
+
+    for (int i = 0; i < 10; ++i) callback(500'000);
+    EXPECT_LT(stats.snapshot().recent.maxLoad, 0.1);
+    EXPECT_GT(stats.snapshot().total.maxLoad, 1.0);
+}
+
+TEST(StreamStatsTest, SnapshotsAreConsistentWhileTheAudioThreadWrites) {
+    StreamStats stats(std::chrono::milliseconds(10));
+    stats.begin(kSampleRate);
+
+    std::atomic<bool> done{false};
+    std::thread audio([&] {
+        for (int64_t i = 1; i <= 200000; ++i) {
+            stats.addUnderrun();
+            stats.endCallback(i * kPeriodNs, i * kPeriodNs + 1000, 0.001, kFrames);
+        }
+        done = true;
+    });
+
+    // Every published set must belong to a single callback
+    uint64_t checked = 0;
+    while (!done.load()) {
+        const StreamStatsSnapshot snapshot = stats.snapshot();
+        ASSERT_EQ(snapshot.total.frames, snapshot.total.callbacks * kFrames);
+        ASSERT_EQ(snapshot.total.underruns, snapshot.total.callbacks);
+        if (snapshot.total.callbacks > 0) {
+            ASSERT_EQ(snapshot.lastCallbackNs,
+                      static_cast<int64_t>(snapshot.total.callbacks) * kPeriodNs + 1000);
+        }
+        ASSERT_EQ(snapshot.recent.underruns, snapshot.recent.callbacks);
+        ++checked;
+    }
+    audio.join();
+
+    EXPECT_GT(checked, 0u);
+    EXPECT_EQ(stats.snapshot().total.callbacks, 200000u);
+}
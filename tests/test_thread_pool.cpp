@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "utils/ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using ptm::ThreadPool;
+
+namespace {
+    template<typename Predicate>
+    bool eventually(Predicate predicate) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST(ThreadPoolTest, RunsEachScheduledTask) {
+    ThreadPool pool(2);
+    std::vector<std::atomic<int>> runs(4);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        EXPECT_EQ(pool.addTask([&runs, i] { ++runs[i]; }), i);
+    }
+    pool.start();
+    EXPECT_THROW(pool.addTask([] {}), std::logic_error);
+
+    pool.schedule(1);
+    pool.schedule(3);
+    ASSERT_TRUE(eventually([&] { return runs[1] == 1 && runs[3] == 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(runs[0].load(), 0);
+    EXPECT_EQ(runs[2].load(), 0);
+    pool.stop();
+    EXPECT_FALSE(pool.isRunning());
+}
+
+TEST(ThreadPoolTest, TaskNeverOverlapsItselfAndMissesNoSchedule) {
+    ThreadPool pool(4);
+    std::atomic<int> inside{0};
+    std::atomic<bool> overlapped{false};
+    std::atomic<int> pending{0};
+    std::atomic<int> handled{0};
+
+    pool.addTask([&] {
+        if (inside.fetch_add(1) != 0) overlapped = true;
+        handled += pending.exchange(0);
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        inside.fetch_sub(1);
+    });
+    pool.start();
+
+    // Work posted before schedule() is always picked up by some run
+    const int posts = 5000;
+    for (int i = 0; i < posts; ++i) {
+        pending.fetch_add(1);
+        pool.schedule(0);
+    }
+    EXPECT_TRUE(eventually([&] { return handled.load() == posts; }));
+    pool.stop();
+    EXPECT_FALSE(overlapped.load());
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "midi/Transcriber.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using ptm::MappedWavFile;
+using ptm::NoteEvent;
+using ptm::TranscriberConfig;
+
+namespace {
+    const double kPi = std::acos(-1.0);
+
+    struct Segment {
+        double frequency;  // 0 for silence
+        double seconds;
+    };
+
+    // 16-bit mono WAV of harmonic tones separated as given
+    std::string writeMelody(const std::string& name, double sampleRate,
+                            const std::vector<Segment>& segments) {
+        std::vector<int16_t> samples;
+        for (const Segment& segment : segments) {
+            size_t count = static_cast<size_t>(segment.seconds * sampleRate);
+            for (size_t i = 0; i < count; ++i) {
+                double t = static_cast<double>(i) / sampleRate;
+                double value = segment.frequency > 0.0
+                    ? 0.4 * std::sin(2.0 * kPi * segment.frequency * t) +
+                      0.2 * std::sin(4.0 * kPi * segment.frequency * t)
+                    : 0.0;
+                samples.push_back(static_cast<int16_t>(value * 32767.0));
+            }
+        }
+
+        auto put32 = [](std::ofstream& out, uint32_t value) {
+            out.write(reinterpret_cast<const char*>(&value), 4);
+        };
+        auto put16 = [](std::ofstream& out, uint16_t value) {
+            out.write(reinterpret_cast<const char*>(&value), 2);
+        };
+
+        std::string path = (std::filesystem::temp_directory_path() / name).string();
+        std::ofstream out(path, std::ios::binary);
+        uint32_t dataBytes = static_cast<uint32_t>(samples.size() * 2);
+        out.write("RIFF", 4);
+        put32(out, 36 + dataBytes);
+        out.write("WAVEfmt ", 8);
+        put32(out, 16);
+        put16(out, 1);
+        put16(out, 1);
+        put32(out, static_cast<uint32_t>(sampleRate));
+        put32(out, static_cast<uint32_t>(sampleRate) * 2);
+        put16(out, 2);
+        put16(out, 16);
+        out.write("data", 4);
+        put32(out, dataBytes);
+        out.write(reinterpret_cast<const char*>(samples.data()), dataBytes);
+        return path;
+    }
+}
+
+TEST(TranscriberTest, TranscribesAMelody) {
+    const double sampleRate = 22050.0;
+    std::string path = writeMelody("ptm_transcriber_melody.wav", sampleRate, {
+        {0.0, 0.2}, {261.63, 0.4}, {329.63, 0.4}, {0.0, 0.3}, {392.00, 0.5}, {0.0, 0.2}
+    });
+
+    MappedWavFile file(path);
+    TranscriberConfig config;
+    config.pitch.windowSize = 1024;
+    config.pitch.hopSize = 256;
+    config.blockFrames = 4096;  // Several refills over the file
+    auto result = ptm::transcribe(file, config);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(result.frames, file.frames());
+    EXPECT_EQ(result.hops, (file.frames() - 1024) / 256 + 1);
+
+    std::vector<int> notesOn;
+    std::vector<double> onsets;
+    int noteOffs = 0;
+    for (const NoteEvent& event : result.events) {
+        if (event.type == NoteEvent::Type::NoteOn) {
+            notesOn.push_back(event.note);
+            onsets.push_back(static_cast<double>(event.samplePosition) / sampleRate);
+        } else {
+            ++noteOffs;
+        }
+    }
+    ASSERT_EQ(notesOn, (std::vector<int>{60, 64, 67}));
+    EXPECT_EQ(noteOffs, 3);
+
+    // Within a window of the true onsets
+    const double tolerance = 1024.0 / sampleRate;
+    EXPECT_NEAR(onsets[0], 0.2, tolerance);
+    EXPECT_NEAR(onsets[1], 0.6, tolerance);
+    EXPECT_NEAR(onsets[2], 1.3, tolerance);
+}
+
+TEST(TranscriberTest, OutputDoesNotDependOnThreadCount) {
+    const double sampleRate = 16000.0;
+    std::vector<Segment> melody;
+    const double frequencies[] = {196.0, 220.0, 246.94, 261.63, 293.66, 0.0, 329.63};
+    for (int i = 0; i < 30; ++i) {
+        melody.push_back({frequencies[i % 7], 0.09 + 0.02 * (i % 5)});
+    }
+    std::string path = writeMelody("ptm_transcriber_threads.wav", sampleRate, melody);
+    MappedWavFile file(path);
+
+    TranscriberConfig config;
+    config.pitch.windowSize = 512;
+    config.pitch.hopSize = 64;
+    config.chunkHops = 1;  // Rounded up to one resync period: many chunk boundaries
+    config.threads = 1;
+    auto reference = ptm::transcribe(file, config);
+    ASSERT_GT(reference.chunks, 10u);
+    ASSERT_GT(reference.events.size(), 40u);
+
+    // A single continuous detector and tracker, as the live path runs them
+    ptm::PitchDetectorConfig pitch = config.pitch;
+    pitch.sampleRate = sampleRate;
+    ptm::PitchDetector detector(pitch);
+    ptm::NoteTrackerConfig notes = config.notes;
+    notes.sampleRate = sampleRate;
+    ptm::NoteTracker tracker(notes);
+    std::vector<float> samples(file.frames());
+    file.readFrames(0, samples.size(), samples.data());
+    std::vector<NoteEvent> continuous;
+    auto append = [&](const ptm::NoteUpdate& update) {
+        continuous.insert(continuous.end(), update.events.begin(), update.events.begin() + update.count);
+    };
+    for (size_t position = 0; position + 512 <= samples.size(); position += 64) {
+        const float* window = samples.data() + position;
+        float sum = 0.0f;
+        for (size_t i = 0; i < 512; ++i) sum += window[i] * window[i];
+        append(tracker.update(detector.process(window), std::sqrt(sum / 512.0f), position + 256));
+    }
+    append(tracker.flush(file.frames()));
+
+    auto sameEvents = [](const std::vector<NoteEvent>& a, const std::vector<NoteEvent>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].type != b[i].type || a[i].note != b[i].note ||
+                a[i].velocity != b[i].velocity || a[i].samplePosition != b[i].samplePosition) {
+                return false;
+            }
+        }
+        return true;
+    };
+    EXPECT_TRUE(sameEvents(reference.events, continuous));
+
+    for (unsigned threads : {2u, 3u, 8u}) {
+        config.threads = threads;
+        auto parallel = ptm::transcribe(file, config);
+        EXPECT_EQ(parallel.threads, threads);
+        EXPECT_TRUE(sameEvents(parallel.events, reference.events)) << threads << " threads";
+    }
+    std::remove(path.c_str());
+}
+
+TEST(TranscriberTest, RequiresAHopSize) {
+    std::string path = writeMelody("ptm_transcriber_hop.wav", 8000.0, {{440.0, 0.5}});
+    MappedWavFile file(path);
+    TranscriberConfig config;
+    config.pitch.hopSize = 0;
+    EXPECT_THROW(ptm::transcribe(file, config), std::invalid_argument);
+
+    // Low sample rate: the pitch range is narrowed below Nyquist
+    config.pitch.hopSize = 256;
+    auto result = ptm::transcribe(file, config);
+    std::remove(path.c_str());
+    ASSERT_FALSE(result.events.empty());
+    EXPECT_EQ(result.events.front().note, 69);
+}
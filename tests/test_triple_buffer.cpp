@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "utils/TripleBuffer.hpp"
+#include <atomic>
+#include <thread>
+
+using ptm::TripleBuffer;
+
+namespace {
+    // Fields that must always agree
+    struct Payload {
+        uint64_t a = 0;
+        uint64_t b = 0;
+        double c = 0.0;
+    };
+}
+
+TEST(TripleBufferTest, ReaderSeesOnlyTheLatestPublication) {
+    TripleBuffer<Payload> buffer(Payload{7, 21, 3.5});
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.front().a, 7u);
+
+    buffer.publish(Payload{1, 3, 0.5});
+    buffer.publish(Payload{2, 6, 1.0});
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.front().a, 2u);
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.front().a, 2u);
+
+    // Filled in place
+    buffer.back().a = 3;
+    buffer.publish();
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.front().a, 3u);
+}
+
+TEST(TripleBufferTest, ReaderNeverSeesATornValue) {
+    TripleBuffer<Payload> buffer;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (uint64_t i = 1; i <= 500000; ++i) {
+            buffer.publish(Payload{i, i * 3, static_cast<double>(i) / 2.0});
+        }
+        done = true;
+    });
+
+    uint64_t previous = 0;
+    while (!done.load()) {
+        if (!buffer.update()) continue;
+        const Payload& value = buffer.front();
+        ASSERT_EQ(value.b, value.a * 3);
+        ASSERT_DOUBLE_EQ(value.c, static_cast<double>(value.a) / 2.0);
+        ASSERT_GT(value.a, previous);
+        previous = value.a;
+    }
+    writer.join();
+
+    buffer.update();
+    EXPECT_EQ(buffer.front().a, 500000u);
+}